@@ -0,0 +1,16 @@
+#version 450
+
+// depth pre-pass of masked meshes, only the alpha test of fragment_shader.frag runs
+layout(set = 0, binding = 1) uniform sampler2D textures[1];
+
+layout(location = 2) in vec2 fragTexCoord;
+layout(location = 3) flat in uint fragTextureIndex;
+
+// see fragment_shader.frag
+const float ALPHA_CUTOFF = 0.5;
+
+void main() {
+    if (texture(textures[fragTextureIndex], fragTexCoord).a < ALPHA_CUTOFF) {
+        discard;
+    }
+}
@@ -1,16 +1,128 @@
 #version 450
 
+layout(set = 0, binding = 0) uniform UniformBufferObject {
+    mat4 view;
+    mat4 proj;
+    vec3 ambientColor;
+    vec4 frustumPlanes[6];
+    vec4 clusterScale;
+    uvec4 clusterParams;
+    mat4 cascadeViewProjections[4];
+    vec4 cascadeSplits;
+    vec4 sunDirection;
+    uvec4 shadowParams;
+} ubo;
+
 layout(set = 0, binding = 1) uniform sampler2D textures[1];
 
+struct Light {
+    vec4 positionRange;
+    vec4 colorIntensity;
+    vec4 directionType;
+    vec4 cone;
+};
+
+layout(std430, set = 0, binding = 4) readonly buffer LightBuffer {
+    Light lights[];
+};
+
+// see ClusteredLighting and cluster_lights.comp
+const uint TILES_X = 16;
+const uint TILES_Y = 9;
+const uint SLICES = 24;
+const uint CLUSTER_COUNT = TILES_X * TILES_Y * SLICES;
+const uint MAX_LIGHTS_PER_CLUSTER = 256;
+const float LIGHT_SPOT = 1.0;
+
+layout(std430, set = 0, binding = 5) readonly buffer ClusterBuffer {
+    uint lightCounts[CLUSTER_COUNT];
+    uint lightIndices[];
+};
+
+// see CascadedShadows, one layer per cascade
+const uint CASCADE_COUNT = 4;
+layout(set = 0, binding = 6) uniform sampler2DArrayShadow shadowMap;
+const vec3 SUN_COLOR = vec3(1.0, 0.95, 0.85);
+
 layout(location = 0) in vec3 fragColor;
 layout(location = 1) in vec3 fragAmbientColor;
 layout(location = 2) in vec2 fragTexCoord;
 layout(location = 3) flat in uint fragTextureIndex;
+layout(location = 4) in vec3 fragWorldPosition;
+layout(location = 5) in vec3 fragNormal;
+layout(location = 6) in float fragViewDepth;
 
 layout(location = 0) out vec4 outColor;
 
+// masked materials, set per pipeline
+layout(constant_id = 0) const bool ALPHA_TEST = false;
+const float ALPHA_CUTOFF = 0.5;
+
+uint clusterIndex() {
+    uvec2 tile = min(uvec2(gl_FragCoord.xy * ubo.clusterScale.xy), uvec2(TILES_X - 1, TILES_Y - 1));
+    uint slice = uint(clamp(log(fragViewDepth) * ubo.clusterScale.z + ubo.clusterScale.w, 0.0, float(SLICES - 1)));
+    return tile.x + TILES_X * (tile.y + TILES_Y * slice);
+}
+
+// blue for an empty cluster to red at 32 lights and more
+vec3 heatColor(uint count) {
+    float heat = clamp(float(count) / 32.0, 0.0, 1.0);
+    return count == 0 ? vec3(0.0, 0.0, 0.3) : mix(vec3(0.0, 1.0, 0.0), vec3(1.0, 0.0, 0.0), heat);
+}
+
+vec3 shade(Light light, vec3 normal) {
+    vec3 toLight = light.positionRange.xyz - fragWorldPosition;
+    float distance = length(toLight);
+    vec3 direction = toLight / max(distance, 1e-4);
+    // smooth window reaching zero at the range, no light is cut off at the cluster boundary
+    float window = clamp(1.0 - pow(distance / light.positionRange.w, 4.0), 0.0, 1.0);
+    float attenuation = window * window / (distance * distance + 1.0);
+    if (light.directionType.w == LIGHT_SPOT) {
+        attenuation *= smoothstep(light.cone.y, light.cone.x, dot(-direction, light.directionType.xyz));
+    }
+    return light.colorIntensity.rgb * light.colorIntensity.w * attenuation * max(dot(normal, direction), 0.0);
+}
+
+// 1 lit to 0 shadowed, 3x3 taps of the hardware 2x2 comparison
+float sunVisibility() {
+    if (ubo.shadowParams.x == 0 || fragViewDepth > ubo.cascadeSplits[CASCADE_COUNT - 1]) {
+        return 1.0;
+    }
+    uint cascade = 0;
+    while (cascade < CASCADE_COUNT - 1 && fragViewDepth > ubo.cascadeSplits[cascade]) {
+        cascade++;
+    }
+    vec4 position = ubo.cascadeViewProjections[cascade] * vec4(fragWorldPosition, 1.0);
+    vec2 uv = position.xy * 0.5 + 0.5;
+    vec2 texel = 1.0 / vec2(textureSize(shadowMap, 0).xy);
+    float visibility = 0.0;
+    for (int y = -1; y <= 1; y++) {
+        for (int x = -1; x <= 1; x++) {
+            visibility += texture(shadowMap, vec4(uv + vec2(x, y) * texel, float(cascade), position.z));
+        }
+    }
+    return visibility / 9.0;
+}
+
 void main() {
     vec4 texColor = texture(textures[fragTextureIndex], fragTexCoord);
-    vec3 finalColor = mix(texColor.rgb, texColor.rgb * fragAmbientColor, 1.0); // 1.0 is the ambient strength, TODO: make a vec4 and use the alpha channel for the strength
+    if (ALPHA_TEST && texColor.a < ALPHA_CUTOFF) {
+        discard;
+    }
+    uint cluster = clusterIndex();
+    uint lightCount = lightCounts[cluster];
+    vec3 normal = normalize(fragNormal);
+    vec3 lighting = fragAmbientColor;
+    float sun = max(dot(normal, ubo.sunDirection.xyz), 0.0);
+    if (sun > 0.0) {
+        lighting += SUN_COLOR * ubo.sunDirection.w * sun * sunVisibility();
+    }
+    for (uint i = 0; i < lightCount; i++) {
+        lighting += shade(lights[lightIndices[cluster * MAX_LIGHTS_PER_CLUSTER + i]], normal);
+    }
+    vec3 finalColor = texColor.rgb * lighting;
+    if (ubo.clusterParams.y != 0) {
+        finalColor = mix(finalColor, heatColor(lightCount), 0.5);
+    }
     outColor = vec4(finalColor, texColor.a);
 }
@@ -0,0 +1,27 @@
+#version 450
+
+struct ObjectData {
+    mat4 world;
+};
+
+// one entry per object, the object buffer of the frame slot
+layout(std430, binding = 0) readonly buffer ObjectBuffer {
+    ObjectData objects[];
+};
+
+// object index of every caster, objectCount entries per cascade
+layout(std430, binding = 1) readonly buffer InstanceBuffer {
+    uint instances[];
+};
+
+layout(push_constant) uniform ShadowConstants {
+    mat4 viewProjection;
+    uint firstInstance;
+} constants;
+
+layout(location = 0) in vec3 inPosition;
+
+void main() {
+    mat4 world = objects[instances[constants.firstInstance + gl_InstanceIndex]].world;
+    gl_Position = constants.viewProjection * world * vec4(inPosition, 1.0);
+}
@@ -0,0 +1,36 @@
+#version 450
+
+layout(binding = 0) uniform sampler2D sceneImage;
+
+layout(push_constant) uniform Constants {
+    vec2 uvScale;
+    vec2 uvMax;
+    vec2 texelSize;
+    float sharpness;
+};
+
+layout(location = 0) in vec2 fragUv;
+
+layout(location = 0) out vec4 outColor;
+
+// the rest of the scene image holds older frames, no tap may reach it
+vec3 fetch(vec2 uv) {
+    return texture(sceneImage, min(uv, uvMax)).rgb;
+}
+
+void main() {
+    vec2 uv = fragUv * uvScale;
+    vec3 color = fetch(uv);
+    if (sharpness > 0.0) {
+        vec3 north = fetch(uv - vec2(0.0, texelSize.y));
+        vec3 south = fetch(uv + vec2(0.0, texelSize.y));
+        vec3 west = fetch(uv - vec2(texelSize.x, 0.0));
+        vec3 east = fetch(uv + vec2(texelSize.x, 0.0));
+        vec3 sharpened = color + (4.0 * color - north - south - west - east) * sharpness * 0.25;
+        // limited to the neighbourhood range, edges do not ring
+        vec3 low = min(color, min(min(north, south), min(west, east)));
+        vec3 high = max(color, max(max(north, south), max(west, east)));
+        color = clamp(sharpened, low, high);
+    }
+    outColor = vec4(color, 1.0);
+}
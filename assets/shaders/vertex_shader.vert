@@ -1,26 +1,52 @@
 #version 450
 
 layout(binding = 0) uniform UniformBufferObject {
-    mat4 model;
     mat4 view;
     mat4 proj;
     vec3 ambientColor;
 } ubo;
 
+struct ObjectData {
+    mat4 world;
+};
+
+// one entry per object
+layout(std430, binding = 2) readonly buffer ObjectBuffer {
+    ObjectData objects[];
+};
+
+// object index of every instance, an instanced draw starts at its firstInstance
+layout(std430, binding = 3) readonly buffer InstanceBuffer {
+    uint instances[];
+};
+
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec3 inColor;
 layout(location = 2) in vec2 inTexCoord;
 layout(location = 3) in uint textureIndex;
+layout(location = 4) in vec3 inNormal;
 
 layout(location = 0) out vec3 fragColor;
 layout(location = 1) out vec3 fragAmbientColor;
 layout(location = 2) out vec2 fragTexCoord;
 layout(location = 3) flat out uint fragTextureIndex;
+layout(location = 4) out vec3 fragWorldPosition;
+layout(location = 5) out vec3 fragNormal;
+layout(location = 6) out float fragViewDepth;
+// the depth pre-pass and the color pass must compute bit identical depths for the equal test
+invariant gl_Position;
 
 void main() {
-    gl_Position = ubo.proj * ubo.view * ubo.model * vec4(inPosition, 1.0);
+    mat4 world = objects[instances[gl_InstanceIndex]].world;
+    vec4 worldPosition = world * vec4(inPosition, 1.0);
+    vec4 viewPosition = ubo.view * worldPosition;
+    gl_Position = ubo.proj * viewPosition;
     fragColor = inColor;
     fragAmbientColor = ubo.ambientColor;
     fragTexCoord = inTexCoord;
     fragTextureIndex = textureIndex;
-}
\ No newline at end of file
+    fragWorldPosition = worldPosition.xyz;
+    // exact for rotations and uniform scales, which is what the scene holds
+    fragNormal = mat3(world) * inNormal;
+    fragViewDepth = -viewPosition.z;
+}
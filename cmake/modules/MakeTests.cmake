@@ -1,10 +1,24 @@
 SET(BINARY_NAME_TESTS ${PROJECT_NAME}-tests)
 
+enable_testing()
+
 file(GLOB_RECURSE SOURCES_TESTS ${CMAKE_SOURCE_DIR}/tests/src/*.cpp)
     
-add_executable(${BINARY_NAME_TESTS} ${SOURCES_TESTS} ${CMAKE_SOURCE_DIR}/src/Utils/parser.cpp)
+# the engine sources under test, the rest needs a device
+set(SOURCES_TESTED
+        ${SRC_DIR}/Core/input.cpp
+        ${SRC_DIR}/Core/inputRecording.cpp
+        ${SRC_DIR}/Gfx/renderQueue.cpp
+        ${SRC_DIR}/Scene/bvh.cpp
+        ${SRC_DIR}/Scene/camera.cpp
+        ${SRC_DIR}/Scene/frustum.cpp
+        ${SRC_DIR}/Scene/registry.cpp
+        ${SRC_DIR}/Scene/transformHierarchy.cpp
+)
+
+add_executable(${BINARY_NAME_TESTS} ${SOURCES_TESTS} ${SOURCES_TESTED})
 
-target_link_libraries(${BINARY_NAME_TESTS} PRIVATE ${THIRDPARTY_LIBRARIES} gtest gtest_main)
+target_link_libraries(${BINARY_NAME_TESTS} PRIVATE ${THIRDPARTY_LIBRARIES} ${MODULES_LIBRARIES} gtest gtest_main)
 target_include_directories(${BINARY_NAME_TESTS} PRIVATE ${gtest_SOURCE_DIR}/googletest/include ${INCLUDE_DIR})
 
 include(GoogleTest)
@@ -2,6 +2,7 @@
 option(USE_CLANG_TIDY "Use Clang-tidy" OFF)
 option(BUILD_DOC "Build documentation only" OFF)
 option(BUILD_TESTS "Build tests" OFF)
+option(ENABLE_PROFILER "Record CPU profiler zones and write a Chrome trace on exit" OFF)
 
 #======================================= Variables ======================================#
 set(CMAKE_CXX_STANDARD 20)
@@ -0,0 +1,81 @@
+///
+/// @file Benchmark.hpp
+/// @brief This file contains the Benchmark class
+/// @namespace ven
+///
+
+#pragma once
+
+#include <utility>
+
+#include "Utils/MemoryMonitor.hpp"
+#include "VEngine/Core/Config.hpp"
+#include "VEngine/Scene/CameraPath.hpp"
+
+namespace ven {
+
+    ///
+    /// @class Benchmark
+    /// @brief Drives the camera along a path for a fixed number of frames and writes a JSON report
+    /// @namespace ven
+    ///
+    /// The camera holds the first key during the warm-up frames, then the measured frames sweep the
+    /// whole path at a constant step per frame, so two runs render the same images whatever their speed.
+    /// The GPU results of a frame are read frames in flight later and joined to it by frame number, the
+    /// last frames in flight never complete in the loop and only count in the CPU series.
+    ///
+    class Benchmark {
+
+        public:
+
+            using LoadTimes = std::vector<std::pair<std::string, float>>;
+
+            explicit Benchmark(const Config& config) : m_path(config.benchmarkPath), m_warmupFrames(config.warmupFrames), m_measuredFrames(config.frameCount), m_reportPath(config.reportPath) { reserve(); }
+            ~Benchmark() = default;
+
+            Benchmark(const Benchmark&) = delete;
+            Benchmark& operator=(const Benchmark&) = delete;
+            Benchmark(Benchmark&&) = delete;
+            Benchmark& operator=(Benchmark&&) = delete;
+
+            void update(Camera& camera, uint64_t frame) const;
+            ///
+            /// @brief Account a rendered frame, warm-up frames are ignored
+            /// @param frameTime Wall time of the whole frame (ms)
+            /// @param cpuTime CPU work of the frame, waits excluded (ms)
+            ///
+            void addFrame(uint64_t frame, float frameTime, float cpuTime);
+            ///
+            /// @brief Attach the GPU results of an earlier frame given to addFrame, warm-up frames are ignored
+            /// @param gpuTime GPU time of the frame (ms)
+            /// @param fragmentInvocations Fragment shader invocations of the frame, 0 without pipeline statistics
+            ///
+            void addGpuFrame(uint64_t frame, float gpuTime, uint64_t fragmentInvocations);
+            void writeReport(const LoadTimes& loadTimes, MemoryMonitor& memoryMonitor) const;
+
+            [[nodiscard]] uint64_t getFrameCount() const { return static_cast<uint64_t>(m_warmupFrames) + m_measuredFrames; }
+
+        private:
+
+            ///
+            /// @struct Sample
+            /// @brief Times of a measured frame (ms), the GPU fields stay NaN until addGpuFrame
+            ///
+            struct Sample {
+                float frameTime;
+                float cpuTime;
+                float gpuTime;
+                float fragmentInvocations; ///< millions, overdraw shows there
+            };
+
+            void reserve() { m_samples.reserve(m_measuredFrames); }
+
+            CameraPath m_path;
+            uint32_t m_warmupFrames;
+            uint32_t m_measuredFrames;
+            std::string m_reportPath;
+            std::vector<Sample> m_samples; ///< indexed by frame - m_warmupFrames
+
+    }; // class Benchmark
+
+} // namespace ven
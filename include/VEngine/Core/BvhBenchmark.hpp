@@ -0,0 +1,42 @@
+///
+/// @file BvhBenchmark.hpp
+/// @brief This file contains the BvhBenchmark class
+/// @namespace ven
+///
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+namespace ven {
+
+    ///
+    /// @class BvhBenchmark
+    /// @brief Times the Bvh against brute force tests over random scenes and writes a JSON report
+    /// @namespace ven
+    ///
+    /// Runs without a window nor a device. For every scene size the objects are random boxes in a cube, the same seed
+    /// each run; the frustum, ray and radius queries are checked to return what brute force returns before being timed.
+    /// The sizes bracket Renderer::BVH_CULL_SIZE and Renderer::PARALLEL_CULL_SIZE, the frustum timings place them.
+    ///
+    class BvhBenchmark {
+
+        public:
+
+            static constexpr std::array<uint32_t, 7> OBJECT_COUNTS{1000, 2048, 4096, 8192, 16384, 32768, 100000};
+            static constexpr uint32_t QUERY_COUNT = 256; ///< queries of each kind timed per scene size
+
+            explicit BvhBenchmark(std::string reportPath) : m_reportPath(std::move(reportPath)) { }
+
+            void run() const;
+
+        private:
+
+            std::string m_reportPath;
+
+    }; // class BvhBenchmark
+
+} // namespace ven
@@ -0,0 +1,46 @@
+///
+/// @file Config.hpp
+/// @brief This file contains the Config struct
+/// @namespace ven
+///
+
+#pragma once
+
+#include <string>
+
+#include "VEngine/Core/Window.hpp"
+
+namespace ven {
+
+    ///
+    /// @struct Config
+    /// @brief Start-up options read from the command line
+    ///
+    struct Config {
+        bool headless = false; ///< render into offscreen images, no window, surface or swap chain
+        uint32_t frameCount = 0; ///< number of frames to render before exiting, 0 = until the window is closed, headless runs get a default
+        std::string dumpDirectory; ///< headless only, write every rendered frame as a png into this directory
+        std::string benchmarkPath; ///< camera path file, when set the run is a benchmark, see Benchmark
+        bool bvhBenchmark = false; ///< run BvhBenchmark into reportPath instead of the engine
+        bool depthPrepass = false; ///< start with RenderSettings::depthPrepass on
+        uint32_t simulationRate = 60; ///< fixed input and camera steps per second, 0 steps once per rendered frame
+        uint32_t lightCount = 0; ///< random point and spot lights spread over the scene bounds
+        uint32_t warmupFrames = 100; ///< benchmark frames rendered before measuring, frameCount are then the measured ones
+        std::string reportPath = "benchmark.json";
+        std::string tracePath = "trace.json"; ///< Chrome trace written on exit, only when built with ENABLE_PROFILER
+        std::string recordPath; ///< save the camera input of the session into this file on exit, see InputRecording
+        std::string replayPath; ///< drive the camera with a recorded session instead of the window input
+        float replayStep = 0.0F; ///< seconds of every replayed frame, 0 replays the recorded delta times
+        std::string frameTracePath; ///< write the frame, CPU and GPU time of every frame as CSV on exit
+        uint16_t width = Window::DEFAULT_WIDTH;
+        uint16_t height = Window::DEFAULT_HEIGHT;
+
+        ///
+        /// @brief Parse --headless, --frames <n>, --dump-dir <path>, --size <width>x<height>,
+        /// --benchmark <camera path>, --bvh-benchmark, --depth-prepass, --lights <n>, --warmup <n>, --report <path>, --trace <path>,
+        /// --record <path>, --replay <path>, --replay-rate <hz>, --frame-trace <path> and --sim-rate <hz>
+        ///
+        [[nodiscard]] static Config parse(int argc, const char* const* argv);
+    };
+
+} // namespace ven
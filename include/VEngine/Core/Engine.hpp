@@ -6,9 +6,16 @@
 
 #pragma once
 
+#include <limits>
+
 #include "Utils/Clock.hpp"
+#include "Utils/FrameLimiter.hpp"
+#include "VEngine/Core/Benchmark.hpp"
+#include "VEngine/Core/Config.hpp"
 #include "VEngine/Core/EventManager.hpp"
-#include "VEngine/Gfx/Backend/Descriptors/Pool.hpp"
+#include "VEngine/Core/RenderThread.hpp"
+#include "VEngine/Gfx/Backend/Descriptors/Allocator.hpp"
+#include "VEngine/Gfx/Backend/Descriptors/LayoutCache.hpp"
 #include "VEngine/Gfx/Backend/Descriptors/SetLayout.hpp"
 #include "VEngine/Gfx/Backend/Descriptors/Sets.hpp"
 #include "VEngine/Gfx/Renderer.hpp"
@@ -25,17 +32,22 @@ namespace ven {
 
         public:
 
-            Engine(): m_device(m_window), m_descriptorPool(m_device.getVkDevice()), m_descriptorSetLayout(m_device.getVkDevice()),
-                      m_descriptorSets(m_device.getVkDevice(), m_descriptorPool.getDescriptorPool(), m_descriptorSetLayout.getDescriptorSetLayout(),m_uniformBuffers),
-                      m_renderer(m_device, m_window, m_models), m_eventManager(m_renderer.getCamera(), m_window) { loadAssets(); init(); }
+            explicit Engine(const Config& config = {}): m_config(config), m_window(config.headless, config.width, config.height), m_device(m_window), m_layoutCache(m_device.getVkDevice()), m_descriptorAllocator(m_device.getVkDevice()), m_descriptorSetLayout(m_layoutCache),
+                      m_descriptorSets(m_device.getVkDevice(), m_descriptorAllocator, m_descriptorSetLayout.getDescriptorSetLayout(),m_uniformBuffers, m_objectBuffers, m_instanceBuffers,
+                                       m_lightBuffers, m_clusterBuffers),
+                      m_renderer(m_device, m_window, m_scene, m_transforms, m_layoutCache, m_descriptorAllocator, config.dumpDirectory), m_eventManager(m_renderer.getCamera(), m_window),
+                      m_renderThread([this](const FrameSnapshot& snapshot) { renderFrame(snapshot); }) { m_submittedFrames.fill(NO_FRAME); if (!config.benchmarkPath.empty()) { m_benchmark = std::make_unique<Benchmark>(config); } loadAssets(); init(); }
 
             ~Engine() {
+                // the render thread uses the buffers below, it is joined before they go
+                m_renderThread.stop();
                 const VkDevice& device = m_device.getVkDevice();
                 TextureManager::clean();
-                for (uint8_t i = 0; i < SwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
-                    vkDestroyBuffer(device, m_uniformBuffers.at(i), nullptr);
-                    vkFreeMemory(device, m_uniformBuffersMemory.at(i), nullptr);
-                }
+                destroyBuffers(m_uniformBuffers, m_uniformBuffersMemory);
+                destroyBuffers(m_objectBuffers, m_objectBuffersMemory);
+                destroyBuffers(m_instanceBuffers, m_instanceBuffersMemory);
+                destroyBuffers(m_lightBuffers, m_lightBuffersMemory);
+                destroyBuffers(m_clusterBuffers, m_clusterBuffersMemory);
                 vkDestroyBuffer(device, m_indexBuffer, nullptr);
                 vkFreeMemory(device, m_indexBufferMemory, nullptr);
                 vkDestroyBuffer(device, m_vertexBuffer, nullptr);
@@ -53,28 +65,90 @@ namespace ven {
 
             void init();
             void loadAssets();
-            void drawFrame();
-            void createUniformBuffers();
+            /// @brief Order m_drawGroups by alpha mode, the MeshRef of the entities and the instance offsets follow
+            void sortDrawGroups();
+            /// @brief Update the next frame into a snapshot, then hand it to the render thread once it took the previous one
+            void drawFrame(uint64_t frame);
+            /// @brief Acquire, record, submit and present the frame of a snapshot, on the render thread
+            void renderFrame(const FrameSnapshot& snapshot);
+            /// @brief Run the fixed simulation steps due since the last frame, then place the camera between the last two
+            void simulate();
+            /// @brief Whether the window events drive the camera, the waits of drawFrame then poll them
+            [[nodiscard]] bool isInputLive() const { return !m_window.isHeadless() && m_benchmark == nullptr && m_config.replayPath.empty(); }
+            /// @brief One host visible buffer per frame slot, mapped for the lifetime of the engine
+            void createMappedBuffers(VkDeviceSize size, VkBufferUsageFlags usage, std::vector<VkBuffer>& buffers, std::vector<VkDeviceMemory>& memory, std::vector<void*>& mapped) const;
+            void destroyBuffers(const std::vector<VkBuffer>& buffers, const std::vector<VkDeviceMemory>& memory) const;
+            /// @brief Mapped light buffers written every frame, device local cluster buffers only the GPU touches
+            void createLightBuffers();
+            ///
+            /// @brief Add count random lights inside m_sceneBounds, every fourth one a spot pointing down
+            ///
+            void createLights(uint32_t count);
+            void writeFrameTrace() const;
+
+            ///
+            /// @struct FrameSample
+            /// @brief Times of a frame written by writeFrameTrace, in ms
+            ///
+            struct FrameSample {
+                float frameTime;
+                float cpuTime;
+                float gpuTime; ///< NaN until the GPU results of the frame are read, the last frames in flight never are
+            };
+
+            static constexpr uint32_t MAX_SIMULATION_STEPS = 8;
+            static constexpr uint64_t NO_FRAME = std::numeric_limits<uint64_t>::max();
+            static constexpr std::chrono::nanoseconds INPUT_POLL_INTERVAL{std::chrono::milliseconds(1)}; ///< of the waits of drawFrame
 
-            uint32_t m_indicesSize = 0;
+            Config m_config;
             Window m_window;
             Device m_device;
-            DescriptorPool m_descriptorPool;
+            DescriptorLayoutCache m_layoutCache;
+            DescriptorAllocator m_descriptorAllocator; ///< every render pass allocates its sets here, transient ones per frame slot, only ImGui keeps its own pool
             DescriptorSetLayout m_descriptorSetLayout;
             DescriptorSets m_descriptorSets;
+            Registry m_scene; ///< a root entity per model with its Transform, then an entity per mesh instance, then the lights
+            TransformHierarchy m_transforms; ///< a root per model, then the nodes of its file
+            uint32_t m_objectCount = 0; ///< entities drawn, the scene is not changed after loadAssets
             Renderer m_renderer;
             EventManager m_eventManager;
             utl::Clock m_clock;
-            std::vector<Model> m_models;
+            double m_simulationTime = -1.0; ///< end of the last step on the input clock, negative before the first frame
+            CameraPose m_previousPose; ///< of the step before the last one
+            CameraPose m_currentPose; ///< of the last step
+            CameraPose m_renderedPose; ///< blend given to the renderer, the Gui edited the camera when they differ
+            utl::FrameLimiter m_frameLimiter;
+            FrameTimings m_frameTimings;
+            std::array<uint64_t, SwapChain::MAX_FRAMES_IN_FLIGHT> m_submittedFrames; ///< last frame submitted per slot, written by the render thread
+            uint64_t m_completedFrame = NO_FRAME; ///< frame of the GPU results in the renderer stats
+            std::unique_ptr<Benchmark> m_benchmark;
+            Benchmark::LoadTimes m_loadTimes;
+            std::vector<FrameSample> m_frameTrace; ///< only with Config::frameTracePath
+            std::vector<DrawGroup> m_drawGroups; ///< one per mesh, MeshRef indexes it
+            Bounds m_sceneBounds; ///< of every object as loaded
             std::vector<VkBuffer> m_uniformBuffers;
             std::vector<VkDeviceMemory> m_uniformBuffersMemory;
             std::vector<void*> m_uniformBuffersMapped;
+            std::vector<VkBuffer> m_objectBuffers;
+            std::vector<VkDeviceMemory> m_objectBuffersMemory;
+            std::vector<void*> m_objectBuffersMapped;
+            std::vector<VkBuffer> m_instanceBuffers;
+            std::vector<VkDeviceMemory> m_instanceBuffersMemory;
+            std::vector<void*> m_instanceBuffersMapped;
+            std::vector<VkBuffer> m_lightBuffers;
+            std::vector<VkDeviceMemory> m_lightBuffersMemory;
+            std::vector<void*> m_lightBuffersMapped;
+            std::vector<VkBuffer> m_clusterBuffers;
+            std::vector<VkDeviceMemory> m_clusterBuffersMemory;
             std::vector<VkCommandBuffer> m_commandBuffers;
             VkBuffer m_vertexBuffer = nullptr;
             VkDeviceMemory m_vertexBufferMemory = nullptr;
             VkBuffer m_indexBuffer = nullptr;
             VkDeviceMemory m_indexBufferMemory = nullptr;
             uint32_t m_currentFrame = 0;
+            FrameTimings m_renderTimings; ///< of the last renderFrame, acquire to present
+            bool m_swapChainOutdated = false; ///< set by the last renderFrame
+            RenderThread m_renderThread; ///< last: it is destroyed first, before anything it renders with
 
     }; // class Engine
 
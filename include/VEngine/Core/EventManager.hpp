@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include "VEngine/Core/Input.hpp"
+#include "VEngine/Core/InputRecording.hpp"
 #include "VEngine/Core/Window.hpp"
 #include "VEngine/Scene/Camera.hpp"
 
@@ -27,6 +29,9 @@ namespace ven {
     };
 
     static constexpr float EPSILON = std::numeric_limits<float>::epsilon();
+    static constexpr float SCROLL_SPEED_STEP = 1.1F; ///< move speed factor per scroll notch
+    static constexpr float MIN_MOVE_SPEED = 0.1F;
+    static constexpr float MAX_MOVE_SPEED = 100.0F;
     static constexpr KeyMappings DEFAULT_KEY_MAPPINGS{};
 
     ///
@@ -38,7 +43,7 @@ namespace ven {
 
         public:
 
-            explicit EventManager(Camera& camera, const Window& window): m_camera(camera), m_window(window) { }
+            explicit EventManager(Camera& camera, Window& window): m_camera(camera), m_window(window) { }
             ~EventManager() = default;
 
             EventManager(const EventManager&) = delete;
@@ -46,16 +51,50 @@ namespace ven {
             EventManager(EventManager&&) = delete;
             EventManager& operator=(EventManager&&) = delete;
 
-            void handleEvents(float dt) const;
+            ///
+            /// @brief Poll the window, consume its input queue and move the camera
+            /// @param dt Seconds since the previous call, the held keys act for their share of it
+            ///
+            void handleEvents(const float dt) { pollEvents(); step(getTime(), dt); }
+            /// @brief Run the window callbacks, their events stay queued until a step consumes them
+            void pollEvents() { m_window.pollEvents(); }
+            ///
+            /// @brief Consume the window events up to time and move the camera
+            /// @param time End of the step, from getTime
+            /// @param dt Length of the step
+            ///
+            void step(double time, float dt);
+            /// @brief Seconds on the clock of the input events
+            [[nodiscard]] static double getTime() { return glfwGetTime(); }
+            ///
+            /// @brief Move the camera with the events of a recorded frame, the window events are discarded
+            /// @param fixedStep Seconds of every frame, 0 to replay the recorded delta times
+            ///
+            void replayEvents(size_t frame, float fixedStep);
+
+            /// @brief Keep the input of every following handleEvents call, from the current camera state
+            void startRecording() { m_recording.begin(m_camera); m_recordingActive = true; }
+            void saveRecording(const std::string& path) const { m_recording.save(path); }
+            /// @brief Load a recording and put the camera in its starting state
+            void loadReplay(const std::string& path) { m_recording.load(path); m_recording.restoreCamera(m_camera); }
+
+            [[nodiscard]] const InputState& getInputState() const { return m_inputState; }
+            [[nodiscard]] size_t getReplayFrameCount() const { return m_recording.getFrameCount(); }
 
         private:
 
-            template<typename Iterator>
-            static void processKeyActions(GLFWwindow* window, Iterator begin, Iterator end);
-            static bool isKeyJustPressed(GLFWwindow* window, long unsigned int key, std::array<bool, GLFW_KEY_LAST>& keyStates);
+            ///
+            /// @brief Consume the queue into m_inputState and move the camera
+            /// @param scroll Apply the wheel to the move speed
+            ///
+            void applyInput(InputQueue& queue, double time, float dt, bool scroll);
 
             Camera &m_camera;
-            const Window& m_window;
+            Window& m_window;
+            InputState m_inputState;
+            InputRecording m_recording; ///< recorded into or replayed from
+            InputQueue m_replayQueue;
+            bool m_recordingActive = false;
 
     }; // class EventManager
 
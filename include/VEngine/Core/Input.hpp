@@ -0,0 +1,134 @@
+///
+/// @file Input.hpp
+/// @brief This file contains the InputQueue and InputState classes
+/// @namespace ven
+///
+
+#pragma once
+
+#include <array>
+#include <bitset>
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+namespace ven {
+
+    ///
+    /// @enum InputEventType
+    /// @brief Source of an InputEvent
+    ///
+    enum class InputEventType : uint8_t {
+        KEY, ///< code is a GLFW key
+        MOUSE_BUTTON, ///< code is a GLFW mouse button
+        SCROLL ///< x and y are the offsets
+    };
+
+    ///
+    /// @struct InputEvent
+    /// @brief Input reported by a GLFW callback
+    ///
+    struct InputEvent {
+        double time = 0.0; ///< glfwGetTime between the poll that reported it and the previous one, see Window::pollEvents
+        float x = 0.0F;
+        float y = 0.0F;
+        int32_t code = 0;
+        InputEventType type = InputEventType::KEY;
+        uint8_t action = GLFW_RELEASE; ///< GLFW_PRESS, GLFW_RELEASE or GLFW_REPEAT
+    };
+
+    ///
+    /// @class InputQueue
+    /// @brief Fixed size ring buffer of InputEvent, filled by the window callbacks and emptied once per frame
+    /// @namespace ven
+    ///
+    /// The callbacks and the consumer both run on the main thread. A full queue drops the new events and counts them:
+    /// CAPACITY is far above what a frame receives, a drop means the queue was not consumed.
+    ///
+    class InputQueue {
+
+        public:
+
+            static constexpr uint32_t CAPACITY = 256; ///< power of two
+
+            void push(const InputEvent& event) {
+                if (m_tail - m_head == CAPACITY) {
+                    m_droppedCount++;
+                    return;
+                }
+                m_events.at(m_tail & (CAPACITY - 1)) = event;
+                m_tail++;
+            }
+            bool pop(InputEvent& event) {
+                if (m_head == m_tail) {
+                    return false;
+                }
+                event = m_events.at(m_head & (CAPACITY - 1));
+                m_head++;
+                return true;
+            }
+
+            /// @brief Queued event, 0 is the next one to pop
+            [[nodiscard]] const InputEvent& peek(const uint32_t index) const { return m_events.at((m_head + index) & (CAPACITY - 1)); }
+            void clear() { m_head = m_tail; }
+            [[nodiscard]] uint32_t getSize() const { return m_tail - m_head; }
+            [[nodiscard]] uint32_t getDroppedCount() const { return m_droppedCount; }
+
+        private:
+
+            std::array<InputEvent, CAPACITY> m_events{};
+            uint32_t m_head = 0; ///< next event to pop, both indices wrap around with the unsigned arithmetic
+            uint32_t m_tail = 0;
+            uint32_t m_droppedCount = 0;
+
+    }; // class InputQueue
+
+    ///
+    /// @class InputState
+    /// @brief Keys and mouse buttons down, built from the events of an InputQueue
+    /// @namespace ven
+    ///
+    /// update replays the events in order over the interval since the previous update: besides the state at its end, it
+    /// keeps the part of the interval each button was held. The events are only as precise as the polls that stamped
+    /// them, the main thread polls while it waits on the GPU and the render thread so that is finer than a frame. A press
+    /// and its release reported by the same poll share a stamp, they count as held for MIN_TAP_TIME so the tap is not lost.
+    ///
+    class InputState {
+
+        public:
+
+            static constexpr uint32_t KEY_COUNT = GLFW_KEY_LAST + 1;
+            static constexpr uint32_t BUTTON_COUNT = KEY_COUNT + GLFW_MOUSE_BUTTON_LAST + 1; ///< keys, then mouse buttons
+            static constexpr double MIN_TAP_TIME = 1.0 / 60.0; ///< seconds a button pressed and released in an interval is held at least
+
+            ///
+            /// @brief Consume the queued events up to now, the later ones stay queued for the next interval
+            /// @param now End of the interval
+            ///
+            void update(InputQueue& queue, double now);
+
+            [[nodiscard]] bool isKeyDown(const int key) const { return isDown(keyIndex(key)); }
+            [[nodiscard]] bool isKeyJustPressed(const int key) const { return isValid(keyIndex(key)) && m_pressed.test(keyIndex(key)); }
+            [[nodiscard]] bool isMouseButtonDown(const int button) const { return isDown(buttonIndex(button)); }
+            /// @brief Part of the last interval the key was held, from 0 to 1
+            [[nodiscard]] float getKeyHeldFraction(const int key) const { return isValid(keyIndex(key)) ? m_heldFractions.at(keyIndex(key)) : 0.0F; }
+            /// @brief Vertical scroll of the last interval
+            [[nodiscard]] float getScroll() const { return m_scroll; }
+
+        private:
+
+            static constexpr uint32_t keyIndex(const int key) { return static_cast<uint32_t>(key); }
+            static constexpr uint32_t buttonIndex(const int button) { return KEY_COUNT + static_cast<uint32_t>(button); }
+            static constexpr bool isValid(const uint32_t index) { return index < BUTTON_COUNT; }
+            [[nodiscard]] bool isDown(const uint32_t index) const { return isValid(index) && m_down.test(index); }
+
+            std::bitset<BUTTON_COUNT> m_down;
+            std::bitset<BUTTON_COUNT> m_pressed; ///< during the last interval
+            std::array<double, BUTTON_COUNT> m_heldSince{}; ///< of the buttons down, counted up to there
+            std::array<float, BUTTON_COUNT> m_heldFractions{};
+            double m_lastUpdate = 0.0;
+            float m_scroll = 0.0F;
+
+    }; // class InputState
+
+} // namespace ven
@@ -0,0 +1,83 @@
+///
+/// @file InputRecording.hpp
+/// @brief This file contains the InputRecording class
+/// @namespace ven
+///
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "VEngine/Core/Input.hpp"
+#include "VEngine/Scene/Camera.hpp"
+
+namespace ven {
+
+    ///
+    /// @class InputRecording
+    /// @brief Input events and delta time of every frame of a session, saved to a binary file
+    /// @namespace ven
+    ///
+    /// The camera pose and speeds at the start are saved with the frames, so a replay starts from the same state and
+    /// moves the camera the same way on any build. Only the camera input is captured: changes made through the Gui are
+    /// not part of the recording.
+    ///
+    /// File, little endian whatever the host: the magic "VENR", the version, the frame and event counts, the starting
+    /// position, yaw, pitch, move and look speeds, then every frame (dt as float, end time as double, event count as
+    /// uint32) and every event (time as double, x, y, code, type, action). load checks the counts against the file size.
+    ///
+    class InputRecording {
+
+        public:
+
+            static constexpr uint32_t VERSION = 1;
+
+            struct Frame {
+                float dt = 0.0F; ///< seconds given to the EventManager
+                double time = 0.0; ///< end of the input interval, glfwGetTime
+                uint32_t firstEvent = 0;
+                uint32_t eventCount = 0;
+            };
+
+            InputRecording() = default;
+            ~InputRecording() = default;
+
+            InputRecording(const InputRecording&) = delete;
+            InputRecording& operator=(const InputRecording&) = delete;
+            InputRecording(InputRecording&&) = delete;
+            InputRecording& operator=(InputRecording&&) = delete;
+
+            /// @brief Start a recording from the current camera state
+            void begin(Camera& camera);
+            ///
+            /// @brief Append a frame with the queued events up to time, the queue is left untouched
+            /// @param scroll Keep the scroll events, they are left out when the Gui used them
+            ///
+            void addFrame(float dt, double time, const InputQueue& queue, bool scroll);
+            void save(const std::string& path) const;
+            void load(const std::string& path);
+
+            /// @brief Put the camera back in its state at the start of the recording
+            void restoreCamera(Camera& camera) const;
+            ///
+            /// @brief Push the events of a frame, the queue is expected to be empty
+            ///
+            void replayEvents(size_t frame, InputQueue& queue) const;
+
+            [[nodiscard]] size_t getFrameCount() const { return m_frames.size(); }
+            [[nodiscard]] const Frame& getFrame(const size_t frame) const { return m_frames.at(frame); }
+
+        private:
+
+            glm::vec3 m_position{0.0F};
+            float m_yaw = 0.0F;
+            float m_pitch = 0.0F;
+            float m_moveSpeed = 0.0F;
+            float m_lookSpeed = 0.0F;
+            std::vector<Frame> m_frames;
+            std::vector<InputEvent> m_events;
+
+    }; // class InputRecording
+
+} // namespace ven
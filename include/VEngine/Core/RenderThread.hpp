@@ -0,0 +1,78 @@
+///
+/// @file RenderThread.hpp
+/// @brief This file contains the RenderThread class
+/// @namespace ven
+///
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "VEngine/Gfx/FrameSnapshot.hpp"
+
+namespace ven {
+
+    ///
+    /// @class RenderThread
+    /// @brief Thread recording, submitting and presenting the frames the update thread hands over
+    /// @namespace ven
+    ///
+    /// Two snapshots alternate: the update thread fills one while the render thread reads the other. A snapshot is only
+    /// handed over once the previous one has been rendered, so the queue is one frame deep and the update thread runs at
+    /// most a frame ahead. Between waitIdle and submit the render thread is parked: the update thread may then change
+    /// anything it uses, the swap chain included.
+    ///
+    class RenderThread {
+
+        public:
+
+            using RenderFunction = std::function<void(const FrameSnapshot&)>;
+
+            explicit RenderThread(RenderFunction render);
+            ~RenderThread() { stop(); }
+
+            RenderThread(const RenderThread&) = delete;
+            RenderThread& operator=(const RenderThread&) = delete;
+            RenderThread(RenderThread&&) = delete;
+            RenderThread& operator=(RenderThread&&) = delete;
+
+            /// @brief Snapshot of the next frame, only the update thread touches it until submit
+            [[nodiscard]] FrameSnapshot& getSnapshot() { return m_snapshots.at(m_writeIndex); }
+            ///
+            /// @brief Block until the frame handed over last has been rendered
+            /// @throws What the render function threw for that frame
+            ///
+            void waitIdle();
+            ///
+            /// @brief waitIdle for at most timeout
+            /// @return Whether the render thread is idle
+            /// @throws What the render function threw for that frame
+            ///
+            bool waitIdleFor(std::chrono::nanoseconds timeout);
+            /// @brief Hand getSnapshot over once the render thread is idle, the other snapshot becomes writable
+            void submit();
+            /// @brief Let the frame handed over finish, then join the thread, nothing can be submitted afterwards
+            void stop();
+
+        private:
+
+            void threadLoop();
+
+            RenderFunction m_render;
+            std::array<FrameSnapshot, 2> m_snapshots;
+            uint32_t m_writeIndex = 0; ///< written by the update thread only, under the lock
+            std::mutex m_mutex;
+            std::condition_variable m_condition;
+            bool m_pending = false; ///< the other snapshot was handed over and is not rendered yet
+            bool m_stop = false;
+            std::exception_ptr m_exception;
+            std::thread m_thread; ///< last, it starts once the rest is initialized
+
+    }; // class RenderThread
+
+} // namespace ven
@@ -6,10 +6,8 @@
 
 #pragma once
 
-#define GLFW_INCLUDE_VULKAN
-#include <GLFW/glfw3.h>
-
 #include "Utils/ErrorHandling.hpp"
+#include "VEngine/Core/Input.hpp"
 
 namespace ven {
 
@@ -25,8 +23,11 @@ namespace ven {
             static constexpr uint16_t DEFAULT_WIDTH = 1920;
             static constexpr uint16_t DEFAULT_HEIGHT = 1080;
 
-            explicit Window(const uint16_t width = DEFAULT_WIDTH, const uint16_t height = DEFAULT_HEIGHT) : m_window(createWindow(width, height, "VEngine")) { setWindowIcon("assets/images/icon64x64.png"); }
-            ~Window() { glfwTerminate(); }
+            ///
+            /// @param headless Do not open a window, only the size is kept, see Config::headless
+            ///
+            explicit Window(const bool headless = false, const uint16_t width = DEFAULT_WIDTH, const uint16_t height = DEFAULT_HEIGHT) : m_headlessExtent{width, height} { if (!headless) { m_window = createWindow(width, height, "VEngine"); setWindowIcon("assets/images/icon64x64.png"); } }
+            ~Window() { if (m_window != nullptr) { glfwTerminate(); } }
 
             Window(const Window&) = delete;
             Window& operator=(const Window&) = delete;
@@ -37,13 +38,22 @@ namespace ven {
             static void setFullscreen(bool fullscreen, uint16_t width, uint16_t height);
             [[nodiscard]] bool wasWindowResized() const { return m_frameBufferResized; }
             void resetWindowResizedFlag() { m_frameBufferResized = false; }
-            static void pollEvents() { glfwPollEvents(); }
-            [[nodiscard]] bool shouldClose() const { return glfwWindowShouldClose(m_window) != 0; }
+            ///
+            /// @brief Run the callbacks of the events received since the previous call
+            ///
+            /// An event only says it happened between the previous poll and this one: it is stamped with the middle of
+            /// that span, polling more often makes its time more precise.
+            ///
+            void pollEvents();
+            [[nodiscard]] bool shouldClose() const { return m_window != nullptr && glfwWindowShouldClose(m_window) != 0; }
+            [[nodiscard]] bool isHeadless() const { return m_window == nullptr; }
             static void waitEvents() { glfwWaitEvents(); }
 
-            [[nodiscard]] VkExtent2D getExtent() const { int width = 0; int height = 0; glfwGetFramebufferSize(m_window, &width, &height); return {static_cast<uint32_t>(width), static_cast<uint32_t>(height)}; }
+            [[nodiscard]] VkExtent2D getExtent() const { int width = 0; int height = 0; getFrameBufferSize(width, height); return {static_cast<uint32_t>(width), static_cast<uint32_t>(height)}; }
             [[nodiscard]] GLFWwindow* getGLFWWindow() const { return m_window; }
-            void getFrameBufferSize(int& width, int& height) const { glfwGetFramebufferSize(m_window, &width, &height); }
+            /// @brief Key, mouse button and scroll events since it was last emptied, filled by pollEvents
+            [[nodiscard]] InputQueue& getInputQueue() { return m_inputQueue; }
+            void getFrameBufferSize(int& width, int& height) const { if (m_window == nullptr) { width = m_headlessExtent.width; height = m_headlessExtent.height; return; } glfwGetFramebufferSize(m_window, &width, &height); }
             [[nodiscard]] static const char **getRequiredInstanceExtensions(uint32_t *count) { return glfwGetRequiredInstanceExtensions(count); }
 
         private:
@@ -51,8 +61,15 @@ namespace ven {
             [[nodiscard]] GLFWwindow* createWindow(uint16_t width, uint16_t height, const std::string &title);
             void setWindowIcon(const std::string& path) const;
             static void frameBufferResizeCallback(GLFWwindow* window, int width, int height) { static_cast<Window *>(glfwGetWindowUserPointer(window))->m_frameBufferResized = true; }
+            static void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
+            static void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods);
+            static void scrollCallback(GLFWwindow* window, double xOffset, double yOffset);
 
             GLFWwindow* m_window = nullptr;
+            VkExtent2D m_headlessExtent{};
+            InputQueue m_inputQueue;
+            double m_lastPoll = -1.0; ///< glfwGetTime of the previous pollEvents, negative before the first one
+            double m_eventTime = 0.0; ///< stamp of the events of the poll running
             bool m_frameBufferResized = false;
 
     }; // class Window
@@ -0,0 +1,47 @@
+///
+/// @file CommandPools.hpp
+/// @brief This file contains the CommandPools class
+/// @namespace ven
+///
+
+#pragma once
+
+#include "VEngine/Gfx/Backend/SwapChain.hpp"
+
+namespace ven {
+
+    ///
+    /// @class CommandPools
+    /// @brief Per-frame, per-slot command pools each owning one secondary command buffer
+    /// @namespace ven
+    ///
+    /// A slot is only ever recorded by one thread at a time, so its pool needs no locking.
+    /// All the pools of a frame are reset at once when that frame starts recording again.
+    ///
+    class CommandPools {
+
+        public:
+
+            explicit CommandPools(const Device& device, uint32_t slotCount);
+            ~CommandPools();
+
+            CommandPools(const CommandPools&) = delete;
+            CommandPools& operator=(const CommandPools&) = delete;
+            CommandPools(CommandPools&&) = delete;
+            CommandPools& operator=(CommandPools&&) = delete;
+
+            void reset(uint32_t frameIndex) const;
+
+            [[nodiscard]] uint32_t getSlotCount() const { return m_slotCount; }
+            [[nodiscard]] const VkCommandBuffer& getCommandBuffer(const uint32_t frameIndex, const uint32_t slot) const { return m_commandBuffers.at((frameIndex * m_slotCount) + slot); }
+
+        private:
+
+            const VkDevice& m_device;
+            uint32_t m_slotCount;
+            std::vector<VkCommandPool> m_pools;
+            std::vector<VkCommandBuffer> m_commandBuffers;
+
+    }; // class CommandPools
+
+} // namespace ven
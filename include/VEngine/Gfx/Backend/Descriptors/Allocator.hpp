@@ -0,0 +1,80 @@
+///
+/// @file Allocator.hpp
+/// @brief This file contains the DescriptorAllocator class
+/// @namespace ven
+///
+
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include "VEngine/Gfx/Backend/SwapChain.hpp"
+
+namespace ven {
+
+    ///
+    /// @class DescriptorAllocator
+    /// @brief Descriptor sets from lists of pools that grow on demand
+    /// @namespace ven
+    ///
+    /// Transient sets live for one frame slot: every slot owns the pools it allocated from, and resetFrame resets them
+    /// whole once the fence of the slot signaled, then hands them back for reuse. The pools are created without
+    /// VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT, so once the pools of a slot are large enough an allocation is a
+    /// bump of the pool offset. A full pool is replaced by a new one, larger than the last up to MAX_POOL_SETS.
+    /// Persistent sets live as long as the allocator, in pools of their own.
+    ///
+    class DescriptorAllocator {
+
+        public:
+
+            static constexpr uint32_t FIRST_POOL_SETS = 64;
+            static constexpr uint32_t MAX_POOL_SETS = 4096;
+
+            explicit DescriptorAllocator(const VkDevice& device) : m_device(device) { }
+            ~DescriptorAllocator();
+
+            DescriptorAllocator(const DescriptorAllocator &) = delete;
+            DescriptorAllocator &operator=(const DescriptorAllocator &) = delete;
+            DescriptorAllocator(DescriptorAllocator &&) = delete;
+            DescriptorAllocator &operator=(DescriptorAllocator &&) = delete;
+
+            ///
+            /// @brief Set valid until the next resetFrame of the slot
+            ///
+            [[nodiscard]] VkDescriptorSet allocate(uint32_t frameIndex, const VkDescriptorSetLayout& layout);
+            ///
+            /// @brief Set valid as long as the allocator
+            ///
+            [[nodiscard]] VkDescriptorSet allocatePersistent(const VkDescriptorSetLayout& layout);
+            ///
+            /// @brief Free every transient set of the slot, its fence must have signaled
+            ///
+            void resetFrame(uint32_t frameIndex);
+
+            [[nodiscard]] size_t getPoolCount() const;
+
+        private:
+
+            struct PoolList {
+                std::vector<VkDescriptorPool> pools; ///< the last one is allocated from
+            };
+
+            ///
+            /// @brief Allocate from the last pool of the list, add a pool when it is full
+            ///
+            VkDescriptorSet allocate(PoolList& list, const VkDescriptorSetLayout& layout);
+            VkDescriptorPool acquirePool();
+            VkDescriptorPool createPool(uint32_t maxSets) const;
+
+            const VkDevice& m_device;
+            std::array<PoolList, SwapChain::MAX_FRAMES_IN_FLIGHT> m_framePools;
+            PoolList m_persistentPools;
+            std::vector<VkDescriptorPool> m_freePools; ///< reset, not owned by any list
+            uint32_t m_nextPoolSets = FIRST_POOL_SETS;
+
+    }; // class DescriptorAllocator
+
+} // namespace ven
@@ -0,0 +1,61 @@
+///
+/// @file LayoutCache.hpp
+/// @brief This file contains the DescriptorLayoutCache class
+/// @namespace ven
+///
+
+#pragma once
+
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+namespace ven {
+
+    ///
+    /// @class DescriptorLayoutCache
+    /// @brief Owner of the descriptor set layouts, one per distinct set of bindings
+    /// @namespace ven
+    ///
+    /// Two passes asking for the same bindings share a layout, so their sets are compatible. Bindings are compared
+    /// whatever order they are given in; immutable samplers are not supported.
+    ///
+    class DescriptorLayoutCache {
+
+        public:
+
+            explicit DescriptorLayoutCache(const VkDevice& device) : m_device(device) { }
+            ~DescriptorLayoutCache();
+
+            DescriptorLayoutCache(const DescriptorLayoutCache &) = delete;
+            DescriptorLayoutCache &operator=(const DescriptorLayoutCache &) = delete;
+            DescriptorLayoutCache(DescriptorLayoutCache &&) = delete;
+            DescriptorLayoutCache &operator=(DescriptorLayoutCache &&) = delete;
+
+            ///
+            /// @brief Layout of these bindings, created on the first request and destroyed with the cache
+            ///
+            [[nodiscard]] VkDescriptorSetLayout getLayout(std::span<const VkDescriptorSetLayoutBinding> bindings);
+
+            [[nodiscard]] size_t getLayoutCount() const { return m_layouts.size(); }
+
+        private:
+
+            struct LayoutKey {
+                std::vector<VkDescriptorSetLayoutBinding> bindings; ///< sorted by binding
+
+                bool operator==(const LayoutKey& other) const;
+            };
+
+            struct LayoutKeyHash {
+                size_t operator()(const LayoutKey& key) const;
+            };
+
+            const VkDevice& m_device;
+            std::unordered_map<LayoutKey, VkDescriptorSetLayout, LayoutKeyHash> m_layouts;
+
+    }; // class DescriptorLayoutCache
+
+} // namespace ven
@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include "VEngine/Gfx/Backend/Descriptors/LayoutCache.hpp"
+
 namespace ven {
 
     ///
@@ -17,8 +19,8 @@ namespace ven {
 
         public:
 
-            explicit DescriptorSetLayout(const VkDevice &device): m_device(device) { }
-            ~DescriptorSetLayout() { vkDestroyDescriptorSetLayout(m_device, m_descriptorSetLayout, nullptr); }
+            explicit DescriptorSetLayout(DescriptorLayoutCache& layoutCache): m_layoutCache(layoutCache) { }
+            ~DescriptorSetLayout() = default;
 
             DescriptorSetLayout(const DescriptorSetLayout &) = delete;
             DescriptorSetLayout &operator=(const DescriptorSetLayout &) = delete;
@@ -31,8 +33,8 @@ namespace ven {
 
         private:
 
-            const VkDevice& m_device;
-            VkDescriptorSetLayout m_descriptorSetLayout = nullptr;
+            DescriptorLayoutCache& m_layoutCache;
+            VkDescriptorSetLayout m_descriptorSetLayout = nullptr; ///< owned by m_layoutCache
 
     }; // class DescriptorSetLayout
 
@@ -1,11 +1,13 @@
 ///
-/// @file Pool.hpp
+/// @file Sets.hpp
 /// @brief This file contains the DescriptorSets class
 /// @namespace ven
 ///
 
 #pragma once
 
+#include "VEngine/Gfx/Backend/Descriptors/Allocator.hpp"
+
 namespace ven {
 
     ///
@@ -17,7 +19,8 @@ namespace ven {
 
         public:
 
-            explicit DescriptorSets(const VkDevice& device, const VkDescriptorPool& descriptorPool, const VkDescriptorSetLayout& descriptorSetLayout, const std::vector<VkBuffer>& buffers) : m_device(device), m_descriptorPool(descriptorPool), m_descriptorSetLayout(descriptorSetLayout), m_buffers(buffers) { }
+            explicit DescriptorSets(const VkDevice& device, DescriptorAllocator& descriptorAllocator, const VkDescriptorSetLayout& descriptorSetLayout, const std::vector<VkBuffer>& buffers, const std::vector<VkBuffer>& objectBuffers, const std::vector<VkBuffer>& instanceBuffers,
+                                    const std::vector<VkBuffer>& lightBuffers, const std::vector<VkBuffer>& clusterBuffers) : m_device(device), m_descriptorAllocator(descriptorAllocator), m_descriptorSetLayout(descriptorSetLayout), m_buffers(buffers), m_objectBuffers(objectBuffers), m_instanceBuffers(instanceBuffers), m_lightBuffers(lightBuffers), m_clusterBuffers(clusterBuffers) { }
             ~DescriptorSets() = default;
 
             DescriptorSets(const DescriptorSets &) = delete;
@@ -25,16 +28,20 @@ namespace ven {
             DescriptorSets(DescriptorSets &&) = delete;
             DescriptorSets &operator=(DescriptorSets &&) = delete;
 
-            void create(VkDeviceSize bufferSize);
+            void create(VkDeviceSize bufferSize, VkDeviceSize objectBufferSize, VkDeviceSize instanceBufferSize, VkDeviceSize lightBufferSize, VkDeviceSize clusterBufferSize, const VkDescriptorImageInfo& shadowMapInfo);
 
             [[nodiscard]] const std::vector<VkDescriptorSet>& getDescriptorSets() const { return m_descriptorSets; }
 
         private:
 
             const VkDevice& m_device;
-            const VkDescriptorPool& m_descriptorPool;
+            DescriptorAllocator& m_descriptorAllocator;
             const VkDescriptorSetLayout& m_descriptorSetLayout;
             const std::vector<VkBuffer>& m_buffers;
+            const std::vector<VkBuffer>& m_objectBuffers;
+            const std::vector<VkBuffer>& m_instanceBuffers;
+            const std::vector<VkBuffer>& m_lightBuffers;
+            const std::vector<VkBuffer>& m_clusterBuffers;
             std::vector<VkDescriptorSet> m_descriptorSets;
 
     }; // class DescriptorSets
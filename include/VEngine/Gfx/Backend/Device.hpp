@@ -10,6 +10,7 @@
 #include <vector>
 #include <optional>
 
+#include "Utils/Profiler.hpp"
 #include "VEngine/Core/Window.hpp"
 
 #ifdef NDEBUG
@@ -45,7 +46,10 @@ namespace ven {
             static constexpr std::array<const char*, 1> DEVICE_EXTENSIONS = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
             static constexpr std::array<const char*, 1> VALIDATION_LAYERS = { "VK_LAYER_KHRONOS_validation" };
 
-            explicit Device(const Window& window): m_window{window} { createInstance(); setupDebugMessenger(); m_window.createWindowSurface(m_instance, &m_surface); pickPhysicalDevice(); createLogicalDevice(); createCommandPool(); }
+            ///
+            /// @brief With a headless window no surface is created and VK_KHR_swapchain is neither required nor enabled
+            ///
+            explicit Device(const Window& window): m_window{window} { PROFILE_SCOPE("Device"); createInstance(); setupDebugMessenger(); if (!m_window.isHeadless()) { m_window.createWindowSurface(m_instance, &m_surface); } pickPhysicalDevice(); createLogicalDevice(); createCommandPool(); }
             ~Device();
 
             Device(const Device &) = delete;
@@ -64,6 +68,10 @@ namespace ven {
             [[nodiscard]] QueueFamilyIndices findQueueFamilies(const VkPhysicalDevice& device) const;
             [[nodiscard]] SwapChainSupportDetails querySwapChainSupport(const VkPhysicalDevice& device) const;
 
+            [[nodiscard]] bool isHeadless() const { return m_window.isHeadless(); }
+            [[nodiscard]] bool hasPipelineStatistics() const { return m_pipelineStatistics; }
+            /// @return true when vkCmdDrawIndexedIndirectCount with multi draw and firstInstance can be used
+            [[nodiscard]] bool hasDrawIndirectCount() const { return m_drawIndirectCount; }
             [[nodiscard]] const VkDevice& getVkDevice() const { return m_device; }
             [[nodiscard]] const VkInstance& getVkInstance() const { return m_instance; }
             [[nodiscard]] const VkSurfaceKHR& getVkSurface() const { return m_surface; }
@@ -94,6 +102,8 @@ namespace ven {
             VkQueue m_presentQueue = VK_NULL_HANDLE;
             VkCommandPool m_commandPool = VK_NULL_HANDLE;
             VkSampleCountFlagBits m_msaaSamples = VK_SAMPLE_COUNT_1_BIT;
+            bool m_pipelineStatistics = false;
+            bool m_drawIndirectCount = false;
             VkDebugUtilsMessengerEXT m_debugMessenger = VK_NULL_HANDLE;
 
     }; // class Device
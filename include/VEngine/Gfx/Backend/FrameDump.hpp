@@ -0,0 +1,64 @@
+///
+/// @file FrameDump.hpp
+/// @brief This file contains the FrameDump class
+/// @namespace ven
+///
+
+#pragma once
+
+#include <string>
+
+#include "VEngine/Gfx/Backend/SwapChain.hpp"
+
+namespace ven {
+
+    ///
+    /// @class FrameDump
+    /// @brief Copies rendered headless frames into host memory and writes them as png files
+    /// @namespace ven
+    ///
+    /// Each frame slot owns a persistently mapped readback buffer, the copy is recorded at the end of the frame
+    /// and the file is only written once the slot fence has been waited on again, so dumping never stalls the GPU.
+    ///
+    class FrameDump {
+
+        public:
+
+            explicit FrameDump(const Device& device, const VkExtent2D& extent, std::string directory);
+            ~FrameDump();
+
+            FrameDump(const FrameDump&) = delete;
+            FrameDump& operator=(const FrameDump&) = delete;
+            FrameDump(FrameDump&&) = delete;
+            FrameDump& operator=(FrameDump&&) = delete;
+
+            ///
+            /// @brief Record the copy of image, which the render pass left in VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
+            ///
+            void record(const VkCommandBuffer& commandBuffer, const VkImage& image, uint32_t frameIndex);
+            ///
+            /// @brief Write the frame copied in frameIndex, its fence must have been waited on
+            ///
+            void write(uint32_t frameIndex);
+            ///
+            /// @brief Write every pending frame in order, the device must be idle
+            ///
+            void writeAll();
+
+        private:
+
+            static constexpr uint64_t NO_FRAME = UINT64_MAX;
+
+            const Device& m_device;
+            VkExtent2D m_extent;
+            std::string m_directory;
+            std::array<VkBuffer, SwapChain::MAX_FRAMES_IN_FLIGHT> m_buffers{};
+            std::array<VkDeviceMemory, SwapChain::MAX_FRAMES_IN_FLIGHT> m_memories{};
+            std::array<void*, SwapChain::MAX_FRAMES_IN_FLIGHT> m_mapped{};
+            std::array<uint64_t, SwapChain::MAX_FRAMES_IN_FLIGHT> m_pendingFrames{};
+            std::vector<unsigned char> m_pixels;
+            uint64_t m_frameNumber = 0;
+
+    }; // class FrameDump
+
+} // namespace ven
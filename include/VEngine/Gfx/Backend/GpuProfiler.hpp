@@ -0,0 +1,76 @@
+///
+/// @file GpuProfiler.hpp
+/// @brief This file contains the GpuProfiler class
+/// @namespace ven
+///
+
+#pragma once
+
+#include "VEngine/Gfx/Backend/SwapChain.hpp"
+#include "VEngine/Gfx/RenderSettings.hpp"
+
+namespace ven {
+
+    ///
+    /// @class GpuProfiler
+    /// @brief Named GPU timestamp scopes and pipeline-statistics queries, one pair of query pools per frame slot
+    /// @namespace ven
+    ///
+    /// Scopes and statistics are registered on the recording thread in beginFrame, the commands writing them can then be
+    /// recorded from any thread, each one only touches its own queries. Results are read in collect once the frame slot
+    /// fence has been waited on, so reading never stalls: they lag the CPU by the number of frames in flight.
+    ///
+    class GpuProfiler {
+
+        public:
+
+            explicit GpuProfiler(const Device& device, uint32_t statisticsSlots);
+            ~GpuProfiler();
+
+            GpuProfiler(const GpuProfiler&) = delete;
+            GpuProfiler& operator=(const GpuProfiler&) = delete;
+            GpuProfiler(GpuProfiler&&) = delete;
+            GpuProfiler& operator=(GpuProfiler&&) = delete;
+
+            void beginFrame(uint32_t frameIndex, uint32_t statisticsCount);
+            /// @return Id of the scope, to pass to writeBegin / writeEnd
+            uint32_t addScope(uint32_t frameIndex, const char* name);
+            ///
+            /// @brief Reset the queries of the frame, must be recorded outside of a render pass before any other query command
+            ///
+            void reset(const VkCommandBuffer& commandBuffer, uint32_t frameIndex) const;
+            void writeBegin(const VkCommandBuffer& commandBuffer, uint32_t frameIndex, uint32_t scope) const;
+            void writeEnd(const VkCommandBuffer& commandBuffer, uint32_t frameIndex, uint32_t scope) const;
+            /// @brief Begin and end must be recorded in the same command buffer, results of all the slots are summed
+            void beginStatistics(const VkCommandBuffer& commandBuffer, uint32_t frameIndex, uint32_t slot) const;
+            void endStatistics(const VkCommandBuffer& commandBuffer, uint32_t frameIndex, uint32_t slot) const;
+            ///
+            /// @brief Read the results of frameIndex into stats, leave stats untouched if the frame never recorded queries
+            ///
+            void collect(uint32_t frameIndex, GpuStats& stats);
+
+            [[nodiscard]] bool isEnabled() const { return m_timestampPeriod > 0.0F; }
+
+        private:
+
+            static constexpr uint32_t STATISTICS_COUNT = 4;
+
+            struct Frame {
+                VkQueryPool timestamps = VK_NULL_HANDLE;
+                VkQueryPool statistics = VK_NULL_HANDLE;
+                std::array<const char*, GpuStats::MAX_SCOPES> names{};
+                uint32_t scopeCount = 0;
+                uint32_t statisticsCount = 0;
+                bool pending = false;
+            };
+
+            const Device& m_device;
+            uint32_t m_statisticsSlots;
+            float m_timestampPeriod = 0.0F; ///< ns per tick, 0 disables the profiler
+            std::array<Frame, SwapChain::MAX_FRAMES_IN_FLIGHT> m_frames{};
+            std::array<uint64_t, GpuStats::MAX_SCOPES * 2> m_timestampResults{};
+            std::vector<uint64_t> m_statisticsResults;
+
+    }; // class GpuProfiler
+
+} // namespace ven
@@ -10,50 +10,128 @@
 
 namespace ven {
 
+    ///
+    /// @enum RenderPassType
+    /// @brief Load / store behaviour of the scene render passes, all compatible with each other, the frame buffers and the pipelines
+    ///
+    enum class RenderPassType : uint8_t {
+        SINGLE, ///< clears the attachments and resolves into the scene image
+        EARLY, ///< clears and keeps the attachments, the depth is left readable by shaders for the depth pyramid
+        LATE, ///< continues an EARLY pass and resolves into the scene image
+        COUNT
+    };
+
     ///
     /// @class SwapChain
     /// @brief Class for swap chain
     /// @namespace ven
     ///
+    /// The scene render passes draw into the multisampled attachments and resolve into the scene image, all of them
+    /// the size of the swap chain: a scene rendered at a lower resolution only uses their top-left area, so changing
+    /// the render scale never reallocates them. The present render pass then writes the swap chain image, upscaling
+    /// the scene image and drawing the Gui on top at native resolution.
+    ///
+    /// On a headless device there is no VkSwapchainKHR, the "swap chain images" are offscreen images,
+    /// one per frame slot, left in VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL by the present render pass.
+    ///
     class SwapChain {
 
         public:
 
-            static constexpr uint8_t MAX_FRAMES_IN_FLIGHT = 2;
+            /// @brief Number of per-frame resources allocated, the count actually used is chosen at runtime (RenderSettings::framesInFlight)
+            static constexpr uint8_t MAX_FRAMES_IN_FLIGHT = 3;
+            static constexpr uint8_t DEFAULT_FRAMES_IN_FLIGHT = 2;
 
             SwapChain(const Device& device, const VkExtent2D& windowExtent) : m_device{device}, m_windowExtent{windowExtent} { init(); }
-            ~SwapChain() { cleanupSwapChain(); }
+            ~SwapChain() { cleanupSwapChain(); releaseRetired(true); }
 
             SwapChain(const SwapChain&) = delete;
             SwapChain& operator=(const SwapChain&) = delete;
             SwapChain(SwapChain&&) = delete;
             SwapChain& operator=(SwapChain&&) = delete;
 
-            void init() { createSwapChain(); createImageViews(); createColorResources(); createDepthResources(); createRenderPass(); createFrameBuffers(); createSyncObjects(); }
+            void init() { createSwapChain(VK_NULL_HANDLE); createImageViews(); createColorResources(); createDepthResources(); createRenderPasses(); createFrameBuffers(); createSyncObjects(); }
+            ///
+            /// @brief Rebuild the swap chain from the current one without waiting for the device
+            /// @return true if the surface format changed and the render passes were replaced, pipelines built against it must be rebuilt
+            ///
+            /// Sync objects are kept, the render passes and the MSAA / depth attachments are only replaced when their format or size changed.
+            /// Everything replaced is retired and destroyed by releaseRetired() once the frames that used it have completed.
+            ///
+            bool recreate(const VkExtent2D& windowExtent);
+            ///
+            /// @brief Destroy the retired resources no in-flight frame can reference anymore
+            /// @param all Destroy everything regardless of age, the device must be idle
+            ///
+            /// Called once per submitted frame.
+            ///
+            void releaseRetired(bool all = false);
+            ///
+            /// @brief Hand over an image made with createImage and its views, destroyed by releaseRetired like the attachments
+            ///
+            void retireImage(VkImage image, VkDeviceMemory imageMemory, std::vector<VkImageView> imageViews) { m_retired.push_back({ .images = {image}, .imageMemories = {imageMemory}, .attachmentViews = std::move(imageViews) }); }
             void createImageView(const VkImage& image, VkFormat format, VkImageAspectFlags aspectFlags, uint32_t mipLevels, VkImageView& imageView) const;
             void createImage(uint32_t width, uint32_t height, uint32_t mipLevels, VkSampleCountFlagBits numSamples, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImage& image, VkDeviceMemory& imageMemory) const;
             void cleanupSwapChain();
-            [[nodiscard]] static VkFormat findDepthFormat(const Device& device) { return findSupportedFormat(device, {VK_FORMAT_D32_SFLOAT, VK_FORMAT_D32_SFLOAT_S8_UINT, VK_FORMAT_D24_UNORM_S8_UINT}, VK_IMAGE_TILING_OPTIMAL, VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT); }
+            [[nodiscard]] static VkFormat findDepthFormat(const Device& device) { return findSupportedFormat(device, {VK_FORMAT_D32_SFLOAT, VK_FORMAT_D32_SFLOAT_S8_UINT, VK_FORMAT_D24_UNORM_S8_UINT}, VK_IMAGE_TILING_OPTIMAL, VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT); }
             [[nodiscard]] static bool hasStencilComponent(const VkFormat format) { return format == VK_FORMAT_D32_SFLOAT_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT; }
             [[nodiscard]] VkResult acquireNextImage(uint32_t& imageIndex, uint32_t currentFrame) const;
+            /// @brief Mode of the next recreation, a warning is logged if it is not supported, unlike the default MAILBOX
+            void setPresentMode(const VkPresentModeKHR presentMode) { m_requestedPresentMode = presentMode; m_presentModeExplicit = true; }
 
             [[nodiscard]] const VkSwapchainKHR& getSwapChain() const { return m_swapChain; }
+            [[nodiscard]] const std::vector<VkImage>& getImages() const { return m_images; }
             [[nodiscard]] VkFormat getFormat() const { return m_format; }
+            [[nodiscard]] VkPresentModeKHR getPresentMode() const { return m_presentMode; }
             [[nodiscard]] const VkExtent2D& getExtent() const { return m_extent; }
+            /// @brief Present render pass frame buffers, one per swap chain image
             [[nodiscard]] const std::vector<VkFramebuffer>& getSwapChainFrameBuffers() const { return m_swapChainFrameBuffers; }
-            [[nodiscard]] const VkRenderPass& getRenderPass() const { return m_renderPass; }
+            /// @brief Scene render pass frame buffer, shared by the frames in flight like its attachments
+            [[nodiscard]] const VkFramebuffer& getSceneFrameBuffer() const { return m_sceneFrameBuffer; }
+            [[nodiscard]] const VkRenderPass& getRenderPass(const RenderPassType type = RenderPassType::SINGLE) const { return m_renderPasses.at(static_cast<size_t>(type)); }
+            ///
+            /// @brief Single sample pass over the swap chain image, its contents are not loaded
+            ///
+            [[nodiscard]] const VkRenderPass& getPresentRenderPass() const { return m_presentRenderPass; }
+            ///
+            /// @brief Resolved scene color, left in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL by the SINGLE and LATE passes
+            ///
+            [[nodiscard]] const VkImageView& getSceneImageView() const { return m_sceneImageView; }
+            ///
+            /// @brief Depth attachment, multisampled like the color attachment, sampled by the depth pyramid
+            ///
+            [[nodiscard]] const VkImageView& getDepthImageView() const { return m_depthImageView; }
             [[nodiscard]] const std::vector<VkSemaphore>& getImageAvailableSemaphores() const { return m_imageAvailableSemaphores; }
             [[nodiscard]] const std::vector<VkSemaphore>& getRenderFinishedSemaphores() const { return m_renderFinishedSemaphores; }
             [[nodiscard]] const std::vector<VkFence>& getInFlightFences() const { return m_inFlightFences; }
 
         private:
 
-            void createSwapChain();
+            ///
+            /// @struct RetiredResources
+            /// @brief Handles replaced by a recreation, kept alive until the frames recorded with them are done
+            ///
+            struct RetiredResources {
+                VkSwapchainKHR swapChain = VK_NULL_HANDLE;
+                std::vector<VkImageView> imageViews;
+                std::vector<VkFramebuffer> frameBuffers;
+                std::vector<VkImage> images;
+                std::vector<VkDeviceMemory> imageMemories;
+                std::vector<VkImageView> attachmentViews;
+                std::array<VkRenderPass, static_cast<size_t>(RenderPassType::COUNT)> renderPasses{};
+                VkRenderPass presentRenderPass = VK_NULL_HANDLE;
+                uint8_t framesLeft = MAX_FRAMES_IN_FLIGHT + 1;
+            };
+
+            void createSwapChain(const VkSwapchainKHR& oldSwapChain);
+            void createOffscreenImages();
             void createImageViews();
             void createColorResources();
             void createDepthResources();
             void createFrameBuffers();
-            void createRenderPass();
+            void createRenderPasses();
+            void createRenderPass(RenderPassType type);
+            void createPresentRenderPass();
             void createSyncObjects();
 
             [[nodiscard]] static VkFormat findSupportedFormat(const Device& device, const std::vector<VkFormat>& candidates, VkImageTiling tiling, VkFormatFeatureFlags features);
@@ -61,22 +139,32 @@ namespace ven {
             const Device& m_device;
             VkSwapchainKHR m_swapChain = VK_NULL_HANDLE;
             std::vector<VkImage> m_images;
+            std::vector<VkDeviceMemory> m_offscreenImageMemories;
             std::vector<VkImageView> m_imageViews;
             VkFormat m_format = VK_FORMAT_UNDEFINED;
+            VkPresentModeKHR m_requestedPresentMode = VK_PRESENT_MODE_MAILBOX_KHR;
+            bool m_presentModeExplicit = false; ///< set by setPresentMode, the default silently falls back to FIFO
+            VkPresentModeKHR m_presentMode = VK_PRESENT_MODE_FIFO_KHR;
             VkExtent2D m_extent{};
             VkExtent2D m_windowExtent{};
             VkImage m_colorImage = VK_NULL_HANDLE;
             VkDeviceMemory m_colorImageMemory = VK_NULL_HANDLE;
             VkImageView m_colorImageView = VK_NULL_HANDLE;
+            VkImage m_sceneImage = VK_NULL_HANDLE;
+            VkDeviceMemory m_sceneImageMemory = VK_NULL_HANDLE;
+            VkImageView m_sceneImageView = VK_NULL_HANDLE;
             VkImage m_depthImage = VK_NULL_HANDLE;
             VkDeviceMemory m_depthImageMemory = VK_NULL_HANDLE;
             VkImageView m_depthImageView = VK_NULL_HANDLE;
             std::vector<VkFramebuffer> m_swapChainFrameBuffers;
-            VkRenderPass m_renderPass = VK_NULL_HANDLE;
+            VkFramebuffer m_sceneFrameBuffer = VK_NULL_HANDLE;
+            std::array<VkRenderPass, static_cast<size_t>(RenderPassType::COUNT)> m_renderPasses{};
+            VkRenderPass m_presentRenderPass = VK_NULL_HANDLE;
 
             std::vector<VkSemaphore> m_imageAvailableSemaphores;
             std::vector<VkSemaphore> m_renderFinishedSemaphores;
             std::vector<VkFence> m_inFlightFences;
+            std::vector<RetiredResources> m_retired;
 
     }; // class SwapChain
 
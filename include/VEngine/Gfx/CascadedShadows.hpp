@@ -0,0 +1,128 @@
+///
+/// @file CascadedShadows.hpp
+/// @brief This file contains the CascadedShadows class
+/// @namespace ven
+///
+
+#pragma once
+
+#include <span>
+
+#include <glm/glm.hpp>
+
+#include "VEngine/Gfx/Backend/Descriptors/Allocator.hpp"
+#include "VEngine/Gfx/Backend/Descriptors/LayoutCache.hpp"
+#include "VEngine/Gfx/Backend/SwapChain.hpp"
+#include "VEngine/Gfx/RenderQueue.hpp"
+#include "VEngine/Gfx/RenderSettings.hpp"
+#include "VEngine/Scene/Bounds.hpp"
+
+namespace ven {
+
+    ///
+    /// @struct ShadowView
+    /// @brief Camera data the cascades are fitted to
+    ///
+    struct ShadowView {
+        glm::mat4 view;
+        float fov; ///< vertical, radians
+        float aspect;
+        float near;
+        float far;
+    };
+
+    ///
+    /// @class CascadedShadows
+    /// @brief Directional sun shadows, one depth layer per slice of the view frustum
+    /// @namespace ven
+    ///
+    /// The shadow distance is split between the practical and the logarithmic distributions by
+    /// RenderSettings::cascadeSplitLambda. Each cascade is an orthographic projection along the sun fitted to the bounding
+    /// sphere of its slice: its size does not change when the camera turns, and its origin is snapped to whole texels in
+    /// light space, so the shadow edges do not shimmer. Its depth range reaches back to the scene bounds so every caster
+    /// between the sun and the slice is drawn.
+    ///
+    /// The casters are the static scene. A cascade is redrawn only when its snapped projection changed, the sun moved or
+    /// the hierarchy changed a transform; otherwise its layer is reused as is. Far cascades have large texels and stay
+    /// cached while the camera moves, near ones follow it. Layers are shared by the frames in flight, the render pass
+    /// dependencies order a redraw after the reads of the previous frames.
+    ///
+    class CascadedShadows {
+
+        public:
+
+            static constexpr uint32_t CASCADE_COUNT = ShadowStats::CASCADE_COUNT;
+            static constexpr uint32_t RESOLUTION = 2048;
+            static constexpr std::array<const char*, CASCADE_COUNT> SCOPE_NAMES{"Shadow cascade 0", "Shadow cascade 1", "Shadow cascade 2", "Shadow cascade 3"};
+
+            ///
+            /// @param objectBuffers Per frame slot, read by the shadow vertex shader
+            /// @param objectCount Objects of the scene, every cascade reserves an instance for each
+            ///
+            explicit CascadedShadows(const Device& device, const Shaders& shaders, DescriptorLayoutCache& layoutCache, DescriptorAllocator& descriptorAllocator, const std::vector<VkBuffer>& objectBuffers, VkDeviceSize objectBufferSize, uint32_t objectCount);
+            ~CascadedShadows();
+
+            CascadedShadows(const CascadedShadows&) = delete;
+            CascadedShadows& operator=(const CascadedShadows&) = delete;
+            CascadedShadows(CascadedShadows&&) = delete;
+            CascadedShadows& operator=(CascadedShadows&&) = delete;
+
+            ///
+            /// @brief Fit the cascades to the camera and decide which ones are redrawn this frame
+            /// @param sceneBounds Box of every caster, only its min and max corners are read
+            /// @param castersChanged A transform of the scene changed since the last call
+            ///
+            void update(const ShadowView& view, const RenderSettings& settings, const glm::vec3& sunDirection, const Bounds& sceneBounds, bool castersChanged, ShadowStats& stats);
+            /// @brief Forget every cached layer, they are redrawn the next time shadows are on
+            void invalidate() { m_valid.fill(false); }
+            ///
+            /// @brief Record the depth render of a cascade, outside of any render pass
+            /// @param viewProjection Of the cascade when the frame was updated, the next update may already have moved it
+            /// @param draws Instanced draws whose firstInstance is relative to getInstances(frameIndex, cascade)
+            ///
+            void record(const VkCommandBuffer& commandBuffer, uint32_t frameIndex, uint32_t cascade, const glm::mat4& viewProjection, const VkBuffer& indexBuffer, const VkBuffer& vertexBuffer, std::span<const DrawCommand> draws) const;
+
+            [[nodiscard]] bool isRedrawn(const uint32_t cascade) const { return m_redraw.at(cascade); }
+            [[nodiscard]] const std::array<glm::mat4, CASCADE_COUNT>& getViewProjections() const { return m_viewProjections; }
+            /// @brief Far view depth of every cascade
+            [[nodiscard]] const glm::vec4& getSplits() const { return m_splits; }
+            /// @brief Mapped instance buffer of a cascade in the frame slot, objectCount object indices
+            [[nodiscard]] uint32_t* getInstances(const uint32_t frameIndex, const uint32_t cascade) const { return static_cast<uint32_t*>(m_instancesMapped.at(frameIndex)) + (static_cast<size_t>(cascade) * m_objectCount); }
+            [[nodiscard]] VkDescriptorImageInfo getDescriptorInfo() const { return { .sampler = m_sampler, .imageView = m_arrayView, .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL }; }
+
+        private:
+
+            struct ShadowConstants {
+                glm::mat4 viewProjection;
+                uint32_t firstInstance; ///< of the cascade in the instance buffer
+            };
+
+            void createImage();
+            void createRenderPass();
+            void createDescriptors(DescriptorLayoutCache& layoutCache, DescriptorAllocator& descriptorAllocator, const std::vector<VkBuffer>& objectBuffers, VkDeviceSize objectBufferSize);
+
+            const Device& m_device;
+            uint32_t m_objectCount;
+            VkFormat m_format = VK_FORMAT_UNDEFINED;
+            VkImage m_image = VK_NULL_HANDLE;
+            VkDeviceMemory m_imageMemory = VK_NULL_HANDLE;
+            VkImageView m_arrayView = VK_NULL_HANDLE;
+            std::array<VkImageView, CASCADE_COUNT> m_layerViews{};
+            std::array<VkFramebuffer, CASCADE_COUNT> m_frameBuffers{};
+            VkSampler m_sampler = VK_NULL_HANDLE; ///< depth comparison, the border is lit
+            VkRenderPass m_renderPass = VK_NULL_HANDLE;
+            std::array<VkBuffer, SwapChain::MAX_FRAMES_IN_FLIGHT> m_instanceBuffers{};
+            std::array<VkDeviceMemory, SwapChain::MAX_FRAMES_IN_FLIGHT> m_instanceMemories{};
+            std::array<void*, SwapChain::MAX_FRAMES_IN_FLIGHT> m_instancesMapped{};
+            VkDescriptorSetLayout m_descriptorSetLayout = VK_NULL_HANDLE; ///< owned by the layout cache
+            std::array<VkDescriptorSet, SwapChain::MAX_FRAMES_IN_FLIGHT> m_descriptorSets{};
+            VkPipelineLayout m_pipelineLayout = VK_NULL_HANDLE;
+            VkPipeline m_pipeline = VK_NULL_HANDLE;
+            std::array<glm::mat4, CASCADE_COUNT> m_viewProjections{};
+            glm::vec4 m_splits{0.0F};
+            std::array<bool, CASCADE_COUNT> m_valid{}; ///< the layer holds the depth of m_viewProjections
+            std::array<bool, CASCADE_COUNT> m_redraw{};
+
+    }; // class CascadedShadows
+
+} // namespace ven
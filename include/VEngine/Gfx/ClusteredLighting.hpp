@@ -0,0 +1,104 @@
+///
+/// @file ClusteredLighting.hpp
+/// @brief This file contains the ClusteredLighting class
+/// @namespace ven
+///
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "VEngine/Gfx/Backend/Descriptors/Allocator.hpp"
+#include "VEngine/Gfx/Backend/Descriptors/LayoutCache.hpp"
+#include "VEngine/Gfx/Backend/SwapChain.hpp"
+#include "VEngine/Gfx/Shaders.hpp"
+
+namespace ven {
+
+    ///
+    /// @struct GpuLight
+    /// @brief Entry of the light storage buffer, world space, std430 layout
+    ///
+    struct GpuLight {
+        glm::vec4 positionRange{0.0F};
+        glm::vec4 colorIntensity{0.0F};
+        glm::vec4 directionType{0.0F}; ///< spot axis, w is the LightType
+        glm::vec4 cone{0.0F}; ///< cosines of the inner and outer spot angles, zw unused
+    };
+
+    ///
+    /// @class ClusteredLighting
+    /// @brief Compute pass binning the lights into a froxel grid, the fragment shader then only walks the list of its cluster
+    /// @namespace ven
+    ///
+    /// The view frustum is cut in TILES_X x TILES_Y screen tiles and SLICES depth slices, exponentially spaced between
+    /// the camera near and far planes so the clusters stay roughly cubic. One thread per cluster builds its view-space
+    /// box and tests it against the bounding sphere of every light, the lights being loaded in workgroup-sized batches
+    /// into shared memory. A cluster keeps at most MAX_LIGHTS_PER_CLUSTER lights. The cluster buffer holds the count of
+    /// every cluster followed by the fixed-size light lists, one buffer per frame slot.
+    ///
+    class ClusteredLighting {
+
+        public:
+
+            static constexpr uint32_t TILES_X = 16;
+            static constexpr uint32_t TILES_Y = 9;
+            static constexpr uint32_t SLICES = 24;
+            static constexpr uint32_t CLUSTER_COUNT = TILES_X * TILES_Y * SLICES;
+            static constexpr uint32_t MAX_LIGHTS = 4096;
+            static constexpr uint32_t MAX_LIGHTS_PER_CLUSTER = 256;
+            static constexpr VkDeviceSize LIGHT_BUFFER_SIZE = sizeof(GpuLight) * MAX_LIGHTS;
+            static constexpr VkDeviceSize CLUSTER_BUFFER_SIZE = sizeof(uint32_t) * CLUSTER_COUNT * (1 + MAX_LIGHTS_PER_CLUSTER);
+
+            ///
+            /// @struct Buffers
+            /// @brief Per frame slot buffers shared with the scene descriptor sets
+            ///
+            struct Buffers {
+                const std::vector<VkBuffer>& uniformBuffers;
+                VkDeviceSize uniformBufferSize;
+                const std::vector<VkBuffer>& lightBuffers; ///< LIGHT_BUFFER_SIZE each
+                const std::vector<VkBuffer>& clusterBuffers; ///< CLUSTER_BUFFER_SIZE each
+            };
+
+            explicit ClusteredLighting(const Device& device, const Shaders& shaders, DescriptorLayoutCache& layoutCache, DescriptorAllocator& descriptorAllocator, const Buffers& buffers);
+            ~ClusteredLighting();
+
+            ClusteredLighting(const ClusteredLighting&) = delete;
+            ClusteredLighting& operator=(const ClusteredLighting&) = delete;
+            ClusteredLighting(ClusteredLighting&&) = delete;
+            ClusteredLighting& operator=(ClusteredLighting&&) = delete;
+
+            ///
+            /// @brief Scale and bias turning a fragment position and view depth into its cluster, see UniformBufferObject
+            /// @return x, y: tiles per pixel, z, w: slice = log(depth) * z + w
+            ///
+            [[nodiscard]] static glm::vec4 getClusterScale(VkExtent2D extent, float near, float far);
+            ///
+            /// @brief Record the binning of the first lightCount lights of the slot, outside of any render pass
+            ///
+            void record(const VkCommandBuffer& commandBuffer, uint32_t frameIndex, uint32_t lightCount, float near, float far) const;
+
+        private:
+
+            static constexpr uint32_t WORKGROUP_SIZE = 64;
+            static constexpr uint32_t BINDING_COUNT = 3;
+
+            struct ClusterConstants {
+                uint32_t lightCount;
+                float near;
+                float far;
+            };
+
+            void createDescriptors(DescriptorLayoutCache& layoutCache, DescriptorAllocator& descriptorAllocator, const Buffers& buffers);
+
+            const Device& m_device;
+            std::array<VkBuffer, SwapChain::MAX_FRAMES_IN_FLIGHT> m_clusterBuffers{};
+            VkDescriptorSetLayout m_descriptorSetLayout = VK_NULL_HANDLE; ///< owned by the layout cache
+            std::array<VkDescriptorSet, SwapChain::MAX_FRAMES_IN_FLIGHT> m_descriptorSets{};
+            VkPipelineLayout m_pipelineLayout = VK_NULL_HANDLE;
+            VkPipeline m_pipeline = VK_NULL_HANDLE;
+
+    }; // class ClusteredLighting
+
+} // namespace ven
@@ -0,0 +1,96 @@
+///
+/// @file DepthPyramid.hpp
+/// @brief This file contains the DepthPyramid class
+/// @namespace ven
+///
+
+#pragma once
+
+#include "VEngine/Gfx/Backend/Descriptors/Allocator.hpp"
+#include "VEngine/Gfx/Backend/Descriptors/LayoutCache.hpp"
+#include "VEngine/Gfx/Backend/SwapChain.hpp"
+#include "VEngine/Gfx/Shaders.hpp"
+
+namespace ven {
+
+    ///
+    /// @class DepthPyramid
+    /// @brief Hierarchical depth buffer built from the depth attachment, read by the occlusion culling
+    /// @namespace ven
+    ///
+    /// Level 0 is the largest power of two not above the attachment size, every texel holds the farthest depth of the
+    /// attachment texels (and samples, the multisampled depth is resolved by the first reduction) it covers, every next
+    /// level the farthest of the 2x2 texels below it. A box whose nearest depth is behind the pyramid texels covering its
+    /// screen rectangle is hidden. The image stays in VK_IMAGE_LAYOUT_GENERAL, written as storage and read as sampled.
+    /// The frames in flight share the image, the descriptor sets of the reductions are allocated per frame slot.
+    ///
+    class DepthPyramid {
+
+        public:
+
+            static constexpr uint32_t MAX_LEVELS = 16;
+
+            explicit DepthPyramid(const Device& device, const Shaders& shaders, const SwapChain& swapChain, DescriptorLayoutCache& layoutCache, DescriptorAllocator& descriptorAllocator);
+            ~DepthPyramid();
+
+            DepthPyramid(const DepthPyramid&) = delete;
+            DepthPyramid& operator=(const DepthPyramid&) = delete;
+            DepthPyramid(DepthPyramid&&) = delete;
+            DepthPyramid& operator=(DepthPyramid&&) = delete;
+
+            ///
+            /// @brief Rebuild the pyramid for the current depth attachment of the swap chain, without waiting for the device
+            ///
+            /// The old image is retired to the swap chain, the frames in flight that read it finish with it.
+            ///
+            void resize(SwapChain& swapChain);
+            ///
+            /// @brief Record the reductions, after the render pass that wrote the depth and outside of any render pass
+            /// @param renderExtent Top-left area of the attachment the scene was rendered into, stretched over the whole pyramid
+            ///
+            /// The pyramid then maps the viewport like the attachment does at full resolution, the culling shader reads
+            /// it the same way whatever the render scale.
+            ///
+            void record(const VkCommandBuffer& commandBuffer, uint32_t frameIndex, VkExtent2D renderExtent);
+
+            [[nodiscard]] const VkImageView& getImageView() const { return m_imageView; }
+            [[nodiscard]] const VkSampler& getSampler() const { return m_sampler; }
+            [[nodiscard]] uint32_t getWidth() const { return m_width; }
+            [[nodiscard]] uint32_t getHeight() const { return m_height; }
+            [[nodiscard]] uint32_t getLevelCount() const { return m_levelCount; }
+
+        private:
+
+            static constexpr uint32_t WORKGROUP_SIZE = 8;
+
+            struct ReduceConstants {
+                int32_t sourceWidth;
+                int32_t sourceHeight;
+                int32_t destinationWidth;
+                int32_t destinationHeight;
+            };
+
+            void create(const SwapChain& swapChain);
+
+            const Device& m_device;
+            DescriptorAllocator& m_descriptorAllocator;
+            bool m_multisampled;
+            bool m_initialized = false; ///< the image left VK_IMAGE_LAYOUT_UNDEFINED, set by the first record after create
+            uint32_t m_width = 0;
+            uint32_t m_height = 0;
+            uint32_t m_levelCount = 0;
+            VkExtent2D m_depthExtent{};
+            VkImageView m_depthView = VK_NULL_HANDLE; ///< of the swap chain the pyramid was created for
+            VkImage m_image = VK_NULL_HANDLE;
+            VkDeviceMemory m_imageMemory = VK_NULL_HANDLE;
+            VkImageView m_imageView = VK_NULL_HANDLE;
+            std::array<VkImageView, MAX_LEVELS> m_levelViews{};
+            VkSampler m_sampler = VK_NULL_HANDLE;
+            VkDescriptorSetLayout m_descriptorSetLayout = VK_NULL_HANDLE; ///< owned by the layout cache
+            VkPipelineLayout m_pipelineLayout = VK_NULL_HANDLE;
+            VkPipeline m_reducePipeline = VK_NULL_HANDLE;
+            VkPipeline m_depthPipeline = VK_NULL_HANDLE; ///< first level, reads the depth attachment
+
+    }; // class DepthPyramid
+
+} // namespace ven
@@ -0,0 +1,42 @@
+///
+/// @file FrameSnapshot.hpp
+/// @brief This file contains the FrameSnapshot struct
+/// @namespace ven
+///
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "VEngine/Gfx/RenderQueue.hpp"
+#include "VEngine/Gfx/RenderSettings.hpp"
+#include "VEngine/Gui/Gui.hpp"
+
+namespace ven {
+
+    ///
+    /// @struct FrameSnapshot
+    /// @brief Everything the render thread reads to record a frame, filled by the update thread
+    ///
+    /// The mapped buffers of the frame slot are written by the update thread as well, the snapshot holds what the
+    /// Renderer would otherwise read from members the next update overwrites. It is not touched once handed over.
+    ///
+    struct FrameSnapshot {
+        uint32_t frameIndex = 0; ///< slot whose fence the update thread waited on
+        uint64_t frame = 0; ///< number of the frame in Engine::run, its GPU results are joined to it
+        RenderSettings settings; ///< once the Gui of the frame edited them
+        std::array<VkClearValue, 2> clearValues{};
+        VkExtent2D renderExtent{}; ///< top-left area of the scene targets the frame is rendered into
+        float renderScale = 1.0F;
+        float near = 0.0F; ///< of the camera, for the light clusters
+        float far = 0.0F;
+        uint32_t lightCount = 0;
+        std::vector<DrawCommand> draws; ///< visible draws in RenderQueue order, empty when the GPU culls
+        bool shadowsDrawn = false;
+        std::array<bool, ShadowStats::CASCADE_COUNT> shadowRedrawn{}; ///< cascades drawn this frame, the others are cached
+        std::array<glm::mat4, ShadowStats::CASCADE_COUNT> shadowViewProjections{};
+        std::array<std::vector<DrawCommand>, ShadowStats::CASCADE_COUNT> shadowDraws;
+        GuiFrame gui; ///< empty when headless
+    };
+
+} // namespace ven
@@ -0,0 +1,160 @@
+///
+/// @file GpuCulling.hpp
+/// @brief This file contains the GpuCulling class
+/// @namespace ven
+///
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "VEngine/Gfx/Backend/Descriptors/Allocator.hpp"
+#include "VEngine/Gfx/Backend/Descriptors/LayoutCache.hpp"
+#include "VEngine/Gfx/DepthPyramid.hpp"
+#include "VEngine/Gfx/RenderSettings.hpp"
+
+namespace ven {
+
+    ///
+    /// @struct DrawData
+    /// @brief Static description of one instanced draw read by the culling shader, std430 layout
+    ///
+    struct DrawData {
+        uint32_t indexCount = 0;
+        uint32_t firstIndex = 0;
+        int32_t vertexOffset = 0;
+        uint32_t instanceOffset = 0; ///< first instance of the draw in each half of the instance buffer, objectCount entries are reserved
+        glm::vec4 centerRadius{0.0F}; ///< object-space bounds center and sphere radius
+        glm::vec4 extent{0.0F}; ///< object-space box half size, w unused
+    };
+
+    ///
+    /// @enum CullingPhase
+    /// @brief Dispatch of the culling shader, SINGLE without occlusion culling, EARLY then LATE with it
+    ///
+    enum class CullingPhase : uint32_t {
+        SINGLE, ///< frustum only, every visible object
+        EARLY, ///< frustum only, the objects visible last frame
+        LATE ///< frustum and depth pyramid, the objects not drawn by EARLY that turned visible, updates the visible set
+    };
+
+    ///
+    /// @class GpuCulling
+    /// @brief Compute pre-pass culling every object and writing the instanced indirect draws of the visible ones
+    /// @namespace ven
+    ///
+    /// One thread per object reads the frustum planes from the camera uniform buffer and its world matrix from the
+    /// object buffer of the frame slot. A visible object takes the next instance of the indirect draw of its mesh and
+    /// writes its index in the instance buffer read by the vertex shader. The indirect draws start every frame from a
+    /// template with no instance, the scene is drawn with one vkCmdDrawIndexedIndirect per range of meshes sharing a
+    /// pipeline. Each frame slot owns its command and count buffers, the counts are host visible so they can be read
+    /// once the slot fence signaled.
+    ///
+    /// With occlusion culling the frame is drawn in two phases: EARLY draws what was visible last frame, the depth
+    /// pyramid is built from that depth, then LATE tests every object against the pyramid, draws the newly visible ones
+    /// and stores the visible set for the next frame. Objects that come into view appear the same frame, no popping.
+    ///
+    class GpuCulling {
+
+        public:
+
+            ///
+            /// @struct Buffers
+            /// @brief Per frame slot buffers shared with the scene descriptor sets
+            ///
+            struct Buffers {
+                const std::vector<VkBuffer>& uniformBuffers;
+                VkDeviceSize uniformBufferSize;
+                const std::vector<VkBuffer>& objectBuffers;
+                VkDeviceSize objectBufferSize;
+                const std::vector<VkBuffer>& instanceBuffers;
+                VkDeviceSize instanceBufferSize;
+            };
+
+            ///
+            /// @param objectGroups Index in draws of the mesh of every object
+            ///
+            explicit GpuCulling(const Device& device, const Shaders& shaders, DescriptorLayoutCache& layoutCache, DescriptorAllocator& descriptorAllocator, const std::vector<DrawData>& draws,
+                                const std::vector<uint32_t>& objectGroups, const Buffers& buffers, const DepthPyramid& depthPyramid);
+            ~GpuCulling();
+
+            GpuCulling(const GpuCulling&) = delete;
+            GpuCulling& operator=(const GpuCulling&) = delete;
+            GpuCulling(GpuCulling&&) = delete;
+            GpuCulling& operator=(GpuCulling&&) = delete;
+
+            ///
+            /// @brief Point the LATE phase at the pyramid, again after every DepthPyramid::resize, while nothing is recorded
+            ///
+            /// The set of each slot is written by its next record, the frames in flight keep reading the old pyramid.
+            ///
+            ///
+            void setDepthPyramid(const DepthPyramid& depthPyramid);
+            ///
+            /// @brief Record the culling dispatch of a phase, outside of any render pass and before its draw
+            ///
+            /// SINGLE and EARLY reset the commands and counts of the slot, LATE must follow EARLY and DepthPyramid::record.
+            ///
+            void record(const VkCommandBuffer& commandBuffer, uint32_t frameIndex, CullingPhase phase);
+            ///
+            /// @brief Record the indirect draws of what a phase kept for the meshes [firstDraw, firstDraw + drawCount),
+            /// the scene pipeline and buffers must be bound
+            ///
+            void draw(const VkCommandBuffer& commandBuffer, uint32_t frameIndex, CullingPhase phase, uint32_t firstDraw, uint32_t drawCount) const;
+            ///
+            /// @brief Read the draw, instance, triangle and occluded counts of frameIndex, its fence must have been waited on
+            ///
+            void readCounts(uint32_t frameIndex, RenderStats& stats) const;
+
+        private:
+
+            static constexpr uint32_t WORKGROUP_SIZE = 64;
+
+            struct Counts {
+                uint32_t drawCount; ///< draws with at least one instance
+                uint32_t instanceCount;
+                uint32_t triangleCount;
+                uint32_t occludedCount;
+            };
+
+            struct CullConstants {
+                uint32_t objectCount;
+                uint32_t drawCount;
+                CullingPhase phase;
+                uint32_t pyramidWidth;
+                uint32_t pyramidHeight;
+                uint32_t pyramidLevels;
+            };
+
+            void createDescriptors(DescriptorLayoutCache& layoutCache, DescriptorAllocator& descriptorAllocator, const Buffers& buffers);
+
+            const Device& m_device;
+            uint32_t m_drawCount;
+            uint32_t m_objectCount;
+            VkBuffer m_drawBuffer = VK_NULL_HANDLE;
+            VkDeviceMemory m_drawBufferMemory = VK_NULL_HANDLE;
+            VkBuffer m_objectGroupBuffer = VK_NULL_HANDLE;
+            VkDeviceMemory m_objectGroupMemory = VK_NULL_HANDLE;
+            VkBuffer m_templateBuffer = VK_NULL_HANDLE; ///< the commands of both phases without instances, copied at the start of every frame
+            VkDeviceMemory m_templateMemory = VK_NULL_HANDLE;
+            VkBuffer m_visibilityBuffer = VK_NULL_HANDLE; ///< one uint per object, set when LATE found it visible
+            VkDeviceMemory m_visibilityMemory = VK_NULL_HANDLE;
+            uint32_t m_pyramidWidth = 0;
+            uint32_t m_pyramidHeight = 0;
+            uint32_t m_pyramidLevels = 0;
+            VkDescriptorImageInfo m_pyramidInfo{};
+            std::array<bool, SwapChain::MAX_FRAMES_IN_FLIGHT> m_pyramidOutdated{}; ///< the set of the slot does not point at m_pyramidInfo yet
+            std::array<VkBuffer, SwapChain::MAX_FRAMES_IN_FLIGHT> m_commandBuffers{}; ///< EARLY commands then LATE commands, drawCount each
+            std::array<VkDeviceMemory, SwapChain::MAX_FRAMES_IN_FLIGHT> m_commandMemories{};
+            std::array<VkBuffer, SwapChain::MAX_FRAMES_IN_FLIGHT> m_countBuffers{};
+            std::array<VkDeviceMemory, SwapChain::MAX_FRAMES_IN_FLIGHT> m_countMemories{};
+            std::array<void*, SwapChain::MAX_FRAMES_IN_FLIGHT> m_countsMapped{};
+            std::array<VkBuffer, SwapChain::MAX_FRAMES_IN_FLIGHT> m_instanceBuffers{};
+            VkDescriptorSetLayout m_descriptorSetLayout = VK_NULL_HANDLE; ///< owned by the layout cache
+            std::array<VkDescriptorSet, SwapChain::MAX_FRAMES_IN_FLIGHT> m_descriptorSets{};
+            VkPipelineLayout m_pipelineLayout = VK_NULL_HANDLE;
+            VkPipeline m_pipeline = VK_NULL_HANDLE;
+
+    }; // class GpuCulling
+
+} // namespace ven
@@ -0,0 +1,83 @@
+///
+/// @file RenderQueue.hpp
+/// @brief This file contains the RenderQueue class
+/// @namespace ven
+///
+
+#pragma once
+
+#include <vector>
+
+#include "VEngine/Gfx/Resources/Mesh.hpp"
+#include "VEngine/Gfx/Shaders.hpp"
+
+namespace ven {
+
+    ///
+    /// @struct DrawCommand
+    /// @brief Instanced draw of the visible objects of a DrawGroup
+    ///
+    struct DrawCommand {
+        uint32_t indexCount = 0;
+        uint32_t firstIndex = 0;
+        int32_t vertexOffset = 0;
+        uint32_t firstInstance = 0; ///< first entry of the instance buffer read by the draw, each one is an ObjectData index
+        uint32_t instanceCount = 0;
+        PipelineType pipeline = PipelineType::SOLID; ///< bound before the draw when it differs from the previous one
+    };
+
+    ///
+    /// @enum RenderBucket
+    /// @brief Pass of a draw, the most significant bits of its sort key, so buckets are drawn in this order
+    ///
+    enum class RenderBucket : uint8_t {
+        DEPTH_PREPASS, ///< depth only copies of the solid and masked draws, front to back
+        SOLID, ///< front to back
+        MASKED, ///< front to back, after the solid draws so their depth rejects most of the discarding fragments
+        BLENDED ///< back to front, one draw per object
+    };
+
+    ///
+    /// @class RenderQueue
+    /// @brief Draws of a frame ordered by a 64-bit sort key
+    /// @namespace ven
+    ///
+    /// Key, from the most significant bit: bucket (2), pipeline (3), depth (24), material (32), 3 bits unused. The depth
+    /// is the distance to the camera, inverted for BLENDED so it is drawn back to front. It is placed before the
+    /// material: textures are indexed from one descriptor array, switching material binds nothing, while front to back
+    /// order is what lets early depth testing reject the hidden fragments.
+    ///
+    class RenderQueue {
+
+        public:
+
+            static constexpr uint32_t DEPTH_BITS = 24;
+
+            ///
+            /// @param depth Non-negative distance to the camera, any monotonic measure such as its square
+            ///
+            [[nodiscard]] static uint64_t makeKey(RenderBucket bucket, PipelineType pipeline, uint32_t material, float depth);
+            [[nodiscard]] static RenderBucket getBucket(const AlphaMode alphaMode) { return static_cast<RenderBucket>(static_cast<uint8_t>(alphaMode) + 1); }
+            [[nodiscard]] static PipelineType getPipeline(RenderBucket bucket, AlphaMode alphaMode);
+
+            void clear() { m_items.clear(); m_draws.clear(); }
+            void push(RenderBucket bucket, uint32_t material, float depth, DrawCommand draw);
+            ///
+            /// @brief Sort the pushed draws by key, valid until the next clear
+            ///
+            [[nodiscard]] const std::vector<DrawCommand>& sort();
+
+        private:
+
+            struct Item {
+                uint64_t key;
+                uint32_t draw; ///< index in m_draws
+            };
+
+            std::vector<Item> m_items;
+            std::vector<DrawCommand> m_draws;
+            std::vector<DrawCommand> m_sorted;
+
+    }; // class RenderQueue
+
+} // namespace ven
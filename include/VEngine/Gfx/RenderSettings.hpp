@@ -0,0 +1,145 @@
+///
+/// @file RenderSettings.hpp
+/// @brief This file contains the renderer settings and statistics structs
+/// @namespace ven
+///
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <vulkan/vulkan_core.h>
+
+namespace ven {
+
+    enum class CullingMode : uint8_t {
+        NONE,
+        CPU, ///< Frustum tested four draws at a time on the recording thread
+        GPU ///< compute pre-pass writing the indirect draws, needs Device::hasDrawIndirectCount
+    };
+
+    enum class UpscaleFilter : uint8_t {
+        BILINEAR,
+        SHARPEN ///< bilinear then a contrast-limited unsharp mask, restores some of the detail lost by the lower resolution
+    };
+
+    ///
+    /// @struct RenderSettings
+    /// @brief Renderer options editable at runtime from the Gui
+    ///
+    struct RenderSettings {
+        static constexpr float MIN_RENDER_SCALE = 0.25F; ///< lowest render scale, the scene targets are allocated for 1
+
+        uint32_t recordThreads = 1;
+        uint32_t framesInFlight = 2;
+        VkPresentModeKHR presentMode = VK_PRESENT_MODE_MAILBOX_KHR;
+        float maxFps = 0.0F; ///< 0 = unlimited
+        CullingMode culling = CullingMode::CPU;
+        bool occlusionCulling = true; ///< GPU culling only, two-phase test against the depth pyramid
+        bool depthPrepass = false; ///< draw the depth of the solid and masked meshes first, each pixel is then shaded once
+        bool showLightClusters = false; ///< tint every pixel by the light count of its cluster
+        bool shadows = true; ///< sun shadows from CascadedShadows
+        bool cacheShadows = true; ///< redraw a cascade only when its projection, the sun or the casters changed
+        float shadowDistance = 60.0F; ///< view depth covered by the cascades, clamped to the camera far plane
+        float cascadeSplitLambda = 0.75F; ///< 0 splits the shadow distance evenly, 1 logarithmically
+        float sunAzimuth = 30.0F; ///< degrees around the Y axis
+        float sunElevation = 50.0F; ///< degrees above the horizon
+        float sunIntensity = 1.0F;
+        bool dynamicResolution = true; ///< adjust the render scale to keep the GPU frame time under targetFrameTime
+        float targetFrameTime = 16.6F; ///< ms
+        float minRenderScale = 0.5F; ///< lowest scale the controller goes down to
+        float renderScale = 1.0F; ///< fraction of the swap chain width and height the scene is rendered at without dynamic resolution
+        UpscaleFilter upscaleFilter = UpscaleFilter::SHARPEN;
+        float sharpness = 0.5F; ///< 0 to 1, UpscaleFilter::SHARPEN only
+    };
+
+    ///
+    /// @struct ShadowStats
+    /// @brief Cascade cache and render time, filled by the Renderer
+    ///
+    struct ShadowStats {
+        static constexpr uint32_t CASCADE_COUNT = 4;
+
+        std::array<float, CASCADE_COUNT> renderTimes{}; ///< ms of the last GPU render of each cascade
+        std::array<uint32_t, CASCADE_COUNT> casterCounts{}; ///< objects drawn by the last render of each cascade
+        std::array<bool, CASCADE_COUNT> cached{}; ///< reused by the last frame instead of being redrawn
+        uint64_t cacheHits = 0;
+        uint64_t cacheMisses = 0;
+
+        [[nodiscard]] float hitRate() const { return cacheHits + cacheMisses == 0 ? 0.0F : static_cast<float>(cacheHits) / static_cast<float>(cacheHits + cacheMisses); }
+    };
+
+    ///
+    /// @struct FrameTimings
+    /// @brief CPU time (ms) spent in each phase of the last frame, update thread then render thread phases
+    ///
+    struct FrameTimings {
+        float limiterWait = 0.0F;
+        float input = 0.0F; ///< window events, simulation steps, replay or benchmark camera
+        float fenceWait = 0.0F; ///< the update thread blocked on the GPU
+        float acquire = 0.0F; ///< the render thread waiting for a swap chain image, the display / vsync wait
+        float update = 0.0F;
+        float record = 0.0F;
+        float submit = 0.0F;
+        float present = 0.0F;
+        float renderWait = 0.0F; ///< the update thread waiting for the render thread to take the frame
+
+        [[nodiscard]] float gpuWait() const { return fenceWait; }
+        [[nodiscard]] float displayWait() const { return acquire; }
+        [[nodiscard]] float cpuTime() const { return std::max(input + update, record + submit + present); }
+        /// @brief Wall time of the frame on the update thread
+        [[nodiscard]] float total() const { return limiterWait + input + fenceWait + update + renderWait; }
+    };
+
+    ///
+    /// @struct GpuStats
+    /// @brief GPU timing breakdown and pipeline statistics of the last completed frame, filled by GpuProfiler
+    ///
+    struct GpuStats {
+        static constexpr uint32_t MAX_SCOPES = 16;
+
+        struct Scope {
+            const char* name = nullptr;
+            float time = 0.0F; ///< ms
+        };
+
+        std::array<Scope, MAX_SCOPES> scopes{};
+        uint32_t scopeCount = 0;
+        bool pipelineStatistics = false; ///< false when the device has no pipelineStatisticsQuery support
+        uint64_t inputPrimitives = 0;
+        uint64_t vertexInvocations = 0;
+        uint64_t clippingPrimitives = 0;
+        uint64_t fragmentInvocations = 0;
+    };
+
+    ///
+    /// @struct RenderStats
+    /// @brief Per-frame renderer statistics shown in the Gui
+    ///
+    struct RenderStats {
+        float recordTime = 0.0F;
+        float gpuTime = 0.0F; ///< ms between the start and the end of the last completed frame on the GPU
+        GpuStats gpu;
+        uint32_t recordThreads = 0;
+        uint32_t availableThreads = 0;
+        uint32_t drawCount = 0; ///< instanced draws recorded, after culling
+        uint32_t totalDrawCount = 0;
+        uint32_t instanceCount = 0; ///< objects drawn, after culling
+        uint32_t totalInstanceCount = 0;
+        uint64_t triangleCount = 0; ///< triangles of the recorded draws, every instance counted
+        uint64_t totalTriangleCount = 0;
+        uint32_t occludedCount = 0; ///< objects in the frustum hidden behind the depth pyramid
+        uint32_t lightCount = 0; ///< lights binned into the clusters
+        uint32_t descriptorPoolCount = 0; ///< created by the descriptor allocator, in use or free
+        float renderScale = 1.0F; ///< of the last recorded frame
+        VkExtent2D renderExtent{}; ///< pixels the scene of the last recorded frame was rendered at
+        ShadowStats shadows;
+        bool gpuCullingSupported = false;
+        std::vector<VkPresentModeKHR> availablePresentModes;
+        FrameTimings frameTimings;
+    };
+
+} // namespace ven
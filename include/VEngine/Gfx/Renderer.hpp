@@ -6,18 +6,72 @@
 
 #pragma once
 
+#include <algorithm>
+#include <memory>
+#include <span>
+
+#include "Utils/ThreadPool.hpp"
+#include "VEngine/Gfx/Backend/Descriptors/Allocator.hpp"
+#include "VEngine/Gfx/Backend/Descriptors/LayoutCache.hpp"
+#include "VEngine/Gfx/Backend/CommandPools.hpp"
+#include "VEngine/Gfx/Backend/FrameDump.hpp"
+#include "VEngine/Gfx/Backend/GpuProfiler.hpp"
+#include "VEngine/Gfx/CascadedShadows.hpp"
+#include "VEngine/Gfx/ClusteredLighting.hpp"
+#include "VEngine/Gfx/FrameSnapshot.hpp"
+#include "VEngine/Gfx/GpuCulling.hpp"
+#include "VEngine/Gfx/RenderQueue.hpp"
+#include "VEngine/Gfx/RenderSettings.hpp"
 #include "VEngine/Gfx/Resources/Model.hpp"
 #include "VEngine/Gfx/Shaders.hpp"
-#include "VEngine/Gui/Gui.hpp"
+#include "VEngine/Gfx/Upscaler.hpp"
+#include "VEngine/Scene/Bvh.hpp"
+#include "VEngine/Scene/Components.hpp"
+#include "VEngine/Scene/Frustum.hpp"
+#include "VEngine/Scene/Registry.hpp"
+#include "VEngine/Scene/TransformHierarchy.hpp"
 
 namespace ven {
 
     static constexpr uint8_t OFFSET = 16;
+    ///
+    /// @struct UniformBufferObject
+    /// @brief Per-frame camera data, written once per frame
+    ///
     struct UniformBufferObject {
-        alignas(OFFSET) glm::mat4 model;
         alignas(OFFSET) glm::mat4 view;
         alignas(OFFSET) glm::mat4 proj;
         alignas(OFFSET) glm::vec3 ambientColor;
+        alignas(OFFSET) std::array<glm::vec4, 6> frustumPlanes; ///< see Frustum, read by the culling shader
+        alignas(OFFSET) glm::vec4 clusterScale; ///< see ClusteredLighting::getClusterScale
+        alignas(OFFSET) glm::uvec4 clusterParams; ///< light count, 1 to show the light count of each cluster
+        alignas(OFFSET) std::array<glm::mat4, CascadedShadows::CASCADE_COUNT> cascadeViewProjections;
+        alignas(OFFSET) glm::vec4 cascadeSplits; ///< far view depth of every cascade
+        alignas(OFFSET) glm::vec4 sunDirection; ///< toward the sun, w is its intensity
+        alignas(OFFSET) glm::uvec4 shadowParams; ///< 1 when the cascades are drawn
+    };
+
+    ///
+    /// @struct ObjectData
+    /// @brief Entry of the object storage buffer, the vertex shader reads it with gl_InstanceIndex
+    ///
+    struct ObjectData {
+        alignas(OFFSET) glm::mat4 world;
+    };
+
+    ///
+    /// @struct DrawGroup
+    /// @brief One mesh inside the merged vertex and index buffers, the entities with a MeshRef to it are its objects
+    ///
+    struct DrawGroup {
+        uint32_t indexCount = 0;
+        uint32_t firstIndex = 0;
+        int32_t vertexOffset = 0;
+        uint32_t instanceOffset = 0; ///< sum of the objectCount of the groups before it
+        uint32_t objectCount = 0;
+        Bounds bounds; ///< object-space bounds of the mesh
+        AlphaMode alphaMode = AlphaMode::SOLID;
+        uint32_t material = 0; ///< texture of the mesh, index in the TextureManager array, shared by its objects
     };
 
     ///
@@ -30,10 +84,24 @@ namespace ven {
         public:
 
             static constexpr VkDeviceSize UNIFORM_BUFFER_SIZE{sizeof(UniformBufferObject)};
+            static constexpr const char* SCENE_SCOPE = "Scene"; ///< GPU scope of the scene render passes, drawn at the render scale
+            /// @brief Objects from which the CPU culling splits its tests across the thread pool, before BVH_CULL_SIZE
+            static constexpr size_t PARALLEL_CULL_SIZE = 16384;
+            /// @brief Objects from which the CPU culling walks the Bvh, where frustumUs.bvh of --bvh-benchmark drops below frustumUs.bruteForceSimd
+            static constexpr size_t BVH_CULL_SIZE = 4096;
+            static constexpr VkDeviceSize getObjectBufferSize(const size_t objectCount) { return sizeof(ObjectData) * std::max<size_t>(objectCount, 1); }
+            /// @brief Instance buffer of a frame slot, twice the object count: the early and late culling phases fill a half each
+            static constexpr VkDeviceSize getInstanceBufferSize(const size_t objectCount) { return sizeof(uint32_t) * std::max<size_t>(objectCount, 1) * 2; }
 
-            explicit Renderer(const Device &device, Window& window, std::vector<Model>& models) : m_device(device), m_window(window),
-                                                                      m_swapChain(m_device, window.getExtent()), m_shadersModule(m_device.getVkDevice()),
-                                                                      m_gui(m_device, m_camera, window.getGLFWWindow(), m_swapChain.getRenderPass(), models, m_clearValues, m_ambientColor) {  }
+            ///
+            /// @param descriptorAllocator Transient sets of a frame slot are reset in recordCommandBuffer
+            /// @param dumpDirectory Headless only, write every frame into this directory when not empty
+            ///
+            explicit Renderer(const Device &device, Window& window, Registry& scene, TransformHierarchy& transforms, DescriptorLayoutCache& layoutCache, DescriptorAllocator& descriptorAllocator,
+                              const std::string& dumpDirectory = "") : m_device(device), m_window(window), m_layoutCache(layoutCache), m_descriptorAllocator(descriptorAllocator),
+                                                                      m_swapChain(m_device, window.getExtent()), m_shadersModule(m_device.getVkDevice()), m_upscaler(m_device, m_shadersModule, m_swapChain, layoutCache, descriptorAllocator),
+                                                                      m_commandPools(m_device, std::max(m_recordThreadPool.getThreadCount(), 2U) + 1), m_gpuProfiler(m_device, m_commandPools.getSlotCount()),
+                                                                      m_gui(m_device, m_camera, window.getGLFWWindow(), m_swapChain.getPresentRenderPass(), scene, transforms, m_clearValues, m_ambientColor, m_settings, m_stats) { init(dumpDirectory); }
 
             ~Renderer();
 
@@ -43,25 +111,150 @@ namespace ven {
             Renderer& operator=(Renderer &&) = delete;
 
             void createCommandBuffers(std::vector<VkCommandBuffer>& commandBuffers) const;
+            /// @brief Follow the window size and the present mode setting, only while the render thread is idle
             void recreateSwapChain();
-            void updateUniformBuffer(void* uniformBufferMapped, std::vector<Model>& models) const;
-            void recordCommandBuffer(uint32_t imageIndex, uint32_t indiceSize, const VkDescriptorSet* descriptorSet, const VkCommandBuffer& commandBuffer, const VkBuffer& indexBuffer, const VkBuffer& vertexBuffer);
+            ///
+            /// @brief Write the camera data and the world matrix of every object, each in a single contiguous copy
+            /// @param objectBufferMapped Mapped object buffer of the frame slot, sized for at least every object
+            ///
+            void updateUniformBuffer(void* uniformBufferMapped, void* objectBufferMapped, TransformHierarchy& transforms, Registry& scene, const std::vector<DrawGroup>& groups);
+            ///
+            /// @brief Frustum cull the objects of every group against the camera and world matrices of the last updateUniformBuffer
+            /// @param instanceBufferMapped Mapped instance buffer of the frame slot, receives the visible objects of each draw
+            /// @return The visible draws in RenderQueue order, valid until the next call, empty when the GPU culls
+            ///
+            [[nodiscard]] const std::vector<DrawCommand>& cullDraws(const std::vector<DrawGroup>& groups, void* instanceBufferMapped);
+            /// @brief Create the GPU culling pass and its depth pyramid, nothing when the device cannot draw indirect with a count
+            void initGpuCulling(const std::vector<DrawGroup>& groups, Registry& scene, const std::vector<VkBuffer>& uniformBuffers, const std::vector<VkBuffer>& objectBuffers, VkDeviceSize objectBufferSize,
+                                const std::vector<VkBuffer>& instanceBuffers, VkDeviceSize instanceBufferSize);
+            /// @brief Create the light binning pass, the light and cluster buffers are the ones of the scene descriptor sets
+            void initClusteredLighting(const std::vector<VkBuffer>& uniformBuffers, const std::vector<VkBuffer>& lightBuffers, const std::vector<VkBuffer>& clusterBuffers);
+            /// @brief Create the shadow maps and their instance buffers, before the scene descriptor sets that sample them
+            void initShadows(const std::vector<VkBuffer>& objectBuffers, VkDeviceSize objectBufferSize, uint32_t objectCount);
+            /// @brief Gather the casters of every cascade redrawn this frame from the Bvh, after updateUniformBuffer
+            void cullShadowCasters(uint32_t frameIndex, const std::vector<DrawGroup>& groups);
+            /// @brief Write up to ClusteredLighting::MAX_LIGHTS lights into the light buffer of the frame slot, after updateUniformBuffer
+            void updateLights(void* lightBufferMapped, const TransformHierarchy& transforms, Registry& scene);
+            ///
+            /// @brief Copy what the recording of the frame reads into snapshot, after cullShadowCasters, then build the Gui
+            /// @param draws Returned by cullDraws
+            ///
+            void buildSnapshot(FrameSnapshot& snapshot, uint32_t frameIndex, const std::vector<DrawCommand>& draws);
+            /// @brief Record the frame of a snapshot, on the render thread
+            void recordCommandBuffer(const FrameSnapshot& snapshot, uint32_t imageIndex, const VkDescriptorSet& descriptorSet, const VkCommandBuffer& commandBuffer, const VkBuffer& indexBuffer, const VkBuffer& vertexBuffer);
+            /// @brief Publish the stats of the last recorded frame, while the render thread is idle
+            void frameRendered();
+            /// @brief A snapshot was built but not rendered, the shadow cascades it marked as drawn are redrawn by the next frame
+            void frameDropped() { if (m_shadows != nullptr) { m_shadows->invalidate(); } }
+            /// @brief Once per frame handed to the render thread, while it is idle
+            void releaseRetiredResources() { m_swapChain.releaseRetired(); }
+            ///
+            /// @brief Collect what the GPU produced for the frame slot: GPU time and the dumped frame
+            /// @param frameIndex Slot whose fence has just been waited on
+            ///
+            void frameCompleted(uint32_t frameIndex);
+            /// @brief Write the dumped frames still pending, the device must be idle
+            void writeFrames() const { if (m_frameDump != nullptr) { m_frameDump->writeAll(); } }
+            void setFrameTimings(const FrameTimings& timings) { m_stats.frameTimings = timings; }
+            void setDepthPrepass(const bool enabled) { m_settings.depthPrepass = enabled; }
 
+            [[nodiscard]] bool isSwapChainOutdated() const { return m_settings.presentMode != m_swapChain.getPresentMode(); }
+            [[nodiscard]] const RenderSettings& getSettings() const { return m_settings; }
+            [[nodiscard]] const RenderStats& getStats() const { return m_stats; }
             [[nodiscard]] const SwapChain& getSwapChain() const { return m_swapChain; }
             [[nodiscard]] Camera& getCamera() { return m_camera; }
             [[nodiscard]] Shaders& getShadersModule() { return m_shadersModule; }
+            /// @brief Hierarchy over the world bounds of the objects of the last updateUniformBuffer, primitives are object indices
+            [[nodiscard]] const Bvh& getBvh() const { return m_bvh; }
+            [[nodiscard]] VkDescriptorImageInfo getShadowMapInfo() const { return m_shadows->getDescriptorInfo(); }
 
         private:
 
+            void init(const std::string& dumpDirectory);
+            void beginSecondaryCommandBuffer(const VkCommandBuffer& commandBuffer, const VkRenderPass& renderPass, const VkFramebuffer& frameBuffer) const;
+            void beginRenderPass(const VkCommandBuffer& commandBuffer, const VkRenderPass& renderPass, const VkFramebuffer& frameBuffer, VkExtent2D extent, const std::array<VkClearValue, 2>& clearValues) const;
+            void bindScene(const VkCommandBuffer& commandBuffer, const VkDescriptorSet& descriptorSet, const VkBuffer& indexBuffer, const VkBuffer& vertexBuffer, VkExtent2D extent) const;
+            void recordDraws(const VkCommandBuffer& commandBuffer, const VkDescriptorSet& descriptorSet, const VkBuffer& indexBuffer, const VkBuffer& vertexBuffer, VkExtent2D extent, std::span<const DrawCommand> draws) const;
+            /// @brief Indirect draws of a culling phase, a pipeline per alpha mode range, after their depth-only copy with the pre-pass
+            void recordGpuDraws(const VkCommandBuffer& commandBuffer, uint32_t frameIndex, CullingPhase phase, bool depthPrepass) const;
+            [[nodiscard]] bool isGpuCulling(const RenderSettings& settings) const { return settings.culling == CullingMode::GPU && m_gpuCulling != nullptr; }
+            [[nodiscard]] bool isOcclusionCulling(const RenderSettings& settings) const { return isGpuCulling(settings) && settings.occlusionCulling; }
+            /// @brief Unit vector toward the sun from the Gui angles
+            [[nodiscard]] glm::vec3 getSunDirection() const;
+            ///
+            /// @brief Move the render scale toward the targetFrameTime from the GPU times of a completed frame
+            /// @param sceneTime Of the SCENE_SCOPE, the only part of the frame rendered at the render scale
+            ///
+            void updateRenderScale(uint32_t frameIndex, float sceneTime);
+
+            ///
+            /// @struct RecordStats
+            /// @brief What recordCommandBuffer measured, copied into the RenderStats by frameRendered
+            ///
+            struct RecordStats {
+                float recordTime = 0.0F;
+                uint32_t recordThreads = 0;
+                uint32_t drawCount = 0;
+                bool gpuCulled = false; ///< drawCount comes from the culling shader instead
+            };
+
+            ///
+            /// @struct SlotScopes
+            /// @brief GPU profiler scopes recordCommandBuffer added for a frame slot, read back by frameCompleted
+            ///
+            struct SlotScopes {
+                uint32_t scene = 0; ///< 0 until the slot is recorded, the frame scope comes first
+                std::array<uint32_t, CascadedShadows::CASCADE_COUNT> shadows{}; ///< 0 for a cascade not redrawn
+            };
+
             std::array<VkClearValue, 2> m_clearValues{
                 VkClearValue{ .color = {0.0F, 0.0F, 0.0F, 1.0F}},
                 VkClearValue{.depthStencil = {1.0F, 0}}};
-            glm::vec3 m_ambientColor{1.0F, 1.0F, 1.0F};
+            glm::vec3 m_ambientColor{0.35F, 0.35F, 0.35F};
+            RenderSettings m_settings;
+            RenderStats m_stats;
             const Device& m_device;
             Window& m_window;
+            DescriptorLayoutCache& m_layoutCache;
+            DescriptorAllocator& m_descriptorAllocator;
             SwapChain m_swapChain;
             Shaders m_shadersModule;
+            Upscaler m_upscaler;
             Camera m_camera;
+            utl::ThreadPool m_threadPool; ///< of the update thread
+            utl::ThreadPool m_recordThreadPool; ///< of the render thread, a pool runs one parallelFor at a time
+            CommandPools m_commandPools;
+            GpuProfiler m_gpuProfiler;
+            std::vector<VkCommandBuffer> m_secondaryCommandBuffers; ///< recordCommandBuffer scratch
+            RecordStats m_recordStats;
+            std::unique_ptr<FrameDump> m_frameDump;
+            std::vector<ObjectData> m_objectData;
+            std::vector<uint32_t> m_objectGroups; ///< DrawGroup of every object, parallel to m_objectData
+            glm::mat4 m_viewProjection{1.0F};
+            glm::vec3 m_cameraPosition{0.0F};
+            BoundsSoA m_worldBounds;
+            std::vector<Bounds> m_objectBounds; ///< m_worldBounds as built into m_bvh
+            Bvh m_bvh;
+            std::vector<uint32_t> m_bvhVisible; ///< cullDraws scratch
+            std::vector<uint8_t> m_visibility;
+            std::vector<DrawCommand> m_visibleDraws;
+            std::vector<uint32_t> m_instanceIndices;
+            std::vector<uint32_t> m_groupOffsets; ///< cullDraws scratch, next instance of every group
+            std::vector<uint32_t> m_visibleGroups; ///< cullDraws scratch, group of every entry of m_visibleDraws
+            RenderQueue m_renderQueue;
+            std::array<uint32_t, 4> m_alphaModeGroups{}; ///< first group of each AlphaMode, then the group count
+            std::unique_ptr<DepthPyramid> m_depthPyramid;
+            std::unique_ptr<GpuCulling> m_gpuCulling;
+            std::unique_ptr<ClusteredLighting> m_clusteredLighting;
+            std::unique_ptr<CascadedShadows> m_shadows;
+            bool m_shadowsDrawn = false; ///< the settings when the cascades were last updated, the Gui may change them before the next frame
+            std::array<std::vector<DrawCommand>, CascadedShadows::CASCADE_COUNT> m_shadowDraws;
+            std::vector<GpuLight> m_lights; ///< updateLights scratch
+            std::array<bool, SwapChain::MAX_FRAMES_IN_FLIGHT> m_gpuCulled{}; ///< frames whose counts come from the culling shader, written by the render thread
+            float m_renderScale = 1.0F; ///< of the dynamic resolution controller
+            VkExtent2D m_renderExtent{}; ///< top-left area of the scene targets the frame being updated is rendered into
+            std::array<float, SwapChain::MAX_FRAMES_IN_FLIGHT> m_slotRenderScales{}; ///< scale each frame slot was last rendered at, written by the render thread
+            std::array<SlotScopes, SwapChain::MAX_FRAMES_IN_FLIGHT> m_slotScopes{}; ///< written by the render thread
             Gui m_gui;
 
     }; // class Renderer
@@ -10,9 +10,22 @@
 
 #include "VEngine/Gfx/Resources/Vertex.hpp"
 #include "VEngine/Gfx/Resources/Texture.hpp"
+#include "VEngine/Scene/Bounds.hpp"
 
 namespace ven {
 
+    ///
+    /// @enum AlphaMode
+    /// @brief How the material uses the alpha of its texture, decides the render queue bucket of the mesh
+    ///
+    /// Not OPAQUE / TRANSPARENT: wingdi.h defines both as macros.
+    ///
+    enum class AlphaMode : uint8_t {
+        SOLID, ///< alpha ignored, drawn front to back
+        MASKED, ///< fragments under the alpha cutoff are discarded, depth still written
+        BLENDED ///< blended over what is behind, drawn back to front without depth write
+    };
+
     class Mesh {
 
         public:
@@ -27,15 +40,24 @@ namespace ven {
 
             void addVertex(const Vertex& vertex) { m_vertices.push_back(vertex); }
             void addIndices(const uint32_t indices) { m_indices.push_back(indices); }
-            void setTextureIndex(const uint32_t index) { for (auto& vertex : m_vertices) { vertex.textureIndex = index; } }
+            void setTextureIndex(const uint32_t index) { m_textureIndex = index; for (auto& vertex : m_vertices) { vertex.textureIndex = index; } }
+            void setAlphaMode(const AlphaMode alphaMode) { m_alphaMode = alphaMode; }
+            /// @brief Compute the bounds from the vertices, to call once they are all added
+            void computeBounds();
 
             [[nodiscard]] const std::vector<Vertex>& getVertices() const { return m_vertices; }
             [[nodiscard]] const std::vector<uint32_t>& getIndices() const { return m_indices; }
+            [[nodiscard]] const Bounds& getBounds() const { return m_bounds; }
+            [[nodiscard]] uint32_t getTextureIndex() const { return m_textureIndex; }
+            [[nodiscard]] AlphaMode getAlphaMode() const { return m_alphaMode; }
 
         private:
 
             std::vector<Vertex> m_vertices;
             std::vector<uint32_t> m_indices;
+            Bounds m_bounds;
+            uint32_t m_textureIndex = 0;
+            AlphaMode m_alphaMode = AlphaMode::SOLID;
 
     };
 
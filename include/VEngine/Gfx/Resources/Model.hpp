@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <limits>
+
 #include <assimp/scene.h>
 
 #include "VEngine/Gfx/Resources/Mesh.hpp"
@@ -13,11 +15,34 @@
 
 namespace ven {
 
+    ///
+    /// @struct ModelNode
+    /// @brief Node of the model file, parents are stored before their children
+    ///
+    struct ModelNode {
+        static constexpr uint32_t NO_PARENT = std::numeric_limits<uint32_t>::max();
+
+        uint32_t parent = NO_PARENT; ///< index in Model::getNodes, NO_PARENT for the root
+        glm::mat4 local{1.0F}; ///< transform relative to the parent
+    };
+
+    ///
+    /// @struct MeshInstance
+    /// @brief One node referencing a mesh of the model
+    ///
+    struct MeshInstance {
+        uint32_t mesh = 0; ///< index in Model::getMeshes
+        uint32_t node = 0; ///< index in Model::getNodes
+    };
+
     ///
     /// @class Model
     /// @brief Class for models
     /// @namespace ven
     ///
+    /// Every mesh of the file is imported once in its own space, the nodes referencing it become instances. A model only
+    /// lives while it is loaded: its meshes are copied into the shared buffers and its instances become scene entities.
+    ///
     class Model {
 
         public:
@@ -50,17 +75,22 @@ namespace ven {
             }
 
             [[nodiscard]] const std::vector<std::unique_ptr<Mesh>>& getMeshes() const { return m_meshes; }
-            [[nodiscard]] Transform& getTransform() { return m_transform; }
+            [[nodiscard]] const std::vector<MeshInstance>& getInstances() const { return m_instances; }
+            [[nodiscard]] const std::vector<ModelNode>& getNodes() const { return m_nodes; }
 
         private:
 
             const Device& m_device;
             const SwapChain& m_swapChain;
             std::vector<std::unique_ptr<Mesh>> m_meshes;
-            Transform m_transform;
-
-            void processNode(const aiNode* node, const aiScene* scene, const Device& device, const SwapChain& swapChain, const glm::mat4 &parentTransform);
-            static std::unique_ptr<Mesh> processMesh(const aiMesh* mesh, const aiScene* scene, const Device& device, const SwapChain& swapChain, const glm::mat4& transform);
+            std::vector<MeshInstance> m_instances;
+            std::vector<ModelNode> m_nodes;
+
+            ///
+            /// @param meshIndices Assimp mesh index to m_meshes index of the meshes imported so far
+            ///
+            void processNode(const aiNode* node, const aiScene* scene, const Device& device, const SwapChain& swapChain, uint32_t parent, std::unordered_map<unsigned int, uint32_t>& meshIndices);
+            static std::unique_ptr<Mesh> processMesh(const aiMesh* mesh, const aiScene* scene, const Device& device, const SwapChain& swapChain);
 
     }; // class Model
 
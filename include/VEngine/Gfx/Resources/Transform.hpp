@@ -1,11 +1,22 @@
 #pragma once
 
+#include <glm/gtc/matrix_transform.hpp>
+
 namespace ven {
 
     struct Transform {
         glm::vec3 position = glm::vec3(0.0F);
         glm::vec3 rotation = glm::vec3(0.0F);
         glm::vec3 scale = glm::vec3(1.0F);
+
+        /// @return World matrix: scale, then rotate around x, y, z, then translate
+        [[nodiscard]] glm::mat4 getMatrix() const {
+            glm::mat4 matrix = glm::translate(glm::mat4(1.0F), position);
+            matrix = glm::rotate(matrix, rotation.x, glm::vec3(1.0F, 0.0F, 0.0F));
+            matrix = glm::rotate(matrix, rotation.y, glm::vec3(0.0F, 1.0F, 0.0F));
+            matrix = glm::rotate(matrix, rotation.z, glm::vec3(0.0F, 0.0F, 1.0F));
+            return glm::scale(matrix, scale);
+        }
     };
 
 } // namespace ven
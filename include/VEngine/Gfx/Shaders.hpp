@@ -6,12 +6,27 @@
 
 #pragma once
 
+#include <array>
+
 #include <vulkan/vulkan_core.h>
 
 namespace ven {
 
     static constexpr std::string_view SHADERS_BIN_PATH = "build/shaders/";
 
+    ///
+    /// @enum PipelineType
+    /// @brief Scene pipelines, they share the layout, the shaders and the render pass
+    ///
+    enum class PipelineType : uint8_t {
+        DEPTH, ///< depth pre-pass of solid meshes, no fragment shader
+        DEPTH_MASKED, ///< depth pre-pass of masked meshes, depth_masked_shader only runs the alpha test
+        SOLID,
+        MASKED, ///< discards under the alpha cutoff, alpha to coverage with MSAA
+        BLENDED, ///< alpha blending, depth tested but not written
+        COUNT
+    };
+
     ///
     /// @class Shaders
     /// @brief Class for shaders
@@ -22,19 +37,36 @@ namespace ven {
         public:
 
             explicit Shaders(const VkDevice& device) : m_device{device} { }
-            ~Shaders() { vkDestroyPipelineLayout(m_device, m_pipelineLayout, nullptr); vkDestroyPipeline(m_device, m_Pipeline, nullptr); }
+            ~Shaders() { vkDestroyPipelineLayout(m_device, m_pipelineLayout, nullptr); for (const VkPipeline& pipeline : m_pipelines) { vkDestroyPipeline(m_device, pipeline, nullptr); } }
 
             Shaders(const Shaders&) = delete;
             Shaders& operator=(const Shaders&) = delete;
             Shaders(Shaders&&) = delete;
             Shaders& operator=(Shaders&&) = delete;
 
+            /// @brief Create the scene pipelines, destroying the previous ones, they must not be in use by the GPU anymore
             void createPipeline(const VkSampleCountFlagBits& msaaSample, const VkDescriptorSetLayout& descriptorSetLayout, const VkRenderPass& renderPass);
+            void recreatePipeline(const VkRenderPass& renderPass) { createPipeline(m_msaaSamples, m_descriptorSetLayout, renderPass); }
+            ///
+            /// @brief Create a compute pipeline from the compiled <name>.spv, the caller owns and destroys it
+            ///
+            [[nodiscard]] VkPipeline createComputePipeline(const std::string& name, const VkPipelineLayout& layout) const;
+            ///
+            /// @brief Create the depth-only pipeline of the shadow maps from shadow_shader.spv, the caller owns and destroys it
+            /// @param resolution Width and height of the shadow map, the viewport is static
+            ///
+            [[nodiscard]] VkPipeline createShadowPipeline(const VkPipelineLayout& layout, const VkRenderPass& renderPass, uint32_t resolution) const;
+            ///
+            /// @brief Create the full screen pipeline of the upscale from fullscreen_shader.spv and upscale_shader.spv, the caller owns and destroys it
+            ///
+            /// No vertex input, single sample, dynamic viewport and scissor.
+            ///
+            [[nodiscard]] VkPipeline createUpscalePipeline(const VkPipelineLayout& layout, const VkRenderPass& renderPass) const;
             //void createImguiPipeline(const VkRenderPass& renderPass);
 
             [[nodiscard]] const VkPipelineLayout& getPipelineLayout() const { return m_pipelineLayout; }
             //[[nodiscard]] const VkPipelineLayout& getImguiPipelineLayout() const { return m_imguiPipelineLayout; }
-            [[nodiscard]] const VkPipeline& getPipeline() const { return m_Pipeline; }
+            [[nodiscard]] const VkPipeline& getPipeline(const PipelineType type) const { return m_pipelines.at(static_cast<size_t>(type)); }
             //[[nodiscard]] const VkPipeline& getImguiPipeline() const { return m_imguiPipeline; }
 
         private:
@@ -44,7 +76,9 @@ namespace ven {
             const VkDevice& m_device;
             VkPipelineLayout m_pipelineLayout = VK_NULL_HANDLE;
             //VkPipelineLayout m_imguiPipelineLayout = VK_NULL_HANDLE;
-            VkPipeline m_Pipeline = VK_NULL_HANDLE;
+            std::array<VkPipeline, static_cast<size_t>(PipelineType::COUNT)> m_pipelines{};
+            VkSampleCountFlagBits m_msaaSamples = VK_SAMPLE_COUNT_1_BIT;
+            VkDescriptorSetLayout m_descriptorSetLayout = VK_NULL_HANDLE;
             // VkPipeline m_imguiPipeline = VK_NULL_HANDLE;
 
     }; // class Shaders
@@ -0,0 +1,77 @@
+///
+/// @file Upscaler.hpp
+/// @brief This file contains the Upscaler class
+/// @namespace ven
+///
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "VEngine/Gfx/Backend/Descriptors/Allocator.hpp"
+#include "VEngine/Gfx/Backend/Descriptors/LayoutCache.hpp"
+#include "VEngine/Gfx/Backend/SwapChain.hpp"
+#include "VEngine/Gfx/RenderSettings.hpp"
+#include "VEngine/Gfx/Shaders.hpp"
+
+namespace ven {
+
+    ///
+    /// @class Upscaler
+    /// @brief Full screen pass stretching the rendered area of the scene image over the swap chain image
+    /// @namespace ven
+    ///
+    /// Drawn first in the present render pass, the Gui follows at native resolution. The scene image is sampled
+    /// bilinearly and the taps are clamped half a texel inside the rendered area: the rest of the image holds older
+    /// frames rendered at a larger scale. UpscaleFilter::SHARPEN adds an unsharp mask over the 4 neighbours, clamped to
+    /// their range so edges do not ring. Its descriptor set is transient, written each frame against the current scene
+    /// image, so a resize does not wait for the frames in flight.
+    ///
+    class Upscaler {
+
+        public:
+
+            explicit Upscaler(const Device& device, const Shaders& shaders, const SwapChain& swapChain, DescriptorLayoutCache& layoutCache, DescriptorAllocator& descriptorAllocator);
+            ~Upscaler();
+
+            Upscaler(const Upscaler&) = delete;
+            Upscaler& operator=(const Upscaler&) = delete;
+            Upscaler(Upscaler&&) = delete;
+            Upscaler& operator=(Upscaler&&) = delete;
+
+            ///
+            /// @brief Point at the scene image of the swap chain again after it was resized, used from the next record on
+            ///
+            void setSource(const SwapChain& swapChain);
+            ///
+            /// @brief Rebuild the pipeline against a new present render pass, the device must be idle
+            ///
+            void recreatePipeline(const Shaders& shaders, const VkRenderPass& renderPass);
+            ///
+            /// @brief Record the upscale, inside the present render pass
+            /// @param frameIndex Slot its descriptor set is allocated for
+            /// @param renderExtent Top-left area of the scene image the scene was rendered into
+            ///
+            void record(const VkCommandBuffer& commandBuffer, uint32_t frameIndex, VkExtent2D renderExtent, UpscaleFilter filter, float sharpness) const;
+
+        private:
+
+            struct UpscaleConstants {
+                glm::vec2 uvScale; ///< rendered area over scene image size
+                glm::vec2 uvMax; ///< last bilinear tap inside the rendered area
+                glm::vec2 texelSize; ///< of the scene image
+                float sharpness; ///< 0 for bilinear
+            };
+
+            const Device& m_device;
+            DescriptorAllocator& m_descriptorAllocator;
+            VkExtent2D m_sourceExtent{};
+            VkImageView m_sourceView = VK_NULL_HANDLE;
+            VkSampler m_sampler = VK_NULL_HANDLE;
+            VkDescriptorSetLayout m_descriptorSetLayout = VK_NULL_HANDLE; ///< owned by the layout cache
+            VkPipelineLayout m_pipelineLayout = VK_NULL_HANDLE;
+            VkPipeline m_pipeline = VK_NULL_HANDLE;
+
+    }; // class Upscaler
+
+} // namespace ven
@@ -6,14 +6,49 @@
 
 #pragma once
 
+#include <imgui_impl_vulkan.h>
+
 #include "Utils/FrameStats.hpp"
 #include "Utils/MemoryMonitor.hpp"
 #include "VEngine/Gfx/Backend/Device.hpp"
-#include "VEngine/Gfx/Resources/Model.hpp"
+#include "VEngine/Gfx/RenderSettings.hpp"
+#include "VEngine/Gfx/Backend/SwapChain.hpp"
 #include "VEngine/Scene/Camera.hpp"
+#include "VEngine/Scene/Registry.hpp"
+#include "VEngine/Scene/TransformHierarchy.hpp"
 
 namespace ven {
 
+    ///
+    /// @class GuiFrame
+    /// @brief Copy of the draw data of an ImGui frame, recorded on the render thread while the next frame is built
+    /// @namespace ven
+    ///
+    class GuiFrame {
+
+        public:
+
+            GuiFrame() = default;
+            ~GuiFrame() { clear(); }
+
+            GuiFrame(const GuiFrame&) = delete;
+            GuiFrame& operator=(const GuiFrame&) = delete;
+            GuiFrame(GuiFrame&&) = delete;
+            GuiFrame& operator=(GuiFrame&&) = delete;
+
+            /// @brief Replace the copy with the output of ImGui::Render
+            void capture(const ImDrawData& drawData);
+            void clear();
+
+            [[nodiscard]] bool isEmpty() const { return !m_drawData.Valid; }
+            [[nodiscard]] const ImDrawData& getDrawData() const { return m_drawData; }
+
+        private:
+
+            ImDrawData m_drawData; ///< its lists are clones owned here, ImGui reuses its own in the next NewFrame
+
+    }; // class GuiFrame
+
     ///
     /// @class Gui
     /// @brief Class for Gui
@@ -23,13 +58,17 @@ namespace ven {
 
         public:
 
+            static constexpr uint8_t PRESENT_MODE_COUNT = VK_PRESENT_MODE_FIFO_RELAXED_KHR + 1;
+            /// @brief Frame time statistics (ms) indexed by [present mode][frames in flight - 1]
+            using PacingStats = std::array<std::array<RunningStats, SwapChain::MAX_FRAMES_IN_FLIGHT>, PRESENT_MODE_COUNT>;
+
             enum Theme: uint8_t {
                 BlackWhite = 0x00,
                 BlueGrey = 0x01,
                 BlackRed = 0x02
             };
 
-            Gui(const Device& device, Camera& camera, GLFWwindow* window, const VkRenderPass& renderPass, std::vector<Model>& models, std::array<VkClearValue, 2>& clearValues, glm::vec3& ambientColor);
+            Gui(const Device& device, Camera& camera, GLFWwindow* window, const VkRenderPass& renderPass, Registry& scene, TransformHierarchy& transforms, std::array<VkClearValue, 2>& clearValues, glm::vec3& ambientColor, RenderSettings& settings, const RenderStats& stats);
             ~Gui();
 
             Gui(const Gui&) = delete;
@@ -37,11 +76,31 @@ namespace ven {
             Gui(Gui&&) = delete;
             Gui& operator=(Gui&&) = delete;
 
-            void render(const VkCommandBuffer& commandBuffer);
+            ///
+            /// @brief Build the widgets of a frame on the update thread and copy its draw data into frame
+            ///
+            /// The widgets edit the settings, the camera and the scene directly: the render thread only reads the copy.
+            ///
+            void update(GuiFrame& frame);
+            /// @brief Record a frame copied by update, inside the present render pass
+            static void record(const VkCommandBuffer& commandBuffer, const GuiFrame& frame);
+            /// @brief Rebuild the ImGui pipeline against a new render pass, the device must be idle
+            void setRenderPass(const VkRenderPass& renderPass);
             static void applyTheme(const Theme theme) { switch (theme) { case BlackRed: blackRedTheme(); break; case BlackWhite: blackWhiteTheme(); break; case BlueGrey: blueGreyTheme(); } }
 
         private:
 
+            ///
+            /// @struct PacingConfig
+            /// @brief Settings a frame time is accounted to in PacingStats, a change of any of them starts a new sample
+            ///
+            struct PacingConfig {
+                VkPresentModeKHR presentMode = VK_PRESENT_MODE_MAX_ENUM_KHR;
+                uint32_t framesInFlight = 0;
+                float maxFps = 0.0F;
+                bool operator==(const PacingConfig&) const = default;
+            };
+
             static constexpr float RIGHT_PANEL_WIDTH = 300.0F;
             static constexpr float GRAPH_MAX_FPS = 10000.0F;
 
@@ -50,14 +109,22 @@ namespace ven {
             static void blueGreyTheme();
 
             const VkDevice& m_device;
+            GLFWwindow* m_window; ///< nullptr when headless, ImGui is then neither set up nor rendered
             VkDescriptorPool m_pool = VK_NULL_HANDLE;
+            ImGui_ImplVulkan_InitInfo m_initInfo{};
             VkPhysicalDeviceProperties m_deviceProperties{};
             std::array<VkClearValue, 2>& m_clearValues;
             glm::vec3& m_ambientColor;
+            RenderSettings& m_settings;
+            const RenderStats& m_stats;
             float m_graphMaxFps{GRAPH_MAX_FPS};
             Camera& m_camera;
-            std::vector<Model>& m_models;
+            Registry& m_scene;
+            TransformHierarchy& m_transforms;
             FrameStats m_frameStats;
+            PacingStats m_pacingStats{};
+            PacingConfig m_lastPacing; ///< of the previous frame
+            FrameTimings m_timings; ///< exponentially smoothed copy of the renderer timings, raw values flicker too much to read
             MemoryMonitor m_memoryMonitor;
 
     }; // class Gui
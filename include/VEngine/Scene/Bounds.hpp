@@ -0,0 +1,53 @@
+///
+/// @file Bounds.hpp
+/// @brief This file contains the Bounds and BoundsSoA structs
+/// @namespace ven
+///
+
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace ven {
+
+    ///
+    /// @struct Bounds
+    /// @brief Axis-aligned box and bounding sphere sharing the same center
+    ///
+    struct Bounds {
+        glm::vec3 center{0.0F};
+        glm::vec3 extent{0.0F}; ///< half size of the box
+        float radius = 0.0F;
+
+        ///
+        /// @brief Bounds of the box after transform, still axis-aligned so larger than the transformed box when rotated
+        ///
+        [[nodiscard]] Bounds transform(const glm::mat4& matrix) const;
+    };
+
+    ///
+    /// @struct BoundsSoA
+    /// @brief Bounds stored one component per array so they can be tested LANES at a time
+    ///
+    /// Arrays are padded to a multiple of LANES with empty bounds, only the first count entries are meaningful.
+    ///
+    struct BoundsSoA {
+        static constexpr size_t LANES = 4;
+
+        std::vector<float> centerX;
+        std::vector<float> centerY;
+        std::vector<float> centerZ;
+        std::vector<float> extentX;
+        std::vector<float> extentY;
+        std::vector<float> extentZ;
+        std::vector<float> radius;
+        size_t count = 0;
+
+        void resize(size_t size);
+        void set(size_t index, const Bounds& bounds);
+        [[nodiscard]] Bounds get(size_t index) const;
+    };
+
+} // namespace ven
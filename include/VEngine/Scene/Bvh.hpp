@@ -0,0 +1,116 @@
+///
+/// @file Bvh.hpp
+/// @brief This file contains the Bvh class
+/// @namespace ven
+///
+
+#pragma once
+
+#include <limits>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "Utils/ThreadPool.hpp"
+#include "VEngine/Scene/Frustum.hpp"
+
+namespace ven {
+
+    ///
+    /// @struct BvhNode
+    /// @brief Box of a subtree, 32 bytes so two siblings share a cache line
+    ///
+    struct alignas(32) BvhNode {
+        glm::vec3 min{0.0F};
+        uint32_t leftFirst = 0; ///< first child when count is 0, the right one follows it, else first primitive
+        glm::vec3 max{0.0F};
+        uint32_t count = 0; ///< primitives of a leaf, 0 for an inner node
+
+        [[nodiscard]] bool isLeaf() const { return count != 0; }
+    };
+    static_assert(sizeof(BvhNode) == 32);
+
+    ///
+    /// @struct RayHit
+    /// @brief Nearest primitive box hit by Bvh::raycast
+    ///
+    struct RayHit {
+        uint32_t primitive = 0;
+        float distance = 0.0F; ///< along the ray direction, in its units
+    };
+
+    ///
+    /// @class Bvh
+    /// @brief Bounding volume hierarchy over the bounds of the scene objects, for culling, picking and proximity queries
+    /// @namespace ven
+    ///
+    /// Built top-down with the surface area heuristic evaluated on BIN_COUNT centroid bins per axis. The first levels
+    /// are split on the calling thread until there are enough subtrees to feed the thread pool, which then builds them
+    /// independently. Primitives are indices in the bounds given to build. When they move, refit updates the boxes
+    /// bottom-up without changing the tree; once the tree has degraded too much compared to its build, shouldRebuild
+    /// turns true.
+    ///
+    class Bvh {
+
+        public:
+
+            static constexpr uint32_t BIN_COUNT = 16;
+            static constexpr uint32_t MAX_LEAF_SIZE = 4;
+            static constexpr uint32_t MAX_DEPTH = 64; ///< deeper nodes are left as leaves, bounds the traversal stacks
+            static constexpr uint32_t PARALLEL_BUILD_SIZE = 4096; ///< primitives from which build uses the thread pool
+            static constexpr float REBUILD_COST_RATIO = 1.5F; ///< SAH cost growth since the build from which shouldRebuild is true
+
+            ///
+            /// @brief Build the tree over bounds, threadPool may be nullptr to build on the calling thread only
+            ///
+            void build(std::span<const Bounds> bounds, utl::ThreadPool* threadPool = nullptr);
+            ///
+            /// @brief Update the boxes for new bounds of the same primitives, in the same order as build
+            ///
+            void refit(std::span<const Bounds> bounds);
+            ///
+            /// @brief Append the primitives whose box is not outside the frustum, whole subtrees inside are not tested further
+            ///
+            void queryFrustum(const Frustum& frustum, std::vector<uint32_t>& result) const;
+            ///
+            /// @brief Append the primitives whose box intersects the sphere
+            ///
+            void queryRadius(const glm::vec3& center, float radius, std::vector<uint32_t>& result) const;
+            ///
+            /// @brief Nearest primitive box crossed by the ray before maxDistance, the box test is the only one done
+            ///
+            [[nodiscard]] std::optional<RayHit> raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance = std::numeric_limits<float>::max()) const;
+
+            [[nodiscard]] bool shouldRebuild() const { return m_cost > m_buildCost * REBUILD_COST_RATIO; }
+            [[nodiscard]] const std::vector<BvhNode>& getNodes() const { return m_nodes; }
+            [[nodiscard]] uint32_t getPrimitiveCount() const { return static_cast<uint32_t>(m_primitives.size()); }
+
+        private:
+
+            struct Aabb {
+                glm::vec3 min{std::numeric_limits<float>::max()};
+                glm::vec3 max{std::numeric_limits<float>::lowest()};
+            };
+
+            ///
+            /// @brief Split node until its leaves hold at most MAX_LEAF_SIZE primitives or no split is cheaper
+            /// @param depth Depth of node in the whole tree
+            /// @param pending When not nullptr, nodes reaching maxDepth are appended to it unsplit, to be built later
+            ///
+            void subdivide(std::vector<BvhNode>& nodes, uint32_t node, uint32_t depth, uint32_t maxDepth, std::vector<uint32_t>* pending);
+            ///
+            /// @brief Append the primitives of a subtree, they are contiguous in m_primitives
+            ///
+            void appendSubtree(uint32_t node, std::vector<uint32_t>& result) const;
+            [[nodiscard]] float computeCost() const;
+
+            std::vector<BvhNode> m_nodes; ///< root first, a child always after its parent
+            std::vector<uint32_t> m_primitives; ///< leaves index this, a subtree owns a contiguous range
+            std::vector<Aabb> m_boxes; ///< per primitive, indexed by the primitive itself
+            std::vector<glm::vec3> m_centroids; ///< build only
+            float m_buildCost = 0.0F;
+            float m_cost = 0.0F;
+
+    }; // class Bvh
+
+} // namespace ven
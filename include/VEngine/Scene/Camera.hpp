@@ -10,6 +10,20 @@
 
 namespace ven {
 
+    ///
+    /// @struct CameraPose
+    /// @brief Position and orientation of a Camera, the state the simulation steps
+    ///
+    struct CameraPose {
+        glm::vec3 position{0.0F};
+        float yaw = 0.0F; ///< degrees
+        float pitch = 0.0F; ///< degrees
+
+        bool operator==(const CameraPose&) const = default;
+        /// @brief Blend from a to b, t from 0 to 1; the camera never wraps its yaw, so close poses blend directly
+        [[nodiscard]] static CameraPose mix(const CameraPose& a, const CameraPose& b, const float t) { return { .position = glm::mix(a.position, b.position, t), .yaw = glm::mix(a.yaw, b.yaw, t), .pitch = glm::mix(a.pitch, b.pitch, t) }; }
+    };
+
     ///
     /// @class Camera
     /// @brief Class for camera
@@ -29,6 +43,10 @@ namespace ven {
 
             void move(const glm::vec3& direction, float deltaTime);
             void rotate(float yawOffset, float pitchOffset, float deltaTime);
+            /// @brief Place the camera directly, angles in degrees, used by scripted camera paths
+            void setPose(const glm::vec3& position, float yaw, float pitch);
+            void setPose(const CameraPose& pose) { setPose(pose.position, pose.yaw, pose.pitch); }
+            [[nodiscard]] CameraPose getPose() const { return { .position = m_position, .yaw = m_yaw, .pitch = m_pitch }; }
             [[nodiscard]] glm::mat4 getProjectionMatrix(float aspectRatio) const;
             [[nodiscard]] glm::mat4 getViewMatrix() const;
 
@@ -41,9 +59,14 @@ namespace ven {
             [[nodiscard]] float& getFar() { return m_far; }
             [[nodiscard]] float& getMoveSpeed() { return m_moveSpeed; }
             [[nodiscard]] float& getLookSpeed() { return m_lookSpeed; }
+            /// @brief Degrees, see setPose
+            [[nodiscard]] float getYaw() const { return m_yaw; }
+            [[nodiscard]] float getPitch() const { return m_pitch; }
 
         private:
 
+            void updateVectors();
+
             glm::vec3 m_position = glm::vec3(0.0F, 0.0F, 3.0F);
             glm::vec3 m_front = glm::vec3(0.0F, 0.0F, -1.0F);
             glm::vec3 m_up = glm::vec3(0.0F, 1.0F, 0.0F);
@@ -0,0 +1,56 @@
+///
+/// @file CameraPath.hpp
+/// @brief This file contains the CameraPath class
+/// @namespace ven
+///
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "VEngine/Scene/Camera.hpp"
+
+namespace ven {
+
+    ///
+    /// @class CameraPath
+    /// @brief Camera spline loaded from a text file, sampled with Catmull-Rom interpolation
+    /// @namespace ven
+    ///
+    /// One key per line: time (s) x y z yaw pitch (degrees), '#' starts a comment.
+    /// Keys must be sorted by time, the first and last keys are held outside of the path.
+    ///
+    class CameraPath {
+
+        public:
+
+            struct Key {
+                float time = 0.0F;
+                glm::vec3 position{0.0F};
+                float yaw = 0.0F;
+                float pitch = 0.0F;
+            };
+
+            explicit CameraPath(const std::string& path);
+            ~CameraPath() = default;
+
+            CameraPath(const CameraPath&) = delete;
+            CameraPath& operator=(const CameraPath&) = delete;
+            CameraPath(CameraPath&&) = delete;
+            CameraPath& operator=(CameraPath&&) = delete;
+
+            ///
+            /// @param elapsed Seconds since the first key
+            ///
+            void apply(Camera& camera, float elapsed) const;
+
+            [[nodiscard]] float getDuration() const { return m_keys.back().time - m_keys.front().time; }
+
+        private:
+
+            std::vector<Key> m_keys;
+
+    }; // class CameraPath
+
+} // namespace ven
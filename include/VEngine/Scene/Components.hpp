@@ -0,0 +1,66 @@
+///
+/// @file Components.hpp
+/// @brief This file contains the scene components stored in the Registry
+/// @namespace ven
+///
+
+#pragma once
+
+#include "VEngine/Scene/Bounds.hpp"
+
+namespace ven {
+
+    ///
+    /// @struct TransformNode
+    /// @brief Node placing the entity in the scene TransformHierarchy
+    ///
+    struct TransformNode {
+        uint32_t node = 0;
+    };
+
+    ///
+    /// @struct WorldMatrix
+    /// @brief World matrix of the node, copied from the hierarchy when it changed
+    ///
+    struct WorldMatrix {
+        glm::mat4 matrix{1.0F};
+    };
+
+    ///
+    /// @struct MeshRef
+    /// @brief Mesh drawn by the entity, index of its DrawGroup
+    ///
+    struct MeshRef {
+        uint32_t group = 0;
+    };
+
+    ///
+    /// @enum LightType
+    ///
+    enum class LightType : uint32_t {
+        POINT,
+        SPOT ///< cone along the -Z axis of its node
+    };
+
+    ///
+    /// @struct Light
+    /// @brief Point or spot light placed by the TransformNode of its entity, no light reaches past range
+    ///
+    struct Light {
+        glm::vec3 color{1.0F};
+        float intensity = 1.0F;
+        float range = 10.0F;
+        LightType type = LightType::POINT;
+        float innerCone = 0.94F; ///< cosine of the angle from the axis where the spot starts fading
+        float outerCone = 0.87F; ///< cosine of the angle from the axis where the spot ends
+    };
+
+    ///
+    /// @struct WorldBounds
+    /// @brief Bounds of the mesh after the world matrix, updated with it
+    ///
+    struct WorldBounds {
+        Bounds bounds;
+    };
+
+} // namespace ven
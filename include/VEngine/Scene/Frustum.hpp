@@ -0,0 +1,57 @@
+///
+/// @file Frustum.hpp
+/// @brief This file contains the Frustum class
+/// @namespace ven
+///
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+#include "VEngine/Scene/Bounds.hpp"
+
+namespace ven {
+
+    ///
+    /// @class Frustum
+    /// @brief Six world-space planes of a camera, normals pointing inside
+    /// @namespace ven
+    ///
+    class Frustum {
+
+        public:
+
+            ///
+            /// @param viewProjection Projection * view, with the Vulkan clip space depth range [0, 1]
+            ///
+            explicit Frustum(const glm::mat4& viewProjection);
+
+            ///
+            /// @brief Test one bounds, reference for cull
+            /// @return false when the box or the sphere is entirely outside one plane
+            ///
+            [[nodiscard]] bool isVisible(const Bounds& bounds) const;
+            ///
+            /// @brief Test every bounds, BoundsSoA::LANES at a time with SSE when available
+            /// @param visible Resized to bounds.count, 1 when bounds i may be visible
+            ///
+            void cull(const BoundsSoA& bounds, std::vector<uint8_t>& visible) const;
+            ///
+            /// @brief Test bounds [first, last) only, so a large set can be split across threads
+            /// @param visible At least bounds.centerX.size() entries, padding included
+            /// @param first Multiple of BoundsSoA::LANES
+            /// @param last Multiple of BoundsSoA::LANES or the padded size
+            ///
+            void cullRange(const BoundsSoA& bounds, std::span<uint8_t> visible, size_t first, size_t last) const;
+
+            [[nodiscard]] const std::array<glm::vec4, 6>& getPlanes() const { return m_planes; }
+
+        private:
+
+            std::array<glm::vec4, 6> m_planes{}; ///< xyz normal, w distance: dot(normal, p) + w >= 0 inside
+
+    }; // class Frustum
+
+} // namespace ven
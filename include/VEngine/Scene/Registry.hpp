@@ -0,0 +1,258 @@
+///
+/// @file Registry.hpp
+/// @brief This file contains the Registry class
+/// @namespace ven
+///
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "Utils/ErrorHandling.hpp"
+#include "Utils/ThreadPool.hpp"
+
+namespace ven {
+
+    using Entity = uint32_t;
+
+    ///
+    /// @class Registry
+    /// @brief Archetype entity / component store, the entities sharing a component set share contiguous columns
+    /// @namespace ven
+    ///
+    /// Every archetype keeps one column per component, a component of row i lives at index i of its column so a query
+    /// walks plain arrays. Components must be trivially copyable: rows move between archetypes (add, remove) and fill
+    /// the holes left by destroy with memcpy, which also means a row index is only stable until the next structural change.
+    ///
+    class Registry {
+
+        public:
+
+            static constexpr Entity INVALID_ENTITY = std::numeric_limits<Entity>::max();
+            static constexpr uint32_t MAX_COMPONENTS = 32;
+            static constexpr uint32_t MIN_PARALLEL_ROWS = 1024; ///< rows per task below which parallelForEach stays on the calling thread
+
+            using ComponentMask = uint32_t;
+
+            Registry() = default;
+            ~Registry() = default;
+
+            Registry(const Registry&) = delete;
+            Registry& operator=(const Registry&) = delete;
+            Registry(Registry&&) = delete;
+            Registry& operator=(Registry&&) = delete;
+
+            template<typename... Ts>
+            Entity create(const Ts&... components) {
+                const ComponentMask mask = (componentBit<Ts>() | ... | 0U);
+                const Entity entity = allocateEntity();
+                const uint32_t archetype = getArchetype(mask);
+                const uint32_t row = pushRow(archetype, entity);
+                (write(archetype, row, components), ...);
+                m_locations[entity] = { .archetype = archetype, .row = row };
+                return entity;
+            }
+
+            void destroy(Entity entity);
+
+            ///
+            /// @brief Add or overwrite a component, moving the entity to the archetype with it when needed
+            ///
+            template<typename T>
+            void add(const Entity entity, const T& component) {
+                const Location location = m_locations.at(entity);
+                const ComponentMask mask = m_archetypes[location.archetype]->mask;
+                if ((mask & componentBit<T>()) == 0) {
+                    moveEntity(entity, mask | componentBit<T>());
+                }
+                write(m_locations[entity].archetype, m_locations[entity].row, component);
+            }
+
+            template<typename T>
+            void remove(const Entity entity) {
+                const ComponentMask mask = m_archetypes[m_locations.at(entity).archetype]->mask;
+                if ((mask & componentBit<T>()) != 0) {
+                    moveEntity(entity, mask & ~componentBit<T>());
+                }
+            }
+
+            template<typename T>
+            [[nodiscard]] bool has(const Entity entity) const {
+                return (m_archetypes[m_locations.at(entity).archetype]->mask & componentBit<T>()) != 0;
+            }
+
+            template<typename T>
+            [[nodiscard]] T& get(const Entity entity) {
+                const Location location = m_locations.at(entity);
+                Archetype& archetype = *m_archetypes[location.archetype];
+                if ((archetype.mask & componentBit<T>()) == 0) {
+                    throw utl::THROW_ERROR("entity has no such component");
+                }
+                return column<T>(archetype)[location.row];
+            }
+
+            ///
+            /// @return Entities having at least the components Ts
+            ///
+            template<typename... Ts>
+            [[nodiscard]] uint32_t count() const {
+                const ComponentMask mask = (componentBit<Ts>() | ... | 0U);
+                uint32_t total = 0;
+                for (const auto& archetype : m_archetypes) {
+                    if ((archetype->mask & mask) == mask) {
+                        total += static_cast<uint32_t>(archetype->entities.size());
+                    }
+                }
+                return total;
+            }
+            [[nodiscard]] uint32_t getEntityCount() const { return static_cast<uint32_t>(m_locations.size() - m_freeEntities.size()); }
+
+            ///
+            /// @brief Call function(first, entities, columns...) once per archetype having the components Ts
+            ///
+            /// first is the number of rows matched before this archetype, the query order is stable until the next
+            /// structural change so first + i can index arrays built by an earlier query over the same components.
+            /// Ts may be const qualified for read only columns.
+            ///
+            template<typename... Ts, typename Function>
+            void forEachChunk(Function&& function) {
+                const ComponentMask mask = (componentBit<std::remove_const_t<Ts>>() | ... | 0U);
+                uint32_t first = 0;
+                for (const auto& archetype : m_archetypes) {
+                    if ((archetype->mask & mask) != mask || archetype->entities.empty()) {
+                        continue;
+                    }
+                    const size_t size = archetype->entities.size();
+                    function(first, std::span<const Entity>(archetype->entities), std::span<Ts>(column<std::remove_const_t<Ts>>(*archetype), size)...);
+                    first += static_cast<uint32_t>(size);
+                }
+            }
+
+            ///
+            /// @brief Call function(components...) for every entity having the components Ts
+            ///
+            template<typename... Ts, typename Function>
+            void forEach(Function&& function) {
+                forEachChunk<Ts...>([&](uint32_t, const std::span<const Entity> entities, std::span<Ts>... columns) {
+                    for (size_t row = 0; row < entities.size(); row++) {
+                        function(columns[row]...);
+                    }
+                });
+            }
+
+            ///
+            /// @brief forEachChunk with the rows split in ranges run on the thread pool, function must be thread safe
+            ///
+            /// Ranges never span two archetypes and hold at least MIN_PARALLEL_ROWS rows, a small query runs inline.
+            ///
+            template<typename... Ts, typename Function>
+            void parallelForEach(utl::ThreadPool& threadPool, Function&& function) {
+                const ComponentMask mask = (componentBit<std::remove_const_t<Ts>>() | ... | 0U);
+                const uint32_t total = count<std::remove_const_t<Ts>...>();
+                const uint32_t rangeSize = std::max(MIN_PARALLEL_ROWS, (total + threadPool.getThreadCount() - 1) / threadPool.getThreadCount());
+                std::vector<Range> ranges; // local, a function may run another query on the same registry
+                uint32_t first = 0;
+                for (uint32_t index = 0; index < m_archetypes.size(); index++) {
+                    const auto size = static_cast<uint32_t>(m_archetypes[index]->entities.size());
+                    if ((m_archetypes[index]->mask & mask) != mask || size == 0) {
+                        continue;
+                    }
+                    for (uint32_t begin = 0; begin < size; begin += rangeSize) {
+                        ranges.push_back({ .archetype = index, .begin = begin, .end = std::min(size, begin + rangeSize), .first = first + begin });
+                    }
+                    first += size;
+                }
+                const auto runRange = [&](const uint32_t rangeIndex) {
+                    const Range& range = ranges[rangeIndex];
+                    Archetype& archetype = *m_archetypes[range.archetype];
+                    const size_t size = range.end - range.begin;
+                    function(range.first, std::span<const Entity>(archetype.entities).subspan(range.begin, size),
+                             std::span<Ts>(column<std::remove_const_t<Ts>>(archetype) + range.begin, size)...);
+                };
+                if (ranges.size() == 1) {
+                    runRange(0);
+                } else if (!ranges.empty()) {
+                    threadPool.parallelFor(static_cast<uint32_t>(ranges.size()), runRange);
+                }
+            }
+
+        private:
+
+            struct Column {
+                size_t elementSize = 0;
+                std::vector<std::byte> data;
+            };
+
+            struct Archetype {
+                ComponentMask mask = 0;
+                std::vector<Entity> entities;
+                std::array<Column, MAX_COMPONENTS> columns; ///< indexed by component id, empty when not in mask
+            };
+
+            struct Location {
+                uint32_t archetype = 0;
+                uint32_t row = 0;
+            };
+
+            struct Range {
+                uint32_t archetype;
+                uint32_t begin;
+                uint32_t end;
+                uint32_t first;
+            };
+
+            ///
+            /// @brief Id of a component type, assigned on first use and shared by every registry
+            ///
+            template<typename T>
+            static uint32_t componentId() {
+                static_assert(std::is_trivially_copyable_v<T>, "components are moved with memcpy");
+                static const uint32_t id = registerComponent(sizeof(T));
+                return id;
+            }
+            template<typename T>
+            static ComponentMask componentBit() { return ComponentMask{1} << componentId<T>(); }
+            static uint32_t registerComponent(size_t size);
+
+            template<typename T>
+            static T* column(Archetype& archetype) {
+                return reinterpret_cast<T*>(archetype.columns[componentId<T>()].data.data());
+            }
+            template<typename T>
+            void write(const uint32_t archetype, const uint32_t row, const T& component) {
+                std::memcpy(column<T>(*m_archetypes[archetype]) + row, &component, sizeof(T));
+            }
+
+            Entity allocateEntity();
+            uint32_t getArchetype(ComponentMask mask);
+            ///
+            /// @brief Append a zeroed row for entity, its location is left to the caller
+            ///
+            uint32_t pushRow(uint32_t archetype, Entity entity);
+            ///
+            /// @brief Fill the row with the last one of the archetype and update the location of the moved entity
+            ///
+            void removeRow(uint32_t archetype, uint32_t row);
+            void moveEntity(Entity entity, ComponentMask mask);
+
+            static std::array<size_t, MAX_COMPONENTS> s_componentSizes;
+            static uint32_t s_componentCount;
+
+            std::vector<std::unique_ptr<Archetype>> m_archetypes;
+            std::unordered_map<ComponentMask, uint32_t> m_archetypeIndices;
+            std::vector<Location> m_locations; ///< per entity
+            std::vector<Entity> m_freeEntities;
+
+    }; // class Registry
+
+} // namespace ven
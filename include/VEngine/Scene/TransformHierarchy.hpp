@@ -0,0 +1,80 @@
+///
+/// @file TransformHierarchy.hpp
+/// @brief This file contains the TransformHierarchy class
+/// @namespace ven
+///
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Utils/ThreadPool.hpp"
+
+namespace ven {
+
+    ///
+    /// @class TransformHierarchy
+    /// @brief Parent / child transforms whose world matrices are only recomputed below the nodes that changed
+    /// @namespace ven
+    ///
+    /// Nodes are referred to by the handle create returned, their data lives in arrays sorted by depth so a parent
+    /// always comes before its children and a level can be updated in one linear pass. setLocal flags the node, update
+    /// walks the levels from the shallowest flagged one down, recomputing the flagged nodes and the children of
+    /// recomputed ones; levels above it and frames where nothing changed cost nothing.
+    ///
+    class TransformHierarchy {
+
+        public:
+
+            static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+            static constexpr uint32_t PARALLEL_LEVEL_SIZE = 4096; ///< nodes in a level from which update splits it across the thread pool
+
+            ///
+            /// @param parent Handle of an existing node, NONE for a root
+            /// @return Handle of the new node, stable for the lifetime of the hierarchy
+            ///
+            uint32_t create(uint32_t parent, const glm::mat4& local);
+            void setLocal(uint32_t node, const glm::mat4& local);
+            ///
+            /// @brief Propagate the local matrices set since the last call down to the world matrices
+            /// @return true when at least one world matrix changed
+            ///
+            bool update(utl::ThreadPool& threadPool);
+
+            [[nodiscard]] const glm::mat4& getLocal(const uint32_t node) const { return m_locals[m_slots[node]]; }
+            ///
+            /// @note Up to date after update only
+            ///
+            [[nodiscard]] const glm::mat4& getWorld(const uint32_t node) const { return m_worlds[m_slots[node]]; }
+            [[nodiscard]] uint32_t getNodeCount() const { return static_cast<uint32_t>(m_slots.size()); }
+
+        private:
+
+            ///
+            /// @brief Reorder the slots by depth after nodes were created, creation order is kept within a level
+            ///
+            void sort();
+            void updateSlots(uint32_t first, uint32_t last);
+
+            // per handle, only read when sorting
+            std::vector<uint32_t> m_slots; ///< position of the node in the arrays below
+            std::vector<uint32_t> m_parentNodes;
+            std::vector<uint32_t> m_depths;
+            // per slot, depth sorted
+            std::vector<uint32_t> m_parents; ///< slot of the parent, NONE for roots
+            std::vector<glm::mat4> m_locals;
+            std::vector<glm::mat4> m_worlds;
+            std::vector<uint8_t> m_dirty; ///< set by setLocal or by the update of the parent, cleared at the end of update
+            // per depth
+            std::vector<uint32_t> m_levels; ///< first slot of every depth, followed by the slot count
+            std::vector<uint8_t> m_levelDirty; ///< a node of the level was set since the last update
+            uint32_t m_firstDirtyLevel = NONE;
+            bool m_sorted = true;
+
+    }; // class TransformHierarchy
+
+} // namespace ven
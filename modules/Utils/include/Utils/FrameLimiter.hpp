@@ -0,0 +1,56 @@
+///
+/// @file FrameLimiter.hpp
+/// @brief This file contains the FrameLimiter class
+/// @namespace utl
+///
+
+#pragma once
+
+#include <cstdint>
+
+#include "Utils/Clock.hpp"
+
+namespace utl {
+
+    ///
+    /// @class FrameLimiter
+    /// @brief Caps the frame rate by sleeping most of the remaining frame time and spinning the rest
+    /// @namespace utl
+    ///
+    /// The sleep granularity of the OS is measured while running, the limiter only sleeps
+    /// while the remaining time is above the observed mean + standard deviation of a 1 ms sleep.
+    ///
+    class FrameLimiter {
+
+        public:
+
+            FrameLimiter() = default;
+            ~FrameLimiter() = default;
+
+            FrameLimiter(const FrameLimiter&) = delete;
+            FrameLimiter& operator=(const FrameLimiter&) = delete;
+            FrameLimiter(FrameLimiter&&) = delete;
+            FrameLimiter& operator=(FrameLimiter&&) = delete;
+
+            ///
+            /// @param fps Target frame rate, 0 disables the limiter
+            ///
+            void setTargetFps(const float fps) { m_period = fps > 0.0F ? 1.0 / static_cast<double>(fps) : 0.0; }
+            void wait();
+
+            [[nodiscard]] double getSleepEstimate() const { return m_estimate; }
+
+        private:
+
+            void sleepOnce();
+
+            Clock::TimePoint m_deadline;
+            double m_period = 0.0;
+            double m_estimate = 5e-3;
+            double m_mean = 5e-3;
+            double m_m2 = 0.0;
+            uint64_t m_count = 1;
+
+    }; // class FrameLimiter
+
+} // namespace utl
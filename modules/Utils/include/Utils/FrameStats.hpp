@@ -6,11 +6,27 @@
 
 #pragma once
 
+#include <cmath>
 #include <vector>
 #include <string>
 
 namespace ven {
 
+    ///
+    /// @struct RunningStats
+    /// @brief Running mean and variance of a sample stream (Welford)
+    ///
+    struct RunningStats {
+        size_t count{0};
+        double mean{0.0};
+        double m2{0.0};
+
+        void add(const double value) { count++; const double delta = value - mean; mean += delta / static_cast<double>(count); m2 += delta * (value - mean); }
+        void reset() { count = 0; mean = 0.0; m2 = 0.0; }
+        [[nodiscard]] double variance() const { return count > 1 ? m2 / static_cast<double>(count - 1) : 0.0; }
+        [[nodiscard]] double stdDev() const { return std::sqrt(variance()); }
+    };
+
     ///
     /// @class FrameStats
     /// @brief Class for frame statistics
@@ -43,6 +59,11 @@ namespace ven {
             [[nodiscard]] std::vector<float> getDisplayFrameTimes() const;
             [[nodiscard]] static std::vector<float> calculateFPS(const std::vector<float>& frameTimes);
             [[nodiscard]] static float calculateUpperBound(const std::vector<float>& data);
+            ///
+            /// @param sortedData Samples sorted in ascending order
+            /// @param percentile In [0, 100], linearly interpolated between the closest ranks
+            ///
+            [[nodiscard]] static float calculatePercentile(const std::vector<float>& sortedData, float percentile);
             static void exportDataToCSV(const std::vector<float>& frameTimes, const std::vector<float>& fpsTimes, const std::string& filename);
 
         private:
@@ -17,6 +17,11 @@ namespace utl {
         explicit Image(const std::string& path, bool flip = false);
         ~Image();
 
+        ///
+        /// @brief Write tightly packed 8-bit RGBA pixels as a png
+        ///
+        static void writePng(const std::string& path, int width, int height, const unsigned char* pixels);
+
         pixel pixels = nullptr;
         int width = 0;
         int height = 0;
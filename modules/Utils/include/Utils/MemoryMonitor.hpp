@@ -34,6 +34,8 @@ namespace ven {
             [[nodiscard]] double getTotalSwap() const { return swap_total; }
             [[nodiscard]] double getFreeSwap() const { return swap_free; }
             [[nodiscard]] double getProcessMemoryUsage() const { return process_memory_usage; }
+            /// @brief Peak resident set size of the process since it started (VmHWM)
+            [[nodiscard]] double getProcessPeakMemory() const { return process_peak_memory; }
 
         private:
 
@@ -45,6 +47,7 @@ namespace ven {
             double swap_total = 0.0;
             double swap_free = 0.0;
             double process_memory_usage = 0.0;
+            double process_peak_memory = 0.0;
 
     }; // class MemoryMonitor
 
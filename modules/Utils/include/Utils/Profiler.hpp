@@ -0,0 +1,138 @@
+///
+/// @file Profiler.hpp
+/// @brief This file contains the Profiler class and the PROFILE_* macros
+/// @namespace utl
+///
+
+#pragma once
+
+#ifdef UTL_PROFILER
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace utl {
+
+    ///
+    /// @class Profiler
+    /// @brief Scoped CPU zones recorded into per-thread buffers and exported as a Chrome trace_event file
+    /// @namespace utl
+    ///
+    /// Recording a zone only writes to the ring of the calling thread, no lock is taken after the first zone
+    /// of a thread. The first zones of a thread are kept, once its buffer is full the oldest of the later ones are
+    /// overwritten and counted as dropped. The trace can be opened in chrome://tracing or ui.perfetto.dev, nesting is rebuilt from the
+    /// timestamps. Only built with -DENABLE_PROFILER=ON, the PROFILE_* macros expand to nothing otherwise.
+    ///
+    class Profiler {
+
+        public:
+
+            struct Event {
+                const char* name;
+                const char* detail; ///< interned, nullptr when the zone has none
+                int64_t start; ///< ns since the profiler was created
+                int64_t duration; ///< ns
+                uint32_t depth;
+            };
+
+            static Profiler& get();
+
+            Profiler(const Profiler&) = delete;
+            Profiler& operator=(const Profiler&) = delete;
+            Profiler(Profiler&&) = delete;
+            Profiler& operator=(Profiler&&) = delete;
+
+            [[nodiscard]] int64_t now() const { return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_epoch).count(); }
+            /// @return Nesting depth of the new zone on the calling thread
+            uint32_t enter();
+            void leave(const char* name, const char* detail, int64_t start, uint32_t depth);
+            /// @return Copy of text living as long as the profiler, equal texts share it
+            const char* intern(std::string_view text);
+            void setThreadName(const std::string& name);
+
+            ///
+            /// @brief Write every recorded zone to path
+            /// @note Zones recorded while writing may be missed, call it once the other threads are idle
+            ///
+            void writeChromeTrace(const std::string& path);
+
+        private:
+
+            static constexpr size_t MAX_EVENTS_PER_THREAD = 1 << 16; ///< 2.5 MB per thread
+            static constexpr size_t PINNED_EVENTS_PER_THREAD = 1 << 13; ///< never overwritten, the startup zones
+
+            struct ThreadBuffer {
+                uint32_t id = 0;
+                std::string name;
+                uint32_t depth = 0;
+                uint64_t dropped = 0;
+                std::vector<Event> events; ///< the pinned events, then a ring once MAX_EVENTS_PER_THREAD long
+                size_t next = PINNED_EVENTS_PER_THREAD; ///< oldest event of the ring once it is full
+            };
+
+            Profiler() : m_epoch(std::chrono::steady_clock::now()) {}
+            ~Profiler() = default;
+
+            ThreadBuffer& getThreadBuffer();
+
+            std::chrono::steady_clock::time_point m_epoch;
+            std::mutex m_mutex;
+            std::vector<std::unique_ptr<ThreadBuffer>> m_buffers; ///< owned here so zones of exited threads are kept
+            std::unordered_set<std::string> m_interned; ///< node based, the pointers handed out stay valid
+
+    }; // class Profiler
+
+    ///
+    /// @class ProfileZone
+    /// @brief Record the lifetime of the object as a zone, use PROFILE_SCOPE rather than this class
+    /// @namespace utl
+    ///
+    class ProfileZone {
+
+        public:
+
+            explicit ProfileZone(const char* name) : m_name(name), m_depth(Profiler::get().enter()), m_start(Profiler::get().now()) {}
+            ProfileZone(const char* name, const std::string_view detail) : m_name(name), m_detail(Profiler::get().intern(detail)), m_depth(Profiler::get().enter()), m_start(Profiler::get().now()) {}
+            ~ProfileZone() { Profiler::get().leave(m_name, m_detail, m_start, m_depth); }
+
+            ProfileZone(const ProfileZone&) = delete;
+            ProfileZone& operator=(const ProfileZone&) = delete;
+            ProfileZone(ProfileZone&&) = delete;
+            ProfileZone& operator=(ProfileZone&&) = delete;
+
+        private:
+
+            const char* m_name;
+            const char* m_detail = nullptr;
+            uint32_t m_depth;
+            int64_t m_start;
+
+    }; // class ProfileZone
+
+} // namespace utl
+
+#define UTL_PROFILE_CONCAT_IMPL(a, b) a##b
+#define UTL_PROFILE_CONCAT(a, b) UTL_PROFILE_CONCAT_IMPL(a, b)
+/// @param name String literal, only the pointer is stored
+#define PROFILE_SCOPE(name) const utl::ProfileZone UTL_PROFILE_CONCAT(profileZone, __COUNTER__)(name)
+/// @param detail Shown in the args of the zone, interned under a lock: meant for rare zones such as asset loads
+#define PROFILE_SCOPE_DETAIL(name, detail) const utl::ProfileZone UTL_PROFILE_CONCAT(profileZone, __COUNTER__)(name, detail)
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__func__)
+#define PROFILE_THREAD_NAME(name) utl::Profiler::get().setThreadName(name)
+#define PROFILE_WRITE_TRACE(path) utl::Profiler::get().writeChromeTrace(path)
+
+#else
+
+#define PROFILE_SCOPE(name) static_cast<void>(0)
+#define PROFILE_SCOPE_DETAIL(name, detail) static_cast<void>(0)
+#define PROFILE_FUNCTION() static_cast<void>(0)
+#define PROFILE_THREAD_NAME(name) static_cast<void>(0)
+#define PROFILE_WRITE_TRACE(path) static_cast<void>(0)
+
+#endif
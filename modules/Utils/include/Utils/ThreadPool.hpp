@@ -0,0 +1,68 @@
+///
+/// @file ThreadPool.hpp
+/// @brief This file contains the ThreadPool class
+/// @namespace utl
+///
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace utl {
+
+    ///
+    /// @class ThreadPool
+    /// @brief Fixed set of worker threads running indexed tasks, the calling thread takes part in the work
+    /// @namespace utl
+    ///
+    class ThreadPool {
+
+        public:
+
+            using Task = std::function<void(uint32_t)>;
+
+            explicit ThreadPool(uint32_t threadCount = std::max(1U, std::thread::hardware_concurrency()));
+            ~ThreadPool();
+
+            ThreadPool(const ThreadPool&) = delete;
+            ThreadPool& operator=(const ThreadPool&) = delete;
+            ThreadPool(ThreadPool&&) = delete;
+            ThreadPool& operator=(ThreadPool&&) = delete;
+
+            ///
+            /// @brief Run task(0) ... task(taskCount - 1) and block until every task returned
+            /// @note Tasks are picked in index order, which task runs on which thread is unspecified
+            ///
+            void parallelFor(uint32_t taskCount, const Task& task);
+
+            [[nodiscard]] uint32_t getThreadCount() const { return static_cast<uint32_t>(m_workers.size()) + 1; }
+
+        private:
+
+            void workerLoop();
+            void runTasks(const Task& task, uint32_t taskCount);
+
+            std::vector<std::thread> m_workers;
+            std::mutex m_mutex;
+            std::condition_variable m_wakeCondition;
+            std::condition_variable m_doneCondition;
+            const Task* m_task = nullptr;
+            uint32_t m_taskCount = 0;
+            uint32_t m_activeWorkers = 0;
+            uint64_t m_generation = 0;
+            std::atomic<uint32_t> m_nextTask{0};
+            std::atomic<uint32_t> m_remainingTasks{0};
+            std::exception_ptr m_exception;
+            bool m_stop = false;
+
+    }; // class ThreadPool
+
+} // namespace utl
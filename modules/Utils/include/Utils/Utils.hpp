@@ -7,10 +7,13 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace utl {
 
       [[nodiscard]] std::vector<char> readFile(const std::string& filename);
+      /// @brief text as the contents of a JSON string, without the quotes
+      [[nodiscard]] std::string escapeJson(std::string_view text);
 
 } // namespace utl
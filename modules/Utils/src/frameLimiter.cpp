@@ -0,0 +1,40 @@
+#include <cmath>
+#include <thread>
+
+#include "Utils/FrameLimiter.hpp"
+
+static constexpr uint64_t MAX_SLEEP_SAMPLES = 1000;
+
+void utl::FrameLimiter::sleepOnce() {
+    const Clock::TimePoint start = Clock::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    const double observed = std::chrono::duration<double>(Clock::now() - start).count();
+    // Welford's running mean / variance, restarted now and then so the estimate follows the system load
+    if (m_count >= MAX_SLEEP_SAMPLES) {
+        m_count = 1;
+        m_m2 = 0.0;
+    }
+    m_count++;
+    const double delta = observed - m_mean;
+    m_mean += delta / static_cast<double>(m_count);
+    m_m2 += delta * (observed - m_mean);
+    m_estimate = m_mean + std::sqrt(m_m2 / static_cast<double>(m_count - 1));
+}
+
+void utl::FrameLimiter::wait() {
+    if (m_period <= 0.0) {
+        m_deadline = Clock::TimePoint();
+        return;
+    }
+    const auto period = std::chrono::duration_cast<Clock::TimePoint::duration>(std::chrono::duration<double>(m_period));
+    if (const Clock::TimePoint now = Clock::now(); m_deadline == Clock::TimePoint() || now - m_deadline > period) {
+        // first frame or more than a whole frame late: restart from now instead of rushing to catch up
+        m_deadline = now;
+    }
+    m_deadline += period;
+    while (std::chrono::duration<double>(m_deadline - Clock::now()).count() > m_estimate) {
+        sleepOnce();
+    }
+    while (Clock::now() < m_deadline) {
+    }
+}
@@ -32,3 +32,13 @@ float ven::FrameStats::calculateUpperBound(const std::vector<float>& data) {
     const float upperBound = maxValue * 1.2F;
     return upperBound < 0.0005F ? 0.0005F : upperBound;
 }
+
+float ven::FrameStats::calculatePercentile(const std::vector<float>& sortedData, const float percentile) {
+    if (sortedData.empty()) {
+        return 0.0F;
+    }
+    const float rank = std::clamp(percentile, 0.0F, 100.0F) / 100.0F * static_cast<float>(sortedData.size() - 1);
+    const auto lower = static_cast<size_t>(rank);
+    const size_t upper = std::min(lower + 1, sortedData.size() - 1);
+    return sortedData[lower] + ((sortedData[upper] - sortedData[lower]) * (rank - static_cast<float>(lower)));
+}
@@ -1,5 +1,7 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
 
 #include "Utils/ErrorHandling.hpp"
 #include "Utils/Image.hpp"
@@ -15,3 +17,9 @@ utl::Image::Image(const std::string& path, const bool flip) {
 }
 
 utl::Image::~Image() { stbi_image_free(pixels); }
+
+void utl::Image::writePng(const std::string& path, const int width, const int height, const unsigned char* pixels) {
+    if (stbi_write_png(path.c_str(), width, height, STBI_rgb_alpha, pixels, width * STBI_rgb_alpha) == 0) {
+        throw THROW_ERROR(("failed to write image: " + path).c_str());
+    }
+}
@@ -28,4 +28,12 @@ void ven::MemoryMonitor::updateProcessMemory() {
     long rss = 0;
     file >> rss;
     process_memory_usage = rss * sysconf(_SC_PAGE_SIZE) / (KB_TO_MB * KB_TO_MB);
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.starts_with("VmHWM:")) {
+            process_peak_memory = std::stod(line.substr(line.find(':') + 1)) / KB_TO_MB;
+            break;
+        }
+    }
 }
@@ -0,0 +1,101 @@
+#ifdef UTL_PROFILER
+
+#include <fstream>
+
+#include "Utils/ErrorHandling.hpp"
+#include "Utils/Profiler.hpp"
+#include "Utils/Utils.hpp"
+
+static constexpr size_t INITIAL_EVENTS_PER_THREAD = 1 << 12;
+
+utl::Profiler& utl::Profiler::get() {
+    static Profiler profiler;
+    return profiler;
+}
+
+utl::Profiler::ThreadBuffer& utl::Profiler::getThreadBuffer() {
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (buffer == nullptr) {
+        const std::lock_guard lock(m_mutex);
+        auto& created = m_buffers.emplace_back(std::make_unique<ThreadBuffer>());
+        created->id = static_cast<uint32_t>(m_buffers.size());
+        created->name = "Thread " + std::to_string(created->id);
+        created->events.reserve(INITIAL_EVENTS_PER_THREAD);
+        buffer = created.get();
+    }
+    return *buffer;
+}
+
+uint32_t utl::Profiler::enter() {
+    return getThreadBuffer().depth++;
+}
+
+void utl::Profiler::leave(const char* name, const char* detail, const int64_t start, const uint32_t depth) {
+    const int64_t end = now();
+    ThreadBuffer& buffer = getThreadBuffer();
+    buffer.depth = depth;
+    const Event event{ .name = name, .detail = detail, .start = start, .duration = end - start, .depth = depth };
+    if (buffer.events.size() < MAX_EVENTS_PER_THREAD) {
+        buffer.events.push_back(event);
+        return;
+    }
+    buffer.events[buffer.next] = event;
+    buffer.next = buffer.next + 1 == MAX_EVENTS_PER_THREAD ? PINNED_EVENTS_PER_THREAD : buffer.next + 1;
+    buffer.dropped++;
+}
+
+const char* utl::Profiler::intern(const std::string_view text) {
+    const std::lock_guard lock(m_mutex);
+    return m_interned.emplace(text).first->c_str();
+}
+
+void utl::Profiler::setThreadName(const std::string& name) {
+    ThreadBuffer& buffer = getThreadBuffer();
+    const std::lock_guard lock(m_mutex);
+    buffer.name = name;
+}
+
+void utl::Profiler::writeChromeTrace(const std::string& path) {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        throw THROW_ERROR(("failed to open trace file: " + path).c_str());
+    }
+    const std::lock_guard lock(m_mutex);
+    uint64_t dropped = 0;
+    for (const auto& buffer : m_buffers) {
+        dropped += buffer->dropped;
+    }
+    out << R"({"displayTimeUnit":"ns","metadata":{"droppedEvents":)" << dropped << R"(,"pinnedEventsPerThread":)" << PINNED_EVENTS_PER_THREAD
+        << R"(,"maxEventsPerThread":)" << MAX_EVENTS_PER_THREAD << R"(},"traceEvents":[)" << '\n';
+    bool first = true;
+    const auto separator = [&] { out << (first ? "" : ",\n"); first = false; };
+    out.precision(3);
+    out << std::fixed;
+    for (const auto& buffer : m_buffers) {
+        separator();
+        out << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << buffer->id << R"(,"args":{"name":")" << escapeJson(buffer->name) << "\"}}";
+        separator();
+        out << R"({"name":"thread_sort_index","ph":"M","pid":1,"tid":)" << buffer->id << R"(,"args":{"sort_index":)" << buffer->id << "}}";
+        // trace_event timestamps are in microseconds, the fraction keeps the nanoseconds
+        // the pinned events, then the ring from its oldest event
+        const size_t size = buffer->events.size();
+        for (size_t i = 0; i < size; i++) {
+            const Event& event = buffer->events[i < PINNED_EVENTS_PER_THREAD ? i : PINNED_EVENTS_PER_THREAD + ((buffer->next + i - (2 * PINNED_EVENTS_PER_THREAD)) % (size - PINNED_EVENTS_PER_THREAD))];
+            separator();
+            out << R"({"name":")" << escapeJson(event.name) << R"(","cat":"cpu","ph":"X","pid":1,"tid":)" << buffer->id
+                << R"(,"ts":)" << static_cast<double>(event.start) / 1e3 << R"(,"dur":)" << static_cast<double>(event.duration) / 1e3
+                << R"(,"args":{"depth":)" << event.depth;
+            if (event.detail != nullptr) {
+                out << R"(,"detail":")" << escapeJson(event.detail) << '"';
+            }
+            out << "}}";
+        }
+        if (buffer->dropped > 0) {
+            separator();
+            out << R"({"name":"dropped events","ph":"i","s":"t","pid":1,"tid":)" << buffer->id << R"(,"ts":0,"args":{"count":)" << buffer->dropped << "}}";
+        }
+    }
+    out << "\n]}\n";
+}
+
+#endif
@@ -0,0 +1,101 @@
+#include "Utils/Profiler.hpp"
+#include "Utils/ThreadPool.hpp"
+
+utl::ThreadPool::ThreadPool(const uint32_t threadCount) {
+    m_workers.reserve(threadCount > 1 ? threadCount - 1 : 0);
+    for (uint32_t i = 1; i < threadCount; i++) {
+        m_workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+utl::ThreadPool::~ThreadPool() {
+    {
+        const std::lock_guard lock(m_mutex);
+        m_stop = true;
+    }
+    m_wakeCondition.notify_all();
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+void utl::ThreadPool::runTasks(const Task& task, const uint32_t taskCount) {
+    for (uint32_t index = m_nextTask.fetch_add(1); index < taskCount; index = m_nextTask.fetch_add(1)) {
+        try {
+            task(index);
+        } catch (...) {
+            const std::lock_guard lock(m_mutex);
+            if (!m_exception) {
+                m_exception = std::current_exception();
+            }
+        }
+        if (m_remainingTasks.fetch_sub(1) == 1) {
+            const std::lock_guard lock(m_mutex);
+            m_doneCondition.notify_all();
+        }
+    }
+}
+
+void utl::ThreadPool::workerLoop() {
+    PROFILE_THREAD_NAME("Worker");
+    uint64_t seenGeneration = 0;
+    while (true) {
+        const Task* task = nullptr;
+        uint32_t taskCount = 0;
+        {
+            std::unique_lock lock(m_mutex);
+            m_wakeCondition.wait(lock, [&] { return m_stop || m_generation != seenGeneration; });
+            if (m_stop) {
+                return;
+            }
+            seenGeneration = m_generation;
+            task = m_task;
+            taskCount = m_taskCount;
+            if (task == nullptr) {
+                continue;
+            }
+            m_activeWorkers++;
+        }
+        runTasks(*task, taskCount);
+        {
+            const std::lock_guard lock(m_mutex);
+            m_activeWorkers--;
+        }
+        m_doneCondition.notify_all();
+    }
+}
+
+void utl::ThreadPool::parallelFor(const uint32_t taskCount, const Task& task) {
+    if (taskCount == 0) {
+        return;
+    }
+    if (m_workers.empty() || taskCount == 1) {
+        for (uint32_t i = 0; i < taskCount; i++) {
+            task(i);
+        }
+        return;
+    }
+    {
+        const std::lock_guard lock(m_mutex);
+        m_task = &task;
+        m_taskCount = taskCount;
+        m_nextTask = 0;
+        m_remainingTasks = taskCount;
+        m_exception = nullptr;
+        m_generation++;
+    }
+    m_wakeCondition.notify_all();
+    runTasks(task, taskCount);
+    std::exception_ptr exception;
+    {
+        std::unique_lock lock(m_mutex);
+        m_doneCondition.wait(lock, [this] { return m_remainingTasks == 0 && m_activeWorkers == 0; });
+        m_task = nullptr;
+        m_taskCount = 0;
+        exception = m_exception;
+        m_exception = nullptr;
+    }
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+}
@@ -19,3 +19,27 @@ std::vector<char> utl::readFile(const std::string& filename) {
     }
     return buffer;
 }
+
+std::string utl::escapeJson(const std::string_view text) {
+    static constexpr std::string_view HEX = "0123456789abcdef";
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (const char character : text) {
+        const auto code = static_cast<unsigned char>(character);
+        switch (character) {
+            case '"': escaped += "\\\""; break;
+            case '\\': escaped += "\\\\"; break;
+            case '\n': escaped += "\\n"; break;
+            case '\t': escaped += "\\t"; break;
+            default:
+                if (code < 0x20) {
+                    escaped += "\\u00";
+                    escaped += HEX[code >> 4U];
+                    escaped += HEX[code & 0xFU];
+                } else {
+                    escaped += character;
+                }
+        }
+    }
+    return escaped;
+}
@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <numeric>
+
+#include "Utils/ErrorHandling.hpp"
+#include "Utils/FrameStats.hpp"
+#include "Utils/Logger.hpp"
+#include "Utils/Utils.hpp"
+#include "VEngine/Core/Benchmark.hpp"
+
+static constexpr std::array<float, 5> PERCENTILES = {1.0F, 50.0F, 90.0F, 95.0F, 99.0F};
+
+static void writeSeries(std::ofstream& out, const char* name, std::vector<float> values, const bool last) {
+    // frames whose GPU results were never read are NaN
+    std::erase_if(values, [](const float value) { return std::isnan(value); });
+    std::ranges::sort(values);
+    const float mean = values.empty() ? 0.0F : std::accumulate(values.begin(), values.end(), 0.0F) / static_cast<float>(values.size());
+    out << "    \"" << name << "\": {\n";
+    out << "      \"count\": " << values.size() << ",\n";
+    out << "      \"min\": " << (values.empty() ? 0.0F : values.front()) << ",\n";
+    out << "      \"mean\": " << mean << ",\n";
+    for (const float percentile : PERCENTILES) {
+        out << "      \"p" << percentile << "\": " << ven::FrameStats::calculatePercentile(values, percentile) << ",\n";
+    }
+    out << "      \"max\": " << (values.empty() ? 0.0F : values.back()) << "\n";
+    out << "    }" << (last ? "" : ",") << "\n";
+}
+
+void ven::Benchmark::update(Camera& camera, const uint64_t frame) const {
+    if (frame < m_warmupFrames || m_measuredFrames < 2) {
+        m_path.apply(camera, 0.0F);
+        return;
+    }
+    const float progress = static_cast<float>(frame - m_warmupFrames) / static_cast<float>(m_measuredFrames - 1);
+    m_path.apply(camera, progress * m_path.getDuration());
+}
+
+void ven::Benchmark::addFrame(const uint64_t frame, const float frameTime, const float cpuTime) {
+    if (frame < m_warmupFrames) {
+        return;
+    }
+    constexpr float pending = std::numeric_limits<float>::quiet_NaN();
+    m_samples.push_back({ .frameTime = frameTime, .cpuTime = cpuTime, .gpuTime = pending, .fragmentInvocations = pending });
+}
+
+void ven::Benchmark::addGpuFrame(const uint64_t frame, const float gpuTime, const uint64_t fragmentInvocations) {
+    if (frame < m_warmupFrames || frame - m_warmupFrames >= m_samples.size()) {
+        return;
+    }
+    Sample& sample = m_samples[frame - m_warmupFrames];
+    sample.gpuTime = gpuTime;
+    sample.fragmentInvocations = static_cast<float>(fragmentInvocations) / 1e6F;
+}
+
+void ven::Benchmark::writeReport(const LoadTimes& loadTimes, MemoryMonitor& memoryMonitor) const {
+    std::ofstream out(m_reportPath);
+    if (!out.is_open()) {
+        throw utl::THROW_ERROR(("failed to open benchmark report: " + m_reportPath).c_str());
+    }
+    memoryMonitor.update();
+    const auto series = [this](float Sample::* field) {
+        std::vector<float> values(m_samples.size());
+        std::ranges::transform(m_samples, values.begin(), field);
+        return values;
+    };
+    out << "{\n";
+    out << "  \"warmupFrames\": " << m_warmupFrames << ",\n";
+    out << "  \"measuredFrames\": " << m_samples.size() << ",\n";
+    out << "  \"frameTimesMs\": {\n";
+    writeSeries(out, "frame", series(&Sample::frameTime), false);
+    writeSeries(out, "cpu", series(&Sample::cpuTime), false);
+    writeSeries(out, "gpu", series(&Sample::gpuTime), true);
+    out << "  },\n";
+    out << "  \"gpuStatisticsMillions\": {\n";
+    writeSeries(out, "fragmentInvocations", series(&Sample::fragmentInvocations), true);
+    out << "  },\n";
+    out << "  \"loadTimesS\": {\n";
+    for (size_t i = 0; i < loadTimes.size(); i++) {
+        out << "    \"" << utl::escapeJson(loadTimes[i].first) << "\": " << loadTimes[i].second << (i + 1 < loadTimes.size() ? "," : "") << "\n";
+    }
+    out << "  },\n";
+    out << "  \"memoryMb\": {\n";
+    out << "    \"processPeak\": " << memoryMonitor.getProcessPeakMemory() << ",\n";
+    out << "    \"processEnd\": " << memoryMonitor.getProcessMemoryUsage() << "\n";
+    out << "  }\n";
+    out << "}\n";
+    utl::Logger::logInfo("Benchmark report written to " + m_reportPath);
+}
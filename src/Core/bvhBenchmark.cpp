@@ -0,0 +1,260 @@
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <random>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "Utils/Clock.hpp"
+#include "Utils/ErrorHandling.hpp"
+#include "Utils/Logger.hpp"
+#include "VEngine/Core/BvhBenchmark.hpp"
+#include "VEngine/Scene/Bvh.hpp"
+
+namespace {
+
+    constexpr uint32_t SEED = 42;
+    constexpr uint32_t BUILD_RUNS = 5;
+
+    struct Result {
+        uint32_t objects = 0;
+        uint32_t nodes = 0;
+        float buildSerialMs = 0.0F;
+        float buildParallelMs = 0.0F;
+        float refitMs = 0.0F;
+        // microseconds per query
+        float frustumBvh = 0.0F;
+        float frustumBrute = 0.0F;
+        float frustumSimd = 0.0F;
+        float frustumSimdParallel = 0.0F; ///< split across the thread pool like Renderer::cullDraws
+        float rayBvh = 0.0F;
+        float rayBrute = 0.0F;
+        float radiusBvh = 0.0F;
+        float radiusBrute = 0.0F;
+    };
+
+    struct Ray {
+        glm::vec3 origin;
+        glm::vec3 direction;
+    };
+
+    template<typename Function>
+    float measureMs(Function&& function) {
+        const utl::Clock::TimePoint start = utl::Clock::now();
+        function();
+        return std::chrono::duration<float, std::milli>(utl::Clock::now() - start).count();
+    }
+
+    template<typename Function>
+    float medianMs(const uint32_t runs, Function&& function) {
+        std::vector<float> times(runs);
+        for (float& time : times) {
+            time = measureMs(function);
+        }
+        std::ranges::nth_element(times, times.begin() + (runs / 2));
+        return times[runs / 2];
+    }
+
+    // reference tests, the same box-only semantics as the Bvh so the results can be compared exactly
+
+    bool outsideFrustum(const std::array<glm::vec4, 6>& planes, const ven::Bounds& bounds) {
+        // through the corners like the Bvh, the rounding is then the same
+        const glm::vec3 min = bounds.center - bounds.extent;
+        const glm::vec3 max = bounds.center + bounds.extent;
+        const glm::vec3 center = (min + max) * 0.5F;
+        const glm::vec3 extent = (max - min) * 0.5F;
+        return std::ranges::any_of(planes, [&](const glm::vec4& plane) {
+            return glm::dot(glm::vec3(plane), center) + plane.w + glm::dot(glm::abs(glm::vec3(plane)), extent) < 0.0F;
+        });
+    }
+
+    float rayDistance(const ven::Bounds& bounds, const Ray& ray, const glm::vec3& inverseDirection) {
+        const glm::vec3 near = (bounds.center - bounds.extent - ray.origin) * inverseDirection;
+        const glm::vec3 far = (bounds.center + bounds.extent - ray.origin) * inverseDirection;
+        const glm::vec3 entry = glm::min(near, far);
+        const glm::vec3 exit = glm::max(near, far);
+        const float tEntry = glm::max(glm::max(entry.x, entry.y), glm::max(entry.z, 0.0F));
+        const float tExit = glm::min(glm::min(exit.x, exit.y), exit.z);
+        return tEntry <= tExit ? tEntry : -1.0F;
+    }
+
+    bool overlapsSphere(const ven::Bounds& bounds, const glm::vec3& center, const float radius) {
+        const glm::vec3 offset = glm::clamp(center, bounds.center - bounds.extent, bounds.center + bounds.extent) - center;
+        return glm::dot(offset, offset) <= radius * radius;
+    }
+
+    void check(const bool condition, const std::string& what, const uint32_t objects) {
+        if (!condition) {
+            throw utl::THROW_ERROR(("bvh " + what + " differs from brute force with " + std::to_string(objects) + " objects").c_str());
+        }
+    }
+
+    Result measure(const uint32_t objectCount, utl::ThreadPool& threadPool) {
+        Result result{ .objects = objectCount };
+        std::mt19937 random(SEED + objectCount);
+        // constant density: the cube grows with the object count
+        const float halfSize = 10.0F * std::cbrt(static_cast<float>(objectCount));
+        std::uniform_real_distribution position(-halfSize, halfSize);
+        std::uniform_real_distribution size(0.2F, 1.0F);
+        std::uniform_real_distribution unit(-1.0F, 1.0F);
+        std::vector<ven::Bounds> bounds(objectCount);
+        for (ven::Bounds& object : bounds) {
+            object.center = {position(random), position(random), position(random)};
+            object.extent = {size(random), size(random), size(random)};
+            object.radius = glm::length(object.extent);
+        }
+        ven::Bvh bvh;
+        result.buildSerialMs = medianMs(BUILD_RUNS, [&] { bvh.build(bounds, nullptr); });
+        result.buildParallelMs = medianMs(BUILD_RUNS, [&] { bvh.build(bounds, &threadPool); });
+        result.nodes = static_cast<uint32_t>(bvh.getNodes().size());
+        std::vector<ven::Bounds> moved = bounds;
+        for (ven::Bounds& object : moved) {
+            object.center += glm::vec3(unit(random), unit(random), unit(random));
+        }
+        result.refitMs = medianMs(BUILD_RUNS, [&] { bvh.refit(moved); });
+        bvh.build(bounds, &threadPool);
+
+        std::vector<ven::Frustum> frustums;
+        std::vector<Ray> rays;
+        std::vector<glm::vec3> centers;
+        for (uint32_t i = 0; i < ven::BvhBenchmark::QUERY_COUNT; i++) {
+            const glm::vec3 eye(position(random), position(random), position(random));
+            const glm::vec3 direction = glm::normalize(glm::vec3(unit(random), unit(random), unit(random)) + glm::vec3(0.0F, 0.0F, 1e-3F));
+            frustums.emplace_back(glm::perspective(glm::radians(60.0F), 16.0F / 9.0F, 0.1F, halfSize) * glm::lookAt(eye, eye + direction, glm::vec3(0.0F, 1.0F, 0.0F)));
+            rays.push_back({ .origin = eye, .direction = direction });
+            centers.push_back(eye);
+        }
+        const float radius = halfSize * 0.1F;
+        const auto perQuery = [](const float ms) { return ms * 1000.0F / static_cast<float>(ven::BvhBenchmark::QUERY_COUNT); };
+
+        ven::BoundsSoA soa;
+        soa.resize(objectCount);
+        for (uint32_t object = 0; object < objectCount; object++) {
+            soa.set(object, bounds[object]);
+        }
+        const size_t padded = soa.centerX.size();
+        const uint32_t rangeCount = threadPool.getThreadCount();
+        const size_t rangeSize = (padded / ven::BoundsSoA::LANES + rangeCount - 1) / rangeCount * ven::BoundsSoA::LANES;
+        std::vector<uint8_t> visible;
+        std::vector<uint8_t> visibleParallel(padded);
+        const auto cullParallel = [&](const ven::Frustum& frustum) {
+            threadPool.parallelFor(rangeCount, [&](const uint32_t range) {
+                frustum.cullRange(soa, visibleParallel, std::min(padded, range * rangeSize), std::min(padded, (range + 1) * rangeSize));
+            });
+        };
+
+        // correctness first, on every query: the same objects, not only as many
+        std::vector<uint32_t> found;
+        std::vector<uint32_t> expected;
+        const auto sameObjects = [&](const auto& predicate) {
+            std::ranges::sort(found);
+            expected.clear();
+            for (uint32_t object = 0; object < objectCount; object++) {
+                if (predicate(bounds[object])) {
+                    expected.push_back(object);
+                }
+            }
+            return found == expected;
+        };
+        for (uint32_t i = 0; i < ven::BvhBenchmark::QUERY_COUNT; i++) {
+            found.clear();
+            bvh.queryFrustum(frustums[i], found);
+            check(sameObjects([&](const ven::Bounds& object) { return !outsideFrustum(frustums[i].getPlanes(), object); }), "frustum query", objectCount);
+            frustums[i].cull(soa, visible);
+            cullParallel(frustums[i]);
+            check(std::equal(visible.begin(), visible.end(), visibleParallel.begin()), "parallel frustum test", objectCount);
+            found.clear();
+            bvh.queryRadius(centers[i], radius, found);
+            check(sameObjects([&](const ven::Bounds& object) { return overlapsSphere(object, centers[i], radius); }), "radius query", objectCount);
+            const std::optional<ven::RayHit> hit = bvh.raycast(rays[i].origin, rays[i].direction);
+            float nearest = std::numeric_limits<float>::max();
+            for (const ven::Bounds& object : bounds) {
+                if (const float distance = rayDistance(object, rays[i], 1.0F / rays[i].direction); distance >= 0.0F) {
+                    nearest = std::min(nearest, distance);
+                }
+            }
+            check(hit.has_value() == (nearest != std::numeric_limits<float>::max()) && (!hit || hit->distance == nearest), "ray cast", objectCount);
+        }
+
+        // sink keeps the brute force loops from being optimized away
+        size_t sink = 0;
+        result.frustumBvh = perQuery(measureMs([&] { for (const ven::Frustum& frustum : frustums) { found.clear(); bvh.queryFrustum(frustum, found); sink += found.size(); } }));
+        result.frustumBrute = perQuery(measureMs([&] {
+            for (const ven::Frustum& frustum : frustums) {
+                found.clear();
+                for (uint32_t object = 0; object < objectCount; object++) {
+                    if (!outsideFrustum(frustum.getPlanes(), bounds[object])) {
+                        found.push_back(object);
+                    }
+                }
+                sink += found.size();
+            }
+        }));
+        result.frustumSimd = perQuery(measureMs([&] { for (const ven::Frustum& frustum : frustums) { frustum.cull(soa, visible); sink += visible[0]; } }));
+        result.frustumSimdParallel = perQuery(measureMs([&] { for (const ven::Frustum& frustum : frustums) { cullParallel(frustum); sink += visibleParallel[0]; } }));
+        result.rayBvh = perQuery(measureMs([&] { for (const Ray& ray : rays) { sink += bvh.raycast(ray.origin, ray.direction).has_value() ? 1 : 0; } }));
+        result.rayBrute = perQuery(measureMs([&] {
+            for (const Ray& ray : rays) {
+                const glm::vec3 inverseDirection = 1.0F / ray.direction;
+                float nearest = std::numeric_limits<float>::max();
+                for (const ven::Bounds& object : bounds) {
+                    if (const float distance = rayDistance(object, ray, inverseDirection); distance >= 0.0F) {
+                        nearest = std::min(nearest, distance);
+                    }
+                }
+                sink += nearest < std::numeric_limits<float>::max() ? 1 : 0;
+            }
+        }));
+        result.radiusBvh = perQuery(measureMs([&] { for (const glm::vec3& center : centers) { found.clear(); bvh.queryRadius(center, radius, found); sink += found.size(); } }));
+        result.radiusBrute = perQuery(measureMs([&] {
+            for (const glm::vec3& center : centers) {
+                found.clear();
+                for (uint32_t object = 0; object < objectCount; object++) {
+                    if (overlapsSphere(bounds[object], center, radius)) {
+                        found.push_back(object);
+                    }
+                }
+                sink += found.size();
+            }
+        }));
+        if (sink == 0) {
+            utl::Logger::logWarning("bvh benchmark queries found nothing");
+        }
+        return result;
+    }
+
+} // namespace
+
+void ven::BvhBenchmark::run() const {
+    utl::ThreadPool threadPool;
+    std::vector<Result> results;
+    for (const uint32_t objectCount : OBJECT_COUNTS) {
+        results.push_back(measure(objectCount, threadPool));
+        const Result& result = results.back();
+        utl::Logger::logInfo(std::to_string(objectCount) + " objects: build " + std::to_string(result.buildParallelMs) + " ms, frustum " + std::to_string(result.frustumBvh) + " us bvh, " +
+                             std::to_string(result.frustumSimd) + " us simd, " + std::to_string(result.frustumSimdParallel) + " us parallel, ray " + std::to_string(result.rayBvh) + " us vs " + std::to_string(result.rayBrute) + " us");
+    }
+    std::ofstream out(m_reportPath);
+    if (!out.is_open()) {
+        throw utl::THROW_ERROR(("failed to open benchmark report: " + m_reportPath).c_str());
+    }
+    out << "{\n";
+    out << "  \"threads\": " << threadPool.getThreadCount() << ",\n";
+    out << "  \"queries\": " << QUERY_COUNT << ",\n";
+    out << "  \"bvh\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& result = results[i];
+        out << "    {\n";
+        out << "      \"objects\": " << result.objects << ",\n";
+        out << "      \"nodes\": " << result.nodes << ",\n";
+        out << "      \"buildMs\": { \"serial\": " << result.buildSerialMs << ", \"parallel\": " << result.buildParallelMs << " },\n";
+        out << "      \"refitMs\": " << result.refitMs << ",\n";
+        out << "      \"frustumUs\": { \"bvh\": " << result.frustumBvh << ", \"bruteForce\": " << result.frustumBrute << ", \"bruteForceSimd\": " << result.frustumSimd << ", \"bruteForceParallel\": " << result.frustumSimdParallel << " },\n";
+        out << "      \"rayUs\": { \"bvh\": " << result.rayBvh << ", \"bruteForce\": " << result.rayBrute << " },\n";
+        out << "      \"radiusUs\": { \"bvh\": " << result.radiusBvh << ", \"bruteForce\": " << result.radiusBrute << " }\n";
+        out << "    }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n";
+    out << "}\n";
+    utl::Logger::logInfo("Bvh benchmark report written to " + m_reportPath);
+}
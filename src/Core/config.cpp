@@ -0,0 +1,95 @@
+#include <string_view>
+
+#include "Utils/ErrorHandling.hpp"
+#include "Utils/Logger.hpp"
+#include "VEngine/Core/Config.hpp"
+
+static constexpr uint32_t DEFAULT_BENCHMARK_FRAMES = 1000;
+static constexpr uint32_t DEFAULT_HEADLESS_FRAMES = 100;
+
+static std::string_view nextArgument(const int argc, const char* const* argv, int& index) {
+    if (index + 1 >= argc) {
+        throw utl::THROW_ERROR(("missing value after " + std::string(argv[index])).c_str());
+    }
+    return argv[++index];
+}
+
+static uint32_t toUnsigned(const std::string_view value) {
+    try {
+        return static_cast<uint32_t>(std::stoul(std::string(value)));
+    } catch (const std::exception&) {
+        throw utl::THROW_ERROR(("invalid number: " + std::string(value)).c_str());
+    }
+}
+
+ven::Config ven::Config::parse(const int argc, const char* const* argv) {
+    Config config;
+    for (int i = 1; i < argc; i++) {
+        const std::string_view argument = argv[i];
+        if (argument == "--headless") {
+            config.headless = true;
+        } else if (argument == "--frames") {
+            config.frameCount = toUnsigned(nextArgument(argc, argv, i));
+        } else if (argument == "--dump-dir") {
+            config.dumpDirectory = nextArgument(argc, argv, i);
+        } else if (argument == "--benchmark") {
+            config.benchmarkPath = nextArgument(argc, argv, i);
+        } else if (argument == "--bvh-benchmark") {
+            config.bvhBenchmark = true;
+        } else if (argument == "--depth-prepass") {
+            config.depthPrepass = true;
+        } else if (argument == "--lights") {
+            config.lightCount = toUnsigned(nextArgument(argc, argv, i));
+        } else if (argument == "--warmup") {
+            config.warmupFrames = toUnsigned(nextArgument(argc, argv, i));
+        } else if (argument == "--report") {
+            config.reportPath = nextArgument(argc, argv, i);
+        } else if (argument == "--trace") {
+            config.tracePath = nextArgument(argc, argv, i);
+#ifndef UTL_PROFILER
+            utl::Logger::logWarning("--trace needs a build with ENABLE_PROFILER, no trace will be written");
+#endif
+        } else if (argument == "--record") {
+            config.recordPath = nextArgument(argc, argv, i);
+        } else if (argument == "--replay") {
+            config.replayPath = nextArgument(argc, argv, i);
+        } else if (argument == "--replay-rate") {
+            const uint32_t rate = toUnsigned(nextArgument(argc, argv, i));
+            config.replayStep = rate > 0 ? 1.0F / static_cast<float>(rate) : 0.0F;
+        } else if (argument == "--frame-trace") {
+            config.frameTracePath = nextArgument(argc, argv, i);
+        } else if (argument == "--sim-rate") {
+            config.simulationRate = toUnsigned(nextArgument(argc, argv, i));
+        } else if (argument == "--size") {
+            const std::string_view size = nextArgument(argc, argv, i);
+            const size_t separator = size.find('x');
+            if (separator == std::string_view::npos) {
+                throw utl::THROW_ERROR("--size expects <width>x<height>");
+            }
+            config.width = static_cast<uint16_t>(toUnsigned(size.substr(0, separator)));
+            config.height = static_cast<uint16_t>(toUnsigned(size.substr(separator + 1)));
+        } else {
+            throw utl::THROW_ERROR(("unknown argument: " + std::string(argument)).c_str());
+        }
+    }
+    if (!config.dumpDirectory.empty() && !config.headless) {
+        utl::Logger::logWarning("--dump-dir is only supported with --headless, frames will not be written");
+        config.dumpDirectory.clear();
+    }
+    if (!config.replayPath.empty() && !config.benchmarkPath.empty()) {
+        throw utl::THROW_ERROR("--replay and --benchmark both drive the camera, use one of them");
+    }
+    if (!config.recordPath.empty() && (!config.replayPath.empty() || !config.benchmarkPath.empty() || config.headless)) {
+        utl::Logger::logWarning("--record needs the window input, nothing will be recorded");
+        config.recordPath.clear();
+    }
+    if (!config.benchmarkPath.empty() && config.frameCount == 0) {
+        config.frameCount = DEFAULT_BENCHMARK_FRAMES;
+    }
+    // a replay ends with its recording, nothing else would end a run without a window
+    if (config.headless && config.frameCount == 0 && config.replayPath.empty()) {
+        utl::Logger::logWarning("--headless without --frames, " + std::to_string(DEFAULT_HEADLESS_FRAMES) + " frames will be rendered");
+        config.frameCount = DEFAULT_HEADLESS_FRAMES;
+    }
+    return config;
+}
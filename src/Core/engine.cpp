@@ -1,87 +1,418 @@
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <random>
+
+#include <glm/gtc/matrix_transform.hpp>
+
 #include "Utils/Logger.hpp"
+#include "Utils/Profiler.hpp"
 #include "VEngine/Core/Engine.hpp"
 
+/// @return milliseconds elapsed since mark, which is moved to now
+static float lap(utl::Clock::TimePoint& mark) {
+    const utl::Clock::TimePoint now = utl::Clock::now();
+    const float elapsed = std::chrono::duration<float, std::milli>(now - mark).count();
+    mark = now;
+    return elapsed;
+}
+
 void ven::Engine::init() {
+    PROFILE_FUNCTION();
     m_descriptorSetLayout.create(TextureManager::getTextureSize());
+    m_renderer.setDepthPrepass(m_config.depthPrepass);
     m_renderer.getShadersModule().createPipeline(m_device.getMsaaSamples(), m_descriptorSetLayout.getDescriptorSetLayout(), m_renderer.getSwapChain().getRenderPass());
-    createUniformBuffers();
-    m_descriptorSets.create(Renderer::UNIFORM_BUFFER_SIZE);
+    createMappedBuffers(Renderer::UNIFORM_BUFFER_SIZE, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, m_uniformBuffers, m_uniformBuffersMemory, m_uniformBuffersMapped);
+    createMappedBuffers(Renderer::getObjectBufferSize(m_objectCount), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, m_objectBuffers, m_objectBuffersMemory, m_objectBuffersMapped);
+    createMappedBuffers(Renderer::getInstanceBufferSize(m_objectCount), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, m_instanceBuffers, m_instanceBuffersMemory, m_instanceBuffersMapped);
+    createLightBuffers();
+    m_renderer.initShadows(m_objectBuffers, Renderer::getObjectBufferSize(m_objectCount), m_objectCount);
+    m_descriptorSets.create(Renderer::UNIFORM_BUFFER_SIZE, Renderer::getObjectBufferSize(m_objectCount), Renderer::getInstanceBufferSize(m_objectCount),
+                            ClusteredLighting::LIGHT_BUFFER_SIZE, ClusteredLighting::CLUSTER_BUFFER_SIZE, m_renderer.getShadowMapInfo());
+    m_renderer.initGpuCulling(m_drawGroups, m_scene, m_uniformBuffers, m_objectBuffers, Renderer::getObjectBufferSize(m_objectCount), m_instanceBuffers, Renderer::getInstanceBufferSize(m_objectCount));
+    m_renderer.initClusteredLighting(m_uniformBuffers, m_lightBuffers, m_clusterBuffers);
     m_renderer.createCommandBuffers(m_commandBuffers);
 }
 
 void ven::Engine::loadAssets() {
+    PROFILE_FUNCTION();
     std::vector<std::string> modelPaths = {"assets/models/sponza/sponza.obj", "assets/models/book.obj", "assets/models/viking_room.obj"};
     std::vector<Vertex> vertices;
     std::vector<uint32_t> indices;
-    uint32_t vertexOffset = 0;
+    const utl::Clock loadClock;
+    glm::vec3 sceneMin(std::numeric_limits<float>::max());
+    glm::vec3 sceneMax(std::numeric_limits<float>::lowest());
     TextureManager::loadTextures(m_device, m_renderer.getSwapChain(), "assets/textures");
+    m_loadTimes.emplace_back("textures", loadClock.getDeltaSeconds());
     for (const auto& path : modelPaths) {
-        utl::Logger::logExecutionTime("Loading model: " + path, [&] { m_models.emplace_back(m_device, m_renderer.getSwapChain(), path); });
-        for (Model& model = m_models.back(); const auto& mesh : model.getMeshes()) {
-            for (const auto& vertex : mesh->getVertices()) {
-                vertices.push_back(vertex);
+        const utl::Clock modelClock;
+        std::unique_ptr<Model> model;
+        utl::Logger::logExecutionTime("Loading model: " + path, [&] { model = std::make_unique<Model>(m_device, m_renderer.getSwapChain(), path); });
+        m_loadTimes.emplace_back(path, modelClock.getDeltaSeconds());
+        // the model root carries the editable Transform, the nodes of the file hang below it
+        const Transform transform;
+        const uint32_t root = m_transforms.create(TransformHierarchy::NONE, transform.getMatrix());
+        m_scene.create(transform, TransformNode{ .node = root });
+        std::vector<uint32_t> nodes(model->getNodes().size());
+        // the model root is the identity until edited, a parent always comes before its children
+        std::vector<glm::mat4> nodeWorlds(nodes.size());
+        for (size_t i = 0; i < nodes.size(); i++) {
+            const ModelNode& node = model->getNodes().at(i);
+            nodes[i] = m_transforms.create(node.parent == ModelNode::NO_PARENT ? root : nodes.at(node.parent), node.local);
+            nodeWorlds[i] = node.parent == ModelNode::NO_PARENT ? node.local : nodeWorlds.at(node.parent) * node.local;
+        }
+        // every mesh is uploaded once, its placements in the node tree become entities drawn by one instanced draw
+        for (uint32_t meshIndex = 0; meshIndex < model->getMeshes().size(); meshIndex++) {
+            const auto& mesh = model->getMeshes().at(meshIndex);
+            const auto group = static_cast<uint32_t>(m_drawGroups.size());
+            uint32_t objectCount = 0;
+            for (const MeshInstance& instance : model->getInstances()) {
+                if (instance.mesh == meshIndex) {
+                    m_scene.create(TransformNode{ .node = nodes.at(instance.node) }, WorldMatrix{}, MeshRef{ .group = group }, WorldBounds{});
+                    const Bounds bounds = mesh->getBounds().transform(nodeWorlds.at(instance.node));
+                    sceneMin = glm::min(sceneMin, bounds.center - bounds.extent);
+                    sceneMax = glm::max(sceneMax, bounds.center + bounds.extent);
+                    objectCount++;
+                }
             }
-            for (const auto& index : mesh->getIndices()) {
-                indices.push_back(index + vertexOffset);
+            if (objectCount > 0) {
+                m_drawGroups.push_back({ .indexCount = static_cast<uint32_t>(mesh->getIndices().size()), .firstIndex = static_cast<uint32_t>(indices.size()), .vertexOffset = static_cast<int32_t>(vertices.size()),
+                                         .instanceOffset = m_objectCount, .objectCount = objectCount, .bounds = mesh->getBounds(), .alphaMode = mesh->getAlphaMode(), .material = mesh->getTextureIndex() });
+                m_objectCount += objectCount;
             }
-            vertexOffset += static_cast<uint32_t>(mesh->getVertices().size());
+            vertices.insert(vertices.end(), mesh->getVertices().begin(), mesh->getVertices().end());
+            indices.insert(indices.end(), mesh->getIndices().begin(), mesh->getIndices().end());
         }
     }
+    sortDrawGroups();
+    if (m_objectCount > 0) {
+        m_sceneBounds = { .center = (sceneMin + sceneMax) * 0.5F, .extent = (sceneMax - sceneMin) * 0.5F, .radius = glm::length(sceneMax - sceneMin) * 0.5F };
+    }
+    createLights(m_config.lightCount);
     utl::Logger::logInfo("Textures loaded: " + std::to_string(TextureManager::getTextureSize()));
-    m_indicesSize = static_cast<uint32_t>(indices.size());
+    utl::Logger::logInfo("Meshes: " + std::to_string(m_drawGroups.size()) + ", objects: " + std::to_string(m_objectCount));
     Model::createBuffer(m_device, vertices, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, m_vertexBuffer, m_vertexBufferMemory);
     Model::createBuffer(m_device, indices, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, m_indexBuffer, m_indexBufferMemory);
+    m_loadTimes.emplace_back("total", loadClock.getDeltaSeconds());
+}
+
+void ven::Engine::sortDrawGroups() {
+    // each alpha mode becomes a contiguous range of groups, the GPU culling draws a range with one pipeline
+    std::vector<uint32_t> order(m_drawGroups.size());
+    std::iota(order.begin(), order.end(), 0U);
+    std::ranges::stable_sort(order, {}, [&](const uint32_t group) { return m_drawGroups[group].alphaMode; });
+    std::vector<uint32_t> remap(m_drawGroups.size());
+    std::vector<DrawGroup> sorted;
+    sorted.reserve(m_drawGroups.size());
+    uint32_t instanceOffset = 0;
+    for (size_t i = 0; i < order.size(); i++) {
+        remap[order[i]] = static_cast<uint32_t>(i);
+        sorted.push_back(m_drawGroups[order[i]]);
+        sorted.back().instanceOffset = instanceOffset;
+        instanceOffset += sorted.back().objectCount;
+    }
+    m_drawGroups = std::move(sorted);
+    m_scene.forEach<MeshRef>([&](MeshRef& mesh) { mesh.group = remap[mesh.group]; });
+}
+
+void ven::Engine::createLights(const uint32_t count) {
+    // same seed every run, benchmarks compare the same lights
+    std::mt19937 random(count);
+    std::uniform_real_distribution unit(-1.0F, 1.0F);
+    std::uniform_real_distribution hue(0.0F, 1.0F);
+    // about as many lights reach a point whatever the count, so the cluster lists stay short
+    const float range = std::max(1.0F, m_sceneBounds.radius * 0.05F);
+    for (uint32_t i = 0; i < count; i++) {
+        const glm::vec3 position = m_sceneBounds.center + m_sceneBounds.extent * glm::vec3(unit(random), unit(random), unit(random));
+        // saturated color of a random hue
+        const glm::vec3 color = glm::clamp(glm::abs(glm::fract(glm::vec3(hue(random)) + glm::vec3(1.0F, 2.0F / 3.0F, 1.0F / 3.0F)) * 6.0F - 3.0F) - 1.0F, 0.0F, 1.0F);
+        Light light{ .color = color, .intensity = 2.0F, .range = range };
+        glm::mat4 local = glm::translate(glm::mat4(1.0F), position);
+        if (i % 4 == 3) {
+            // -Z turned to -Y, the spot lights the floor below it
+            light.type = LightType::SPOT;
+            light.range = range * 2.0F;
+            local = glm::rotate(local, glm::radians(-90.0F), glm::vec3(1.0F, 0.0F, 0.0F));
+        }
+        m_scene.create(light, TransformNode{ .node = m_transforms.create(TransformHierarchy::NONE, local) });
+    }
+    if (count > ClusteredLighting::MAX_LIGHTS) {
+        utl::Logger::logWarning("Lights: only the first " + std::to_string(ClusteredLighting::MAX_LIGHTS) + " of " + std::to_string(count) + " are drawn");
+    }
 }
 
 void ven::Engine::run() {
-    while (!m_window.shouldClose()) {
-        m_eventManager.handleEvents(m_clock.getDeltaSeconds());
+    uint64_t frameCount = m_benchmark != nullptr ? m_benchmark->getFrameCount() : m_config.frameCount;
+    const bool replay = !m_config.replayPath.empty();
+    if (replay) {
+        m_eventManager.loadReplay(m_config.replayPath);
+        frameCount = frameCount == 0 ? m_eventManager.getReplayFrameCount() : std::min<uint64_t>(frameCount, m_eventManager.getReplayFrameCount());
+    }
+    if (!m_config.recordPath.empty()) {
+        m_eventManager.startRecording();
+    }
+    if (!m_config.frameTracePath.empty()) {
+        m_frameTrace.reserve(frameCount);
+    }
+    for (uint64_t frame = 0; !m_window.shouldClose() && (frameCount == 0 || frame < frameCount); frame++) {
+        const utl::Clock::TimePoint frameStart = utl::Clock::now();
+        utl::Clock::TimePoint mark = frameStart;
+        PROFILE_SCOPE("frame");
+        m_frameLimiter.setTargetFps(m_renderer.getSettings().maxFps);
+        {
+            PROFILE_SCOPE("frameLimiter");
+            m_frameLimiter.wait();
+        }
+        m_frameTimings.limiterWait = lap(mark);
+        if (m_benchmark != nullptr) {
+            // the path drives the camera, events are still pumped so the window stays responsive
+            if (!m_window.isHeadless()) {
+                m_window.pollEvents();
+            }
+            m_benchmark->update(m_renderer.getCamera(), frame);
+        } else if (replay) {
+            m_eventManager.replayEvents(frame, m_config.replayStep);
+        } else if (!m_window.isHeadless() && m_config.simulationRate > 0) {
+            simulate();
+        } else if (!m_window.isHeadless()) {
+            m_eventManager.handleEvents(m_clock.getDeltaSeconds());
+        }
         m_clock.restart();
-        drawFrame();
+        m_frameTimings.input = lap(mark);
+        drawFrame(frame);
+        const float frameTime = std::chrono::duration<float, std::milli>(utl::Clock::now() - frameStart).count();
+        // the GPU results read this frame belong to the frame submitted frames in flight earlier on the same slot
+        const RenderStats& stats = m_renderer.getStats();
+        if (m_benchmark != nullptr) {
+            m_benchmark->addFrame(frame, frameTime, m_frameTimings.cpuTime());
+            if (m_completedFrame != NO_FRAME) {
+                m_benchmark->addGpuFrame(m_completedFrame, stats.gpuTime, stats.gpu.fragmentInvocations);
+            }
+        }
+        if (!m_config.frameTracePath.empty()) {
+            m_frameTrace.push_back({ .frameTime = frameTime, .cpuTime = m_frameTimings.cpuTime(), .gpuTime = std::numeric_limits<float>::quiet_NaN() });
+            if (m_completedFrame < m_frameTrace.size()) {
+                m_frameTrace[m_completedFrame].gpuTime = stats.gpuTime;
+            }
+        }
     }
+    // the last frame handed over is submitted before the device is drained
+    m_renderThread.waitIdle();
     m_device.waitIdle();
+    m_renderer.writeFrames();
+    PROFILE_WRITE_TRACE(m_config.tracePath);
+    if (m_benchmark != nullptr) {
+        MemoryMonitor memoryMonitor;
+        m_benchmark->writeReport(m_loadTimes, memoryMonitor);
+    }
+    if (!m_config.recordPath.empty()) {
+        m_eventManager.saveRecording(m_config.recordPath);
+    }
+    if (!m_config.frameTracePath.empty()) {
+        writeFrameTrace();
+    }
+}
+
+void ven::Engine::writeFrameTrace() const {
+    std::ofstream out(m_config.frameTracePath);
+    if (!out.is_open()) {
+        throw utl::THROW_ERROR(("failed to open frame trace: " + m_config.frameTracePath).c_str());
+    }
+    // one line per frame, two replays of a recording line up frame by frame; gpuMs is empty when it was never read
+    out << "frame,frameMs,cpuMs,gpuMs\n";
+    for (size_t frame = 0; frame < m_frameTrace.size(); frame++) {
+        const FrameSample& sample = m_frameTrace.at(frame);
+        out << frame << ',' << sample.frameTime << ',' << sample.cpuTime << ',';
+        if (!std::isnan(sample.gpuTime)) {
+            out << sample.gpuTime;
+        }
+        out << '\n';
+    }
+    utl::Logger::logInfo("Frame trace written to " + m_config.frameTracePath);
 }
 
-void ven::Engine::createUniformBuffers() {
-    m_uniformBuffers.resize(SwapChain::MAX_FRAMES_IN_FLIGHT);
-    m_uniformBuffersMemory.resize(SwapChain::MAX_FRAMES_IN_FLIGHT);
-    m_uniformBuffersMapped.resize(SwapChain::MAX_FRAMES_IN_FLIGHT);
+void ven::Engine::simulate() {
+    PROFILE_FUNCTION();
+    const double step = 1.0 / static_cast<double>(m_config.simulationRate);
+    Camera& camera = m_renderer.getCamera();
+    m_eventManager.pollEvents();
+    const double now = EventManager::getTime();
+    const bool firstFrame = m_simulationTime < 0.0;
+    if (firstFrame) {
+        m_simulationTime = now;
+    }
+    if (firstFrame || camera.getPose() != m_renderedPose) {
+        m_previousPose = camera.getPose();
+        m_currentPose = m_previousPose;
+    }
+    // the steps move the camera from the last simulated pose, not the blended one
+    camera.setPose(m_currentPose);
+    uint32_t steps = 0;
+    while (now - m_simulationTime >= step && steps < MAX_SIMULATION_STEPS) {
+        m_simulationTime += step;
+        m_previousPose = m_currentPose;
+        m_eventManager.step(m_simulationTime, static_cast<float>(step));
+        m_currentPose = camera.getPose();
+        steps++;
+    }
+    if (now - m_simulationTime >= step) {
+        // too far behind to catch up: the remaining time is lost instead of growing the next frames
+        m_simulationTime = now;
+    }
+    const auto alpha = static_cast<float>((now - m_simulationTime) / step);
+    camera.setPose(CameraPose::mix(m_previousPose, m_currentPose, alpha));
+    m_renderedPose = camera.getPose();
+}
+
+void ven::Engine::createMappedBuffers(const VkDeviceSize size, const VkBufferUsageFlags usage, std::vector<VkBuffer>& buffers, std::vector<VkDeviceMemory>& memory, std::vector<void*>& mapped) const {
+    buffers.resize(SwapChain::MAX_FRAMES_IN_FLIGHT);
+    memory.resize(SwapChain::MAX_FRAMES_IN_FLIGHT);
+    mapped.resize(SwapChain::MAX_FRAMES_IN_FLIGHT);
     for (uint8_t i = 0; i < SwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
-        m_device.createBuffer(Renderer::UNIFORM_BUFFER_SIZE, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_uniformBuffers.at(i), m_uniformBuffersMemory.at(i));
-        vkMapMemory(m_device.getVkDevice(), m_uniformBuffersMemory.at(i), 0, Renderer::UNIFORM_BUFFER_SIZE, 0, &m_uniformBuffersMapped.at(i));
+        m_device.createBuffer(size, usage, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, buffers.at(i), memory.at(i));
+        vkMapMemory(m_device.getVkDevice(), memory.at(i), 0, size, 0, &mapped.at(i));
     }
 }
 
-void ven::Engine::drawFrame() {
+void ven::Engine::destroyBuffers(const std::vector<VkBuffer>& buffers, const std::vector<VkDeviceMemory>& memory) const {
+    // freeing the memory unmaps it
+    for (size_t i = 0; i < buffers.size(); i++) {
+        vkDestroyBuffer(m_device.getVkDevice(), buffers.at(i), nullptr);
+        vkFreeMemory(m_device.getVkDevice(), memory.at(i), nullptr);
+    }
+}
+
+void ven::Engine::createLightBuffers() {
+    createMappedBuffers(ClusteredLighting::LIGHT_BUFFER_SIZE, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, m_lightBuffers, m_lightBuffersMemory, m_lightBuffersMapped);
+    m_clusterBuffers.resize(SwapChain::MAX_FRAMES_IN_FLIGHT);
+    m_clusterBuffersMemory.resize(SwapChain::MAX_FRAMES_IN_FLIGHT);
+    for (uint8_t i = 0; i < SwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
+        m_device.createBuffer(ClusteredLighting::CLUSTER_BUFFER_SIZE, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_clusterBuffers.at(i), m_clusterBuffersMemory.at(i));
+    }
+}
+
+void ven::Engine::drawFrame(const uint64_t frame) {
+    PROFILE_FUNCTION();
+    const uint32_t frameIndex = m_currentFrame;
+    utl::Clock::TimePoint mark = utl::Clock::now();
+    // the waits poll the window, its events are stamped closer to when they happened than by a single poll per frame
+    const bool pollInput = isInputLive();
+    const uint64_t fenceTimeout = pollInput ? static_cast<uint64_t>(INPUT_POLL_INTERVAL.count()) : UINT64_MAX;
+    const auto waitRenderThread = [this, pollInput] {
+        if (!pollInput) {
+            m_renderThread.waitIdle();
+            return;
+        }
+        while (!m_renderThread.waitIdleFor(INPUT_POLL_INTERVAL)) {
+            m_eventManager.pollEvents();
+        }
+    };
+    if (m_renderer.getSettings().framesInFlight == 1) {
+        // the only slot is the one of the frame the render thread may still be submitting, nothing overlaps
+        waitRenderThread();
+    }
+    {
+        PROFILE_SCOPE("waitForFence");
+        // the only wait on this fence in the frame, acquireNextImage relies on it
+        VkResult result = VK_TIMEOUT;
+        while ((result = vkWaitForFences(m_device.getVkDevice(), 1, &m_renderer.getSwapChain().getInFlightFences().at(frameIndex), VK_TRUE, fenceTimeout)) == VK_TIMEOUT) {
+            m_eventManager.pollEvents();
+        }
+        if (result != VK_SUCCESS) {
+            throw utl::THROW_ERROR("failed to wait for fence!");
+        }
+    }
+    m_frameTimings.fenceWait = lap(mark);
+    m_renderer.frameCompleted(frameIndex);
+    m_completedFrame = m_submittedFrames.at(frameIndex);
+    FrameSnapshot& snapshot = m_renderThread.getSnapshot();
+    m_renderer.updateUniformBuffer(m_uniformBuffersMapped.at(frameIndex), m_objectBuffersMapped.at(frameIndex), m_transforms, m_scene, m_drawGroups);
+    m_renderer.updateLights(m_lightBuffersMapped.at(frameIndex), m_transforms, m_scene);
+    const std::vector<DrawCommand>& visibleDraws = m_renderer.cullDraws(m_drawGroups, m_instanceBuffersMapped.at(frameIndex));
+    m_renderer.cullShadowCasters(frameIndex, m_drawGroups);
+    m_renderer.buildSnapshot(snapshot, frameIndex, visibleDraws);
+    snapshot.frame = frame;
+    m_frameTimings.update = lap(mark);
+    {
+        PROFILE_SCOPE("waitRenderThread");
+        waitRenderThread();
+    }
+    m_frameTimings.renderWait = lap(mark);
+    // the render thread is parked until submit, what it uses can change
+    m_frameTimings.acquire = m_renderTimings.acquire;
+    m_frameTimings.record = m_renderTimings.record;
+    m_frameTimings.submit = m_renderTimings.submit;
+    m_frameTimings.present = m_renderTimings.present;
+    m_renderer.setFrameTimings(m_frameTimings);
+    const bool recreate = !m_window.isHeadless() && (m_swapChainOutdated || m_window.wasWindowResized() || m_renderer.isSwapChainOutdated());
+    if (recreate) {
+        m_swapChainOutdated = false;
+        m_window.resetWindowResizedFlag();
+        m_renderer.recreateSwapChain();
+    }
+    m_renderer.frameRendered();
+    if (recreate) {
+        // fitted to the old extent: the slot was neither submitted nor its fence reset, the next frame reuses it. A
+        // failed acquire always leads here as well, the snapshot before this one was not rendered either
+        m_renderer.frameDropped();
+        return;
+    }
+    // counted per frame handed over, a dropped frame submits nothing that would retire the old handles
+    m_renderer.releaseRetiredResources();
+    m_renderThread.submit();
+    // only the frame index modulo changes when the count is edited, every slot up to MAX_FRAMES_IN_FLIGHT already exists
+    m_currentFrame = (m_currentFrame + 1) % m_renderer.getSettings().framesInFlight;
+}
+
+void ven::Engine::renderFrame(const FrameSnapshot& snapshot) {
+    PROFILE_FUNCTION();
+    const uint32_t frameIndex = snapshot.frameIndex;
     uint32_t imageIndex = 0;
-    if (vkWaitForFences(m_device.getVkDevice(), 1, &m_renderer.getSwapChain().getInFlightFences().at(m_currentFrame), VK_TRUE, UINT64_MAX) != VK_SUCCESS) {
-        throw utl::THROW_ERROR("failed to wait for fence!");
+    utl::Clock::TimePoint mark = utl::Clock::now();
+    m_renderTimings = {};
+    VkResult result = VK_SUCCESS;
+    {
+        PROFILE_SCOPE("acquireNextImage");
+        result = m_renderer.getSwapChain().acquireNextImage(imageIndex, frameIndex);
     }
-    VkResult result = m_renderer.getSwapChain().acquireNextImage(imageIndex, m_currentFrame);
+    m_renderTimings.acquire = lap(mark);
     if (result == VK_ERROR_OUT_OF_DATE_KHR) {
-        m_renderer.recreateSwapChain();
+        m_swapChainOutdated = true;
         return;
     } if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
         throw utl::THROW_ERROR("failed to acquire swap chain image!");
     }
-    m_renderer.updateUniformBuffer(m_uniformBuffersMapped.at(m_currentFrame), m_models);
-    vkResetFences(m_device.getVkDevice(), 1, &m_renderer.getSwapChain().getInFlightFences().at(m_currentFrame));
-    vkResetCommandBuffer(m_commandBuffers.at(m_currentFrame), /*VkCommandBufferResetFlagBits*/ 0);
-    m_renderer.recordCommandBuffer(imageIndex, m_indicesSize, &m_descriptorSets.getDescriptorSets().at(m_currentFrame), m_commandBuffers.at(m_currentFrame), m_indexBuffer, m_vertexBuffer);
+    vkResetFences(m_device.getVkDevice(), 1, &m_renderer.getSwapChain().getInFlightFences().at(frameIndex));
+    vkResetCommandBuffer(m_commandBuffers.at(frameIndex), /*VkCommandBufferResetFlagBits*/ 0);
+    m_renderer.recordCommandBuffer(snapshot, imageIndex, m_descriptorSets.getDescriptorSets().at(frameIndex), m_commandBuffers.at(frameIndex), m_indexBuffer, m_vertexBuffer);
+    m_renderTimings.record = lap(mark);
     VkSubmitInfo submitInfo{};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    const std::array waitSemaphores = {m_renderer.getSwapChain().getImageAvailableSemaphores().at(m_currentFrame)};
+    const std::array waitSemaphores = {m_renderer.getSwapChain().getImageAvailableSemaphores().at(frameIndex)};
     constexpr std::array<VkPipelineStageFlags, 1> waitStages = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-    submitInfo.waitSemaphoreCount = waitSemaphores.size();
-    submitInfo.pWaitSemaphores = waitSemaphores.data();
-    submitInfo.pWaitDstStageMask = waitStages.data();
+    const std::array signalSemaphores = {m_renderer.getSwapChain().getRenderFinishedSemaphores().at(frameIndex)};
+    // headless frames are neither acquired nor presented, the in-flight fence is the only synchronization
+    if (!m_window.isHeadless()) {
+        submitInfo.waitSemaphoreCount = waitSemaphores.size();
+        submitInfo.pWaitSemaphores = waitSemaphores.data();
+        submitInfo.pWaitDstStageMask = waitStages.data();
+        submitInfo.signalSemaphoreCount = signalSemaphores.size();
+        submitInfo.pSignalSemaphores = signalSemaphores.data();
+    }
     submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &m_commandBuffers.at(m_currentFrame);
-    const std::array signalSemaphores = {m_renderer.getSwapChain().getRenderFinishedSemaphores().at(m_currentFrame)};
-    submitInfo.signalSemaphoreCount = signalSemaphores.size();
-    submitInfo.pSignalSemaphores = signalSemaphores.data();
-    if (vkQueueSubmit(m_device.getGraphicsQueue(), 1, &submitInfo, m_renderer.getSwapChain().getInFlightFences().at(m_currentFrame)) != VK_SUCCESS) {
-        throw utl::THROW_ERROR("failed to submit draw command buffer!");
+    submitInfo.pCommandBuffers = &m_commandBuffers.at(frameIndex);
+    {
+        PROFILE_SCOPE("submit");
+        if (vkQueueSubmit(m_device.getGraphicsQueue(), 1, &submitInfo, m_renderer.getSwapChain().getInFlightFences().at(frameIndex)) != VK_SUCCESS) {
+            throw utl::THROW_ERROR("failed to submit draw command buffer!");
+        }
+    }
+    // read by drawFrame once the slot fence is signaled, after the render thread went idle at least once
+    m_submittedFrames.at(frameIndex) = snapshot.frame;
+    m_renderTimings.submit = lap(mark);
+    if (m_window.isHeadless()) {
+        return;
     }
     VkPresentInfoKHR presentInfo{};
     presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
@@ -91,12 +422,14 @@ void ven::Engine::drawFrame() {
     presentInfo.swapchainCount = swapChains.size();
     presentInfo.pSwapchains = swapChains.data();
     presentInfo.pImageIndices = &imageIndex;
-    result = vkQueuePresentKHR(m_device.getPresentQueue(), &presentInfo);
-    if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || m_window.wasWindowResized()) {
-        m_window.resetWindowResizedFlag();
-        m_renderer.recreateSwapChain();
+    {
+        PROFILE_SCOPE("present");
+        result = vkQueuePresentKHR(m_device.getPresentQueue(), &presentInfo);
+    }
+    m_renderTimings.present = lap(mark);
+    if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
+        m_swapChainOutdated = true;
     } else if (result != VK_SUCCESS) {
         throw utl::THROW_ERROR("failed to present swap chain image!");
     }
-    m_currentFrame = (m_currentFrame + 1) % SwapChain::MAX_FRAMES_IN_FLIGHT;
 }
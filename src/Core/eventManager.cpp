@@ -1,53 +1,62 @@
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include <imgui.h>
+
+#include "Utils/Profiler.hpp"
 #include "VEngine/Core/EventManager.hpp"
 
-void ven::EventManager::handleEvents(float dt) const {
-    Window::pollEvents();
-    glm::vec3 moveDir(0.0F);
-    const std::unordered_map<int, glm::vec3> moveDirections = {
+void ven::EventManager::step(const double time, const float dt) {
+    PROFILE_FUNCTION();
+    // the wheel scrolls the Gui windows it hovers, that scroll is neither applied nor recorded
+    const bool guiScroll = ImGui::GetIO().WantCaptureMouse;
+    if (m_recordingActive) {
+        m_recording.addFrame(dt, time, m_window.getInputQueue(), !guiScroll);
+    }
+    applyInput(m_window.getInputQueue(), time, dt, !guiScroll);
+}
+
+void ven::EventManager::replayEvents(const size_t frame, const float fixedStep) {
+    PROFILE_FUNCTION();
+    // the window stays responsive, its input is not applied
+    if (!m_window.isHeadless()) {
+        m_window.pollEvents();
+    }
+    m_window.getInputQueue().clear();
+    const InputRecording::Frame& recorded = m_recording.getFrame(frame);
+    m_recording.replayEvents(frame, m_replayQueue);
+    applyInput(m_replayQueue, recorded.time, fixedStep > 0.0F ? fixedStep : recorded.dt, true);
+}
+
+void ven::EventManager::applyInput(InputQueue& queue, const double time, const float dt, const bool scroll) {
+    m_inputState.update(queue, time);
+    // a direction counts for the share of the frame its key was held, the longest one moves the camera
+    const std::array<std::pair<uint16_t, glm::vec3>, 6> moveDirections{{
         {DEFAULT_KEY_MAPPINGS.moveForward, m_camera.getFront()},
         {DEFAULT_KEY_MAPPINGS.moveBackward, -m_camera.getFront()},
         {DEFAULT_KEY_MAPPINGS.moveLeft, -m_camera.getRight()},
         {DEFAULT_KEY_MAPPINGS.moveRight, m_camera.getRight()},
         {DEFAULT_KEY_MAPPINGS.moveUp, m_camera.getUp()},
         {DEFAULT_KEY_MAPPINGS.moveDown, -m_camera.getUp()}
-    };
+    }};
+    glm::vec3 moveDir(0.0F);
+    float moveFraction = 0.0F;
     for (const auto& [key, direction] : moveDirections) {
-        if (glfwGetKey(m_window.getGLFWWindow(), key) == GLFW_PRESS) {
-            moveDir += direction;
-        }
+        const float fraction = m_inputState.getKeyHeldFraction(key);
+        moveDir += direction * fraction;
+        moveFraction = std::max(moveFraction, fraction);
     }
     if (glm::length(moveDir) > EPSILON) {
-        m_camera.move(glm::normalize(moveDir), dt);
-    }
-    float yawOffset = 0.0F, pitchOffset = 0.0F;
-    const std::unordered_map<int, float*> lookOffsets = {
-        {DEFAULT_KEY_MAPPINGS.lookLeft, &yawOffset},
-        {DEFAULT_KEY_MAPPINGS.lookRight, &yawOffset},
-        {DEFAULT_KEY_MAPPINGS.lookUp, &pitchOffset},
-        {DEFAULT_KEY_MAPPINGS.lookDown, &pitchOffset}
-    };
-    for (const auto& [key, offset] : lookOffsets) {
-        if (glfwGetKey(m_window.getGLFWWindow(), key) == GLFW_PRESS) {
-            *offset += (key == DEFAULT_KEY_MAPPINGS.lookLeft || key == DEFAULT_KEY_MAPPINGS.lookDown) ? -1.0F : 1.0F;
-        }
+        m_camera.move(glm::normalize(moveDir), dt * moveFraction);
     }
+    const float yawOffset = m_inputState.getKeyHeldFraction(DEFAULT_KEY_MAPPINGS.lookRight) - m_inputState.getKeyHeldFraction(DEFAULT_KEY_MAPPINGS.lookLeft);
+    const float pitchOffset = m_inputState.getKeyHeldFraction(DEFAULT_KEY_MAPPINGS.lookUp) - m_inputState.getKeyHeldFraction(DEFAULT_KEY_MAPPINGS.lookDown);
     if (yawOffset != 0.0F || pitchOffset != 0.0F) {
         m_camera.rotate(yawOffset, pitchOffset, dt);
     }
-}
-
-bool ven::EventManager::isKeyJustPressed(GLFWwindow* window, const long unsigned int key, std::array<bool, GLFW_KEY_LAST>& keyStates) {
-    const bool isPressed = glfwGetKey(window, static_cast<int>(key)) == GLFW_PRESS;
-    const bool wasPressed = keyStates.at(key);
-    keyStates.at(key) = isPressed;
-    return isPressed && !wasPressed;
-}
-
-template<typename Iterator>
-void ven::EventManager::processKeyActions(GLFWwindow* window, Iterator begin, Iterator end) {
-    for (auto it = begin; it != end; ++it) {
-        if (glfwGetKey(window, it->key) == GLFW_PRESS) {
-            *it->dir += it->value;
-        }
+    if (scroll && m_inputState.getScroll() != 0.0F) {
+        float& moveSpeed = m_camera.getMoveSpeed();
+        moveSpeed = std::clamp(moveSpeed * std::pow(SCROLL_SPEED_STEP, m_inputState.getScroll()), MIN_MOVE_SPEED, MAX_MOVE_SPEED);
     }
 }
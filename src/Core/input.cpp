@@ -0,0 +1,45 @@
+#include <algorithm>
+
+#include "VEngine/Core/Input.hpp"
+
+void ven::InputState::update(InputQueue& queue, const double now) {
+    const double start = std::min(m_lastUpdate, now);
+    const double interval = now - start;
+    m_pressed.reset();
+    m_heldFractions.fill(0.0F);
+    m_scroll = 0.0F;
+    // held time is accumulated in seconds, then turned into fractions of the interval
+    std::array<double, BUTTON_COUNT> held{};
+    InputEvent event;
+    while (queue.getSize() > 0 && queue.peek(0).time <= now && queue.pop(event)) {
+        if (event.type == InputEventType::SCROLL) {
+            m_scroll += event.y;
+            continue;
+        }
+        // GLFW_KEY_UNKNOWN is negative and becomes out of range
+        const uint32_t index = event.type == InputEventType::KEY ? keyIndex(event.code) : buttonIndex(event.code);
+        if (!isValid(index)) {
+            continue;
+        }
+        const double time = std::clamp(event.time, start, now);
+        if (event.action == GLFW_PRESS && !m_down.test(index)) {
+            m_down.set(index);
+            m_pressed.set(index);
+            m_heldSince.at(index) = time;
+        } else if (event.action == GLFW_RELEASE && m_down.test(index)) {
+            m_down.reset(index);
+            // a press and its release reported by the same poll share a stamp, the tap still moves the camera a little
+            held.at(index) += std::max(time - m_heldSince.at(index), m_pressed.test(index) ? MIN_TAP_TIME : 0.0);
+        }
+    }
+    for (uint32_t index = 0; index < BUTTON_COUNT; index++) {
+        if (m_down.test(index)) {
+            held.at(index) += now - std::max(m_heldSince.at(index), start);
+            m_heldSince.at(index) = now;
+        }
+        if (held.at(index) > 0.0) {
+            m_heldFractions.at(index) = interval > 0.0 ? static_cast<float>(std::min(held.at(index) / interval, 1.0)) : 1.0F;
+        }
+    }
+    m_lastUpdate = now;
+}
@@ -0,0 +1,148 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <fstream>
+
+#include "Utils/ErrorHandling.hpp"
+#include "Utils/Logger.hpp"
+#include "VEngine/Core/InputRecording.hpp"
+
+static constexpr std::array<char, 4> MAGIC = {'V', 'E', 'N', 'R'};
+static constexpr size_t HEADER_SIZE = MAGIC.size() + (3 * sizeof(uint32_t)) + (7 * sizeof(float));
+static constexpr size_t FRAME_SIZE = sizeof(float) + sizeof(double) + sizeof(uint32_t);
+static constexpr size_t EVENT_SIZE = sizeof(double) + (2 * sizeof(float)) + sizeof(int32_t) + sizeof(ven::InputEventType) + sizeof(uint8_t);
+
+// field by field, the structs have padding; the bytes are swapped on big endian hosts so the files are little endian
+template<typename T>
+static void write(std::ofstream& out, const T& value) {
+    auto bytes = std::bit_cast<std::array<char, sizeof(T)>>(value);
+    if constexpr (std::endian::native == std::endian::big) {
+        std::ranges::reverse(bytes);
+    }
+    out.write(bytes.data(), bytes.size());
+}
+
+template<typename T>
+static T read(std::ifstream& in) {
+    std::array<char, sizeof(T)> bytes{};
+    if (!in.read(bytes.data(), bytes.size())) {
+        throw utl::THROW_ERROR("truncated input recording");
+    }
+    if constexpr (std::endian::native == std::endian::big) {
+        std::ranges::reverse(bytes);
+    }
+    return std::bit_cast<T>(bytes);
+}
+
+void ven::InputRecording::begin(Camera& camera) {
+    m_position = camera.getPosition();
+    m_yaw = camera.getYaw();
+    m_pitch = camera.getPitch();
+    m_moveSpeed = camera.getMoveSpeed();
+    m_lookSpeed = camera.getLookSpeed();
+    m_frames.clear();
+    m_events.clear();
+}
+
+void ven::InputRecording::addFrame(const float dt, const double time, const InputQueue& queue, const bool scroll) {
+    const auto firstEvent = static_cast<uint32_t>(m_events.size());
+    for (uint32_t i = 0; i < queue.getSize() && queue.peek(i).time <= time; i++) {
+        if (scroll || queue.peek(i).type != InputEventType::SCROLL) {
+            m_events.push_back(queue.peek(i));
+        }
+    }
+    m_frames.push_back({ .dt = dt, .time = time, .firstEvent = firstEvent, .eventCount = static_cast<uint32_t>(m_events.size()) - firstEvent });
+}
+
+void ven::InputRecording::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary);
+    if (!out.is_open()) {
+        throw utl::THROW_ERROR(("failed to open input recording: " + path).c_str());
+    }
+    out.write(MAGIC.data(), MAGIC.size());
+    write(out, VERSION);
+    write(out, static_cast<uint32_t>(m_frames.size()));
+    write(out, static_cast<uint32_t>(m_events.size()));
+    write(out, m_position.x);
+    write(out, m_position.y);
+    write(out, m_position.z);
+    write(out, m_yaw);
+    write(out, m_pitch);
+    write(out, m_moveSpeed);
+    write(out, m_lookSpeed);
+    for (const Frame& frame : m_frames) {
+        write(out, frame.dt);
+        write(out, frame.time);
+        write(out, frame.eventCount);
+    }
+    for (const InputEvent& event : m_events) {
+        write(out, event.time);
+        write(out, event.x);
+        write(out, event.y);
+        write(out, event.code);
+        write(out, event.type);
+        write(out, event.action);
+    }
+    utl::Logger::logInfo("Input recording of " + std::to_string(m_frames.size()) + " frames written to " + path);
+}
+
+void ven::InputRecording::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in.is_open()) {
+        throw utl::THROW_ERROR(("failed to open input recording: " + path).c_str());
+    }
+    const auto fileSize = static_cast<uint64_t>(in.tellg());
+    in.seekg(0, std::ios::beg);
+    std::array<char, MAGIC.size()> magic{};
+    in.read(magic.data(), magic.size());
+    if (magic != MAGIC || read<uint32_t>(in) != VERSION) {
+        throw utl::THROW_ERROR(("not an input recording of this version: " + path).c_str());
+    }
+    const uint32_t frameCount = read<uint32_t>(in);
+    const uint32_t eventCount = read<uint32_t>(in);
+    // checked before anything is allocated, a corrupted count would otherwise ask for gigabytes
+    if (fileSize != HEADER_SIZE + (frameCount * uint64_t{FRAME_SIZE}) + (eventCount * uint64_t{EVENT_SIZE})) {
+        throw utl::THROW_ERROR(("corrupted input recording, the counts do not match the file size: " + path).c_str());
+    }
+    m_frames.resize(frameCount);
+    m_events.resize(eventCount);
+    m_position.x = read<float>(in);
+    m_position.y = read<float>(in);
+    m_position.z = read<float>(in);
+    m_yaw = read<float>(in);
+    m_pitch = read<float>(in);
+    m_moveSpeed = read<float>(in);
+    m_lookSpeed = read<float>(in);
+    uint32_t firstEvent = 0;
+    for (Frame& frame : m_frames) {
+        frame.dt = read<float>(in);
+        frame.time = read<double>(in);
+        frame.eventCount = read<uint32_t>(in);
+        frame.firstEvent = firstEvent;
+        firstEvent += frame.eventCount;
+    }
+    if (firstEvent != m_events.size()) {
+        throw utl::THROW_ERROR(("corrupted input recording: " + path).c_str());
+    }
+    for (InputEvent& event : m_events) {
+        event.time = read<double>(in);
+        event.x = read<float>(in);
+        event.y = read<float>(in);
+        event.code = read<int32_t>(in);
+        event.type = read<InputEventType>(in);
+        event.action = read<uint8_t>(in);
+    }
+}
+
+void ven::InputRecording::restoreCamera(Camera& camera) const {
+    camera.setPose(m_position, m_yaw, m_pitch);
+    camera.getMoveSpeed() = m_moveSpeed;
+    camera.getLookSpeed() = m_lookSpeed;
+}
+
+void ven::InputRecording::replayEvents(const size_t frame, InputQueue& queue) const {
+    const Frame& recorded = m_frames.at(frame);
+    for (uint32_t i = 0; i < recorded.eventCount; i++) {
+        queue.push(m_events.at(recorded.firstEvent + i));
+    }
+}
@@ -0,0 +1,73 @@
+#include <utility>
+
+#include "Utils/Profiler.hpp"
+#include "VEngine/Core/RenderThread.hpp"
+
+ven::RenderThread::RenderThread(RenderFunction render) : m_render(std::move(render)), m_thread(&RenderThread::threadLoop, this) {}
+
+void ven::RenderThread::waitIdle() {
+    std::unique_lock lock(m_mutex);
+    m_condition.wait(lock, [this] { return !m_pending; });
+    if (m_exception) {
+        std::rethrow_exception(std::exchange(m_exception, nullptr));
+    }
+}
+
+bool ven::RenderThread::waitIdleFor(const std::chrono::nanoseconds timeout) {
+    std::unique_lock lock(m_mutex);
+    if (!m_condition.wait_for(lock, timeout, [this] { return !m_pending; })) {
+        return false;
+    }
+    if (m_exception) {
+        std::rethrow_exception(std::exchange(m_exception, nullptr));
+    }
+    return true;
+}
+
+void ven::RenderThread::submit() {
+    waitIdle();
+    {
+        const std::lock_guard lock(m_mutex);
+        m_writeIndex ^= 1U;
+        m_pending = true;
+    }
+    m_condition.notify_all();
+}
+
+void ven::RenderThread::stop() {
+    {
+        std::unique_lock lock(m_mutex);
+        m_condition.wait(lock, [this] { return !m_pending; });
+        m_stop = true;
+    }
+    m_condition.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void ven::RenderThread::threadLoop() {
+    PROFILE_THREAD_NAME("Render");
+    std::unique_lock lock(m_mutex);
+    while (true) {
+        m_condition.wait(lock, [this] { return m_pending || m_stop; });
+        if (!m_pending) {
+            return;
+        }
+        // the snapshot handed over is the one the update thread is not writing
+        const FrameSnapshot& snapshot = m_snapshots.at(m_writeIndex ^ 1U);
+        lock.unlock();
+        std::exception_ptr exception;
+        try {
+            m_render(snapshot);
+        } catch (...) {
+            exception = std::current_exception();
+        }
+        lock.lock();
+        if (exception && !m_exception) {
+            m_exception = exception;
+        }
+        m_pending = false;
+        m_condition.notify_all();
+    }
+}
@@ -14,9 +14,35 @@ GLFWwindow* ven::Window::createWindow(const uint16_t width, const uint16_t heigh
     }
     glfwSetWindowUserPointer(window, this);
     glfwSetFramebufferSizeCallback(window, frameBufferResizeCallback);
+    // installed before the Gui, its GLFW backend chains them after its own
+    glfwSetKeyCallback(window, keyCallback);
+    glfwSetMouseButtonCallback(window, mouseButtonCallback);
+    glfwSetScrollCallback(window, scrollCallback);
     return window;
 }
 
+void ven::Window::pollEvents() {
+    const double now = glfwGetTime();
+    m_eventTime = m_lastPoll < 0.0 ? now : (m_lastPoll + now) * 0.5;
+    glfwPollEvents();
+    m_lastPoll = now;
+}
+
+void ven::Window::keyCallback(GLFWwindow* window, const int key, int /*scancode*/, const int action, int /*mods*/) {
+    auto *self = static_cast<Window *>(glfwGetWindowUserPointer(window));
+    self->m_inputQueue.push({ .time = self->m_eventTime, .code = key, .type = InputEventType::KEY, .action = static_cast<uint8_t>(action) });
+}
+
+void ven::Window::mouseButtonCallback(GLFWwindow* window, const int button, const int action, int /*mods*/) {
+    auto *self = static_cast<Window *>(glfwGetWindowUserPointer(window));
+    self->m_inputQueue.push({ .time = self->m_eventTime, .code = button, .type = InputEventType::MOUSE_BUTTON, .action = static_cast<uint8_t>(action) });
+}
+
+void ven::Window::scrollCallback(GLFWwindow* window, const double xOffset, const double yOffset) {
+    auto *self = static_cast<Window *>(glfwGetWindowUserPointer(window));
+    self->m_inputQueue.push({ .time = self->m_eventTime, .x = static_cast<float>(xOffset), .y = static_cast<float>(yOffset), .type = InputEventType::SCROLL });
+}
+
 void ven::Window::setWindowIcon(const std::string& path) const {
     static const utl::Image image(path);
     if (image.pixels == nullptr) {
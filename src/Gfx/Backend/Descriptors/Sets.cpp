@@ -5,18 +5,10 @@
 #include "VEngine/Gfx/Backend/Descriptors/Sets.hpp"
 #include "VEngine/Gfx/Resources/TextureManager.hpp"
 
-void ven::DescriptorSets::create(const VkDeviceSize bufferSize) {
-    VkDescriptorSetAllocateInfo allocInfo{};
-    const std::vector layouts(SwapChain::MAX_FRAMES_IN_FLIGHT, m_descriptorSetLayout);
-    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-    allocInfo.descriptorPool = m_descriptorPool;
-    allocInfo.descriptorSetCount = static_cast<uint32_t>(SwapChain::MAX_FRAMES_IN_FLIGHT);
-    allocInfo.pSetLayouts = layouts.data();
+void ven::DescriptorSets::create(const VkDeviceSize bufferSize, const VkDeviceSize objectBufferSize, const VkDeviceSize instanceBufferSize, const VkDeviceSize lightBufferSize, const VkDeviceSize clusterBufferSize, const VkDescriptorImageInfo& shadowMapInfo) {
     m_descriptorSets.resize(SwapChain::MAX_FRAMES_IN_FLIGHT);
-    if (vkAllocateDescriptorSets(m_device, &allocInfo, m_descriptorSets.data()) != VK_SUCCESS) {
-        throw utl::THROW_ERROR("failed to allocate descriptor sets!");
-    }
     for (uint8_t i = 0; i < SwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
+        m_descriptorSets.at(i) = m_descriptorAllocator.allocatePersistent(m_descriptorSetLayout);
         VkDescriptorBufferInfo bufferInfo{};
         bufferInfo.buffer = m_buffers.at(i);
         bufferInfo.offset = 0;
@@ -48,6 +40,67 @@ void ven::DescriptorSets::create(const VkDeviceSize bufferSize) {
         samplerWrite.descriptorCount = static_cast<uint32_t>(imageInfos.size());
         samplerWrite.pImageInfo = imageInfos.data();
         descriptorWrites.push_back(samplerWrite);
+        VkDescriptorBufferInfo objectBufferInfo{};
+        objectBufferInfo.buffer = m_objectBuffers.at(i);
+        objectBufferInfo.offset = 0;
+        objectBufferInfo.range = objectBufferSize;
+        VkWriteDescriptorSet objectWrite{};
+        objectWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        objectWrite.dstSet = m_descriptorSets.at(i);
+        objectWrite.dstBinding = 2;
+        objectWrite.dstArrayElement = 0;
+        objectWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        objectWrite.descriptorCount = 1;
+        objectWrite.pBufferInfo = &objectBufferInfo;
+        descriptorWrites.push_back(objectWrite);
+        VkDescriptorBufferInfo instanceBufferInfo{};
+        instanceBufferInfo.buffer = m_instanceBuffers.at(i);
+        instanceBufferInfo.offset = 0;
+        instanceBufferInfo.range = instanceBufferSize;
+        VkWriteDescriptorSet instanceWrite{};
+        instanceWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        instanceWrite.dstSet = m_descriptorSets.at(i);
+        instanceWrite.dstBinding = 3;
+        instanceWrite.dstArrayElement = 0;
+        instanceWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        instanceWrite.descriptorCount = 1;
+        instanceWrite.pBufferInfo = &instanceBufferInfo;
+        descriptorWrites.push_back(instanceWrite);
+        VkDescriptorBufferInfo lightBufferInfo{};
+        lightBufferInfo.buffer = m_lightBuffers.at(i);
+        lightBufferInfo.offset = 0;
+        lightBufferInfo.range = lightBufferSize;
+        VkWriteDescriptorSet lightWrite{};
+        lightWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        lightWrite.dstSet = m_descriptorSets.at(i);
+        lightWrite.dstBinding = 4;
+        lightWrite.dstArrayElement = 0;
+        lightWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        lightWrite.descriptorCount = 1;
+        lightWrite.pBufferInfo = &lightBufferInfo;
+        descriptorWrites.push_back(lightWrite);
+        VkDescriptorBufferInfo clusterBufferInfo{};
+        clusterBufferInfo.buffer = m_clusterBuffers.at(i);
+        clusterBufferInfo.offset = 0;
+        clusterBufferInfo.range = clusterBufferSize;
+        VkWriteDescriptorSet clusterWrite{};
+        clusterWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        clusterWrite.dstSet = m_descriptorSets.at(i);
+        clusterWrite.dstBinding = 5;
+        clusterWrite.dstArrayElement = 0;
+        clusterWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        clusterWrite.descriptorCount = 1;
+        clusterWrite.pBufferInfo = &clusterBufferInfo;
+        descriptorWrites.push_back(clusterWrite);
+        VkWriteDescriptorSet shadowWrite{};
+        shadowWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        shadowWrite.dstSet = m_descriptorSets.at(i);
+        shadowWrite.dstBinding = 6;
+        shadowWrite.dstArrayElement = 0;
+        shadowWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        shadowWrite.descriptorCount = 1;
+        shadowWrite.pImageInfo = &shadowMapInfo;
+        descriptorWrites.push_back(shadowWrite);
         vkUpdateDescriptorSets(m_device, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
     }
 }
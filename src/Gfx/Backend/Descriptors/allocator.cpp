@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <utility>
+
+#include "VEngine/Gfx/Backend/Descriptors/Allocator.hpp"
+#include "Utils/ErrorHandling.hpp"
+
+// descriptors of each type per set of a pool, the scene set is the largest with its texture array
+static constexpr std::array<std::pair<VkDescriptorType, uint32_t>, 4> POOL_RATIOS{{
+    { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1 },
+    { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4 },
+    { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4 },
+    { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1 }
+}};
+
+ven::DescriptorAllocator::~DescriptorAllocator() {
+    for (PoolList& list : m_framePools) {
+        m_freePools.insert(m_freePools.end(), list.pools.begin(), list.pools.end());
+    }
+    m_freePools.insert(m_freePools.end(), m_persistentPools.pools.begin(), m_persistentPools.pools.end());
+    for (const VkDescriptorPool& pool : m_freePools) {
+        vkDestroyDescriptorPool(m_device, pool, nullptr);
+    }
+}
+
+VkDescriptorPool ven::DescriptorAllocator::createPool(const uint32_t maxSets) const {
+    std::array<VkDescriptorPoolSize, POOL_RATIOS.size()> poolSizes{};
+    for (size_t i = 0; i < POOL_RATIOS.size(); i++) {
+        poolSizes.at(i) = { .type = POOL_RATIOS.at(i).first, .descriptorCount = POOL_RATIOS.at(i).second * maxSets };
+    }
+    const VkDescriptorPoolCreateInfo poolInfo{ .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO, .maxSets = maxSets, .poolSizeCount = static_cast<uint32_t>(poolSizes.size()), .pPoolSizes = poolSizes.data() };
+    VkDescriptorPool pool = VK_NULL_HANDLE;
+    if (vkCreateDescriptorPool(m_device, &poolInfo, nullptr, &pool) != VK_SUCCESS) {
+        throw utl::THROW_ERROR("failed to create descriptor pool!");
+    }
+    return pool;
+}
+
+VkDescriptorPool ven::DescriptorAllocator::acquirePool() {
+    if (!m_freePools.empty()) {
+        const VkDescriptorPool pool = m_freePools.back();
+        m_freePools.pop_back();
+        return pool;
+    }
+    const VkDescriptorPool pool = createPool(m_nextPoolSets);
+    m_nextPoolSets = std::min(m_nextPoolSets * 2, MAX_POOL_SETS);
+    return pool;
+}
+
+VkDescriptorSet ven::DescriptorAllocator::allocate(PoolList& list, const VkDescriptorSetLayout& layout) {
+    VkDescriptorSetAllocateInfo allocInfo{ .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO, .descriptorSetCount = 1, .pSetLayouts = &layout };
+    VkDescriptorSet set = VK_NULL_HANDLE;
+    if (!list.pools.empty()) {
+        allocInfo.descriptorPool = list.pools.back();
+        if (vkAllocateDescriptorSets(m_device, &allocInfo, &set) == VK_SUCCESS) {
+            return set;
+        }
+    }
+    // the pool is full, the next one is either a reset pool or a new one larger than the last
+    while (true) {
+        const bool largest = m_freePools.empty() && m_nextPoolSets == MAX_POOL_SETS;
+        list.pools.push_back(acquirePool());
+        allocInfo.descriptorPool = list.pools.back();
+        const VkResult result = vkAllocateDescriptorSets(m_device, &allocInfo, &set);
+        if (result == VK_SUCCESS) {
+            return set;
+        }
+        if ((result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL) || largest) {
+            throw utl::THROW_ERROR("failed to allocate descriptor set!");
+        }
+    }
+}
+
+VkDescriptorSet ven::DescriptorAllocator::allocate(const uint32_t frameIndex, const VkDescriptorSetLayout& layout) {
+    return allocate(m_framePools.at(frameIndex), layout);
+}
+
+VkDescriptorSet ven::DescriptorAllocator::allocatePersistent(const VkDescriptorSetLayout& layout) {
+    return allocate(m_persistentPools, layout);
+}
+
+void ven::DescriptorAllocator::resetFrame(const uint32_t frameIndex) {
+    std::vector<VkDescriptorPool>& pools = m_framePools.at(frameIndex).pools;
+    // the last pool stays with the slot: in steady state a frame fits in it and nothing moves
+    for (size_t i = 0; i < pools.size(); i++) {
+        vkResetDescriptorPool(m_device, pools.at(i), 0);
+        if (i + 1 < pools.size()) {
+            m_freePools.push_back(pools.at(i));
+        }
+    }
+    if (pools.size() > 1) {
+        pools.erase(pools.begin(), pools.end() - 1);
+    }
+}
+
+size_t ven::DescriptorAllocator::getPoolCount() const {
+    size_t count = m_persistentPools.pools.size() + m_freePools.size();
+    for (const PoolList& list : m_framePools) {
+        count += list.pools.size();
+    }
+    return count;
+}
@@ -0,0 +1,44 @@
+#include <algorithm>
+
+#include "VEngine/Gfx/Backend/Descriptors/LayoutCache.hpp"
+#include "Utils/ErrorHandling.hpp"
+
+ven::DescriptorLayoutCache::~DescriptorLayoutCache() {
+    for (const auto& [key, layout] : m_layouts) {
+        vkDestroyDescriptorSetLayout(m_device, layout, nullptr);
+    }
+}
+
+bool ven::DescriptorLayoutCache::LayoutKey::operator==(const LayoutKey& other) const {
+    return std::ranges::equal(bindings, other.bindings, [](const VkDescriptorSetLayoutBinding& lhs, const VkDescriptorSetLayoutBinding& rhs) {
+        return lhs.binding == rhs.binding && lhs.descriptorType == rhs.descriptorType && lhs.descriptorCount == rhs.descriptorCount && lhs.stageFlags == rhs.stageFlags;
+    });
+}
+
+size_t ven::DescriptorLayoutCache::LayoutKeyHash::operator()(const LayoutKey& key) const {
+    size_t hash = key.bindings.size();
+    for (const VkDescriptorSetLayoutBinding& binding : key.bindings) {
+        // every field fits in its own bits of a 64 bit word
+        const uint64_t packed = static_cast<uint64_t>(binding.binding) | (static_cast<uint64_t>(binding.descriptorType) << 8U) | (static_cast<uint64_t>(binding.descriptorCount) << 16U) | (static_cast<uint64_t>(binding.stageFlags) << 40U);
+        hash ^= std::hash<uint64_t>{}(packed) + 0x9e3779b97f4a7c15ULL + (hash << 6U) + (hash >> 2U);
+    }
+    return hash;
+}
+
+VkDescriptorSetLayout ven::DescriptorLayoutCache::getLayout(const std::span<const VkDescriptorSetLayoutBinding> bindings) {
+    if (std::ranges::any_of(bindings, [](const VkDescriptorSetLayoutBinding& binding) { return binding.pImmutableSamplers != nullptr; })) {
+        throw utl::THROW_ERROR("immutable samplers are not supported by the descriptor layout cache!");
+    }
+    LayoutKey key{ .bindings = { bindings.begin(), bindings.end() } };
+    std::ranges::sort(key.bindings, {}, &VkDescriptorSetLayoutBinding::binding);
+    if (const auto found = m_layouts.find(key); found != m_layouts.end()) {
+        return found->second;
+    }
+    const VkDescriptorSetLayoutCreateInfo layoutInfo{ .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO, .bindingCount = static_cast<uint32_t>(key.bindings.size()), .pBindings = key.bindings.data() };
+    VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+    if (vkCreateDescriptorSetLayout(m_device, &layoutInfo, nullptr, &layout) != VK_SUCCESS) {
+        throw utl::THROW_ERROR("failed to create descriptor set layout!");
+    }
+    m_layouts.emplace(std::move(key), layout);
+    return layout;
+}
@@ -3,7 +3,6 @@
 #include <vulkan/vulkan.h>
 
 #include "VEngine/Gfx/Backend/Descriptors/SetLayout.hpp"
-#include "Utils/ErrorHandling.hpp"
 
 static VkDescriptorSetLayoutBinding binding(const uint32_t binding, const uint16_t descriptorCount, const VkDescriptorType descriptorType, const VkSampler *immutableSamplers, const VkShaderStageFlags stageFlags) {
     VkDescriptorSetLayoutBinding layoutBinding{};
@@ -17,14 +16,13 @@ static VkDescriptorSetLayoutBinding binding(const uint32_t binding, const uint16
 
 void ven::DescriptorSetLayout::create(const uint16_t textureSize) {
     const std::array bindings = {
-        binding(0, 1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, nullptr, VK_SHADER_STAGE_VERTEX_BIT),
-        binding(1, textureSize, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, nullptr, VK_SHADER_STAGE_FRAGMENT_BIT)
+        binding(0, 1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, nullptr, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT),
+        binding(1, textureSize, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, nullptr, VK_SHADER_STAGE_FRAGMENT_BIT),
+        binding(2, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, nullptr, VK_SHADER_STAGE_VERTEX_BIT),
+        binding(3, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, nullptr, VK_SHADER_STAGE_VERTEX_BIT),
+        binding(4, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, nullptr, VK_SHADER_STAGE_FRAGMENT_BIT),
+        binding(5, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, nullptr, VK_SHADER_STAGE_FRAGMENT_BIT),
+        binding(6, 1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, nullptr, VK_SHADER_STAGE_FRAGMENT_BIT)
     };
-    VkDescriptorSetLayoutCreateInfo layoutInfo{};
-    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
-    layoutInfo.pBindings = bindings.data();
-    if (vkCreateDescriptorSetLayout(m_device, &layoutInfo, nullptr, &m_descriptorSetLayout) != VK_SUCCESS) {
-        throw utl::THROW_ERROR("failed to create descriptor set layout!");
-    }
+    m_descriptorSetLayout = m_layoutCache.getLayout(bindings);
 }
\ No newline at end of file
@@ -0,0 +1,43 @@
+#include "VEngine/Gfx/Backend/CommandPools.hpp"
+
+ven::CommandPools::CommandPools(const Device& device, const uint32_t slotCount) : m_device(device.getVkDevice()), m_slotCount(slotCount) {
+    const size_t count = static_cast<size_t>(SwapChain::MAX_FRAMES_IN_FLIGHT) * m_slotCount;
+    m_pools.resize(count, VK_NULL_HANDLE);
+    m_commandBuffers.resize(count, VK_NULL_HANDLE);
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    poolInfo.queueFamilyIndex = device.findQueueFamilies(device.getPhysicalDevice()).graphicsFamily.value();
+    // the destructor does not run for a constructor that throws, the pools created so far are destroyed here
+    const auto fail = [this](const char* message) {
+        for (auto *const pool : m_pools) {
+            vkDestroyCommandPool(m_device, pool, nullptr);
+        }
+        return utl::THROW_ERROR(message);
+    };
+    for (size_t i = 0; i < count; i++) {
+        if (vkCreateCommandPool(m_device, &poolInfo, nullptr, &m_pools[i]) != VK_SUCCESS) {
+            throw fail("failed to create secondary command pool!");
+        }
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = m_pools[i];
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+        allocInfo.commandBufferCount = 1;
+        if (vkAllocateCommandBuffers(m_device, &allocInfo, &m_commandBuffers[i]) != VK_SUCCESS) {
+            throw fail("failed to allocate secondary command buffer!");
+        }
+    }
+}
+
+ven::CommandPools::~CommandPools() {
+    for (auto *const pool : m_pools) {
+        vkDestroyCommandPool(m_device, pool, nullptr);
+    }
+}
+
+void ven::CommandPools::reset(const uint32_t frameIndex) const {
+    for (uint32_t slot = 0; slot < m_slotCount; slot++) {
+        vkResetCommandPool(m_device, m_pools.at((frameIndex * m_slotCount) + slot), 0);
+    }
+}
@@ -22,10 +22,13 @@ static VKAPI_ATTR VkBool32 VKAPI_CALL debugCallback(VkDebugUtilsMessageSeverityF
     return VK_FALSE;
 }
 
-static std::vector<const char*> getRequiredExtensions() {
-    uint32_t glfwExtensionCount = 0;
-    const char **glfwExtensions = ven::Window::getRequiredInstanceExtensions(&glfwExtensionCount);
-    std::vector extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
+static std::vector<const char*> getRequiredExtensions(const bool headless) {
+    std::vector<const char*> extensions;
+    if (!headless) {
+        uint32_t glfwExtensionCount = 0;
+        const char **glfwExtensions = ven::Window::getRequiredInstanceExtensions(&glfwExtensionCount);
+        extensions.assign(glfwExtensions, glfwExtensions + glfwExtensionCount);
+    }
     if (enableValidationLayers) {
         extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
     }
@@ -81,6 +84,7 @@ ven::Device::~Device() {
 }
 
 void ven::Device::createInstance() {
+    PROFILE_FUNCTION();
     if (enableValidationLayers && !checkValidationLayerSupport()) { throw utl::THROW_ERROR("validation layers requested, but not available!"); }
     static constexpr VkApplicationInfo appInfo{
         .sType = VK_STRUCTURE_TYPE_APPLICATION_INFO,
@@ -93,7 +97,7 @@ void ven::Device::createInstance() {
     VkInstanceCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
     createInfo.pApplicationInfo = &appInfo;
-    const auto extensions = getRequiredExtensions();
+    const auto extensions = getRequiredExtensions(isHeadless());
     createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
     createInfo.ppEnabledExtensionNames = extensions.data();
     VkDebugUtilsMessengerCreateInfoEXT debugCreateInfo{};
@@ -122,6 +126,7 @@ void ven::Device::setupDebugMessenger() {
 }
 
 void ven::Device::pickPhysicalDevice() {
+    PROFILE_FUNCTION();
     uint32_t deviceCount = 0;
     vkEnumeratePhysicalDevices(m_instance, &deviceCount, nullptr);
     if (deviceCount == 0) {
@@ -142,6 +147,7 @@ void ven::Device::pickPhysicalDevice() {
 }
 
 void ven::Device::createLogicalDevice() {
+    PROFILE_FUNCTION();
     float queuePriority = 1.0F;
     auto [graphicsFamily, presentFamily] = findQueueFamilies(m_physicalDevice);
     std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
@@ -153,15 +159,30 @@ void ven::Device::createLogicalDevice() {
         queueCreateInfo.pQueuePriorities = &queuePriority;
         queueCreateInfos.push_back(queueCreateInfo);
     }
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(m_physicalDevice, &properties);
+    VkPhysicalDeviceVulkan12Features supportedFeatures12{ .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES };
+    VkPhysicalDeviceFeatures2 supportedFeatures2{ .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2, .pNext = properties.apiVersion >= VK_API_VERSION_1_2 ? &supportedFeatures12 : nullptr };
+    vkGetPhysicalDeviceFeatures2(m_physicalDevice, &supportedFeatures2);
+    const VkPhysicalDeviceFeatures& supportedFeatures = supportedFeatures2.features;
     VkPhysicalDeviceFeatures deviceFeatures{};
     deviceFeatures.samplerAnisotropy = VK_TRUE;
+    // optional, only used for profiling
+    deviceFeatures.pipelineStatisticsQuery = supportedFeatures.pipelineStatisticsQuery;
+    m_pipelineStatistics = supportedFeatures.pipelineStatisticsQuery != VK_FALSE;
+    // optional, GPU culling falls back to CPU culling without them
+    m_drawIndirectCount = supportedFeatures12.drawIndirectCount != VK_FALSE && supportedFeatures.multiDrawIndirect != VK_FALSE && supportedFeatures.drawIndirectFirstInstance != VK_FALSE;
+    deviceFeatures.multiDrawIndirect = m_drawIndirectCount ? VK_TRUE : VK_FALSE;
+    deviceFeatures.drawIndirectFirstInstance = m_drawIndirectCount ? VK_TRUE : VK_FALSE;
+    const VkPhysicalDeviceVulkan12Features deviceFeatures12{ .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES, .drawIndirectCount = m_drawIndirectCount ? VK_TRUE : VK_FALSE };
     VkDeviceCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    createInfo.pNext = properties.apiVersion >= VK_API_VERSION_1_2 ? &deviceFeatures12 : nullptr;
     createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
     createInfo.pQueueCreateInfos = queueCreateInfos.data();
     createInfo.pEnabledFeatures = &deviceFeatures;
-    createInfo.enabledExtensionCount = static_cast<uint32_t>(DEVICE_EXTENSIONS.size());
-    createInfo.ppEnabledExtensionNames = DEVICE_EXTENSIONS.data();
+    createInfo.enabledExtensionCount = isHeadless() ? 0 : static_cast<uint32_t>(DEVICE_EXTENSIONS.size());
+    createInfo.ppEnabledExtensionNames = isHeadless() ? nullptr : DEVICE_EXTENSIONS.data();
     if (vkCreateDevice(m_physicalDevice, &createInfo, nullptr, &m_device) != VK_SUCCESS) {
         throw utl::THROW_ERROR("failed to create logical device!");
     }
@@ -191,7 +212,12 @@ ven::QueueFamilyIndices ven::Device::findQueueFamilies(const VkPhysicalDevice& d
             indices.graphicsFamily = index;
         }
         VkBool32 presentSupport = VK_FALSE;
-        vkGetPhysicalDeviceSurfaceSupportKHR(device, index, m_surface, &presentSupport);
+        if (m_surface == VK_NULL_HANDLE) {
+            // headless: nothing is presented, the graphics queue stands in for the present one
+            indices.presentFamily = indices.graphicsFamily;
+        } else {
+            vkGetPhysicalDeviceSurfaceSupportKHR(device, index, m_surface, &presentSupport);
+        }
         if (presentSupport != VK_FALSE) {
             indices.presentFamily = index;
         }
@@ -207,6 +233,9 @@ ven::SwapChainSupportDetails ven::Device::querySwapChainSupport(const VkPhysical
     uint32_t formatCount = 0;
     uint32_t presentModeCount = 0;
     SwapChainSupportDetails details;
+    if (m_surface == VK_NULL_HANDLE) {
+        return details;
+    }
     vkGetPhysicalDeviceSurfaceCapabilitiesKHR(device, m_surface, &details.capabilities);
     vkGetPhysicalDeviceSurfaceFormatsKHR(device, m_surface, &formatCount, nullptr);
     if (formatCount != 0) {
@@ -223,9 +252,9 @@ ven::SwapChainSupportDetails ven::Device::querySwapChainSupport(const VkPhysical
 
 bool ven::Device::isDeviceSuitable(const VkPhysicalDevice& device) const {
     QueueFamilyIndices indices = findQueueFamilies(device);
-    bool extensionsSupported = checkDeviceExtensionSupport(device);
-    bool swapChainAdequate = false;
-    if (extensionsSupported) {
+    bool extensionsSupported = isHeadless() || checkDeviceExtensionSupport(device);
+    bool swapChainAdequate = isHeadless();
+    if (extensionsSupported && !isHeadless()) {
         SwapChainSupportDetails swapChainSupport = querySwapChainSupport(device);
         swapChainAdequate = !swapChainSupport.formats.empty() && !swapChainSupport.presentModes.empty();
     }
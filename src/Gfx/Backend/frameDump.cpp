@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <numeric>
+
+#include "Utils/Image.hpp"
+#include "VEngine/Gfx/Backend/FrameDump.hpp"
+
+static constexpr uint32_t BYTES_PER_PIXEL = 4;
+
+ven::FrameDump::FrameDump(const Device& device, const VkExtent2D& extent, std::string directory) : m_device(device), m_extent(extent), m_directory(std::move(directory)) {
+    const VkDeviceSize size = static_cast<VkDeviceSize>(m_extent.width) * m_extent.height * BYTES_PER_PIXEL;
+    std::filesystem::create_directories(m_directory);
+    m_pendingFrames.fill(NO_FRAME);
+    m_pixels.resize(size);
+    for (size_t i = 0; i < m_buffers.size(); i++) {
+        m_device.createBuffer(size, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_buffers.at(i), m_memories.at(i));
+        vkMapMemory(m_device.getVkDevice(), m_memories.at(i), 0, size, 0, &m_mapped.at(i));
+    }
+}
+
+ven::FrameDump::~FrameDump() {
+    for (size_t i = 0; i < m_buffers.size(); i++) {
+        vkDestroyBuffer(m_device.getVkDevice(), m_buffers.at(i), nullptr);
+        vkFreeMemory(m_device.getVkDevice(), m_memories.at(i), nullptr);
+    }
+}
+
+void ven::FrameDump::record(const VkCommandBuffer& commandBuffer, const VkImage& image, const uint32_t frameIndex) {
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange = { .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .baseMipLevel = 0, .levelCount = 1, .baseArrayLayer = 0, .layerCount = 1 };
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+    const VkBufferImageCopy region{
+        .bufferOffset = 0,
+        .bufferRowLength = 0,
+        .bufferImageHeight = 0,
+        .imageSubresource = { .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .mipLevel = 0, .baseArrayLayer = 0, .layerCount = 1 },
+        .imageOffset = { .x = 0, .y = 0, .z = 0 },
+        .imageExtent = { .width = m_extent.width, .height = m_extent.height, .depth = 1 }
+    };
+    vkCmdCopyImageToBuffer(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, m_buffers.at(frameIndex), 1, &region);
+    VkBufferMemoryBarrier hostBarrier{};
+    hostBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    hostBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    hostBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    hostBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    hostBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    hostBarrier.buffer = m_buffers.at(frameIndex);
+    hostBarrier.size = VK_WHOLE_SIZE;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 0, nullptr, 1, &hostBarrier, 0, nullptr);
+    m_pendingFrames.at(frameIndex) = m_frameNumber++;
+}
+
+void ven::FrameDump::write(const uint32_t frameIndex) {
+    const uint64_t frameNumber = m_pendingFrames.at(frameIndex);
+    if (frameNumber == NO_FRAME) {
+        return;
+    }
+    m_pendingFrames.at(frameIndex) = NO_FRAME;
+    std::memcpy(m_pixels.data(), m_mapped.at(frameIndex), m_pixels.size());
+    // the offscreen images are B8G8R8A8, png wants RGBA
+    for (size_t i = 0; i < m_pixels.size(); i += BYTES_PER_PIXEL) {
+        std::swap(m_pixels[i], m_pixels[i + 2]);
+    }
+    std::string name = std::to_string(frameNumber);
+    name.insert(0, name.size() < 6 ? 6 - name.size() : 0, '0');
+    utl::Image::writePng(m_directory + "/frame_" + name + ".png", static_cast<int>(m_extent.width), static_cast<int>(m_extent.height), m_pixels.data());
+}
+
+void ven::FrameDump::writeAll() {
+    std::array<uint32_t, SwapChain::MAX_FRAMES_IN_FLIGHT> order{};
+    std::iota(order.begin(), order.end(), 0U);
+    std::ranges::sort(order, {}, [this](const uint32_t frameIndex) { return m_pendingFrames.at(frameIndex); });
+    for (const uint32_t frameIndex : order) {
+        write(frameIndex);
+    }
+}
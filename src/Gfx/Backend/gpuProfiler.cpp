@@ -0,0 +1,127 @@
+#include <algorithm>
+
+#include "VEngine/Gfx/Backend/GpuProfiler.hpp"
+
+static constexpr VkQueryPipelineStatisticFlags STATISTICS_FLAGS = VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT | VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT | VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT | VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+
+ven::GpuProfiler::GpuProfiler(const Device& device, const uint32_t statisticsSlots) : m_device(device), m_statisticsSlots(statisticsSlots) {
+    const VkPhysicalDevice& physicalDevice = m_device.getPhysicalDevice();
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+    if (queueFamilies.at(m_device.findQueueFamilies(physicalDevice).graphicsFamily.value()).timestampValidBits == 0) {
+        return;
+    }
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+    m_timestampPeriod = properties.limits.timestampPeriod;
+    m_statisticsResults.resize(static_cast<size_t>(m_statisticsSlots) * STATISTICS_COUNT);
+    for (Frame& frame : m_frames) {
+        const VkQueryPoolCreateInfo timestampInfo{
+            .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+            .queryType = VK_QUERY_TYPE_TIMESTAMP,
+            .queryCount = GpuStats::MAX_SCOPES * 2
+        };
+        if (vkCreateQueryPool(m_device.getVkDevice(), &timestampInfo, nullptr, &frame.timestamps) != VK_SUCCESS) {
+            throw utl::THROW_ERROR("failed to create timestamp query pool!");
+        }
+        if (!m_device.hasPipelineStatistics()) {
+            continue;
+        }
+        const VkQueryPoolCreateInfo statisticsInfo{
+            .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+            .queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS,
+            .queryCount = m_statisticsSlots,
+            .pipelineStatistics = STATISTICS_FLAGS
+        };
+        if (vkCreateQueryPool(m_device.getVkDevice(), &statisticsInfo, nullptr, &frame.statistics) != VK_SUCCESS) {
+            throw utl::THROW_ERROR("failed to create pipeline statistics query pool!");
+        }
+    }
+}
+
+ven::GpuProfiler::~GpuProfiler() {
+    for (const Frame& frame : m_frames) {
+        vkDestroyQueryPool(m_device.getVkDevice(), frame.timestamps, nullptr);
+        vkDestroyQueryPool(m_device.getVkDevice(), frame.statistics, nullptr);
+    }
+}
+
+void ven::GpuProfiler::beginFrame(const uint32_t frameIndex, const uint32_t statisticsCount) {
+    Frame& frame = m_frames.at(frameIndex);
+    frame.scopeCount = 0;
+    frame.statisticsCount = frame.statistics != VK_NULL_HANDLE ? std::min(statisticsCount, m_statisticsSlots) : 0;
+    frame.pending = isEnabled();
+}
+
+uint32_t ven::GpuProfiler::addScope(const uint32_t frameIndex, const char* name) {
+    Frame& frame = m_frames.at(frameIndex);
+    if (frame.scopeCount == GpuStats::MAX_SCOPES) {
+        throw utl::THROW_ERROR("too many gpu profiler scopes!");
+    }
+    frame.names.at(frame.scopeCount) = name;
+    return frame.scopeCount++;
+}
+
+void ven::GpuProfiler::reset(const VkCommandBuffer& commandBuffer, const uint32_t frameIndex) const {
+    if (!isEnabled()) {
+        return;
+    }
+    const Frame& frame = m_frames.at(frameIndex);
+    vkCmdResetQueryPool(commandBuffer, frame.timestamps, 0, GpuStats::MAX_SCOPES * 2);
+    if (frame.statistics != VK_NULL_HANDLE) {
+        vkCmdResetQueryPool(commandBuffer, frame.statistics, 0, m_statisticsSlots);
+    }
+}
+
+void ven::GpuProfiler::writeBegin(const VkCommandBuffer& commandBuffer, const uint32_t frameIndex, const uint32_t scope) const {
+    if (isEnabled()) {
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_frames.at(frameIndex).timestamps, scope * 2);
+    }
+}
+
+void ven::GpuProfiler::writeEnd(const VkCommandBuffer& commandBuffer, const uint32_t frameIndex, const uint32_t scope) const {
+    if (isEnabled()) {
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_frames.at(frameIndex).timestamps, (scope * 2) + 1);
+    }
+}
+
+void ven::GpuProfiler::beginStatistics(const VkCommandBuffer& commandBuffer, const uint32_t frameIndex, const uint32_t slot) const {
+    if (const Frame& frame = m_frames.at(frameIndex); slot < frame.statisticsCount) {
+        vkCmdBeginQuery(commandBuffer, frame.statistics, slot, 0);
+    }
+}
+
+void ven::GpuProfiler::endStatistics(const VkCommandBuffer& commandBuffer, const uint32_t frameIndex, const uint32_t slot) const {
+    if (const Frame& frame = m_frames.at(frameIndex); slot < frame.statisticsCount) {
+        vkCmdEndQuery(commandBuffer, frame.statistics, slot);
+    }
+}
+
+void ven::GpuProfiler::collect(const uint32_t frameIndex, GpuStats& stats) {
+    Frame& frame = m_frames.at(frameIndex);
+    if (!frame.pending) {
+        return;
+    }
+    frame.pending = false;
+    // no VK_QUERY_RESULT_WAIT_BIT: the fence of the frame has been waited on, a query still unavailable means it was never written
+    if (frame.scopeCount > 0 && vkGetQueryPoolResults(m_device.getVkDevice(), frame.timestamps, 0, frame.scopeCount * 2, sizeof(m_timestampResults), m_timestampResults.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT) == VK_SUCCESS) {
+        stats.scopeCount = frame.scopeCount;
+        for (uint32_t scope = 0; scope < frame.scopeCount; scope++) {
+            const uint64_t ticks = m_timestampResults.at((scope * 2) + 1) - m_timestampResults.at(scope * 2);
+            stats.scopes.at(scope) = { .name = frame.names.at(scope), .time = static_cast<float>(static_cast<double>(ticks) * m_timestampPeriod / 1e6) };
+        }
+    }
+    stats.pipelineStatistics = frame.statisticsCount > 0;
+    if (frame.statisticsCount > 0 && vkGetQueryPoolResults(m_device.getVkDevice(), frame.statistics, 0, frame.statisticsCount, m_statisticsResults.size() * sizeof(uint64_t), m_statisticsResults.data(), STATISTICS_COUNT * sizeof(uint64_t), VK_QUERY_RESULT_64_BIT) == VK_SUCCESS) {
+        stats.inputPrimitives = stats.vertexInvocations = stats.clippingPrimitives = stats.fragmentInvocations = 0;
+        // results come in the order of the flag bits
+        for (uint32_t slot = 0; slot < frame.statisticsCount; slot++) {
+            stats.inputPrimitives += m_statisticsResults.at((slot * STATISTICS_COUNT) + 0);
+            stats.vertexInvocations += m_statisticsResults.at((slot * STATISTICS_COUNT) + 1);
+            stats.clippingPrimitives += m_statisticsResults.at((slot * STATISTICS_COUNT) + 2);
+            stats.fragmentInvocations += m_statisticsResults.at((slot * STATISTICS_COUNT) + 3);
+        }
+    }
+}
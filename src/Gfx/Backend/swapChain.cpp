@@ -1,5 +1,7 @@
+#include <algorithm>
 #include <limits>
 
+#include "Utils/Logger.hpp"
 #include "VEngine/Gfx/Backend/SwapChain.hpp"
 
 static VkSurfaceFormatKHR chooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& availableFormats) {
@@ -11,7 +13,7 @@ static VkSurfaceFormatKHR chooseSwapSurfaceFormat(const std::vector<VkSurfaceFor
     return availableFormats[0];
 }
 
-static VkPresentModeKHR chooseSwapPresentMode(const std::vector<VkPresentModeKHR>& availablePresentModes) {
+static VkPresentModeKHR chooseSwapPresentMode(const std::vector<VkPresentModeKHR>& availablePresentModes, const VkPresentModeKHR requestedPresentMode, const bool explicitRequest) {
     // VK_PRESENT_MODE_IMMEDIATE_KHR = 0, = Immediate
     // VK_PRESENT_MODE_MAILBOX_KHR = 1, = Triple Buffering
     // VK_PRESENT_MODE_FIFO_KHR = 2, = V-Sync
@@ -20,13 +22,12 @@ static VkPresentModeKHR chooseSwapPresentMode(const std::vector<VkPresentModeKHR
     // VK_PRESENT_MODE_SHARED_CONTINUOUS_REFRESH_KHR = 1000111001, = Shared Continuous Refresh
     // VK_PRESENT_MODE_FIFO_LATEST_READY_EXT = 1000361000, = V-Sync (Latest Ready)
     // VK_PRESENT_MODE_MAX_ENUM_KHR = 0x7FFFFFFF = Max Enum
-    for (const auto &availablePresentMode : availablePresentModes) {
-        if (availablePresentMode == VK_PRESENT_MODE_MAILBOX_KHR) {
-            return availablePresentMode;
-        }
-        if (availablePresentMode == VK_PRESENT_MODE_IMMEDIATE_KHR) {
-            return availablePresentMode;
-        }
+    if (std::ranges::find(availablePresentModes, requestedPresentMode) != availablePresentModes.end()) {
+        return requestedPresentMode;
+    }
+    // FIFO is the only mode every implementation has to support, missing the default MAILBOX is common and not worth a warning
+    if (explicitRequest) {
+        utl::Logger::logWarning("Present mode " + std::to_string(requestedPresentMode) + " is not supported, falling back to FIFO");
     }
     return VK_PRESENT_MODE_FIFO_KHR;
 }
@@ -42,8 +43,11 @@ VkExtent2D chooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilities, const
 }
 
 VkResult ven::SwapChain::acquireNextImage(uint32_t &imageIndex, const uint32_t currentFrame) const {
-    if (vkWaitForFences(m_device.getVkDevice(), 1, &m_inFlightFences[currentFrame], VK_TRUE, std::numeric_limits<uint64_t>::max()) != VK_SUCCESS) {
-        throw utl::THROW_ERROR("failed to wait for fences!");
+    // the in-flight fence of currentFrame has already been waited on by the caller
+    if (m_device.isHeadless()) {
+        // one offscreen image per frame slot, the fence that was just waited on also guards the image
+        imageIndex = currentFrame;
+        return VK_SUCCESS;
     }
     return vkAcquireNextImageKHR(m_device.getVkDevice(), m_swapChain, std::numeric_limits<uint64_t>::max(), m_imageAvailableSemaphores[currentFrame], VK_NULL_HANDLE, &imageIndex);
 }
@@ -61,7 +65,7 @@ VkFormat ven::SwapChain::findSupportedFormat(const Device& device, const std::ve
     throw utl::THROW_ERROR("failed to find supported format!");
 }
 
-static void createAttachmentDescription(VkAttachmentDescription& attachmentDescription, const VkFormat& format, const VkSampleCountFlagBits& samples, const VkAttachmentLoadOp& loadOp, const VkAttachmentStoreOp& storeOp, const VkImageLayout& finalLayout) {
+static void createAttachmentDescription(VkAttachmentDescription& attachmentDescription, const VkFormat& format, const VkSampleCountFlagBits& samples, const VkAttachmentLoadOp& loadOp, const VkAttachmentStoreOp& storeOp, const VkImageLayout& finalLayout, const VkImageLayout& initialLayout = VK_IMAGE_LAYOUT_UNDEFINED) {
     attachmentDescription.flags = 0;
     attachmentDescription.format = format;
     attachmentDescription.samples = samples;
@@ -69,11 +73,25 @@ static void createAttachmentDescription(VkAttachmentDescription& attachmentDescr
     attachmentDescription.storeOp = storeOp;
     attachmentDescription.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     attachmentDescription.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-    attachmentDescription.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    attachmentDescription.initialLayout = initialLayout;
     attachmentDescription.finalLayout = finalLayout;
 }
 
-void ven::SwapChain::createSwapChain() {
+void ven::SwapChain::createOffscreenImages() {
+    m_format = VK_FORMAT_B8G8R8A8_SRGB;
+    m_extent = m_windowExtent;
+    m_images.resize(MAX_FRAMES_IN_FLIGHT);
+    m_offscreenImageMemories.resize(MAX_FRAMES_IN_FLIGHT);
+    for (size_t i = 0; i < m_images.size(); i++) {
+        createImage(m_extent.width, m_extent.height, 1, VK_SAMPLE_COUNT_1_BIT, m_format, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_images[i], m_offscreenImageMemories[i]);
+    }
+}
+
+void ven::SwapChain::createSwapChain(const VkSwapchainKHR& oldSwapChain) {
+    if (m_device.isHeadless()) {
+        createOffscreenImages();
+        return;
+    }
     auto [capabilities, formats, presentModes] = m_device.querySwapChainSupport(m_device.getPhysicalDevice());
     const auto [format, colorSpace] = chooseSwapSurfaceFormat(formats);
     const VkExtent2D extent = chooseSwapExtent(capabilities, m_windowExtent);
@@ -101,8 +119,10 @@ void ven::SwapChain::createSwapChain() {
     }
     createInfo.preTransform = capabilities.currentTransform;
     createInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
-    createInfo.presentMode = chooseSwapPresentMode(presentModes);
+    const VkPresentModeKHR presentMode = chooseSwapPresentMode(presentModes, m_requestedPresentMode, m_presentModeExplicit);
+    createInfo.presentMode = presentMode;
     createInfo.clipped = VK_TRUE;
+    createInfo.oldSwapchain = oldSwapChain;
     if (vkCreateSwapchainKHR(m_device.getVkDevice(), &createInfo, nullptr, &m_swapChain) != VK_SUCCESS) {
         throw utl::THROW_ERROR("failed to create swap chain!");
     }
@@ -111,6 +131,7 @@ void ven::SwapChain::createSwapChain() {
     vkGetSwapchainImagesKHR(m_device.getVkDevice(), m_swapChain, &imageCount, m_images.data());
     m_format = format;
     m_extent = extent;
+    m_presentMode = presentMode;
 }
 
 
@@ -169,61 +190,118 @@ void ven::SwapChain::createImage(const uint32_t width, const uint32_t height, co
 
 void ven::SwapChain::createColorResources() {
     const VkFormat colorFormat = m_format;
-    createImage(m_extent.width, m_extent.height, 1, m_device.getMsaaSamples(), colorFormat, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_colorImage, m_colorImageMemory);
+    // not transient: the early and late render passes of occlusion culling store and load it
+    createImage(m_extent.width, m_extent.height, 1, m_device.getMsaaSamples(), colorFormat, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_colorImage, m_colorImageMemory);
     createImageView(m_colorImage, colorFormat, VK_IMAGE_ASPECT_COLOR_BIT, 1, m_colorImageView);
+    createImage(m_extent.width, m_extent.height, 1, VK_SAMPLE_COUNT_1_BIT, colorFormat, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_sceneImage, m_sceneImageMemory);
+    createImageView(m_sceneImage, colorFormat, VK_IMAGE_ASPECT_COLOR_BIT, 1, m_sceneImageView);
 }
 
 void ven::SwapChain::createDepthResources() {
     const VkFormat depthFormat = findDepthFormat(m_device);
-    createImage(m_extent.width, m_extent.height, 1, m_device.getMsaaSamples(), depthFormat, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_depthImage, m_depthImageMemory);
+    createImage(m_extent.width, m_extent.height, 1, m_device.getMsaaSamples(), depthFormat, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_depthImage, m_depthImageMemory);
     createImageView(m_depthImage, depthFormat, VK_IMAGE_ASPECT_DEPTH_BIT, 1, m_depthImageView);
 }
 
 void ven::SwapChain::createFrameBuffers() {
+    const std::array sceneAttachments = {
+        m_colorImageView,
+        m_depthImageView,
+        m_sceneImageView
+    };
+    VkFramebufferCreateInfo frameBufferInfo{};
+    frameBufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+    frameBufferInfo.renderPass = getRenderPass();
+    frameBufferInfo.attachmentCount = static_cast<uint32_t>(sceneAttachments.size());
+    frameBufferInfo.pAttachments = sceneAttachments.data();
+    frameBufferInfo.width = m_extent.width;
+    frameBufferInfo.height = m_extent.height;
+    frameBufferInfo.layers = 1;
+    if (vkCreateFramebuffer(m_device.getVkDevice(), &frameBufferInfo, nullptr, &m_sceneFrameBuffer) != VK_SUCCESS) {
+        throw utl::THROW_ERROR("failed to create scene frame buffer!");
+    }
     m_swapChainFrameBuffers.resize(m_imageViews.size());
+    frameBufferInfo.renderPass = m_presentRenderPass;
+    frameBufferInfo.attachmentCount = 1;
     for (size_t i = 0; i < m_imageViews.size(); i++) {
-        std::array attachments = {
-            m_colorImageView,
-            m_depthImageView,
-            m_imageViews[i]
-        };
-        VkFramebufferCreateInfo frameBufferInfo{};
-        frameBufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-        frameBufferInfo.renderPass = m_renderPass;
-        frameBufferInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
-        frameBufferInfo.pAttachments = attachments.data();
-        frameBufferInfo.width = m_extent.width;
-        frameBufferInfo.height = m_extent.height;
-        frameBufferInfo.layers = 1;
+        frameBufferInfo.pAttachments = &m_imageViews[i];
         if (vkCreateFramebuffer(m_device.getVkDevice(), &frameBufferInfo, nullptr, &m_swapChainFrameBuffers[i]) != VK_SUCCESS) {
             throw utl::THROW_ERROR("failed to create frame buffer!");
         }
     }
 }
 
-void ven::SwapChain::createRenderPass() {
+void ven::SwapChain::createRenderPasses() {
+    for (size_t type = 0; type < m_renderPasses.size(); type++) {
+        createRenderPass(static_cast<RenderPassType>(type));
+    }
+    createPresentRenderPass();
+}
+
+void ven::SwapChain::createRenderPass(const RenderPassType type) {
     constexpr VkAttachmentReference colorAttachmentRef{ .attachment = 0, .layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL };
     constexpr VkAttachmentReference depthAttachmentRef{ .attachment = 1, .layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL };
     constexpr VkAttachmentReference colorAttachmentResolveRef{ .attachment = 2, .layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL };
+    const VkFormat depthFormat = findDepthFormat(m_device);
+    const VkSampleCountFlagBits samples = m_device.getMsaaSamples();
+    // the present render pass samples the resolved scene
+    constexpr VkImageLayout resolvedLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
     VkAttachmentDescription colorAttachment{};
     VkAttachmentDescription depthAttachment{};
     VkAttachmentDescription colorAttachmentResolve{};
-    createAttachmentDescription(colorAttachment, m_format, m_device.getMsaaSamples(), VK_ATTACHMENT_LOAD_OP_CLEAR, VK_ATTACHMENT_STORE_OP_STORE, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
-    createAttachmentDescription(depthAttachment, findDepthFormat(m_device), m_device.getMsaaSamples(), VK_ATTACHMENT_LOAD_OP_CLEAR, VK_ATTACHMENT_STORE_OP_DONT_CARE, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
-    createAttachmentDescription(colorAttachmentResolve, m_format, VK_SAMPLE_COUNT_1_BIT, VK_ATTACHMENT_LOAD_OP_DONT_CARE, VK_ATTACHMENT_STORE_OP_STORE, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+    // only load / store operations and layouts differ between the types, which keeps the passes compatible
+    switch (type) {
+        case RenderPassType::EARLY:
+            createAttachmentDescription(colorAttachment, m_format, samples, VK_ATTACHMENT_LOAD_OP_CLEAR, VK_ATTACHMENT_STORE_OP_STORE, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+            createAttachmentDescription(depthAttachment, depthFormat, samples, VK_ATTACHMENT_LOAD_OP_CLEAR, VK_ATTACHMENT_STORE_OP_STORE, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL);
+            createAttachmentDescription(colorAttachmentResolve, m_format, VK_SAMPLE_COUNT_1_BIT, VK_ATTACHMENT_LOAD_OP_DONT_CARE, VK_ATTACHMENT_STORE_OP_DONT_CARE, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+            break;
+        case RenderPassType::LATE:
+            createAttachmentDescription(colorAttachment, m_format, samples, VK_ATTACHMENT_LOAD_OP_LOAD, VK_ATTACHMENT_STORE_OP_STORE, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+            createAttachmentDescription(depthAttachment, depthFormat, samples, VK_ATTACHMENT_LOAD_OP_LOAD, VK_ATTACHMENT_STORE_OP_DONT_CARE, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL);
+            createAttachmentDescription(colorAttachmentResolve, m_format, VK_SAMPLE_COUNT_1_BIT, VK_ATTACHMENT_LOAD_OP_DONT_CARE, VK_ATTACHMENT_STORE_OP_STORE, resolvedLayout);
+            break;
+        default:
+            createAttachmentDescription(colorAttachment, m_format, samples, VK_ATTACHMENT_LOAD_OP_CLEAR, VK_ATTACHMENT_STORE_OP_STORE, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+            createAttachmentDescription(depthAttachment, depthFormat, samples, VK_ATTACHMENT_LOAD_OP_CLEAR, VK_ATTACHMENT_STORE_OP_DONT_CARE, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
+            createAttachmentDescription(colorAttachmentResolve, m_format, VK_SAMPLE_COUNT_1_BIT, VK_ATTACHMENT_LOAD_OP_DONT_CARE, VK_ATTACHMENT_STORE_OP_STORE, resolvedLayout);
+            break;
+    }
     VkSubpassDescription subpass{};
     subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
     subpass.colorAttachmentCount = 1;
     subpass.pColorAttachments = &colorAttachmentRef;
     subpass.pDepthStencilAttachment = &depthAttachmentRef;
     subpass.pResolveAttachments = &colorAttachmentResolveRef;
-    VkSubpassDependency dependency{};
-    dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
-    dependency.dstSubpass = 0;
-    dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
-    dependency.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-    dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-    dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    std::array<VkSubpassDependency, 2> dependencies{};
+    dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[0].dstSubpass = 0;
+    // the upscale of the previous frame has read the scene image before the resolve overwrites it
+    dependencies[0].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    dependencies[0].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+    dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    // the resolved scene is sampled by the present render pass
+    dependencies[1].srcSubpass = 0;
+    dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    dependencies[1].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    dependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    if (type == RenderPassType::LATE) {
+        // the depth pyramid reads the depth in compute before the layout goes back to attachment
+        dependencies[0].srcStageMask |= VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        dependencies[0].dstAccessMask |= VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+    }
+    if (type == RenderPassType::EARLY) {
+        // the depth pyramid samples the depth, the late pass loads both attachments
+        dependencies[1].srcSubpass = 0;
+        dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+        dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        dependencies[1].dstStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+        dependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+    }
     const std::array attachments = {colorAttachment, depthAttachment, colorAttachmentResolve };
     VkRenderPassCreateInfo renderPassInfo{};
     renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
@@ -231,10 +309,42 @@ void ven::SwapChain::createRenderPass() {
     renderPassInfo.pAttachments = attachments.data();
     renderPassInfo.subpassCount = 1;
     renderPassInfo.pSubpasses = &subpass;
+    renderPassInfo.dependencyCount = static_cast<uint32_t>(dependencies.size());
+    renderPassInfo.pDependencies = dependencies.data();
+    if (vkCreateRenderPass(m_device.getVkDevice(), &renderPassInfo, nullptr, &m_renderPasses.at(static_cast<size_t>(type))) != VK_SUCCESS) {
+        throw utl::THROW_ERROR("failed to create render pass!");
+    }
+}
+
+void ven::SwapChain::createPresentRenderPass() {
+    // offscreen images are left ready to be copied out, there is no presentation engine to hand them to
+    const VkImageLayout presentLayout = m_device.isHeadless() ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    constexpr VkAttachmentReference colorAttachmentRef{ .attachment = 0, .layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL };
+    // the upscale covers every pixel, the previous contents are never read
+    VkAttachmentDescription colorAttachment{};
+    createAttachmentDescription(colorAttachment, m_format, VK_SAMPLE_COUNT_1_BIT, VK_ATTACHMENT_LOAD_OP_DONT_CARE, VK_ATTACHMENT_STORE_OP_STORE, presentLayout);
+    VkSubpassDescription subpass{};
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.colorAttachmentCount = 1;
+    subpass.pColorAttachments = &colorAttachmentRef;
+    // the acquire semaphore is waited on at the color output stage
+    VkSubpassDependency dependency{};
+    dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependency.dstSubpass = 0;
+    dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependency.srcAccessMask = 0;
+    dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    VkRenderPassCreateInfo renderPassInfo{};
+    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    renderPassInfo.attachmentCount = 1;
+    renderPassInfo.pAttachments = &colorAttachment;
+    renderPassInfo.subpassCount = 1;
+    renderPassInfo.pSubpasses = &subpass;
     renderPassInfo.dependencyCount = 1;
     renderPassInfo.pDependencies = &dependency;
-    if (vkCreateRenderPass(m_device.getVkDevice(), &renderPassInfo, nullptr, &m_renderPass) != VK_SUCCESS) {
-        throw utl::THROW_ERROR("failed to create render pass!");
+    if (vkCreateRenderPass(m_device.getVkDevice(), &renderPassInfo, nullptr, &m_presentRenderPass) != VK_SUCCESS) {
+        throw utl::THROW_ERROR("failed to create present render pass!");
     }
 }
 
@@ -267,12 +377,93 @@ void ven::SwapChain::cleanupSwapChain() {
     vkDestroyImageView(device, m_colorImageView, nullptr);
     vkDestroyImage(device, m_colorImage, nullptr);
     vkFreeMemory(device, m_colorImageMemory, nullptr);
+    vkDestroyImageView(device, m_sceneImageView, nullptr);
+    vkDestroyImage(device, m_sceneImage, nullptr);
+    vkFreeMemory(device, m_sceneImageMemory, nullptr);
+    vkDestroyFramebuffer(device, m_sceneFrameBuffer, nullptr);
     for (auto *const frameBuffer : m_swapChainFrameBuffers) {
         vkDestroyFramebuffer(device, frameBuffer, nullptr);
     }
     for (auto *const imageView : m_imageViews) {
         vkDestroyImageView(device, imageView, nullptr);
     }
-    vkDestroySwapchainKHR(device, m_swapChain, nullptr);
-    vkDestroyRenderPass(device, m_renderPass, nullptr);
+    if (m_device.isHeadless()) {
+        for (size_t i = 0; i < m_images.size(); i++) {
+            vkDestroyImage(device, m_images[i], nullptr);
+            vkFreeMemory(device, m_offscreenImageMemories[i], nullptr);
+        }
+    } else {
+        vkDestroySwapchainKHR(device, m_swapChain, nullptr);
+    }
+    for (auto *const renderPass : m_renderPasses) {
+        vkDestroyRenderPass(device, renderPass, nullptr);
+    }
+    vkDestroyRenderPass(device, m_presentRenderPass, nullptr);
+}
+
+bool ven::SwapChain::recreate(const VkExtent2D& windowExtent) {
+    const VkFormat oldFormat = m_format;
+    const VkExtent2D oldExtent = m_extent;
+    RetiredResources retired{ .swapChain = m_swapChain, .imageViews = std::move(m_imageViews), .frameBuffers = std::move(m_swapChainFrameBuffers) };
+    retired.frameBuffers.push_back(m_sceneFrameBuffer);
+    m_windowExtent = windowExtent;
+    createSwapChain(retired.swapChain);
+    createImageViews();
+    const bool formatChanged = m_format != oldFormat;
+    const bool resized = m_extent.width != oldExtent.width || m_extent.height != oldExtent.height;
+    if (formatChanged || resized) {
+        retired.images.push_back(m_colorImage);
+        retired.imageMemories.push_back(m_colorImageMemory);
+        retired.attachmentViews.push_back(m_colorImageView);
+        retired.images.push_back(m_sceneImage);
+        retired.imageMemories.push_back(m_sceneImageMemory);
+        retired.attachmentViews.push_back(m_sceneImageView);
+        createColorResources();
+    }
+    if (resized) {
+        retired.images.push_back(m_depthImage);
+        retired.imageMemories.push_back(m_depthImageMemory);
+        retired.attachmentViews.push_back(m_depthImageView);
+        createDepthResources();
+    }
+    if (formatChanged) {
+        retired.renderPasses = m_renderPasses;
+        retired.presentRenderPass = m_presentRenderPass;
+        createRenderPasses();
+    }
+    createFrameBuffers();
+    m_retired.push_back(std::move(retired));
+    return formatChanged;
+}
+
+void ven::SwapChain::releaseRetired(const bool all) {
+    const VkDevice& device = m_device.getVkDevice();
+    // a submitted frame has waited the fence of the frame framesInFlight before it, so once MAX_FRAMES_IN_FLIGHT frames
+    // were submitted after the one during which the retirement happened, nothing recorded with these handles is still running
+    std::erase_if(m_retired, [&](RetiredResources& retired) {
+        if (!all && --retired.framesLeft > 0) {
+            return false;
+        }
+        for (auto *const frameBuffer : retired.frameBuffers) {
+            vkDestroyFramebuffer(device, frameBuffer, nullptr);
+        }
+        for (auto *const imageView : retired.imageViews) {
+            vkDestroyImageView(device, imageView, nullptr);
+        }
+        for (auto *const imageView : retired.attachmentViews) {
+            vkDestroyImageView(device, imageView, nullptr);
+        }
+        for (auto *const image : retired.images) {
+            vkDestroyImage(device, image, nullptr);
+        }
+        for (auto *const memory : retired.imageMemories) {
+            vkFreeMemory(device, memory, nullptr);
+        }
+        vkDestroySwapchainKHR(device, retired.swapChain, nullptr);
+        for (auto *const renderPass : retired.renderPasses) {
+            vkDestroyRenderPass(device, renderPass, nullptr);
+        }
+        vkDestroyRenderPass(device, retired.presentRenderPass, nullptr);
+        return true;
+    });
 }
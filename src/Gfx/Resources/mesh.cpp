@@ -0,0 +1,22 @@
+#include "VEngine/Gfx/Resources/Mesh.hpp"
+
+void ven::Mesh::computeBounds() {
+    if (m_vertices.empty()) {
+        return;
+    }
+    glm::vec3 min = m_vertices.front().pos;
+    glm::vec3 max = min;
+    for (const Vertex& vertex : m_vertices) {
+        min = glm::min(min, vertex.pos);
+        max = glm::max(max, vertex.pos);
+    }
+    m_bounds.center = (min + max) * 0.5F;
+    m_bounds.extent = (max - min) * 0.5F;
+    // centered on the box so both volumes share it, tighter than the half diagonal for most meshes
+    float radiusSquared = 0.0F;
+    for (const Vertex& vertex : m_vertices) {
+        const glm::vec3 offset = vertex.pos - m_bounds.center;
+        radiusSquared = glm::max(radiusSquared, glm::dot(offset, offset));
+    }
+    m_bounds.radius = glm::sqrt(radiusSquared);
+}
@@ -4,12 +4,13 @@
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
 
+#include "Utils/Profiler.hpp"
 #include "VEngine/Gfx/Resources/Model.hpp"
 #include "VEngine/Gfx/Resources/TextureManager.hpp"
 
 template<> struct std::hash<ven::Vertex> {
     size_t operator()(ven::Vertex const& vertex) const noexcept {
-        return ((hash<glm::vec3>()(vertex.pos) ^ (hash<glm::vec3>()(vertex.color) << 1)) >> 1) ^ (hash<glm::vec2>()(vertex.texCoord) << 1);
+        return ((((hash<glm::vec3>()(vertex.pos) ^ (hash<glm::vec3>()(vertex.color) << 1)) >> 1) ^ (hash<glm::vec2>()(vertex.texCoord) << 1)) >> 1) ^ (hash<glm::vec3>()(vertex.normal) << 1);
     }
 };
 
@@ -29,26 +30,38 @@ glm::mat4 getNodeTransformation(const aiNode* node) {
 
 ven::Model::Model(const Device& device, const SwapChain& swapChain, const std::string& path)
     : m_device(device), m_swapChain(swapChain) {
+    PROFILE_SCOPE_DETAIL("Model", path);
     Assimp::Importer importer;
-    const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_JoinIdenticalVertices);
+    const aiScene* scene = nullptr;
+    {
+        PROFILE_SCOPE("Assimp::ReadFile");
+        scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_JoinIdenticalVertices | aiProcess_GenSmoothNormals);
+    }
     if (scene == nullptr || (scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE) != 0U || scene->mRootNode == nullptr) {
         throw utl::THROW_ERROR(importer.GetErrorString());
     }
-    processNode(scene->mRootNode, scene, device, swapChain, glm::mat4(1.0F));
+    std::unordered_map<unsigned int, uint32_t> meshIndices;
+    processNode(scene->mRootNode, scene, device, swapChain, ModelNode::NO_PARENT, meshIndices);
 }
 
-void ven::Model::processNode(const aiNode* node, const aiScene* scene, const Device& device, const SwapChain& swapChain, const glm::mat4 &parentTransform) {
-    const glm::mat4 globalTransform = parentTransform * getNodeTransformation(node);
+void ven::Model::processNode(const aiNode* node, const aiScene* scene, const Device& device, const SwapChain& swapChain, const uint32_t parent, std::unordered_map<unsigned int, uint32_t>& meshIndices) {
+    const auto index = static_cast<uint32_t>(m_nodes.size());
+    m_nodes.push_back({ .parent = parent, .local = getNodeTransformation(node) });
     for (unsigned int i = 0; i < node->mNumMeshes; i++) {
-        const aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-        m_meshes.push_back(processMesh(mesh, scene, device, swapChain, globalTransform));
+        // a mesh referenced by several nodes is imported once, each node only adds an instance of it
+        const unsigned int sceneMesh = node->mMeshes[i];
+        auto [it, inserted] = meshIndices.try_emplace(sceneMesh, static_cast<uint32_t>(m_meshes.size()));
+        if (inserted) {
+            m_meshes.push_back(processMesh(scene->mMeshes[sceneMesh], scene, device, swapChain));
+        }
+        m_instances.push_back({ .mesh = it->second, .node = index });
     }
     for (unsigned int i = 0; i < node->mNumChildren; i++) {
-        processNode(node->mChildren[i], scene, device, swapChain, globalTransform);
+        processNode(node->mChildren[i], scene, device, swapChain, index, meshIndices);
     }
 }
 
-std::unique_ptr<ven::Mesh> ven::Model::processMesh(const aiMesh* mesh, const aiScene* scene, const Device& device, const SwapChain& swapChain, const glm::mat4& transform) {
+std::unique_ptr<ven::Mesh> ven::Model::processMesh(const aiMesh* mesh, const aiScene* scene, const Device& device, const SwapChain& swapChain) {
     auto newMesh = std::make_unique<Mesh>();
     std::unordered_map<Vertex, uint32_t> uniqueVertices{};
     for (unsigned int i = 0; i < mesh->mNumVertices; i++) {
@@ -67,8 +80,9 @@ std::unique_ptr<ven::Mesh> ven::Model::processMesh(const aiMesh* mesh, const aiS
         } else {
             vertex.texCoord = {0.0F, 0.0F};
         }
-        glm::vec4 transformedPos = transform * glm::vec4(vertex.pos, 1.0f);
-        vertex.pos = glm::vec3(transformedPos);
+        if (mesh->mNormals != nullptr) {
+            vertex.normal = {mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z};
+        }
         if (!uniqueVertices.contains(vertex)) {
             uniqueVertices[vertex] = static_cast<uint32_t>(newMesh->getVertices().size());
             newMesh->addVertex(vertex);
@@ -84,7 +98,11 @@ std::unique_ptr<ven::Mesh> ven::Model::processMesh(const aiMesh* mesh, const aiS
             }, .color = {1.0F, 1.0F, 1.0F}, .texCoord = mesh->mTextureCoords[0] != nullptr ? glm::vec2{
                 mesh->mTextureCoords[0][face.mIndices[j]].x,
                 1.0F - mesh->mTextureCoords[0][face.mIndices[j]].y
-            } : glm::vec2{0.0F, 0.0F}
+            } : glm::vec2{0.0F, 0.0F}, .normal = mesh->mNormals != nullptr ? glm::vec3{
+                mesh->mNormals[face.mIndices[j]].x,
+                mesh->mNormals[face.mIndices[j]].y,
+                mesh->mNormals[face.mIndices[j]].z
+            } : glm::vec3{0.0F}
             }]);
         }
     }
@@ -103,6 +121,15 @@ std::unique_ptr<ven::Mesh> ven::Model::processMesh(const aiMesh* mesh, const aiS
         } else {
             newMesh->setTextureIndex(TextureManager::getTextureIndex("assets/textures/default.png"));
         }
+        // .mtl d / Tr land in the opacity, map_d in an opacity texture: foliage and chains of Sponza are cut out with it
+        float opacity = 1.0F;
+        material->Get(AI_MATKEY_OPACITY, opacity);
+        if (opacity < 1.0F) {
+            newMesh->setAlphaMode(AlphaMode::BLENDED);
+        } else if (material->GetTextureCount(aiTextureType_OPACITY) > 0) {
+            newMesh->setAlphaMode(AlphaMode::MASKED);
+        }
     }
+    newMesh->computeBounds();
     return newMesh;
 }
@@ -1,8 +1,10 @@
 #include <filesystem>
 
+#include "Utils/Profiler.hpp"
 #include "VEngine/Gfx/Resources/TextureManager.hpp"
 
 void ven::TextureManager::loadTextures(const Device& device, const SwapChain& swapChain, const std::string& directory) {
+    PROFILE_SCOPE_DETAIL("TextureManager::loadTextures", directory);
     auto& instance = getInstance();
     for (const auto& entry : std::filesystem::directory_iterator(directory)) {
         const auto& path = entry.path();
@@ -11,6 +13,7 @@ void ven::TextureManager::loadTextures(const Device& device, const SwapChain& sw
             instance.m_texturePaths.contains(filename) || extension != ".png" && extension != ".jpg") {
             continue;
         }
+        PROFILE_SCOPE_DETAIL("Texture", filename);
         const uint8_t newIndex = instance.m_nextIndex++;
         const auto texture = std::make_shared<Texture>(device, swapChain, filename);
         instance.m_textures[newIndex] = texture;
@@ -19,6 +22,7 @@ void ven::TextureManager::loadTextures(const Device& device, const SwapChain& sw
 }
 
 void ven::TextureManager::loadTexture(const Device& device, const SwapChain& swapChain, const std::string& filepath) {
+    PROFILE_SCOPE_DETAIL("TextureManager::loadTexture", filepath);
     auto& instance = getInstance();
     if (instance.m_texturePaths.contains(filepath)) {
         return;
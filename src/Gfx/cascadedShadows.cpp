@@ -0,0 +1,284 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "Utils/ErrorHandling.hpp"
+#include "Utils/Profiler.hpp"
+#include "VEngine/Gfx/CascadedShadows.hpp"
+
+ven::CascadedShadows::CascadedShadows(const Device& device, const Shaders& shaders, DescriptorLayoutCache& layoutCache, DescriptorAllocator& descriptorAllocator, const std::vector<VkBuffer>& objectBuffers, const VkDeviceSize objectBufferSize, const uint32_t objectCount) : m_device(device), m_objectCount(std::max(objectCount, 1U)) {
+    PROFILE_FUNCTION();
+    const VkDeviceSize instanceBufferSize = sizeof(uint32_t) * m_objectCount * CASCADE_COUNT;
+    for (size_t i = 0; i < SwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
+        m_device.createBuffer(instanceBufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_instanceBuffers.at(i), m_instanceMemories.at(i));
+        vkMapMemory(m_device.getVkDevice(), m_instanceMemories.at(i), 0, instanceBufferSize, 0, &m_instancesMapped.at(i));
+    }
+    createImage();
+    createRenderPass();
+    createDescriptors(layoutCache, descriptorAllocator, objectBuffers, objectBufferSize);
+    constexpr VkPushConstantRange pushConstantRange{ .stageFlags = VK_SHADER_STAGE_VERTEX_BIT, .offset = 0, .size = sizeof(ShadowConstants) };
+    const VkPipelineLayoutCreateInfo pipelineLayoutInfo{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+        .setLayoutCount = 1,
+        .pSetLayouts = &m_descriptorSetLayout,
+        .pushConstantRangeCount = 1,
+        .pPushConstantRanges = &pushConstantRange
+    };
+    if (vkCreatePipelineLayout(m_device.getVkDevice(), &pipelineLayoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS) {
+        throw utl::THROW_ERROR("failed to create shadow pipeline layout!");
+    }
+    m_pipeline = shaders.createShadowPipeline(m_pipelineLayout, m_renderPass, RESOLUTION);
+}
+
+ven::CascadedShadows::~CascadedShadows() {
+    const VkDevice& vkDevice = m_device.getVkDevice();
+    vkDestroyPipeline(vkDevice, m_pipeline, nullptr);
+    vkDestroyPipelineLayout(vkDevice, m_pipelineLayout, nullptr);
+    for (uint32_t cascade = 0; cascade < CASCADE_COUNT; cascade++) {
+        vkDestroyFramebuffer(vkDevice, m_frameBuffers.at(cascade), nullptr);
+        vkDestroyImageView(vkDevice, m_layerViews.at(cascade), nullptr);
+    }
+    vkDestroyRenderPass(vkDevice, m_renderPass, nullptr);
+    vkDestroySampler(vkDevice, m_sampler, nullptr);
+    vkDestroyImageView(vkDevice, m_arrayView, nullptr);
+    vkDestroyImage(vkDevice, m_image, nullptr);
+    vkFreeMemory(vkDevice, m_imageMemory, nullptr);
+    for (size_t i = 0; i < SwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
+        vkDestroyBuffer(vkDevice, m_instanceBuffers.at(i), nullptr);
+        vkFreeMemory(vkDevice, m_instanceMemories.at(i), nullptr);
+    }
+}
+
+void ven::CascadedShadows::createImage() {
+    const VkDevice& vkDevice = m_device.getVkDevice();
+    m_format = SwapChain::findDepthFormat(m_device);
+    const VkImageCreateInfo imageInfo{
+        .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+        .imageType = VK_IMAGE_TYPE_2D,
+        .format = m_format,
+        .extent = { .width = RESOLUTION, .height = RESOLUTION, .depth = 1 },
+        .mipLevels = 1,
+        .arrayLayers = CASCADE_COUNT,
+        .samples = VK_SAMPLE_COUNT_1_BIT,
+        .tiling = VK_IMAGE_TILING_OPTIMAL,
+        .usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+        .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED
+    };
+    if (vkCreateImage(vkDevice, &imageInfo, nullptr, &m_image) != VK_SUCCESS) {
+        throw utl::THROW_ERROR("failed to create shadow map image!");
+    }
+    VkMemoryRequirements memRequirements;
+    vkGetImageMemoryRequirements(vkDevice, m_image, &memRequirements);
+    const VkMemoryAllocateInfo allocInfo{ .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO, .allocationSize = memRequirements.size, .memoryTypeIndex = m_device.findMemoryType(memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) };
+    if (vkAllocateMemory(vkDevice, &allocInfo, nullptr, &m_imageMemory) != VK_SUCCESS) {
+        throw utl::THROW_ERROR("failed to allocate shadow map memory!");
+    }
+    vkBindImageMemory(vkDevice, m_image, m_imageMemory, 0);
+    // the depth aspect only, the format may carry stencil
+    VkImageViewCreateInfo viewInfo{
+        .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+        .image = m_image,
+        .viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY,
+        .format = m_format,
+        .subresourceRange = { .aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT, .baseMipLevel = 0, .levelCount = 1, .baseArrayLayer = 0, .layerCount = CASCADE_COUNT }
+    };
+    if (vkCreateImageView(vkDevice, &viewInfo, nullptr, &m_arrayView) != VK_SUCCESS) {
+        throw utl::THROW_ERROR("failed to create shadow map image view!");
+    }
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.subresourceRange.layerCount = 1;
+    for (uint32_t cascade = 0; cascade < CASCADE_COUNT; cascade++) {
+        viewInfo.subresourceRange.baseArrayLayer = cascade;
+        if (vkCreateImageView(vkDevice, &viewInfo, nullptr, &m_layerViews.at(cascade)) != VK_SUCCESS) {
+            throw utl::THROW_ERROR("failed to create shadow cascade image view!");
+        }
+    }
+    const VkSamplerCreateInfo samplerInfo{
+        .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+        .magFilter = VK_FILTER_LINEAR,
+        .minFilter = VK_FILTER_LINEAR,
+        .mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST,
+        .addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER,
+        .addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER,
+        .addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER,
+        .compareEnable = VK_TRUE,
+        .compareOp = VK_COMPARE_OP_LESS_OR_EQUAL,
+        .maxLod = 0.0F,
+        .borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE
+    };
+    if (vkCreateSampler(vkDevice, &samplerInfo, nullptr, &m_sampler) != VK_SUCCESS) {
+        throw utl::THROW_ERROR("failed to create shadow map sampler!");
+    }
+    // every layer is readable before its first render, the scene descriptor sets point at all of them
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    m_device.beginSingleTimeCommands(commandBuffer);
+    const VkImageMemoryBarrier barrier{
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .srcAccessMask = 0,
+        .dstAccessMask = VK_ACCESS_SHADER_READ_BIT,
+        .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+        .newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image = m_image,
+        .subresourceRange = { .aspectMask = static_cast<VkImageAspectFlags>(VK_IMAGE_ASPECT_DEPTH_BIT | (SwapChain::hasStencilComponent(m_format) ? VK_IMAGE_ASPECT_STENCIL_BIT : 0)),
+                              .baseMipLevel = 0, .levelCount = 1, .baseArrayLayer = 0, .layerCount = CASCADE_COUNT }
+    };
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+    m_device.endSingleTimeCommands(commandBuffer);
+}
+
+void ven::CascadedShadows::createRenderPass() {
+    const VkDevice& vkDevice = m_device.getVkDevice();
+    // a redrawn layer is cleared whole, what it held before does not matter
+    const VkAttachmentDescription depthAttachment{
+        .format = m_format,
+        .samples = VK_SAMPLE_COUNT_1_BIT,
+        .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+        .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+        .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+        .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+        .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+        .finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+    };
+    constexpr VkAttachmentReference depthReference{ .attachment = 0, .layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL };
+    const VkSubpassDescription subpass{ .pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS, .pDepthStencilAttachment = &depthReference };
+    // the previous frames may still sample the layer, the scene pass of this frame samples it next
+    const std::array<VkSubpassDependency, 2> dependencies{{
+        { .srcSubpass = VK_SUBPASS_EXTERNAL, .dstSubpass = 0, .srcStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+          .dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT, .srcAccessMask = 0, .dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT },
+        { .srcSubpass = 0, .dstSubpass = VK_SUBPASS_EXTERNAL, .srcStageMask = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+          .dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, .srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, .dstAccessMask = VK_ACCESS_SHADER_READ_BIT }
+    }};
+    const VkRenderPassCreateInfo renderPassInfo{
+        .sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
+        .attachmentCount = 1,
+        .pAttachments = &depthAttachment,
+        .subpassCount = 1,
+        .pSubpasses = &subpass,
+        .dependencyCount = static_cast<uint32_t>(dependencies.size()),
+        .pDependencies = dependencies.data()
+    };
+    if (vkCreateRenderPass(vkDevice, &renderPassInfo, nullptr, &m_renderPass) != VK_SUCCESS) {
+        throw utl::THROW_ERROR("failed to create shadow render pass!");
+    }
+    for (uint32_t cascade = 0; cascade < CASCADE_COUNT; cascade++) {
+        const VkFramebufferCreateInfo frameBufferInfo{
+            .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
+            .renderPass = m_renderPass,
+            .attachmentCount = 1,
+            .pAttachments = &m_layerViews.at(cascade),
+            .width = RESOLUTION,
+            .height = RESOLUTION,
+            .layers = 1
+        };
+        if (vkCreateFramebuffer(vkDevice, &frameBufferInfo, nullptr, &m_frameBuffers.at(cascade)) != VK_SUCCESS) {
+            throw utl::THROW_ERROR("failed to create shadow framebuffer!");
+        }
+    }
+}
+
+void ven::CascadedShadows::createDescriptors(DescriptorLayoutCache& layoutCache, DescriptorAllocator& descriptorAllocator, const std::vector<VkBuffer>& objectBuffers, const VkDeviceSize objectBufferSize) {
+    const VkDevice& vkDevice = m_device.getVkDevice();
+    // 0 objects, 1 instances of every cascade
+    const std::array<VkDescriptorSetLayoutBinding, 2> bindings{{
+        { .binding = 0, .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, .descriptorCount = 1, .stageFlags = VK_SHADER_STAGE_VERTEX_BIT },
+        { .binding = 1, .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, .descriptorCount = 1, .stageFlags = VK_SHADER_STAGE_VERTEX_BIT }
+    }};
+    m_descriptorSetLayout = layoutCache.getLayout(bindings);
+    for (size_t i = 0; i < SwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
+        m_descriptorSets.at(i) = descriptorAllocator.allocatePersistent(m_descriptorSetLayout);
+        const std::array<VkDescriptorBufferInfo, 2> bufferInfos{{
+            { .buffer = objectBuffers.at(i), .offset = 0, .range = objectBufferSize },
+            { .buffer = m_instanceBuffers.at(i), .offset = 0, .range = VK_WHOLE_SIZE }
+        }};
+        std::array<VkWriteDescriptorSet, 2> writes{};
+        for (uint32_t write = 0; write < writes.size(); write++) {
+            writes.at(write) = { .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, .dstSet = m_descriptorSets.at(i), .dstBinding = write, .descriptorCount = 1, .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, .pBufferInfo = &bufferInfos.at(write) };
+        }
+        vkUpdateDescriptorSets(vkDevice, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+    }
+}
+
+void ven::CascadedShadows::update(const ShadowView& view, const RenderSettings& settings, const glm::vec3& sunDirection, const Bounds& sceneBounds, const bool castersChanged, ShadowStats& stats) {
+    PROFILE_FUNCTION();
+    if (castersChanged || !settings.cacheShadows) {
+        invalidate();
+    }
+    const float near = view.near;
+    const float distance = std::max(std::min(settings.shadowDistance, view.far), near * 2.0F);
+    // squared half diagonal of the frustum per unit of depth, the corners of a slice at depth z are z * k away from the axis
+    const float tanHalfFov = std::tan(view.fov * 0.5F);
+    const float k2 = tanHalfFov * tanHalfFov * (1.0F + (view.aspect * view.aspect));
+    const glm::mat4 inverseView = glm::inverse(view.view);
+    // rotation into light space, looking along the light, the translation is folded into the orthographic bounds
+    const glm::vec3 up = std::abs(sunDirection.y) > 0.99F ? glm::vec3(0.0F, 0.0F, 1.0F) : glm::vec3(0.0F, 1.0F, 0.0F);
+    const glm::mat4 lightRotation = glm::lookAt(glm::vec3(0.0F), -sunDirection, up);
+    const glm::vec3 sceneMin = sceneBounds.center - sceneBounds.extent;
+    const glm::vec3 sceneMax = sceneBounds.center + sceneBounds.extent;
+    // light space z of the scene corner nearest to the sun
+    float sceneTop = std::numeric_limits<float>::lowest();
+    for (uint32_t corner = 0; corner < 8; corner++) {
+        const glm::vec3 point((corner & 1) != 0 ? sceneMax.x : sceneMin.x, (corner & 2) != 0 ? sceneMax.y : sceneMin.y, (corner & 4) != 0 ? sceneMax.z : sceneMin.z);
+        sceneTop = std::max(sceneTop, (lightRotation * glm::vec4(point, 1.0F)).z);
+    }
+    float sliceNear = near;
+    for (uint32_t cascade = 0; cascade < CASCADE_COUNT; cascade++) {
+        // practical split scheme: a blend of the logarithmic and the uniform distributions
+        const float ratio = static_cast<float>(cascade + 1) / static_cast<float>(CASCADE_COUNT);
+        const float logSplit = near * std::pow(distance / near, ratio);
+        const float uniformSplit = near + ((distance - near) * ratio);
+        const float sliceFar = glm::mix(uniformSplit, logSplit, settings.cascadeSplitLambda);
+        m_splits[static_cast<glm::length_t>(cascade)] = sliceFar;
+        // smallest sphere around the slice, centered on the view axis, its radius only depends on the split depths
+        const float centerDepth = std::min(sliceFar, (sliceFar + sliceNear) * 0.5F * (1.0F + k2));
+        float radius = std::sqrt(((sliceFar - centerDepth) * (sliceFar - centerDepth)) + (sliceFar * sliceFar * k2));
+        // rounded up so float noise in the splits cannot change the texel size frame to frame
+        radius = std::ceil(radius * 16.0F) / 16.0F;
+        sliceNear = sliceFar;
+        const float texelSize = radius * 2.0F / static_cast<float>(RESOLUTION);
+        glm::vec3 center = glm::vec3(lightRotation * inverseView * glm::vec4(0.0F, 0.0F, -centerDepth, 1.0F));
+        center = glm::floor(center / texelSize) * texelSize;
+        // the near plane reaches back to the scene so casters outside the slice still cast into it
+        const float zNear = -std::max(sceneTop, center.z + radius);
+        const float zFar = -(center.z - radius);
+        const glm::mat4 viewProjection = glm::ortho(center.x - radius, center.x + radius, center.y - radius, center.y + radius, zNear, zFar) * lightRotation;
+        const bool reuse = m_valid.at(cascade) && viewProjection == m_viewProjections.at(cascade);
+        m_redraw.at(cascade) = !reuse;
+        m_valid.at(cascade) = true;
+        m_viewProjections.at(cascade) = viewProjection;
+        stats.cached.at(cascade) = reuse;
+        if (reuse) {
+            stats.cacheHits++;
+        } else {
+            stats.cacheMisses++;
+        }
+    }
+}
+
+void ven::CascadedShadows::record(const VkCommandBuffer& commandBuffer, const uint32_t frameIndex, const uint32_t cascade, const glm::mat4& viewProjection, const VkBuffer& indexBuffer, const VkBuffer& vertexBuffer, const std::span<const DrawCommand> draws) const {
+    const VkClearValue clearValue{ .depthStencil = { .depth = 1.0F, .stencil = 0 } };
+    const VkRenderPassBeginInfo renderPassInfo{
+        .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
+        .renderPass = m_renderPass,
+        .framebuffer = m_frameBuffers.at(cascade),
+        .renderArea = { .offset = { .x = 0, .y = 0 }, .extent = { .width = RESOLUTION, .height = RESOLUTION } },
+        .clearValueCount = 1,
+        .pClearValues = &clearValue
+    };
+    vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout, 0, 1, &m_descriptorSets.at(frameIndex), 0, nullptr);
+    const ShadowConstants constants{ .viewProjection = viewProjection, .firstInstance = cascade * m_objectCount };
+    vkCmdPushConstants(commandBuffer, m_pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(constants), &constants);
+    constexpr VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, &vertexBuffer, &offset);
+    vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+    for (const DrawCommand& draw : draws) {
+        vkCmdDrawIndexed(commandBuffer, draw.indexCount, draw.instanceCount, draw.firstIndex, draw.vertexOffset, draw.firstInstance);
+    }
+    vkCmdEndRenderPass(commandBuffer);
+}
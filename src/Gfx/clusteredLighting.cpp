@@ -0,0 +1,79 @@
+#include <cmath>
+
+#include "Utils/ErrorHandling.hpp"
+#include "Utils/Profiler.hpp"
+#include "VEngine/Gfx/ClusteredLighting.hpp"
+
+ven::ClusteredLighting::ClusteredLighting(const Device& device, const Shaders& shaders, DescriptorLayoutCache& layoutCache, DescriptorAllocator& descriptorAllocator, const Buffers& buffers) : m_device(device) {
+    PROFILE_FUNCTION();
+    for (size_t i = 0; i < SwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
+        m_clusterBuffers.at(i) = buffers.clusterBuffers.at(i);
+    }
+    createDescriptors(layoutCache, descriptorAllocator, buffers);
+    constexpr VkPushConstantRange pushConstantRange{ .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT, .offset = 0, .size = sizeof(ClusterConstants) };
+    const VkPipelineLayoutCreateInfo pipelineLayoutInfo{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+        .setLayoutCount = 1,
+        .pSetLayouts = &m_descriptorSetLayout,
+        .pushConstantRangeCount = 1,
+        .pPushConstantRanges = &pushConstantRange
+    };
+    if (vkCreatePipelineLayout(m_device.getVkDevice(), &pipelineLayoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS) {
+        throw utl::THROW_ERROR("failed to create light clustering pipeline layout!");
+    }
+    m_pipeline = shaders.createComputePipeline("cluster_lights", m_pipelineLayout);
+}
+
+ven::ClusteredLighting::~ClusteredLighting() {
+    const VkDevice& vkDevice = m_device.getVkDevice();
+    vkDestroyPipeline(vkDevice, m_pipeline, nullptr);
+    vkDestroyPipelineLayout(vkDevice, m_pipelineLayout, nullptr);
+}
+
+void ven::ClusteredLighting::createDescriptors(DescriptorLayoutCache& layoutCache, DescriptorAllocator& descriptorAllocator, const Buffers& buffers) {
+    const VkDevice& vkDevice = m_device.getVkDevice();
+    // 0 camera, 1 lights, 2 clusters
+    std::array<VkDescriptorSetLayoutBinding, BINDING_COUNT> bindings{};
+    for (uint32_t binding = 0; binding < bindings.size(); binding++) {
+        bindings.at(binding) = { .binding = binding, .descriptorType = binding == 0 ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, .descriptorCount = 1, .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT };
+    }
+    m_descriptorSetLayout = layoutCache.getLayout(bindings);
+    for (size_t i = 0; i < SwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
+        m_descriptorSets.at(i) = descriptorAllocator.allocatePersistent(m_descriptorSetLayout);
+        const std::array<VkDescriptorBufferInfo, BINDING_COUNT> bufferInfos{{
+            { .buffer = buffers.uniformBuffers.at(i), .offset = 0, .range = buffers.uniformBufferSize },
+            { .buffer = buffers.lightBuffers.at(i), .offset = 0, .range = LIGHT_BUFFER_SIZE },
+            { .buffer = buffers.clusterBuffers.at(i), .offset = 0, .range = CLUSTER_BUFFER_SIZE }
+        }};
+        std::array<VkWriteDescriptorSet, BINDING_COUNT> writes{};
+        for (uint32_t write = 0; write < writes.size(); write++) {
+            writes.at(write) = {
+                .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                .dstSet = m_descriptorSets.at(i),
+                .dstBinding = write,
+                .descriptorCount = 1,
+                .descriptorType = bindings.at(write).descriptorType,
+                .pBufferInfo = &bufferInfos.at(write)
+            };
+        }
+        vkUpdateDescriptorSets(vkDevice, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+    }
+}
+
+glm::vec4 ven::ClusteredLighting::getClusterScale(const VkExtent2D extent, const float near, const float far) {
+    // slice k starts at near * (far / near)^(k / SLICES)
+    const float sliceScale = static_cast<float>(SLICES) / std::log(far / near);
+    return { static_cast<float>(TILES_X) / static_cast<float>(extent.width), static_cast<float>(TILES_Y) / static_cast<float>(extent.height), sliceScale, -std::log(near) * sliceScale };
+}
+
+void ven::ClusteredLighting::record(const VkCommandBuffer& commandBuffer, const uint32_t frameIndex, const uint32_t lightCount, const float near, const float far) const {
+    const ClusterConstants constants{ .lightCount = lightCount, .near = near, .far = far };
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipeline);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipelineLayout, 0, 1, &m_descriptorSets.at(frameIndex), 0, nullptr);
+    vkCmdPushConstants(commandBuffer, m_pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(constants), &constants);
+    vkCmdDispatch(commandBuffer, (CLUSTER_COUNT + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1);
+    // the previous reader of the slot buffer is done, its fence was waited on; only the fragment shader reads it next
+    const VkBufferMemoryBarrier barrier{ .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER, .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT, .dstAccessMask = VK_ACCESS_SHADER_READ_BIT,
+                                         .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED, .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED, .buffer = m_clusterBuffers.at(frameIndex), .offset = 0, .size = VK_WHOLE_SIZE };
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 1, &barrier, 0, nullptr);
+}
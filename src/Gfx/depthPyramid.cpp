@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <bit>
+
+#include "Utils/ErrorHandling.hpp"
+#include "Utils/Profiler.hpp"
+#include "VEngine/Gfx/DepthPyramid.hpp"
+
+static constexpr VkFormat PYRAMID_FORMAT = VK_FORMAT_R32_SFLOAT;
+
+static VkImageView createLevelView(const VkDevice& device, const VkImage& image, const uint32_t baseLevel, const uint32_t levelCount) {
+    const VkImageViewCreateInfo viewInfo{
+        .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+        .image = image,
+        .viewType = VK_IMAGE_VIEW_TYPE_2D,
+        .format = PYRAMID_FORMAT,
+        .subresourceRange = { .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .baseMipLevel = baseLevel, .levelCount = levelCount, .baseArrayLayer = 0, .layerCount = 1 }
+    };
+    VkImageView imageView = VK_NULL_HANDLE;
+    if (vkCreateImageView(device, &viewInfo, nullptr, &imageView) != VK_SUCCESS) {
+        throw utl::THROW_ERROR("failed to create depth pyramid image view!");
+    }
+    return imageView;
+}
+
+ven::DepthPyramid::DepthPyramid(const Device& device, const Shaders& shaders, const SwapChain& swapChain, DescriptorLayoutCache& layoutCache, DescriptorAllocator& descriptorAllocator) : m_device(device), m_descriptorAllocator(descriptorAllocator), m_multisampled(device.getMsaaSamples() != VK_SAMPLE_COUNT_1_BIT) {
+    PROFILE_FUNCTION();
+    const VkDevice& vkDevice = m_device.getVkDevice();
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_NEAREST;
+    samplerInfo.minFilter = VK_FILTER_NEAREST;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.minLod = 0.0F;
+    samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
+    if (vkCreateSampler(vkDevice, &samplerInfo, nullptr, &m_sampler) != VK_SUCCESS) {
+        throw utl::THROW_ERROR("failed to create depth pyramid sampler!");
+    }
+    // 0 source level (or the depth attachment), 1 destination level
+    const std::array<VkDescriptorSetLayoutBinding, 2> bindings{{
+        { .binding = 0, .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, .descriptorCount = 1, .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT },
+        { .binding = 1, .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, .descriptorCount = 1, .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT }
+    }};
+    m_descriptorSetLayout = layoutCache.getLayout(bindings);
+    constexpr VkPushConstantRange pushConstantRange{ .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT, .offset = 0, .size = sizeof(ReduceConstants) };
+    const VkPipelineLayoutCreateInfo pipelineLayoutInfo{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+        .setLayoutCount = 1,
+        .pSetLayouts = &m_descriptorSetLayout,
+        .pushConstantRangeCount = 1,
+        .pPushConstantRanges = &pushConstantRange
+    };
+    if (vkCreatePipelineLayout(vkDevice, &pipelineLayoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS) {
+        throw utl::THROW_ERROR("failed to create depth pyramid pipeline layout!");
+    }
+    m_reducePipeline = shaders.createComputePipeline("depth_reduce_shader", m_pipelineLayout);
+    if (m_multisampled) {
+        m_depthPipeline = shaders.createComputePipeline("depth_reduce_ms_shader", m_pipelineLayout);
+    }
+    create(swapChain);
+}
+
+ven::DepthPyramid::~DepthPyramid() {
+    const VkDevice& vkDevice = m_device.getVkDevice();
+    for (uint32_t level = 0; level < m_levelCount; level++) {
+        vkDestroyImageView(vkDevice, m_levelViews.at(level), nullptr);
+    }
+    vkDestroyImageView(vkDevice, m_imageView, nullptr);
+    vkDestroyImage(vkDevice, m_image, nullptr);
+    vkFreeMemory(vkDevice, m_imageMemory, nullptr);
+    vkDestroyPipeline(vkDevice, m_depthPipeline, nullptr);
+    vkDestroyPipeline(vkDevice, m_reducePipeline, nullptr);
+    vkDestroyPipelineLayout(vkDevice, m_pipelineLayout, nullptr);
+    vkDestroySampler(vkDevice, m_sampler, nullptr);
+}
+
+void ven::DepthPyramid::create(const SwapChain& swapChain) {
+    const VkDevice& vkDevice = m_device.getVkDevice();
+    m_depthExtent = swapChain.getExtent();
+    m_depthView = swapChain.getDepthImageView();
+    m_width = std::bit_floor(m_depthExtent.width);
+    m_height = std::bit_floor(m_depthExtent.height);
+    m_levelCount = std::min(static_cast<uint32_t>(std::bit_width(std::max(m_width, m_height))), MAX_LEVELS);
+    swapChain.createImage(m_width, m_height, m_levelCount, VK_SAMPLE_COUNT_1_BIT, PYRAMID_FORMAT, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_image, m_imageMemory);
+    m_imageView = createLevelView(vkDevice, m_image, 0, m_levelCount);
+    for (uint32_t level = 0; level < m_levelCount; level++) {
+        m_levelViews.at(level) = createLevelView(vkDevice, m_image, level, 1);
+    }
+    // moved to VK_IMAGE_LAYOUT_GENERAL by the first record, a single time command would wait for the queue
+    m_initialized = false;
+}
+
+void ven::DepthPyramid::resize(SwapChain& swapChain) {
+    const VkExtent2D& extent = swapChain.getExtent();
+    if (extent.width == m_depthExtent.width && extent.height == m_depthExtent.height) {
+        return;
+    }
+    std::vector<VkImageView> views(m_levelViews.begin(), m_levelViews.begin() + m_levelCount);
+    views.push_back(m_imageView);
+    swapChain.retireImage(m_image, m_imageMemory, std::move(views));
+    create(swapChain);
+}
+
+void ven::DepthPyramid::record(const VkCommandBuffer& commandBuffer, const uint32_t frameIndex, const VkExtent2D renderExtent) {
+    const VkDevice& vkDevice = m_device.getVkDevice();
+    // freed with the other sets of the slot once its fence signals, a resize never updates a set in use
+    std::array<VkDescriptorSet, MAX_LEVELS> descriptorSets{};
+    for (uint32_t level = 0; level < m_levelCount; level++) {
+        descriptorSets.at(level) = m_descriptorAllocator.allocate(frameIndex, m_descriptorSetLayout);
+        const VkDescriptorImageInfo sourceInfo = level == 0
+            ? VkDescriptorImageInfo{ .sampler = m_sampler, .imageView = m_depthView, .imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL }
+            : VkDescriptorImageInfo{ .sampler = m_sampler, .imageView = m_levelViews.at(level - 1), .imageLayout = VK_IMAGE_LAYOUT_GENERAL };
+        const VkDescriptorImageInfo destinationInfo{ .sampler = VK_NULL_HANDLE, .imageView = m_levelViews.at(level), .imageLayout = VK_IMAGE_LAYOUT_GENERAL };
+        const std::array<VkWriteDescriptorSet, 2> writes{{
+            { .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, .dstSet = descriptorSets.at(level), .dstBinding = 0, .descriptorCount = 1, .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, .pImageInfo = &sourceInfo },
+            { .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, .dstSet = descriptorSets.at(level), .dstBinding = 1, .descriptorCount = 1, .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, .pImageInfo = &destinationInfo }
+        }};
+        vkUpdateDescriptorSets(vkDevice, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+    }
+    // the previous frame may still sample the pyramid in its culling pass
+    VkImageMemoryBarrier barrier{
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .srcAccessMask = m_initialized ? VK_ACCESS_SHADER_READ_BIT : VkAccessFlags{0},
+        .dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+        .oldLayout = m_initialized ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_UNDEFINED,
+        .newLayout = VK_IMAGE_LAYOUT_GENERAL,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image = m_image,
+        .subresourceRange = { .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .baseMipLevel = 0, .levelCount = m_levelCount, .baseArrayLayer = 0, .layerCount = 1 }
+    };
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+    m_initialized = true;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    barrier.subresourceRange.levelCount = 1;
+    // the depth outside the rendered area is left over from older frames
+    ReduceConstants constants{ .sourceWidth = static_cast<int32_t>(renderExtent.width), .sourceHeight = static_cast<int32_t>(renderExtent.height), .destinationWidth = 0, .destinationHeight = 0 };
+    for (uint32_t level = 0; level < m_levelCount; level++) {
+        constants.destinationWidth = std::max(1, static_cast<int32_t>(m_width >> level));
+        constants.destinationHeight = std::max(1, static_cast<int32_t>(m_height >> level));
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, level == 0 && m_multisampled ? m_depthPipeline : m_reducePipeline);
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipelineLayout, 0, 1, &descriptorSets.at(level), 0, nullptr);
+        vkCmdPushConstants(commandBuffer, m_pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(constants), &constants);
+        vkCmdDispatch(commandBuffer, (static_cast<uint32_t>(constants.destinationWidth) + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, (static_cast<uint32_t>(constants.destinationHeight) + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1);
+        // the next level and the culling shader read what was just written
+        barrier.subresourceRange.baseMipLevel = level;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+        constants.sourceWidth = constants.destinationWidth;
+        constants.sourceHeight = constants.destinationHeight;
+    }
+}
@@ -0,0 +1,188 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+#include "Utils/ErrorHandling.hpp"
+#include "Utils/Profiler.hpp"
+#include "VEngine/Gfx/GpuCulling.hpp"
+#include "VEngine/Gfx/Resources/Model.hpp"
+
+static constexpr VkDeviceSize COUNTS_SIZE = sizeof(uint32_t) * 4;
+static constexpr uint32_t PYRAMID_BINDING = 5;
+static constexpr uint32_t BINDING_COUNT = 9;
+
+ven::GpuCulling::GpuCulling(const Device& device, const Shaders& shaders, DescriptorLayoutCache& layoutCache, DescriptorAllocator& descriptorAllocator, const std::vector<DrawData>& draws,
+                            const std::vector<uint32_t>& objectGroups, const Buffers& buffers, const DepthPyramid& depthPyramid) : m_device(device), m_drawCount(static_cast<uint32_t>(draws.size())), m_objectCount(static_cast<uint32_t>(objectGroups.size())) {
+    PROFILE_FUNCTION();
+    const VkDevice& vkDevice = m_device.getVkDevice();
+    // zero sized buffers are not allowed, one empty draw / object keeps the descriptors valid
+    Model::createBuffer(m_device, draws.empty() ? std::vector<DrawData>(1) : draws, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, m_drawBuffer, m_drawBufferMemory);
+    Model::createBuffer(m_device, objectGroups.empty() ? std::vector<uint32_t>(1) : objectGroups, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, m_objectGroupBuffer, m_objectGroupMemory);
+    // nothing was visible before the first frame, its LATE phase draws everything in the frustum
+    Model::createBuffer(m_device, std::vector<uint32_t>(std::max(m_objectCount, 1U), 0), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, m_visibilityBuffer, m_visibilityMemory);
+    // the late phase instances live in the second half of the instance buffer, see Renderer::getInstanceBufferSize
+    std::vector<VkDrawIndexedIndirectCommand> commands(static_cast<size_t>(std::max(m_drawCount, 1U)) * 2);
+    for (uint32_t phase = 0; phase < 2; phase++) {
+        for (uint32_t i = 0; i < m_drawCount; i++) {
+            commands[(phase * m_drawCount) + i] = { .indexCount = draws[i].indexCount, .instanceCount = 0, .firstIndex = draws[i].firstIndex,
+                                                    .vertexOffset = draws[i].vertexOffset, .firstInstance = (phase * m_objectCount) + draws[i].instanceOffset };
+        }
+    }
+    Model::createBuffer(m_device, commands, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, m_templateBuffer, m_templateMemory);
+    const VkDeviceSize commandsSize = sizeof(VkDrawIndexedIndirectCommand) * commands.size();
+    for (size_t i = 0; i < SwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
+        m_device.createBuffer(commandsSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_commandBuffers.at(i), m_commandMemories.at(i));
+        m_device.createBuffer(COUNTS_SIZE, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_countBuffers.at(i), m_countMemories.at(i));
+        if (vkMapMemory(vkDevice, m_countMemories.at(i), 0, COUNTS_SIZE, 0, &m_countsMapped.at(i)) != VK_SUCCESS) {
+            throw utl::THROW_ERROR("failed to map culling count buffer!");
+        }
+        m_instanceBuffers.at(i) = buffers.instanceBuffers.at(i);
+    }
+    createDescriptors(layoutCache, descriptorAllocator, buffers);
+    setDepthPyramid(depthPyramid);
+    constexpr VkPushConstantRange pushConstantRange{ .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT, .offset = 0, .size = sizeof(CullConstants) };
+    const VkPipelineLayoutCreateInfo pipelineLayoutInfo{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+        .setLayoutCount = 1,
+        .pSetLayouts = &m_descriptorSetLayout,
+        .pushConstantRangeCount = 1,
+        .pPushConstantRanges = &pushConstantRange
+    };
+    if (vkCreatePipelineLayout(vkDevice, &pipelineLayoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS) {
+        throw utl::THROW_ERROR("failed to create culling pipeline layout!");
+    }
+    m_pipeline = shaders.createComputePipeline("cull_shader", m_pipelineLayout);
+}
+
+ven::GpuCulling::~GpuCulling() {
+    const VkDevice& vkDevice = m_device.getVkDevice();
+    vkDestroyPipeline(vkDevice, m_pipeline, nullptr);
+    vkDestroyPipelineLayout(vkDevice, m_pipelineLayout, nullptr);
+    for (size_t i = 0; i < SwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
+        vkDestroyBuffer(vkDevice, m_commandBuffers.at(i), nullptr);
+        vkFreeMemory(vkDevice, m_commandMemories.at(i), nullptr);
+        vkDestroyBuffer(vkDevice, m_countBuffers.at(i), nullptr);
+        vkFreeMemory(vkDevice, m_countMemories.at(i), nullptr);
+    }
+    vkDestroyBuffer(vkDevice, m_templateBuffer, nullptr);
+    vkFreeMemory(vkDevice, m_templateMemory, nullptr);
+    vkDestroyBuffer(vkDevice, m_visibilityBuffer, nullptr);
+    vkFreeMemory(vkDevice, m_visibilityMemory, nullptr);
+    vkDestroyBuffer(vkDevice, m_objectGroupBuffer, nullptr);
+    vkFreeMemory(vkDevice, m_objectGroupMemory, nullptr);
+    vkDestroyBuffer(vkDevice, m_drawBuffer, nullptr);
+    vkFreeMemory(vkDevice, m_drawBufferMemory, nullptr);
+}
+
+void ven::GpuCulling::createDescriptors(DescriptorLayoutCache& layoutCache, DescriptorAllocator& descriptorAllocator, const Buffers& buffers) {
+    const VkDevice& vkDevice = m_device.getVkDevice();
+    // 0 camera, 1 objects, 2 draws, 3 indirect commands, 4 counts, 5 depth pyramid, 6 visibility, 7 object groups, 8 instances
+    std::array<VkDescriptorSetLayoutBinding, BINDING_COUNT> bindings{};
+    for (uint32_t binding = 0; binding < bindings.size(); binding++) {
+        VkDescriptorType type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        if (binding == 0) {
+            type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        } else if (binding == PYRAMID_BINDING) {
+            type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        }
+        bindings.at(binding) = { .binding = binding, .descriptorType = type, .descriptorCount = 1, .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT };
+    }
+    m_descriptorSetLayout = layoutCache.getLayout(bindings);
+    for (size_t i = 0; i < SwapChain::MAX_FRAMES_IN_FLIGHT; i++) {
+        m_descriptorSets.at(i) = descriptorAllocator.allocatePersistent(m_descriptorSetLayout);
+        // the pyramid is written by setDepthPyramid
+        const std::array<uint32_t, BINDING_COUNT - 1> bufferBindings{0, 1, 2, 3, 4, 6, 7, 8};
+        const std::array<VkDescriptorBufferInfo, BINDING_COUNT - 1> bufferInfos{{
+            { .buffer = buffers.uniformBuffers.at(i), .offset = 0, .range = buffers.uniformBufferSize },
+            { .buffer = buffers.objectBuffers.at(i), .offset = 0, .range = buffers.objectBufferSize },
+            { .buffer = m_drawBuffer, .offset = 0, .range = VK_WHOLE_SIZE },
+            { .buffer = m_commandBuffers.at(i), .offset = 0, .range = VK_WHOLE_SIZE },
+            { .buffer = m_countBuffers.at(i), .offset = 0, .range = COUNTS_SIZE },
+            { .buffer = m_visibilityBuffer, .offset = 0, .range = VK_WHOLE_SIZE },
+            { .buffer = m_objectGroupBuffer, .offset = 0, .range = VK_WHOLE_SIZE },
+            { .buffer = buffers.instanceBuffers.at(i), .offset = 0, .range = buffers.instanceBufferSize }
+        }};
+        std::array<VkWriteDescriptorSet, BINDING_COUNT - 1> writes{};
+        for (size_t write = 0; write < writes.size(); write++) {
+            writes.at(write) = {
+                .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                .dstSet = m_descriptorSets.at(i),
+                .dstBinding = bufferBindings.at(write),
+                .descriptorCount = 1,
+                .descriptorType = bindings.at(bufferBindings.at(write)).descriptorType,
+                .pBufferInfo = &bufferInfos.at(write)
+            };
+        }
+        vkUpdateDescriptorSets(vkDevice, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+    }
+}
+
+void ven::GpuCulling::setDepthPyramid(const DepthPyramid& depthPyramid) {
+    m_pyramidWidth = depthPyramid.getWidth();
+    m_pyramidHeight = depthPyramid.getHeight();
+    m_pyramidLevels = depthPyramid.getLevelCount();
+    m_pyramidInfo = { .sampler = depthPyramid.getSampler(), .imageView = depthPyramid.getImageView(), .imageLayout = VK_IMAGE_LAYOUT_GENERAL };
+    // the sets of the frames in flight are still read, each is written by the next record of its slot
+    m_pyramidOutdated.fill(true);
+}
+
+void ven::GpuCulling::record(const VkCommandBuffer& commandBuffer, const uint32_t frameIndex, const CullingPhase phase) {
+    if (m_pyramidOutdated.at(frameIndex)) {
+        // the fence of the slot signaled, its set is not in use anymore
+        const VkWriteDescriptorSet write{ .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, .dstSet = m_descriptorSets.at(frameIndex), .dstBinding = PYRAMID_BINDING, .descriptorCount = 1,
+                                          .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, .pImageInfo = &m_pyramidInfo };
+        vkUpdateDescriptorSets(m_device.getVkDevice(), 1, &write, 0, nullptr);
+        m_pyramidOutdated.at(frameIndex) = false;
+    }
+    const VkBuffer& commands = m_commandBuffers.at(frameIndex);
+    const VkBuffer& countBuffer = m_countBuffers.at(frameIndex);
+    // the visible set was written by the LATE phase of the previous frame, or by EARLY for the commands and counts
+    constexpr VkMemoryBarrier visibilityBarrier{ .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER, .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT, .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT };
+    if (phase == CullingPhase::LATE) {
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &visibilityBarrier, 0, nullptr, 0, nullptr);
+    } else {
+        const VkBufferCopy copyRegion{ .srcOffset = 0, .dstOffset = 0, .size = sizeof(VkDrawIndexedIndirectCommand) * static_cast<VkDeviceSize>(std::max(m_drawCount, 1U)) * 2 };
+        vkCmdCopyBuffer(commandBuffer, m_templateBuffer, commands, 1, &copyRegion);
+        vkCmdFillBuffer(commandBuffer, countBuffer, 0, COUNTS_SIZE, 0);
+        const std::array<VkBufferMemoryBarrier, 2> clearBarriers{{
+            { .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER, .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT, .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+              .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED, .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED, .buffer = commands, .offset = 0, .size = VK_WHOLE_SIZE },
+            { .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER, .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT, .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+              .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED, .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED, .buffer = countBuffer, .offset = 0, .size = COUNTS_SIZE }
+        }};
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &visibilityBarrier, static_cast<uint32_t>(clearBarriers.size()), clearBarriers.data(), 0, nullptr);
+    }
+    const CullConstants constants{ .objectCount = m_objectCount, .drawCount = m_drawCount, .phase = phase, .pyramidWidth = m_pyramidWidth, .pyramidHeight = m_pyramidHeight, .pyramidLevels = m_pyramidLevels };
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipeline);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipelineLayout, 0, 1, &m_descriptorSets.at(frameIndex), 0, nullptr);
+    vkCmdPushConstants(commandBuffer, m_pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(constants), &constants);
+    vkCmdDispatch(commandBuffer, (m_objectCount + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1);
+    // the commands are consumed by the indirect draw, the instances by the vertex shader, the counts by the host
+    const std::array<VkBufferMemoryBarrier, 3> cullBarriers{{
+        { .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER, .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT, .dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+          .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED, .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED, .buffer = commands, .offset = 0, .size = VK_WHOLE_SIZE },
+        { .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER, .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT, .dstAccessMask = VK_ACCESS_SHADER_READ_BIT,
+          .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED, .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED, .buffer = m_instanceBuffers.at(frameIndex), .offset = 0, .size = VK_WHOLE_SIZE },
+        { .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER, .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT, .dstAccessMask = VK_ACCESS_HOST_READ_BIT,
+          .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED, .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED, .buffer = countBuffer, .offset = 0, .size = COUNTS_SIZE }
+    }};
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_HOST_BIT, 0, 0, nullptr, static_cast<uint32_t>(cullBarriers.size()), cullBarriers.data(), 0, nullptr);
+}
+
+void ven::GpuCulling::draw(const VkCommandBuffer& commandBuffer, const uint32_t frameIndex, const CullingPhase phase, const uint32_t firstDraw, const uint32_t drawCount) const {
+    if (drawCount == 0) {
+        return;
+    }
+    // a mesh without visible instance is an empty draw, cheaper than compacting the commands
+    const VkDeviceSize offset = sizeof(VkDrawIndexedIndirectCommand) * ((phase == CullingPhase::LATE ? m_drawCount : 0) + firstDraw);
+    vkCmdDrawIndexedIndirect(commandBuffer, m_commandBuffers.at(frameIndex), offset, drawCount, sizeof(VkDrawIndexedIndirectCommand));
+}
+
+void ven::GpuCulling::readCounts(const uint32_t frameIndex, RenderStats& stats) const {
+    Counts counts{};
+    memcpy(&counts, m_countsMapped.at(frameIndex), sizeof(counts));
+    stats.drawCount = counts.drawCount;
+    stats.instanceCount = counts.instanceCount;
+    stats.triangleCount = counts.triangleCount;
+    stats.occludedCount = counts.occludedCount;
+}
@@ -0,0 +1,46 @@
+#include <algorithm>
+#include <bit>
+
+#include "Utils/Profiler.hpp"
+#include "VEngine/Gfx/RenderQueue.hpp"
+
+uint64_t ven::RenderQueue::makeKey(const RenderBucket bucket, const PipelineType pipeline, const uint32_t material, const float depth) {
+    // the bits of a non-negative float sort like its value, the top ones keep that order
+    constexpr uint32_t depthMask = (1U << DEPTH_BITS) - 1;
+    uint32_t quantized = std::bit_cast<uint32_t>(std::max(depth, 0.0F)) >> (32 - DEPTH_BITS);
+    if (bucket == RenderBucket::BLENDED) {
+        quantized = depthMask - quantized;
+    }
+    return (static_cast<uint64_t>(bucket) << 62) | (static_cast<uint64_t>(pipeline) << 59) | (static_cast<uint64_t>(quantized & depthMask) << 35) | (static_cast<uint64_t>(material) << 3);
+}
+
+ven::PipelineType ven::RenderQueue::getPipeline(const RenderBucket bucket, const AlphaMode alphaMode) {
+    if (bucket == RenderBucket::DEPTH_PREPASS) {
+        return alphaMode == AlphaMode::MASKED ? PipelineType::DEPTH_MASKED : PipelineType::DEPTH;
+    }
+    switch (alphaMode) {
+        case AlphaMode::MASKED:
+            return PipelineType::MASKED;
+        case AlphaMode::BLENDED:
+            return PipelineType::BLENDED;
+        default:
+            return PipelineType::SOLID;
+    }
+}
+
+void ven::RenderQueue::push(const RenderBucket bucket, const uint32_t material, const float depth, const DrawCommand draw) {
+    m_items.push_back({ .key = makeKey(bucket, draw.pipeline, material, depth), .draw = static_cast<uint32_t>(m_draws.size()) });
+    m_draws.push_back(draw);
+}
+
+const std::vector<ven::DrawCommand>& ven::RenderQueue::sort() {
+    PROFILE_FUNCTION();
+    // the draws are only moved once, the sort swaps 16-byte items
+    std::ranges::sort(m_items, {}, &Item::key);
+    m_sorted.clear();
+    m_sorted.reserve(m_items.size());
+    for (const Item& item : m_items) {
+        m_sorted.push_back(m_draws[item.draw]);
+    }
+    return m_sorted;
+}
@@ -1,38 +1,268 @@
-#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
+#include "Utils/Clock.hpp"
+#include "Utils/Profiler.hpp"
 #include "VEngine/Gfx/Renderer.hpp"
 
-void ven::Renderer::recordCommandBuffer(const uint32_t imageIndex, const uint32_t indiceSize, const VkDescriptorSet* descriptorSet, const VkCommandBuffer& commandBuffer, const VkBuffer& indexBuffer, const VkBuffer& vertexBuffer) {
-    const VkExtent2D extent = m_swapChain.getExtent();
-    const VkViewport viewport{.x=0.0F, .y=0.0F, .width=static_cast<float>(extent.width), .height=static_cast<float>(extent.height), .minDepth=0.0F, .maxDepth=1.0F };
-    const VkRect2D scissor{ .offset = { .x=0, .y=0 }, .extent = extent };
-    constexpr VkCommandBufferBeginInfo beginInfo{ .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+void ven::Renderer::init(const std::string& dumpDirectory) {
+    if (m_device.isHeadless() && !dumpDirectory.empty()) {
+        m_frameDump = std::make_unique<FrameDump>(m_device, m_swapChain.getExtent(), dumpDirectory);
+    }
+    m_settings.recordThreads = m_recordThreadPool.getThreadCount();
+    m_settings.framesInFlight = SwapChain::DEFAULT_FRAMES_IN_FLIGHT;
+    m_settings.presentMode = m_swapChain.getPresentMode();
+    m_stats.availableThreads = m_recordThreadPool.getThreadCount();
+    m_stats.availablePresentModes = m_device.querySwapChainSupport(m_device.getPhysicalDevice()).presentModes;
+}
+
+void ven::Renderer::beginSecondaryCommandBuffer(const VkCommandBuffer& commandBuffer, const VkRenderPass& renderPass, const VkFramebuffer& frameBuffer) const {
+    const VkCommandBufferInheritanceInfo inheritanceInfo{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+        .renderPass = renderPass,
+        .subpass = 0,
+        .framebuffer = frameBuffer
+    };
+    const VkCommandBufferBeginInfo beginInfo{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+        .pInheritanceInfo = &inheritanceInfo
+    };
     if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
-        throw utl::THROW_ERROR("failed to begin recording command buffer!");
+        throw utl::THROW_ERROR("failed to begin recording secondary command buffer!");
     }
+}
+
+void ven::Renderer::beginRenderPass(const VkCommandBuffer& commandBuffer, const VkRenderPass& renderPass, const VkFramebuffer& frameBuffer, const VkExtent2D extent, const std::array<VkClearValue, 2>& clearValues) const {
     VkRenderPassBeginInfo renderPassInfo{};
     renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-    renderPassInfo.renderPass = m_swapChain.getRenderPass();
-    renderPassInfo.framebuffer = m_swapChain.getSwapChainFrameBuffers().at(imageIndex);
+    renderPassInfo.renderPass = renderPass;
+    renderPassInfo.framebuffer = frameBuffer;
     renderPassInfo.renderArea.offset = { .x=0, .y=0 };
     renderPassInfo.renderArea.extent = extent;
-    renderPassInfo.clearValueCount = static_cast<uint32_t>(m_clearValues.size());
-    renderPassInfo.pClearValues = m_clearValues.data();
-    vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
-    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_shadersModule.getPipeline());
+    renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
+    renderPassInfo.pClearValues = clearValues.data();
+    vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+}
+
+void ven::Renderer::bindScene(const VkCommandBuffer& commandBuffer, const VkDescriptorSet& descriptorSet, const VkBuffer& indexBuffer, const VkBuffer& vertexBuffer, const VkExtent2D extent) const {
+    const VkViewport viewport{.x=0.0F, .y=0.0F, .width=static_cast<float>(extent.width), .height=static_cast<float>(extent.height), .minDepth=0.0F, .maxDepth=1.0F };
+    const VkRect2D scissor{ .offset = { .x=0, .y=0 }, .extent = extent };
     vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
     vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
     const std::array vertexBuffers = {vertexBuffer};
     constexpr std::array<VkDeviceSize, 1> offsets = {0};
     vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers.data(), offsets.data());
     vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, VK_INDEX_TYPE_UINT32);
-    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_shadersModule.getPipelineLayout(), 0, 1, descriptorSet, 0, nullptr);
-    vkCmdDrawIndexed(commandBuffer, indiceSize, 1, 0, 0, 0);
-    m_gui.render(commandBuffer);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_shadersModule.getPipelineLayout(), 0, 1, &descriptorSet, 0, nullptr);
+}
+
+void ven::Renderer::recordDraws(const VkCommandBuffer& commandBuffer, const VkDescriptorSet& descriptorSet, const VkBuffer& indexBuffer, const VkBuffer& vertexBuffer, const VkExtent2D extent, const std::span<const DrawCommand> draws) const {
+    bindScene(commandBuffer, descriptorSet, indexBuffer, vertexBuffer, extent);
+    // the draws are sorted by pipeline first, it changes a handful of times per frame
+    PipelineType bound = PipelineType::COUNT;
+    for (const auto& [indexCount, firstIndex, vertexOffset, firstInstance, instanceCount, pipeline] : draws) {
+        if (pipeline != bound) {
+            vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_shadersModule.getPipeline(pipeline));
+            bound = pipeline;
+        }
+        vkCmdDrawIndexed(commandBuffer, indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
+    }
+}
+
+void ven::Renderer::recordGpuDraws(const VkCommandBuffer& commandBuffer, const uint32_t frameIndex, const CullingPhase phase, const bool depthPrepass) const {
+    const auto drawRange = [&](const PipelineType pipeline, const AlphaMode alphaMode) {
+        const auto mode = static_cast<size_t>(alphaMode);
+        if (m_alphaModeGroups.at(mode + 1) > m_alphaModeGroups.at(mode)) {
+            vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_shadersModule.getPipeline(pipeline));
+            m_gpuCulling->draw(commandBuffer, frameIndex, phase, m_alphaModeGroups.at(mode), m_alphaModeGroups.at(mode + 1) - m_alphaModeGroups.at(mode));
+        }
+    };
+    if (depthPrepass) {
+        drawRange(PipelineType::DEPTH, AlphaMode::SOLID);
+        drawRange(PipelineType::DEPTH_MASKED, AlphaMode::MASKED);
+    }
+    drawRange(PipelineType::SOLID, AlphaMode::SOLID);
+    drawRange(PipelineType::MASKED, AlphaMode::MASKED);
+    drawRange(PipelineType::BLENDED, AlphaMode::BLENDED);
+}
+
+void ven::Renderer::buildSnapshot(FrameSnapshot& snapshot, const uint32_t frameIndex, const std::vector<DrawCommand>& draws) {
+    PROFILE_FUNCTION();
+    snapshot.frameIndex = frameIndex;
+    snapshot.settings = m_settings;
+    snapshot.clearValues = m_clearValues;
+    snapshot.renderExtent = m_renderExtent;
+    snapshot.renderScale = m_renderScale;
+    snapshot.near = m_camera.getNear();
+    snapshot.far = m_camera.getFar();
+    snapshot.lightCount = m_stats.lightCount;
+    snapshot.draws = draws;
+    snapshot.shadowsDrawn = m_shadowsDrawn;
+    for (uint32_t cascade = 0; cascade < CascadedShadows::CASCADE_COUNT; cascade++) {
+        snapshot.shadowRedrawn.at(cascade) = m_shadowsDrawn && m_shadows->isRedrawn(cascade);
+        // cullShadowCasters clears them before refilling, both sides keep their capacity
+        std::swap(snapshot.shadowDraws.at(cascade), m_shadowDraws.at(cascade));
+    }
+    if (m_shadows != nullptr) {
+        snapshot.shadowViewProjections = m_shadows->getViewProjections();
+    }
+    // there is no input to drive the Gui without a window
+    if (!m_device.isHeadless()) {
+        m_gui.update(snapshot.gui);
+    }
+}
+
+void ven::Renderer::recordCommandBuffer(const FrameSnapshot& snapshot, const uint32_t imageIndex, const VkDescriptorSet& descriptorSet, const VkCommandBuffer& commandBuffer, const VkBuffer& indexBuffer, const VkBuffer& vertexBuffer) {
+    PROFILE_FUNCTION();
+    const utl::Clock clock;
+    const uint32_t frameIndex = snapshot.frameIndex;
+    const std::vector<DrawCommand>& draws = snapshot.draws;
+    const VkExtent2D renderExtent = snapshot.renderExtent;
+    const VkFramebuffer& frameBuffer = m_swapChain.getSceneFrameBuffer();
+    const VkFramebuffer& presentFrameBuffer = m_swapChain.getSwapChainFrameBuffers().at(imageIndex);
+    const uint32_t guiSlot = m_commandPools.getSlotCount() - 1;
+    const bool gpuCulling = isGpuCulling(snapshot.settings);
+    const bool occlusionCulling = isOcclusionCulling(snapshot.settings);
+    // the transient descriptor sets of the slot were last read by the frame the update thread waited the fence of
+    m_descriptorAllocator.resetFrame(frameIndex);
+    // a single indirect draw covers the whole scene when the GPU culls, one per phase with occlusion culling
+    uint32_t chunkCount = std::max(1U, std::min({snapshot.settings.recordThreads, guiSlot, static_cast<uint32_t>(draws.size())}));
+    if (gpuCulling) {
+        chunkCount = occlusionCulling ? 2 : 1;
+    }
+    const size_t drawsPerChunk = (draws.size() + chunkCount - 1) / chunkCount;
+    // the early pass only holds the first chunk, the late pass the second one
+    const VkRenderPass& firstRenderPass = m_swapChain.getRenderPass(occlusionCulling ? RenderPassType::EARLY : RenderPassType::SINGLE);
+    const VkRenderPass& lastRenderPass = m_swapChain.getRenderPass(occlusionCulling ? RenderPassType::LATE : RenderPassType::SINGLE);
+    m_commandPools.reset(frameIndex);
+    m_gpuProfiler.beginFrame(frameIndex, chunkCount);
+    const uint32_t frameScope = m_gpuProfiler.addScope(frameIndex, "Frame");
+    const uint32_t sceneScope = m_gpuProfiler.addScope(frameIndex, SCENE_SCOPE);
+    const uint32_t upscaleScope = m_gpuProfiler.addScope(frameIndex, "Upscale");
+    const uint32_t guiScope = m_device.isHeadless() ? 0 : m_gpuProfiler.addScope(frameIndex, "ImGui");
+    const uint32_t cullScope = gpuCulling ? m_gpuProfiler.addScope(frameIndex, "Culling") : 0;
+    const uint32_t pyramidScope = occlusionCulling ? m_gpuProfiler.addScope(frameIndex, "Depth pyramid") : 0;
+    const uint32_t lightScope = m_clusteredLighting != nullptr ? m_gpuProfiler.addScope(frameIndex, "Light clusters") : 0;
+    std::array<uint32_t, CascadedShadows::CASCADE_COUNT> shadowScopes{};
+    for (uint32_t cascade = 0; cascade < CascadedShadows::CASCADE_COUNT; cascade++) {
+        if (snapshot.shadowRedrawn.at(cascade)) {
+            shadowScopes.at(cascade) = m_gpuProfiler.addScope(frameIndex, CascadedShadows::SCOPE_NAMES.at(cascade));
+        }
+    }
+    // each chunk owns the slot matching its index, so the execution order below does not depend on thread scheduling
+    m_recordThreadPool.parallelFor(chunkCount, [&](const uint32_t chunk) {
+        PROFILE_SCOPE("recordChunk");
+        const VkCommandBuffer& secondary = m_commandPools.getCommandBuffer(frameIndex, chunk);
+        const size_t first = std::min(draws.size(), chunk * drawsPerChunk);
+        const size_t count = std::min(draws.size() - first, drawsPerChunk);
+        beginSecondaryCommandBuffer(secondary, occlusionCulling && chunk == 1 ? lastRenderPass : firstRenderPass, frameBuffer);
+        // timestamps cannot be written in the primary inside a render pass recorded with secondary contents,
+        // the scene scope spans the secondaries instead: they execute in chunk order
+        if (chunk == 0) {
+            m_gpuProfiler.writeBegin(secondary, frameIndex, sceneScope);
+        }
+        m_gpuProfiler.beginStatistics(secondary, frameIndex, chunk);
+        if (gpuCulling) {
+            CullingPhase phase = CullingPhase::SINGLE;
+            if (occlusionCulling) {
+                phase = chunk == 0 ? CullingPhase::EARLY : CullingPhase::LATE;
+            }
+            bindScene(secondary, descriptorSet, indexBuffer, vertexBuffer, renderExtent);
+            recordGpuDraws(secondary, frameIndex, phase, snapshot.settings.depthPrepass);
+        } else {
+            recordDraws(secondary, descriptorSet, indexBuffer, vertexBuffer, renderExtent, std::span(draws).subspan(first, count));
+        }
+        m_gpuProfiler.endStatistics(secondary, frameIndex, chunk);
+        if (chunk == chunkCount - 1) {
+            m_gpuProfiler.writeEnd(secondary, frameIndex, sceneScope);
+        }
+        if (vkEndCommandBuffer(secondary) != VK_SUCCESS) {
+            throw utl::THROW_ERROR("failed to record secondary command buffer!");
+        }
+    });
+    m_secondaryCommandBuffers.clear();
+    for (uint32_t chunk = 0; chunk < chunkCount; chunk++) {
+        m_secondaryCommandBuffers.push_back(m_commandPools.getCommandBuffer(frameIndex, chunk));
+    }
+    // the present pass upscales the scene then draws the Gui on top, both at native resolution
+    const VkCommandBuffer& presentCommandBuffer = m_commandPools.getCommandBuffer(frameIndex, guiSlot);
+    beginSecondaryCommandBuffer(presentCommandBuffer, m_swapChain.getPresentRenderPass(), presentFrameBuffer);
+    m_gpuProfiler.writeBegin(presentCommandBuffer, frameIndex, upscaleScope);
+    m_upscaler.record(presentCommandBuffer, frameIndex, renderExtent, snapshot.settings.upscaleFilter, snapshot.settings.sharpness);
+    m_gpuProfiler.writeEnd(presentCommandBuffer, frameIndex, upscaleScope);
+    if (!m_device.isHeadless()) {
+        PROFILE_SCOPE("Gui::record");
+        m_gpuProfiler.writeBegin(presentCommandBuffer, frameIndex, guiScope);
+        Gui::record(presentCommandBuffer, snapshot.gui);
+        m_gpuProfiler.writeEnd(presentCommandBuffer, frameIndex, guiScope);
+    }
+    if (vkEndCommandBuffer(presentCommandBuffer) != VK_SUCCESS) {
+        throw utl::THROW_ERROR("failed to record present command buffer!");
+    }
+    constexpr VkCommandBufferBeginInfo beginInfo{ .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+    if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
+        throw utl::THROW_ERROR("failed to begin recording command buffer!");
+    }
+    m_gpuProfiler.reset(commandBuffer, frameIndex);
+    m_gpuProfiler.writeBegin(commandBuffer, frameIndex, frameScope);
+    if (gpuCulling) {
+        m_gpuProfiler.writeBegin(commandBuffer, frameIndex, cullScope);
+        m_gpuCulling->record(commandBuffer, frameIndex, occlusionCulling ? CullingPhase::EARLY : CullingPhase::SINGLE);
+        m_gpuProfiler.writeEnd(commandBuffer, frameIndex, cullScope);
+    }
+    m_gpuCulled.at(frameIndex) = gpuCulling;
+    if (m_clusteredLighting != nullptr) {
+        // an empty scene still clears the counts, the fragment shader reads them every frame
+        m_gpuProfiler.writeBegin(commandBuffer, frameIndex, lightScope);
+        m_clusteredLighting->record(commandBuffer, frameIndex, snapshot.lightCount, snapshot.near, snapshot.far);
+        m_gpuProfiler.writeEnd(commandBuffer, frameIndex, lightScope);
+    }
+    for (uint32_t cascade = 0; cascade < CascadedShadows::CASCADE_COUNT; cascade++) {
+        if (snapshot.shadowRedrawn.at(cascade)) {
+            m_gpuProfiler.writeBegin(commandBuffer, frameIndex, shadowScopes.at(cascade));
+            m_shadows->record(commandBuffer, frameIndex, cascade, snapshot.shadowViewProjections.at(cascade), indexBuffer, vertexBuffer, snapshot.shadowDraws.at(cascade));
+            m_gpuProfiler.writeEnd(commandBuffer, frameIndex, shadowScopes.at(cascade));
+        }
+    }
+    beginRenderPass(commandBuffer, firstRenderPass, frameBuffer, renderExtent, snapshot.clearValues);
+    if (occlusionCulling) {
+        // what was visible last frame is drawn, its depth decides what else is visible
+        vkCmdExecuteCommands(commandBuffer, 1, m_secondaryCommandBuffers.data());
+        vkCmdEndRenderPass(commandBuffer);
+        m_gpuProfiler.writeBegin(commandBuffer, frameIndex, pyramidScope);
+        m_depthPyramid->record(commandBuffer, frameIndex, renderExtent);
+        m_gpuCulling->record(commandBuffer, frameIndex, CullingPhase::LATE);
+        m_gpuProfiler.writeEnd(commandBuffer, frameIndex, pyramidScope);
+        beginRenderPass(commandBuffer, lastRenderPass, frameBuffer, renderExtent, snapshot.clearValues);
+        vkCmdExecuteCommands(commandBuffer, static_cast<uint32_t>(m_secondaryCommandBuffers.size() - 1), m_secondaryCommandBuffers.data() + 1);
+    } else {
+        vkCmdExecuteCommands(commandBuffer, static_cast<uint32_t>(m_secondaryCommandBuffers.size()), m_secondaryCommandBuffers.data());
+    }
     vkCmdEndRenderPass(commandBuffer);
+    beginRenderPass(commandBuffer, m_swapChain.getPresentRenderPass(), presentFrameBuffer, m_swapChain.getExtent(), snapshot.clearValues);
+    vkCmdExecuteCommands(commandBuffer, 1, &presentCommandBuffer);
+    vkCmdEndRenderPass(commandBuffer);
+    if (m_frameDump != nullptr) {
+        m_frameDump->record(commandBuffer, m_swapChain.getImages().at(imageIndex), frameIndex);
+    }
+    m_gpuProfiler.writeEnd(commandBuffer, frameIndex, frameScope);
     if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
         throw utl::THROW_ERROR("failed to record command buffer!");
     }
+    m_recordStats = { .recordTime = clock.getDeltaSeconds() * 1000.0F, .recordThreads = chunkCount, .drawCount = static_cast<uint32_t>(draws.size()), .gpuCulled = gpuCulling };
+    m_slotRenderScales.at(frameIndex) = snapshot.renderScale;
+    m_slotScopes.at(frameIndex) = { .scene = sceneScope, .shadows = shadowScopes };
+}
+
+void ven::Renderer::frameRendered() {
+    m_stats.recordTime = m_recordStats.recordTime;
+    m_stats.recordThreads = m_recordStats.recordThreads;
+    if (!m_recordStats.gpuCulled) {
+        m_stats.drawCount = m_recordStats.drawCount;
+    }
+    m_stats.descriptorPoolCount = static_cast<uint32_t>(m_descriptorAllocator.getPoolCount());
 }
 
 void ven::Renderer::createCommandBuffers(std::vector<VkCommandBuffer>& commandBuffers) const {
@@ -55,31 +285,340 @@ void ven::Renderer::recreateSwapChain() {
         m_window.getFrameBufferSize(width, height);
         Window::waitEvents();
     }
-    m_device.waitIdle();
-    m_swapChain.cleanupSwapChain();
-    m_swapChain.init();
+    m_swapChain.setPresentMode(m_settings.presentMode);
+    const VkExtent2D oldExtent = m_swapChain.getExtent();
+    const bool formatChanged = m_swapChain.recreate({ .width = static_cast<uint32_t>(width), .height = static_cast<uint32_t>(height) });
+    if (formatChanged) {
+        // the surface format changed: the pipelines were built against the old render pass, this rare case can afford a stall
+        m_device.waitIdle();
+        m_shadersModule.recreatePipeline(m_swapChain.getRenderPass());
+        m_upscaler.recreatePipeline(m_shadersModule, m_swapChain.getPresentRenderPass());
+        m_gui.setRenderPass(m_swapChain.getPresentRenderPass());
+    }
+    const VkExtent2D& extent = m_swapChain.getExtent();
+    const bool resized = extent.width != oldExtent.width || extent.height != oldExtent.height;
+    if (formatChanged || resized) {
+        // the frames in flight keep their own upscale descriptor sets, the old scene image is retired after them
+        m_upscaler.setSource(m_swapChain);
+    }
+    if (m_depthPyramid != nullptr && resized) {
+        // the pyramid follows the depth attachment, the old one is retired like it and each culling set is repointed by its slot
+        m_depthPyramid->resize(m_swapChain);
+        m_gpuCulling->setDepthPyramid(*m_depthPyramid);
+    }
+    m_settings.presentMode = m_swapChain.getPresentMode();
 }
 
-void ven::Renderer::updateUniformBuffer(void* uniformBufferMapped, std::vector<Model>& models) const {
-    for (size_t i = 0; i < models.size(); ++i) {
-        Model& model = models[i];
-        UniformBufferObject ubo{};
-        auto modelmat = glm::mat4(1.0F);
+void ven::Renderer::updateUniformBuffer(void* uniformBufferMapped, void* objectBufferMapped, TransformHierarchy& transforms, Registry& scene, const std::vector<DrawGroup>& groups) {
+    PROFILE_FUNCTION();
+    const VkExtent2D& extent = m_swapChain.getExtent();
+    UniformBufferObject ubo{};
+    ubo.view = m_camera.getViewMatrix();
+    ubo.proj = m_camera.getProjectionMatrix(static_cast<float>(extent.width) / static_cast<float>(extent.height));
+    ubo.proj[1][1] *= -1;
+    ubo.ambientColor = m_ambientColor;
+    m_viewProjection = ubo.proj * ubo.view;
+    m_cameraPosition = glm::vec3(glm::inverse(ubo.view)[3]);
+    ubo.frustumPlanes = Frustum(m_viewProjection).getPlanes();
+    // updateLights writes the same lights, in the same order, once the hierarchy below is up to date
+    m_stats.lightCount = std::min(scene.count<Light, TransformNode>(), ClusteredLighting::MAX_LIGHTS);
+    // the scene targets are the size of the swap chain, the scene only covers their top-left render extent
+    if (!m_settings.dynamicResolution) {
+        m_renderScale = std::clamp(m_settings.renderScale, RenderSettings::MIN_RENDER_SCALE, 1.0F);
+    }
+    m_renderExtent = { .width = std::max(1U, static_cast<uint32_t>(std::lround(static_cast<float>(extent.width) * m_renderScale))),
+                       .height = std::max(1U, static_cast<uint32_t>(std::lround(static_cast<float>(extent.height) * m_renderScale))) };
+    m_stats.renderScale = m_renderScale;
+    m_stats.renderExtent = m_renderExtent;
+    ubo.clusterScale = ClusteredLighting::getClusterScale(m_renderExtent, m_camera.getNear(), m_camera.getFar());
+    ubo.clusterParams = glm::uvec4(m_stats.lightCount, m_settings.showLightClusters ? 1 : 0, 0, 0);
+    // kept in cached memory between frames: a static scene skips the gather, the mapped buffer of the slot is still
+    // written front to back in one go, never read nor revisited
+    const uint32_t objectCount = scene.count<TransformNode, WorldMatrix, MeshRef, WorldBounds>();
+    const bool changed = transforms.update(m_threadPool) || m_objectData.size() != objectCount;
+    if (changed) {
+        PROFILE_SCOPE("gatherObjects");
+        m_objectData.resize(objectCount);
+        m_objectGroups.resize(objectCount);
+        m_worldBounds.resize(objectCount);
+        m_objectBounds.resize(objectCount);
+        scene.parallelForEach<const TransformNode, WorldMatrix, const MeshRef, WorldBounds>(m_threadPool, [&](const uint32_t first, std::span<const Entity>, const std::span<const TransformNode> nodes,
+                                                                                                          const std::span<WorldMatrix> worlds, const std::span<const MeshRef> meshes, const std::span<WorldBounds> bounds) {
+            for (size_t i = 0; i < nodes.size(); i++) {
+                worlds[i].matrix = transforms.getWorld(nodes[i].node);
+                bounds[i].bounds = groups[meshes[i].group].bounds.transform(worlds[i].matrix);
+                m_objectData[first + i].world = worlds[i].matrix;
+                m_objectGroups[first + i] = meshes[i].group;
+                m_worldBounds.set(first + i, bounds[i].bounds);
+                m_objectBounds[first + i] = bounds[i].bounds;
+            }
+        });
+        if (m_bvh.getPrimitiveCount() != objectCount || m_bvh.shouldRebuild()) {
+            m_bvh.build(m_objectBounds, &m_threadPool);
+        } else {
+            m_bvh.refit(m_objectBounds);
+        }
+    }
+    const glm::vec3 sunDirection = getSunDirection();
+    m_shadowsDrawn = m_settings.shadows && m_shadows != nullptr && !m_bvh.getNodes().empty();
+    if (m_shadowsDrawn) {
+        const ShadowView view{ .view = ubo.view, .fov = glm::radians(m_camera.getFov()), .aspect = static_cast<float>(extent.width) / static_cast<float>(extent.height),
+                               .near = m_camera.getNear(), .far = m_camera.getFar() };
+        const BvhNode& root = m_bvh.getNodes().front();
+        const Bounds sceneBounds{ .center = (root.min + root.max) * 0.5F, .extent = (root.max - root.min) * 0.5F, .radius = glm::length(root.max - root.min) * 0.5F };
+        m_shadows->update(view, m_settings, sunDirection, sceneBounds, changed, m_stats.shadows);
+        ubo.cascadeViewProjections = m_shadows->getViewProjections();
+        ubo.cascadeSplits = m_shadows->getSplits();
+    } else if (m_shadows != nullptr) {
+        // the casters may move while nothing is drawn
+        m_shadows->invalidate();
+    }
+    ubo.sunDirection = glm::vec4(sunDirection, m_settings.sunIntensity);
+    ubo.shadowParams = glm::uvec4(m_shadowsDrawn ? 1 : 0, 0, 0, 0);
+    memcpy(uniformBufferMapped, &ubo, sizeof(ubo));
+    memcpy(objectBufferMapped, m_objectData.data(), m_objectData.size() * sizeof(ObjectData));
+}
 
-        modelmat = glm::rotate(modelmat, model.getTransform().rotation.x, glm::vec3(1.0F, 0.0F, 0.0F));
-        modelmat = glm::rotate(modelmat, model.getTransform().rotation.y, glm::vec3(0.0F, 1.0F, 0.0F));
-        modelmat = glm::rotate(modelmat, model.getTransform().rotation.z, glm::vec3(0.0F, 0.0F, 1.0F));
-        modelmat = glm::translate(modelmat, model.getTransform().position);
-        modelmat = glm::scale(modelmat, model.getTransform().scale);
+void ven::Renderer::updateRenderScale(const uint32_t frameIndex, const float sceneTime) {
+    static constexpr float SHRINK_RATE = 0.5F;
+    static constexpr float GROW_RATE = 0.1F;
+    static constexpr float HEADROOM = 0.85F; ///< fraction of the budget under which the scale grows
+    if (!m_settings.dynamicResolution || sceneTime <= 0.0F || m_slotRenderScales.at(frameIndex) <= 0.0F) {
+        return;
+    }
+    // the slot was rendered frames in flight ago, at the scale it was recorded with
+    const float budget = std::max(m_settings.targetFrameTime - (m_stats.gpuTime - sceneTime), 0.0F);
+    const float ideal = m_slotRenderScales.at(frameIndex) * std::sqrt(budget / sceneTime);
+    float scale = m_renderScale;
+    if (sceneTime > budget) {
+        scale = std::min(scale, std::lerp(scale, ideal, SHRINK_RATE));
+    } else if (sceneTime < budget * HEADROOM) {
+        scale = std::max(scale, std::lerp(scale, ideal, GROW_RATE));
+    }
+    m_renderScale = std::clamp(scale, std::clamp(m_settings.minRenderScale, RenderSettings::MIN_RENDER_SCALE, 1.0F), 1.0F);
+}
 
-        ubo.model = modelmat;
-        ubo.view = m_camera.getViewMatrix();
-        ubo.proj = m_camera.getProjectionMatrix(static_cast<float>(m_swapChain.getExtent().width) / static_cast<float>(m_swapChain.getExtent().height));
-        ubo.proj[1][1] *= -1;
-        ubo.ambientColor = m_ambientColor;
-        memcpy(uniformBufferMapped, &ubo, sizeof(ubo));
+glm::vec3 ven::Renderer::getSunDirection() const {
+    const float azimuth = glm::radians(m_settings.sunAzimuth);
+    const float elevation = glm::radians(m_settings.sunElevation);
+    return { std::cos(elevation) * std::sin(azimuth), std::sin(elevation), std::cos(elevation) * std::cos(azimuth) };
+}
+
+void ven::Renderer::cullShadowCasters(const uint32_t frameIndex, const std::vector<DrawGroup>& groups) {
+    PROFILE_FUNCTION();
+    for (uint32_t cascade = 0; cascade < CascadedShadows::CASCADE_COUNT; cascade++) {
+        std::vector<DrawCommand>& draws = m_shadowDraws.at(cascade);
+        draws.clear();
+        if (!m_shadowsDrawn || !m_shadows->isRedrawn(cascade)) {
+            continue;
+        }
+        // the orthographic box reaches back to the scene bounds, so it holds every caster of the cascade
+        m_bvhVisible.clear();
+        m_bvh.queryFrustum(Frustum(m_shadows->getViewProjections().at(cascade)), m_bvhVisible);
+        // counting sort of the casters by group, as cullDraws
+        m_groupOffsets.assign(groups.size() + 1, 0);
+        for (const uint32_t object : m_bvhVisible) {
+            if (groups[m_objectGroups[object]].alphaMode != AlphaMode::BLENDED) {
+                m_groupOffsets[m_objectGroups[object] + 1]++;
+            }
+        }
+        for (size_t group = 0; group < groups.size(); group++) {
+            const uint32_t instanceCount = m_groupOffsets[group + 1];
+            m_groupOffsets[group + 1] += m_groupOffsets[group];
+            if (instanceCount > 0) {
+                draws.push_back({ .indexCount = groups[group].indexCount, .firstIndex = groups[group].firstIndex, .vertexOffset = groups[group].vertexOffset,
+                                  .firstInstance = m_groupOffsets[group], .instanceCount = instanceCount });
+            }
+        }
+        uint32_t* instances = m_shadows->getInstances(frameIndex, cascade);
+        for (const uint32_t object : m_bvhVisible) {
+            if (groups[m_objectGroups[object]].alphaMode != AlphaMode::BLENDED) {
+                instances[m_groupOffsets[m_objectGroups[object]]++] = object;
+            }
+        }
+        m_stats.shadows.casterCounts.at(cascade) = m_groupOffsets.back();
     }
 }
 
+void ven::Renderer::updateLights(void* lightBufferMapped, const TransformHierarchy& transforms, Registry& scene) {
+    PROFILE_FUNCTION();
+    m_lights.clear();
+    scene.forEach<const Light, const TransformNode>([&](const Light& light, const TransformNode& node) {
+        if (m_lights.size() == ClusteredLighting::MAX_LIGHTS) {
+            return;
+        }
+        const glm::mat4& world = transforms.getWorld(node.node);
+        const glm::vec3 direction = glm::normalize(glm::vec3(world * glm::vec4(0.0F, 0.0F, -1.0F, 0.0F)));
+        m_lights.push_back({ .positionRange = glm::vec4(glm::vec3(world[3]), light.range), .colorIntensity = glm::vec4(light.color, light.intensity),
+                             .directionType = glm::vec4(direction, static_cast<float>(light.type)), .cone = glm::vec4(light.innerCone, light.outerCone, 0.0F, 0.0F) });
+    });
+    memcpy(lightBufferMapped, m_lights.data(), m_lights.size() * sizeof(GpuLight));
+}
+
+const std::vector<ven::DrawCommand>& ven::Renderer::cullDraws(const std::vector<DrawGroup>& groups, void* instanceBufferMapped) {
+    PROFILE_FUNCTION();
+    m_stats.totalDrawCount = static_cast<uint32_t>(groups.size());
+    m_stats.totalInstanceCount = static_cast<uint32_t>(m_objectData.size());
+    m_stats.totalTriangleCount = 0;
+    for (const DrawGroup& group : groups) {
+        m_stats.totalTriangleCount += static_cast<uint64_t>(group.indexCount / 3) * group.objectCount;
+    }
+    m_visibleDraws.clear();
+    if (isGpuCulling(m_settings)) {
+        // the culling shader writes the instances and the indirect draws, the counts are read back in frameCompleted
+        return m_visibleDraws;
+    }
+    m_stats.occludedCount = 0;
+    if (m_settings.culling == CullingMode::CPU) {
+        // the world bounds were refreshed with the world matrices, a large scene is split in ranges of whole lanes
+        const Frustum frustum(m_viewProjection);
+        const size_t padded = m_worldBounds.centerX.size();
+        m_visibility.resize(padded);
+        if (padded >= PARALLEL_CULL_SIZE && m_threadPool.getThreadCount() > 1) {
+            // the Bvh walk is serial, from there the test of every object split across the pool is faster
+            const uint32_t rangeCount = m_threadPool.getThreadCount();
+            const size_t rangeSize = (padded / BoundsSoA::LANES + rangeCount - 1) / rangeCount * BoundsSoA::LANES;
+            m_threadPool.parallelFor(rangeCount, [&](const uint32_t range) {
+                frustum.cullRange(m_worldBounds, m_visibility, std::min(padded, range * rangeSize), std::min(padded, (range + 1) * rangeSize));
+            });
+        } else if (m_worldBounds.count >= BVH_CULL_SIZE) {
+            // whole subtrees outside or inside are decided at once, only the boxes crossing a plane are tested
+            m_bvhVisible.clear();
+            m_bvh.queryFrustum(frustum, m_bvhVisible);
+            std::ranges::fill(m_visibility, 0);
+            for (const uint32_t object : m_bvhVisible) {
+                m_visibility[object] = 1;
+            }
+        } else {
+            frustum.cullRange(m_worldBounds, m_visibility, 0, padded);
+        }
+        m_visibility.resize(m_worldBounds.count);
+    } else {
+        m_visibility.assign(m_objectData.size(), 1);
+    }
+    // counting sort of the visible objects by group: count, offsets, scatter
+    m_groupOffsets.assign(groups.size() + 1, 0);
+    for (size_t object = 0; object < m_visibility.size(); object++) {
+        m_groupOffsets[m_objectGroups[object] + 1] += m_visibility[object];
+    }
+    m_stats.triangleCount = 0;
+    m_visibleGroups.clear();
+    for (size_t group = 0; group < groups.size(); group++) {
+        const uint32_t instanceCount = m_groupOffsets[group + 1];
+        m_groupOffsets[group + 1] += m_groupOffsets[group];
+        if (instanceCount > 0) {
+            m_visibleDraws.push_back({ .indexCount = groups[group].indexCount, .firstIndex = groups[group].firstIndex, .vertexOffset = groups[group].vertexOffset,
+                                       .firstInstance = m_groupOffsets[group], .instanceCount = instanceCount });
+            m_visibleGroups.push_back(static_cast<uint32_t>(group));
+            m_stats.triangleCount += static_cast<uint64_t>(groups[group].indexCount / 3) * instanceCount;
+        }
+    }
+    m_instanceIndices.resize(m_groupOffsets.back());
+    for (size_t object = 0; object < m_visibility.size(); object++) {
+        if (m_visibility[object] != 0) {
+            m_instanceIndices[m_groupOffsets[m_objectGroups[object]]++] = static_cast<uint32_t>(object);
+        }
+    }
+    memcpy(instanceBufferMapped, m_instanceIndices.data(), m_instanceIndices.size() * sizeof(uint32_t));
+    m_stats.instanceCount = static_cast<uint32_t>(m_instanceIndices.size());
+    // squared distances order the draws as well as distances do
+    const auto distance = [&](const uint32_t instance) {
+        const glm::vec3 offset = m_objectBounds[m_instanceIndices[instance]].center - m_cameraPosition;
+        return glm::dot(offset, offset);
+    };
+    m_renderQueue.clear();
+    for (size_t i = 0; i < m_visibleDraws.size(); i++) {
+        DrawCommand draw = m_visibleDraws[i];
+        const DrawGroup& group = groups[m_visibleGroups[i]];
+        const RenderBucket bucket = RenderQueue::getBucket(group.alphaMode);
+        draw.pipeline = RenderQueue::getPipeline(bucket, group.alphaMode);
+        if (group.alphaMode == AlphaMode::BLENDED) {
+            const uint32_t last = draw.firstInstance + draw.instanceCount;
+            for (uint32_t instance = draw.firstInstance; instance < last; instance++) {
+                m_renderQueue.push(bucket, group.material, distance(instance), { .indexCount = draw.indexCount, .firstIndex = draw.firstIndex, .vertexOffset = draw.vertexOffset,
+                                                                                 .firstInstance = instance, .instanceCount = 1, .pipeline = draw.pipeline });
+            }
+            continue;
+        }
+        float nearest = std::numeric_limits<float>::max();
+        for (uint32_t instance = draw.firstInstance; instance < draw.firstInstance + draw.instanceCount; instance++) {
+            nearest = std::min(nearest, distance(instance));
+        }
+        m_renderQueue.push(bucket, group.material, nearest, draw);
+        if (m_settings.depthPrepass) {
+            draw.pipeline = RenderQueue::getPipeline(RenderBucket::DEPTH_PREPASS, group.alphaMode);
+            m_renderQueue.push(RenderBucket::DEPTH_PREPASS, group.material, nearest, draw);
+        }
+    }
+    return m_renderQueue.sort();
+}
+
+void ven::Renderer::initGpuCulling(const std::vector<DrawGroup>& groups, Registry& scene, const std::vector<VkBuffer>& uniformBuffers, const std::vector<VkBuffer>& objectBuffers, const VkDeviceSize objectBufferSize,
+                                   const std::vector<VkBuffer>& instanceBuffers, const VkDeviceSize instanceBufferSize) {
+    if (!m_device.hasDrawIndirectCount()) {
+        if (m_settings.culling == CullingMode::GPU) {
+            m_settings.culling = CullingMode::CPU;
+        }
+        return;
+    }
+    // the groups are ordered by alpha mode, each range is drawn with the pipeline of its mode
+    m_alphaModeGroups.fill(0);
+    for (const DrawGroup& group : groups) {
+        m_alphaModeGroups.at(static_cast<size_t>(group.alphaMode) + 1)++;
+    }
+    for (size_t mode = 1; mode < m_alphaModeGroups.size(); mode++) {
+        m_alphaModeGroups.at(mode) += m_alphaModeGroups.at(mode - 1);
+    }
+    std::vector<DrawData> drawData;
+    drawData.reserve(groups.size());
+    for (const DrawGroup& group : groups) {
+        drawData.push_back({ .indexCount = group.indexCount, .firstIndex = group.firstIndex, .vertexOffset = group.vertexOffset, .instanceOffset = group.instanceOffset,
+                             .centerRadius = glm::vec4(group.bounds.center, group.bounds.radius), .extent = glm::vec4(group.bounds.extent, 0.0F) });
+    }
+    // same components as updateUniformBuffer, so the same object order
+    std::vector<uint32_t> objectGroups(scene.count<TransformNode, WorldMatrix, MeshRef, WorldBounds>());
+    scene.forEachChunk<const TransformNode, const WorldMatrix, const MeshRef, const WorldBounds>([&](const uint32_t first, std::span<const Entity>, std::span<const TransformNode>, std::span<const WorldMatrix>,
+                                                                                                    const std::span<const MeshRef> meshes, std::span<const WorldBounds>) {
+        for (size_t i = 0; i < meshes.size(); i++) {
+            objectGroups[first + i] = meshes[i].group;
+        }
+    });
+    m_depthPyramid = std::make_unique<DepthPyramid>(m_device, m_shadersModule, m_swapChain, m_layoutCache, m_descriptorAllocator);
+    m_gpuCulling = std::make_unique<GpuCulling>(m_device, m_shadersModule, m_layoutCache, m_descriptorAllocator, drawData, objectGroups, GpuCulling::Buffers{ .uniformBuffers = uniformBuffers, .uniformBufferSize = UNIFORM_BUFFER_SIZE,
+                                                .objectBuffers = objectBuffers, .objectBufferSize = objectBufferSize, .instanceBuffers = instanceBuffers, .instanceBufferSize = instanceBufferSize }, *m_depthPyramid);
+    m_stats.gpuCullingSupported = true;
+}
+
+void ven::Renderer::initShadows(const std::vector<VkBuffer>& objectBuffers, const VkDeviceSize objectBufferSize, const uint32_t objectCount) {
+    m_shadows = std::make_unique<CascadedShadows>(m_device, m_shadersModule, m_layoutCache, m_descriptorAllocator, objectBuffers, objectBufferSize, objectCount);
+}
+
+void ven::Renderer::initClusteredLighting(const std::vector<VkBuffer>& uniformBuffers, const std::vector<VkBuffer>& lightBuffers, const std::vector<VkBuffer>& clusterBuffers) {
+    m_clusteredLighting = std::make_unique<ClusteredLighting>(m_device, m_shadersModule, m_layoutCache, m_descriptorAllocator, ClusteredLighting::Buffers{ .uniformBuffers = uniformBuffers, .uniformBufferSize = UNIFORM_BUFFER_SIZE,
+                                                              .lightBuffers = lightBuffers, .clusterBuffers = clusterBuffers });
+}
+
+void ven::Renderer::frameCompleted(const uint32_t frameIndex) {
+    if (m_frameDump != nullptr) {
+        m_frameDump->write(frameIndex);
+    }
+    // the slot fence has been waited on, the results are available and this never blocks
+    if (m_gpuCulled.at(frameIndex)) {
+        m_gpuCulling->readCounts(frameIndex, m_stats);
+    }
+    m_gpuProfiler.collect(frameIndex, m_stats.gpu);
+    const SlotScopes& scopes = m_slotScopes.at(frameIndex);
+    if (m_stats.gpu.scopeCount > 0) {
+        m_stats.gpuTime = m_stats.gpu.scopes.at(0).time;
+        updateRenderScale(frameIndex, scopes.scene != 0 && scopes.scene < m_stats.gpu.scopeCount ? m_stats.gpu.scopes.at(scopes.scene).time : 0.0F);
+    }
+    // a cached cascade keeps the time of its last render
+    for (uint32_t cascade = 0; cascade < CascadedShadows::CASCADE_COUNT; cascade++) {
+        const uint32_t scope = scopes.shadows.at(cascade);
+        if (scope != 0 && scope < m_stats.gpu.scopeCount) {
+            m_stats.shadows.renderTimes.at(cascade) = m_stats.gpu.scopes.at(scope).time;
+        }
+    }
+}
 
 ven::Renderer::~Renderer() = default;
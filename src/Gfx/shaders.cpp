@@ -1,4 +1,5 @@
 #include "Utils/ErrorHandling.hpp"
+#include "Utils/Profiler.hpp"
 #include "Utils/Utils.hpp"
 #include "VEngine/Gfx/Shaders.hpp"
 #include "VEngine/Gfx/Resources/Vertex.hpp"
@@ -25,14 +26,30 @@ void ven::Shaders::createShaderModule(const std::vector<char>& code, VkShaderMod
 }
 
 void ven::Shaders::createPipeline(const VkSampleCountFlagBits& msaaSample, const VkDescriptorSetLayout& descriptorSetLayout, const VkRenderPass& renderPass) {
+    PROFILE_FUNCTION();
+    for (VkPipeline& pipeline : m_pipelines) {
+        vkDestroyPipeline(m_device, pipeline, nullptr);
+    }
+    vkDestroyPipelineLayout(m_device, m_pipelineLayout, nullptr);
+    m_msaaSamples = msaaSample;
+    m_descriptorSetLayout = descriptorSetLayout;
     VkShaderModule vertShader = nullptr;
     VkShaderModule fragShader = nullptr;
+    VkShaderModule depthMaskedShader = nullptr;
     createShaderModule(utl::readFile(std::string(SHADER_PATH) + "/vertex_shader.spv"), vertShader);
     createShaderModule(utl::readFile(std::string(SHADER_PATH) + "/fragment_shader.spv"), fragShader);
+    createShaderModule(utl::readFile(std::string(SHADER_PATH) + "/depth_masked_shader.spv"), depthMaskedShader);
     VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
     VkPipelineShaderStageCreateInfo fragShaderStageInfo{};
+    VkPipelineShaderStageCreateInfo depthMaskedStageInfo{};
     createPipelineShaderStageCreateInfo(vertShaderStageInfo, VK_SHADER_STAGE_VERTEX_BIT, vertShader);
     createPipelineShaderStageCreateInfo(fragShaderStageInfo, VK_SHADER_STAGE_FRAGMENT_BIT, fragShader);
+    createPipelineShaderStageCreateInfo(depthMaskedStageInfo, VK_SHADER_STAGE_FRAGMENT_BIT, depthMaskedShader);
+    // constant_id 0 of the fragment shader: discard under the alpha cutoff
+    constexpr VkSpecializationMapEntry alphaTestEntry{ .constantID = 0, .offset = 0, .size = sizeof(VkBool32) };
+    VkBool32 alphaTest = VK_FALSE;
+    const VkSpecializationInfo specializationInfo{ .mapEntryCount = 1, .pMapEntries = &alphaTestEntry, .dataSize = sizeof(VkBool32), .pData = &alphaTest };
+    fragShaderStageInfo.pSpecializationInfo = &specializationInfo;
     std::array shaderStages = {vertShaderStageInfo, fragShaderStageInfo};
     VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
     vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
@@ -65,18 +82,17 @@ void ven::Shaders::createPipeline(const VkSampleCountFlagBits& msaaSample, const
     multisampling.rasterizationSamples = msaaSample;
     multisampling.minSampleShading = 1.0F;
     multisampling.pSampleMask = nullptr;
-    multisampling.alphaToCoverageEnable = VK_TRUE;
+    multisampling.alphaToCoverageEnable = VK_FALSE;
     multisampling.alphaToOneEnable = VK_FALSE;
+    // less or equal: the color pass after a depth pre-pass shades exactly the fragments the pre-pass kept
     VkPipelineDepthStencilStateCreateInfo depthStencil{};
     depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
     depthStencil.depthTestEnable = VK_TRUE;
     depthStencil.depthWriteEnable = VK_TRUE;
-    depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;
+    depthStencil.depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
     depthStencil.depthBoundsTestEnable = VK_FALSE;
     depthStencil.stencilTestEnable = VK_FALSE;
     VkPipelineColorBlendAttachmentState colorBlendAttachment{};
-    colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-    colorBlendAttachment.blendEnable = VK_TRUE;
     colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
     colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
     colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
@@ -107,7 +123,6 @@ void ven::Shaders::createPipeline(const VkSampleCountFlagBits& msaaSample, const
     }
     VkGraphicsPipelineCreateInfo pipelineInfo{};
     pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-    pipelineInfo.stageCount = 2;
     pipelineInfo.pStages = shaderStages.data();
     pipelineInfo.pVertexInputState = &vertexInputInfo;
     pipelineInfo.pInputAssemblyState = &inputAssembly;
@@ -121,9 +136,155 @@ void ven::Shaders::createPipeline(const VkSampleCountFlagBits& msaaSample, const
     pipelineInfo.renderPass = renderPass;
     pipelineInfo.subpass = 0;
     pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
-    if (vkCreateGraphicsPipelines(m_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_Pipeline) != VK_SUCCESS) {
-        throw utl::THROW_ERROR("failed to create graphics pipeline!");
+    for (uint8_t type = 0; type < static_cast<uint8_t>(PipelineType::COUNT); type++) {
+        const auto pipelineType = static_cast<PipelineType>(type);
+        const bool masked = pipelineType == PipelineType::DEPTH_MASKED || pipelineType == PipelineType::MASKED;
+        const bool blended = pipelineType == PipelineType::BLENDED;
+        const bool depthOnly = pipelineType == PipelineType::DEPTH || pipelineType == PipelineType::DEPTH_MASKED;
+        // a solid depth-only draw has nothing to run per fragment, a masked one only the alpha test
+        pipelineInfo.stageCount = pipelineType == PipelineType::DEPTH ? 1 : 2;
+        shaderStages[1] = pipelineType == PipelineType::DEPTH_MASKED ? depthMaskedStageInfo : fragShaderStageInfo;
+        alphaTest = masked ? VK_TRUE : VK_FALSE;
+        // without a color output there is no alpha to turn into coverage, the discard alone masks the depth
+        multisampling.alphaToCoverageEnable = masked && !depthOnly ? VK_TRUE : VK_FALSE;
+        depthStencil.depthWriteEnable = blended ? VK_FALSE : VK_TRUE;
+        colorBlendAttachment.blendEnable = blended ? VK_TRUE : VK_FALSE;
+        colorBlendAttachment.colorWriteMask = depthOnly ? 0 : VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+        if (vkCreateGraphicsPipelines(m_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_pipelines.at(type)) != VK_SUCCESS) {
+            throw utl::THROW_ERROR("failed to create graphics pipeline!");
+        }
     }
     vkDestroyShaderModule(m_device, vertShader, nullptr);
     vkDestroyShaderModule(m_device, fragShader, nullptr);
+    vkDestroyShaderModule(m_device, depthMaskedShader, nullptr);
+}
+
+VkPipeline ven::Shaders::createComputePipeline(const std::string& name, const VkPipelineLayout& layout) const {
+    PROFILE_SCOPE_DETAIL("Shaders::createComputePipeline", name);
+    VkShaderModule computeShader = nullptr;
+    createShaderModule(utl::readFile(std::string(SHADER_PATH) + "/" + name + ".spv"), computeShader);
+    VkPipelineShaderStageCreateInfo stageInfo{};
+    createPipelineShaderStageCreateInfo(stageInfo, VK_SHADER_STAGE_COMPUTE_BIT, computeShader);
+    const VkComputePipelineCreateInfo pipelineInfo{
+        .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+        .stage = stageInfo,
+        .layout = layout
+    };
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    const VkResult result = vkCreateComputePipelines(m_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline);
+    vkDestroyShaderModule(m_device, computeShader, nullptr);
+    if (result != VK_SUCCESS) {
+        throw utl::THROW_ERROR(("failed to create compute pipeline " + name + "!").c_str());
+    }
+    return pipeline;
+}
+
+VkPipeline ven::Shaders::createShadowPipeline(const VkPipelineLayout& layout, const VkRenderPass& renderPass, const uint32_t resolution) const {
+    PROFILE_FUNCTION();
+    VkShaderModule vertShader = nullptr;
+    createShaderModule(utl::readFile(std::string(SHADER_PATH) + "/shadow_shader.spv"), vertShader);
+    VkPipelineShaderStageCreateInfo stageInfo{};
+    createPipelineShaderStageCreateInfo(stageInfo, VK_SHADER_STAGE_VERTEX_BIT, vertShader);
+    // the position is the only attribute read, the stride still walks whole vertices
+    const auto bindingDescriptions = Vertex::getBindingDescriptions();
+    const VkVertexInputAttributeDescription positionAttribute = Vertex::getAttributeDescriptions().front();
+    const VkPipelineVertexInputStateCreateInfo vertexInputInfo{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
+        .vertexBindingDescriptionCount = 1,
+        .pVertexBindingDescriptions = bindingDescriptions.data(),
+        .vertexAttributeDescriptionCount = 1,
+        .pVertexAttributeDescriptions = &positionAttribute
+    };
+    constexpr VkPipelineInputAssemblyStateCreateInfo inputAssembly{ .sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO, .topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST };
+    const VkViewport viewport{ .x = 0.0F, .y = 0.0F, .width = static_cast<float>(resolution), .height = static_cast<float>(resolution), .minDepth = 0.0F, .maxDepth = 1.0F };
+    const VkRect2D scissor{ .offset = { .x = 0, .y = 0 }, .extent = { .width = resolution, .height = resolution } };
+    const VkPipelineViewportStateCreateInfo viewportState{ .sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO, .viewportCount = 1, .pViewports = &viewport, .scissorCount = 1, .pScissors = &scissor };
+    // no culling: the scene has open meshes and single-sided walls; the slope bias keeps lit surfaces out of their own shadow
+    constexpr VkPipelineRasterizationStateCreateInfo rasterizer{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
+        .polygonMode = VK_POLYGON_MODE_FILL,
+        .cullMode = VK_CULL_MODE_NONE,
+        .frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE,
+        .depthBiasEnable = VK_TRUE,
+        .depthBiasConstantFactor = 1.25F,
+        .depthBiasSlopeFactor = 1.75F,
+        .lineWidth = 1.0F
+    };
+    constexpr VkPipelineMultisampleStateCreateInfo multisampling{ .sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO, .rasterizationSamples = VK_SAMPLE_COUNT_1_BIT };
+    constexpr VkPipelineDepthStencilStateCreateInfo depthStencil{ .sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO, .depthTestEnable = VK_TRUE, .depthWriteEnable = VK_TRUE, .depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL };
+    constexpr VkPipelineColorBlendStateCreateInfo colorBlending{ .sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO };
+    const VkGraphicsPipelineCreateInfo pipelineInfo{
+        .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+        .stageCount = 1,
+        .pStages = &stageInfo,
+        .pVertexInputState = &vertexInputInfo,
+        .pInputAssemblyState = &inputAssembly,
+        .pViewportState = &viewportState,
+        .pRasterizationState = &rasterizer,
+        .pMultisampleState = &multisampling,
+        .pDepthStencilState = &depthStencil,
+        .pColorBlendState = &colorBlending,
+        .layout = layout,
+        .renderPass = renderPass,
+        .subpass = 0
+    };
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    const VkResult result = vkCreateGraphicsPipelines(m_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline);
+    vkDestroyShaderModule(m_device, vertShader, nullptr);
+    if (result != VK_SUCCESS) {
+        throw utl::THROW_ERROR("failed to create shadow pipeline!");
+    }
+    return pipeline;
+}
+
+VkPipeline ven::Shaders::createUpscalePipeline(const VkPipelineLayout& layout, const VkRenderPass& renderPass) const {
+    PROFILE_FUNCTION();
+    VkShaderModule vertShader = nullptr;
+    VkShaderModule fragShader = nullptr;
+    createShaderModule(utl::readFile(std::string(SHADER_PATH) + "/fullscreen_shader.spv"), vertShader);
+    createShaderModule(utl::readFile(std::string(SHADER_PATH) + "/upscale_shader.spv"), fragShader);
+    std::array<VkPipelineShaderStageCreateInfo, 2> stages{};
+    createPipelineShaderStageCreateInfo(stages[0], VK_SHADER_STAGE_VERTEX_BIT, vertShader);
+    createPipelineShaderStageCreateInfo(stages[1], VK_SHADER_STAGE_FRAGMENT_BIT, fragShader);
+    // the triangle is generated from gl_VertexIndex
+    constexpr VkPipelineVertexInputStateCreateInfo vertexInputInfo{ .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO };
+    constexpr VkPipelineInputAssemblyStateCreateInfo inputAssembly{ .sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO, .topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST };
+    constexpr VkPipelineViewportStateCreateInfo viewportState{ .sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO, .viewportCount = 1, .scissorCount = 1 };
+    constexpr VkPipelineRasterizationStateCreateInfo rasterizer{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
+        .polygonMode = VK_POLYGON_MODE_FILL,
+        .cullMode = VK_CULL_MODE_NONE,
+        .frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE,
+        .lineWidth = 1.0F
+    };
+    constexpr VkPipelineMultisampleStateCreateInfo multisampling{ .sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO, .rasterizationSamples = VK_SAMPLE_COUNT_1_BIT };
+    constexpr VkPipelineDepthStencilStateCreateInfo depthStencil{ .sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO };
+    constexpr VkPipelineColorBlendAttachmentState colorBlendAttachment{ .colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT };
+    const VkPipelineColorBlendStateCreateInfo colorBlending{ .sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO, .attachmentCount = 1, .pAttachments = &colorBlendAttachment };
+    constexpr std::array dynamicStates = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+    const VkPipelineDynamicStateCreateInfo dynamicState{ .sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO, .dynamicStateCount = static_cast<uint32_t>(dynamicStates.size()), .pDynamicStates = dynamicStates.data() };
+    const VkGraphicsPipelineCreateInfo pipelineInfo{
+        .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+        .stageCount = static_cast<uint32_t>(stages.size()),
+        .pStages = stages.data(),
+        .pVertexInputState = &vertexInputInfo,
+        .pInputAssemblyState = &inputAssembly,
+        .pViewportState = &viewportState,
+        .pRasterizationState = &rasterizer,
+        .pMultisampleState = &multisampling,
+        .pDepthStencilState = &depthStencil,
+        .pColorBlendState = &colorBlending,
+        .pDynamicState = &dynamicState,
+        .layout = layout,
+        .renderPass = renderPass,
+        .subpass = 0
+    };
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    const VkResult result = vkCreateGraphicsPipelines(m_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline);
+    vkDestroyShaderModule(m_device, fragShader, nullptr);
+    vkDestroyShaderModule(m_device, vertShader, nullptr);
+    if (result != VK_SUCCESS) {
+        throw utl::THROW_ERROR("failed to create upscale pipeline!");
+    }
+    return pipeline;
 }
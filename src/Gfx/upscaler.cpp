@@ -0,0 +1,74 @@
+#include "Utils/ErrorHandling.hpp"
+#include "Utils/Profiler.hpp"
+#include "VEngine/Gfx/Upscaler.hpp"
+
+ven::Upscaler::Upscaler(const Device& device, const Shaders& shaders, const SwapChain& swapChain, DescriptorLayoutCache& layoutCache, DescriptorAllocator& descriptorAllocator) : m_device(device), m_descriptorAllocator(descriptorAllocator) {
+    PROFILE_FUNCTION();
+    const VkDevice& vkDevice = m_device.getVkDevice();
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_LINEAR;
+    samplerInfo.minFilter = VK_FILTER_LINEAR;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    if (vkCreateSampler(vkDevice, &samplerInfo, nullptr, &m_sampler) != VK_SUCCESS) {
+        throw utl::THROW_ERROR("failed to create upscale sampler!");
+    }
+    // 0 scene image
+    constexpr VkDescriptorSetLayoutBinding binding{ .binding = 0, .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, .descriptorCount = 1, .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT };
+    m_descriptorSetLayout = layoutCache.getLayout({ &binding, 1 });
+    constexpr VkPushConstantRange pushConstantRange{ .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT, .offset = 0, .size = sizeof(UpscaleConstants) };
+    const VkPipelineLayoutCreateInfo pipelineLayoutInfo{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+        .setLayoutCount = 1,
+        .pSetLayouts = &m_descriptorSetLayout,
+        .pushConstantRangeCount = 1,
+        .pPushConstantRanges = &pushConstantRange
+    };
+    if (vkCreatePipelineLayout(vkDevice, &pipelineLayoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS) {
+        throw utl::THROW_ERROR("failed to create upscale pipeline layout!");
+    }
+    m_pipeline = shaders.createUpscalePipeline(m_pipelineLayout, swapChain.getPresentRenderPass());
+    setSource(swapChain);
+}
+
+ven::Upscaler::~Upscaler() {
+    const VkDevice& vkDevice = m_device.getVkDevice();
+    vkDestroyPipeline(vkDevice, m_pipeline, nullptr);
+    vkDestroyPipelineLayout(vkDevice, m_pipelineLayout, nullptr);
+    vkDestroySampler(vkDevice, m_sampler, nullptr);
+}
+
+void ven::Upscaler::setSource(const SwapChain& swapChain) {
+    m_sourceExtent = swapChain.getExtent();
+    m_sourceView = swapChain.getSceneImageView();
+}
+
+void ven::Upscaler::recreatePipeline(const Shaders& shaders, const VkRenderPass& renderPass) {
+    vkDestroyPipeline(m_device.getVkDevice(), m_pipeline, nullptr);
+    m_pipeline = shaders.createUpscalePipeline(m_pipelineLayout, renderPass);
+}
+
+void ven::Upscaler::record(const VkCommandBuffer& commandBuffer, const uint32_t frameIndex, const VkExtent2D renderExtent, const UpscaleFilter filter, const float sharpness) const {
+    const glm::vec2 source(static_cast<float>(m_sourceExtent.width), static_cast<float>(m_sourceExtent.height));
+    const glm::vec2 rendered(static_cast<float>(renderExtent.width), static_cast<float>(renderExtent.height));
+    const UpscaleConstants constants{ .uvScale = rendered / source, .uvMax = (rendered - 0.5F) / source, .texelSize = 1.0F / source,
+                                      .sharpness = filter == UpscaleFilter::SHARPEN ? sharpness : 0.0F };
+    // the output is the whole swap chain image, the same size as the scene image
+    const VkViewport viewport{ .x = 0.0F, .y = 0.0F, .width = source.x, .height = source.y, .minDepth = 0.0F, .maxDepth = 1.0F };
+    const VkRect2D scissor{ .offset = { .x = 0, .y = 0 }, .extent = m_sourceExtent };
+    vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+    vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline);
+    // freed with the other sets of the slot once its fence signals
+    const VkDescriptorSet descriptorSet = m_descriptorAllocator.allocate(frameIndex, m_descriptorSetLayout);
+    const VkDescriptorImageInfo imageInfo{ .sampler = m_sampler, .imageView = m_sourceView, .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+    const VkWriteDescriptorSet write{ .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, .dstSet = descriptorSet, .dstBinding = 0, .descriptorCount = 1, .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, .pImageInfo = &imageInfo };
+    vkUpdateDescriptorSets(m_device.getVkDevice(), 1, &write, 0, nullptr);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout, 0, 1, &descriptorSet, 0, nullptr);
+    vkCmdPushConstants(commandBuffer, m_pipelineLayout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(constants), &constants);
+    // one triangle covering the screen, generated from the vertex index
+    vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+}
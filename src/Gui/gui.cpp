@@ -4,19 +4,11 @@
 #include "VEngine/Gui/Gui.hpp"
 
 void createDescriptorPool(const VkDevice& device, VkDescriptorPool& pool) {
-    static constexpr uint16_t DESCRIPTOR_COUNT = 1000;
-    static constexpr std::array<VkDescriptorPoolSize, 11> poolSizes = {{
-        { .type=VK_DESCRIPTOR_TYPE_SAMPLER, .descriptorCount=DESCRIPTOR_COUNT },
-        { .type=VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, .descriptorCount=DESCRIPTOR_COUNT },
-        { .type=VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, .descriptorCount=DESCRIPTOR_COUNT},
-        { .type=VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, .descriptorCount=DESCRIPTOR_COUNT },
-        { .type=VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER, .descriptorCount=DESCRIPTOR_COUNT },
-        { .type=VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER, .descriptorCount=DESCRIPTOR_COUNT },
-        { .type=VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, .descriptorCount=DESCRIPTOR_COUNT },
-        { .type=VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, .descriptorCount=DESCRIPTOR_COUNT },
-        { .type=VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, .descriptorCount=DESCRIPTOR_COUNT },
-        { .type=VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, .descriptorCount=DESCRIPTOR_COUNT },
-        { .type=VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, .descriptorCount=DESCRIPTOR_COUNT }}};
+    // the Vulkan backend only allocates a combined image sampler set per texture, the font atlas and a few spares;
+    // it frees them one by one, so this pool keeps the free bit and stays out of the frame descriptor allocator
+    static constexpr uint16_t DESCRIPTOR_COUNT = 16;
+    static constexpr std::array<VkDescriptorPoolSize, 1> poolSizes = {{
+        { .type=VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, .descriptorCount=DESCRIPTOR_COUNT }}};
     static constexpr VkDescriptorPoolCreateInfo poolInfo {
         .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
         .flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT,
@@ -30,33 +22,67 @@ void createDescriptorPool(const VkDevice& device, VkDescriptorPool& pool) {
 }
 
 ven::Gui::~Gui() {
+    if (m_window == nullptr) {
+        return;
+    }
     ImGui_ImplVulkan_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
     vkDestroyDescriptorPool(m_device, m_pool, nullptr);
 }
 
-ven::Gui::Gui(const Device& device, Camera& camera, GLFWwindow* window, const VkRenderPass& renderPass, std::vector<Model>& models, std::array<VkClearValue, 2>& clearValues, glm::vec3& ambientColor): m_device(device.getVkDevice()), m_models(models), m_clearValues(clearValues), m_ambientColor(ambientColor), m_camera(camera) {
+ven::Gui::Gui(const Device& device, Camera& camera, GLFWwindow* window, const VkRenderPass& renderPass, Registry& scene, TransformHierarchy& transforms, std::array<VkClearValue, 2>& clearValues, glm::vec3& ambientColor, RenderSettings& settings, const RenderStats& stats): m_device(device.getVkDevice()), m_window(window), m_scene(scene), m_transforms(transforms), m_clearValues(clearValues), m_ambientColor(ambientColor), m_settings(settings), m_stats(stats), m_camera(camera) {
     IMGUI_CHECKVERSION();
     const VkPhysicalDevice &physicalDevice = device.getPhysicalDevice();
+    vkGetPhysicalDeviceProperties(physicalDevice, &m_deviceProperties);
+    // nothing is shown nor drives it without a window, neither ImGui nor its backends are set up
+    if (m_window == nullptr) {
+        return;
+    }
     ImGui::CreateContext();
     ImGui::GetIO().IniFilename = nullptr;
     createDescriptorPool(m_device, m_pool);
-    ImGui_ImplVulkan_InitInfo init_info{};
-    init_info.Instance = device.getVkInstance();
-    init_info.PhysicalDevice = physicalDevice;
-    init_info.Device = m_device;
-    init_info.QueueFamily = device.findQueueFamilies(physicalDevice).graphicsFamily.value();
-    init_info.Queue = device.getGraphicsQueue();
-    init_info.PipelineCache = nullptr;
-    init_info.DescriptorPool = m_pool;
-    init_info.RenderPass = renderPass;
-    init_info.MinImageCount = 3;
-    init_info.ImageCount = 3;
-    init_info.MSAASamples = device.getMsaaSamples();
-    init_info.Subpass = 0;
-    ImGui_ImplVulkan_Init(&init_info);
-    ImGui_ImplGlfw_InitForVulkan(window, true);
-    vkGetPhysicalDeviceProperties(physicalDevice, &m_deviceProperties);
+    m_initInfo.Instance = device.getVkInstance();
+    m_initInfo.PhysicalDevice = physicalDevice;
+    m_initInfo.Device = m_device;
+    m_initInfo.QueueFamily = device.findQueueFamilies(physicalDevice).graphicsFamily.value();
+    m_initInfo.Queue = device.getGraphicsQueue();
+    m_initInfo.PipelineCache = nullptr;
+    m_initInfo.DescriptorPool = m_pool;
+    m_initInfo.RenderPass = renderPass;
+    m_initInfo.MinImageCount = 3;
+    m_initInfo.ImageCount = 3;
+    // drawn in the present render pass, after the upscale
+    m_initInfo.MSAASamples = VK_SAMPLE_COUNT_1_BIT;
+    m_initInfo.Subpass = 0;
+    ImGui_ImplVulkan_Init(&m_initInfo);
+    ImGui_ImplGlfw_InitForVulkan(m_window, true);
+    ImGui_ImplVulkan_CreateFontsTexture();
     //blackRedTheme();
 }
+
+void ven::Gui::setRenderPass(const VkRenderPass& renderPass) {
+    if (m_window == nullptr) {
+        return;
+    }
+    ImGui_ImplVulkan_Shutdown();
+    m_initInfo.RenderPass = renderPass;
+    ImGui_ImplVulkan_Init(&m_initInfo);
+    // not left to the next NewFrame: it runs on the update thread and would submit to the queue of the render thread
+    ImGui_ImplVulkan_CreateFontsTexture();
+}
+
+void ven::GuiFrame::capture(const ImDrawData& drawData) {
+    clear();
+    m_drawData = drawData;
+    for (ImDrawList*& list : m_drawData.CmdLists) {
+        list = list->CloneOutput();
+    }
+}
+
+void ven::GuiFrame::clear() {
+    for (ImDrawList* list : m_drawData.CmdLists) {
+        IM_DELETE(list);
+    }
+    m_drawData.Clear();
+}
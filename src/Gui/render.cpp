@@ -12,9 +12,14 @@
 #include "VEngine/Gfx/Resources/Texture.hpp"
 #include "VEngine/Gfx/Resources/TextureManager.hpp"
 #include "VEngine/Gui/Gui.hpp"
+#include "VEngine/Scene/Components.hpp"
 
 static bool IsLegacyNativeDupe(const ImGuiKey key) { return key >= 0 && key < 512; }
 
+static constexpr float TIMINGS_SMOOTHING = 0.05F;
+
+static void smooth(float& value, const float sample) { value += (sample - value) * TIMINGS_SMOOTHING; }
+
 void frameSection(const float frameRate, const ven::FrameStats& frameStats, float& graphMaxFps) {
     const auto displayFrameTimes = frameStats.getDisplayFrameTimes();
     const auto fpsTimes = ven::FrameStats::calculateFPS(displayFrameTimes);
@@ -91,9 +96,28 @@ void memorySection(const ven::MemoryMonitor& memoryMonitor) {
     }
 }
 
-void rendererSection(std::array<VkClearValue, 2>& clearValues) {
+void rendererSection(std::array<VkClearValue, 2>& clearValues, ven::RenderSettings& settings, const ven::RenderStats& stats) {
     if (ImGui::CollapsingHeader("Renderer")) {
         ImGui::Spacing();
+        int recordThreads = static_cast<int>(settings.recordThreads);
+        if (ImGui::SliderInt("Record threads", &recordThreads, 1, static_cast<int>(stats.availableThreads))) {
+            settings.recordThreads = static_cast<uint32_t>(recordThreads);
+        }
+        ImGui::Text("Record time: %.3f ms (%u threads)", stats.recordTime, stats.recordThreads);
+        ImGui::Text("GPU time: %.3f ms", stats.gpuTime);
+        static constexpr std::array<const char*, 3> CULLING_MODES = {"None", "CPU", "GPU"};
+        int culling = static_cast<int>(settings.culling);
+        if (ImGui::Combo("Culling", &culling, CULLING_MODES.data(), stats.gpuCullingSupported ? 3 : 2)) {
+            settings.culling = static_cast<ven::CullingMode>(culling);
+        }
+        if (settings.culling == ven::CullingMode::GPU) {
+            ImGui::Checkbox("Occlusion culling", &settings.occlusionCulling);
+        }
+        ImGui::Checkbox("Depth pre-pass", &settings.depthPrepass);
+        ImGui::Text("Draw calls: %u / %u", stats.drawCount, stats.totalDrawCount);
+        ImGui::Text("Instances: %u / %u (%u culled, %u occluded)", stats.instanceCount, stats.totalInstanceCount, stats.totalInstanceCount - stats.instanceCount, stats.occludedCount);
+        ImGui::Text("Triangles: %llu / %llu", static_cast<unsigned long long>(stats.triangleCount), static_cast<unsigned long long>(stats.totalTriangleCount));
+        ImGui::Text("Descriptor pools: %u", stats.descriptorPoolCount);
         ImGui::ColorEdit4("Clear Color", clearValues.at(0).color.float32);
         ImGui::SliderFloat("Depth", &clearValues.at(1).depthStencil.depth, 0.0F, 1.0F);
         int stencilValue = static_cast<int>(clearValues.at(1).depthStencil.stencil);
@@ -104,28 +128,187 @@ void rendererSection(std::array<VkClearValue, 2>& clearValues) {
     }
 }
 
-void lightSection(glm::vec3& ambientColor) {
+static const char* presentModeName(const VkPresentModeKHR presentMode) {
+    switch (presentMode) {
+        case VK_PRESENT_MODE_IMMEDIATE_KHR: return "Immediate";
+        case VK_PRESENT_MODE_MAILBOX_KHR: return "Mailbox";
+        case VK_PRESENT_MODE_FIFO_KHR: return "FIFO";
+        case VK_PRESENT_MODE_FIFO_RELAXED_KHR: return "FIFO relaxed";
+        default: return "Other";
+    }
+}
+
+void framePacingSection(ven::RenderSettings& settings, const ven::RenderStats& stats, ven::Gui::PacingStats& pacingStats) {
+    if (ImGui::CollapsingHeader("Frame pacing")) {
+        ImGui::Spacing();
+        if (ImGui::BeginCombo("Present mode", presentModeName(settings.presentMode))) {
+            for (const VkPresentModeKHR presentMode : stats.availablePresentModes) {
+                if (ImGui::Selectable(presentModeName(presentMode), presentMode == settings.presentMode)) {
+                    settings.presentMode = presentMode;
+                }
+            }
+            ImGui::EndCombo();
+        }
+        int framesInFlight = static_cast<int>(settings.framesInFlight);
+        if (ImGui::SliderInt("Frames in flight", &framesInFlight, 1, ven::SwapChain::MAX_FRAMES_IN_FLIGHT)) {
+            settings.framesInFlight = static_cast<uint32_t>(framesInFlight);
+        }
+        ImGui::SliderFloat("Max FPS", &settings.maxFps, 0.0F, 480.0F, settings.maxFps > 0.0F ? "%.0f" : "unlimited");
+        if (ImGui::BeginTable("PacingTable", 4)) {
+            ImGui::TableSetupColumn("Mode");
+            ImGui::TableSetupColumn("In flight");
+            ImGui::TableSetupColumn("Mean");
+            ImGui::TableSetupColumn("Std dev");
+            ImGui::TableHeadersRow();
+            for (size_t mode = 0; mode < pacingStats.size(); mode++) {
+                for (size_t framesIndex = 0; framesIndex < pacingStats.at(mode).size(); framesIndex++) {
+                    const ven::RunningStats& entry = pacingStats.at(mode).at(framesIndex);
+                    if (entry.count == 0) { continue; }
+                    ImGui::TableNextColumn(); ImGui::Text("%s", presentModeName(static_cast<VkPresentModeKHR>(mode)));
+                    ImGui::TableNextColumn(); ImGui::Text("%zu", framesIndex + 1);
+                    ImGui::TableNextColumn(); ImGui::Text("%.3f ms", entry.mean);
+                    ImGui::TableNextColumn(); ImGui::Text("%.3f ms", entry.stdDev());
+                }
+            }
+            ImGui::EndTable();
+        }
+        if (ImGui::Button("Reset pacing stats")) {
+            for (auto& modeStats : pacingStats) {
+                for (auto& entry : modeStats) { entry.reset(); }
+            }
+        }
+        ImGui::Spacing();
+    }
+}
+
+void latencySection(const ven::FrameTimings& timings, const float gpuTime) {
+    if (ImGui::CollapsingHeader("Latency")) {
+        ImGui::Spacing();
+        if (ImGui::BeginTable("LatencyTable", 2)) {
+            ImGui::TableNextColumn(); ImGui::Text("Limiter"); ImGui::TableNextColumn(); ImGui::Text("%.3f ms", timings.limiterWait);
+            ImGui::TableNextColumn(); ImGui::Text("Input"); ImGui::TableNextColumn(); ImGui::Text("%.3f ms", timings.input);
+            ImGui::TableNextColumn(); ImGui::Text("Fence wait"); ImGui::TableNextColumn(); ImGui::Text("%.3f ms", timings.fenceWait);
+            ImGui::TableNextColumn(); ImGui::Text("Acquire"); ImGui::TableNextColumn(); ImGui::Text("%.3f ms", timings.acquire);
+            ImGui::TableNextColumn(); ImGui::Text("Update"); ImGui::TableNextColumn(); ImGui::Text("%.3f ms", timings.update);
+            ImGui::TableNextColumn(); ImGui::Text("Record"); ImGui::TableNextColumn(); ImGui::Text("%.3f ms", timings.record);
+            ImGui::TableNextColumn(); ImGui::Text("Submit"); ImGui::TableNextColumn(); ImGui::Text("%.3f ms", timings.submit);
+            ImGui::TableNextColumn(); ImGui::Text("Present"); ImGui::TableNextColumn(); ImGui::Text("%.3f ms", timings.present);
+            ImGui::TableNextColumn(); ImGui::Text("Render wait"); ImGui::TableNextColumn(); ImGui::Text("%.3f ms", timings.renderWait);
+            ImGui::EndTable();
+        }
+        const float cpu = timings.cpuTime();
+        ImGui::Text("Frame: %.3f ms", timings.total());
+        ImGui::Text("Waiting on GPU: %.3f ms / display: %.3f ms", timings.gpuWait(), timings.displayWait());
+        ImGui::Text("Work CPU: %.3f ms / GPU: %.3f ms", cpu, gpuTime);
+        // the threads and the GPU overlap, the longest of the CPU work, the GPU work and the idle time the limiter or
+        // the display impose paces the loop, the others wait on it
+        const std::array<std::pair<float, const char*>, 4> paces = {{ {timings.limiterWait, "frame limiter"}, {timings.displayWait(), "display"}, {cpu, "CPU"}, {gpuTime, "GPU"} }};
+        ImGui::Text("Bound: %s", std::ranges::max(paces, {}, [](const auto& pace) { return pace.first; }).second);
+        ImGui::Spacing();
+    }
+}
+
+void gpuSection(const ven::GpuStats& gpu) {
+    if (ImGui::CollapsingHeader("GPU")) {
+        ImGui::Spacing();
+        if (gpu.scopeCount == 0) {
+            ImGui::Text("Timestamps not supported by the graphics queue");
+        } else if (ImGui::BeginTable("GpuScopesTable", 2)) {
+            for (uint32_t scope = 0; scope < gpu.scopeCount; scope++) {
+                ImGui::TableNextColumn(); ImGui::Text("%s", gpu.scopes.at(scope).name); ImGui::TableNextColumn(); ImGui::Text("%.3f ms", gpu.scopes.at(scope).time);
+            }
+            ImGui::EndTable();
+        }
+        if (!gpu.pipelineStatistics) {
+            ImGui::Text("Pipeline statistics not supported by the device");
+        } else if (ImGui::BeginTable("GpuStatisticsTable", 2)) {
+            ImGui::TableNextColumn(); ImGui::Text("Input primitives"); ImGui::TableNextColumn(); ImGui::Text("%llu", static_cast<unsigned long long>(gpu.inputPrimitives));
+            ImGui::TableNextColumn(); ImGui::Text("Vertex invocations"); ImGui::TableNextColumn(); ImGui::Text("%llu", static_cast<unsigned long long>(gpu.vertexInvocations));
+            ImGui::TableNextColumn(); ImGui::Text("Clipping primitives"); ImGui::TableNextColumn(); ImGui::Text("%llu", static_cast<unsigned long long>(gpu.clippingPrimitives));
+            ImGui::TableNextColumn(); ImGui::Text("Fragment invocations"); ImGui::TableNextColumn(); ImGui::Text("%llu", static_cast<unsigned long long>(gpu.fragmentInvocations));
+            ImGui::EndTable();
+        }
+        ImGui::Spacing();
+    }
+}
+
+void lightSection(glm::vec3& ambientColor, ven::RenderSettings& settings, const ven::RenderStats& stats) {
     if (ImGui::CollapsingHeader("Light")) {
         ImGui::Spacing();
         ImGui::ColorEdit3("Ambient", glm::value_ptr(ambientColor));
+        ImGui::Text("Lights: %u", stats.lightCount);
+        ImGui::Checkbox("Show light clusters", &settings.showLightClusters);
+        ImGui::SliderFloat("Sun azimuth", &settings.sunAzimuth, -180.0F, 180.0F);
+        ImGui::SliderFloat("Sun elevation", &settings.sunElevation, 1.0F, 90.0F);
+        ImGui::SliderFloat("Sun intensity", &settings.sunIntensity, 0.0F, 4.0F);
         ImGui::Spacing();
     }
 }
 
-void objectsSection(std::vector<ven::Model>& models) {
+void shadowSection(ven::RenderSettings& settings, const ven::ShadowStats& stats) {
+    if (ImGui::CollapsingHeader("Shadows")) {
+        ImGui::Spacing();
+        ImGui::Checkbox("Sun shadows", &settings.shadows);
+        ImGui::Checkbox("Cache static cascades", &settings.cacheShadows);
+        ImGui::SliderFloat("Shadow distance", &settings.shadowDistance, 5.0F, 500.0F);
+        ImGui::SliderFloat("Split lambda", &settings.cascadeSplitLambda, 0.0F, 1.0F);
+        ImGui::Text("Cache hit rate: %.1f %% (%llu hits, %llu redraws)", stats.hitRate() * 100.0F, static_cast<unsigned long long>(stats.cacheHits), static_cast<unsigned long long>(stats.cacheMisses));
+        if (ImGui::BeginTable("ShadowCascadesTable", 4)) {
+            ImGui::TableSetupColumn("Cascade"); ImGui::TableSetupColumn("State"); ImGui::TableSetupColumn("Last render"); ImGui::TableSetupColumn("Casters");
+            ImGui::TableHeadersRow();
+            for (uint32_t cascade = 0; cascade < ven::ShadowStats::CASCADE_COUNT; cascade++) {
+                ImGui::TableNextColumn(); ImGui::Text("%u", cascade);
+                ImGui::TableNextColumn(); ImGui::Text("%s", stats.cached.at(cascade) ? "cached" : "redrawn");
+                ImGui::TableNextColumn(); ImGui::Text("%.3f ms", stats.renderTimes.at(cascade));
+                ImGui::TableNextColumn(); ImGui::Text("%u", stats.casterCounts.at(cascade));
+            }
+            ImGui::EndTable();
+        }
+        ImGui::Spacing();
+    }
+}
+
+void resolutionSection(ven::RenderSettings& settings, const ven::RenderStats& stats) {
+    if (ImGui::CollapsingHeader("Resolution")) {
+        ImGui::Spacing();
+        ImGui::Checkbox("Dynamic resolution", &settings.dynamicResolution);
+        if (settings.dynamicResolution) {
+            ImGui::SliderFloat("GPU time target (ms)", &settings.targetFrameTime, 4.0F, 50.0F);
+            ImGui::SliderFloat("Min render scale", &settings.minRenderScale, ven::RenderSettings::MIN_RENDER_SCALE, 1.0F);
+        } else {
+            ImGui::SliderFloat("Render scale", &settings.renderScale, ven::RenderSettings::MIN_RENDER_SCALE, 1.0F);
+        }
+        ImGui::Text("Scene: %ux%u (%.0f %%)", stats.renderExtent.width, stats.renderExtent.height, stats.renderScale * 100.0F);
+        static constexpr std::array<const char*, 2> UPSCALE_FILTERS = {"Bilinear", "Sharpen"};
+        int filter = static_cast<int>(settings.upscaleFilter);
+        if (ImGui::Combo("Upscale", &filter, UPSCALE_FILTERS.data(), static_cast<int>(UPSCALE_FILTERS.size()))) {
+            settings.upscaleFilter = static_cast<ven::UpscaleFilter>(filter);
+        }
+        if (settings.upscaleFilter == ven::UpscaleFilter::SHARPEN) {
+            ImGui::SliderFloat("Sharpness", &settings.sharpness, 0.0F, 1.0F);
+        }
+        ImGui::Spacing();
+    }
+}
+
+void objectsSection(ven::Registry& scene, ven::TransformHierarchy& transforms) {
     int count = 0;
     if (ImGui::CollapsingHeader("Objects")) {
         ImGui::Spacing();
-        for (auto& model : models) {
+        // the editable roots, one per loaded model
+        scene.forEach<ven::Transform, const ven::TransformNode>([&](ven::Transform& transform, const ven::TransformNode& node) {
             count++;
             const std::string number = std::to_string(count);
             ImGui::Separator();
             ImGui::Text("Object %d", count);
-            auto&[position, rotation, scale] = model.getTransform();
-            ImGui::SliderFloat3(("Position##" + number).c_str(), glm::value_ptr(position), -100.0F, 100.0F);
-            ImGui::SliderFloat3(("Rotation##" +number).c_str(), glm::value_ptr(rotation), -180.0F, 180.0F);
-            ImGui::SliderFloat3(("Scale##" + number).c_str(), glm::value_ptr(scale), 0.1F, 10.0F);
-        }
+            auto&[position, rotation, scale] = transform;
+            bool changed = ImGui::SliderFloat3(("Position##" + number).c_str(), glm::value_ptr(position), -100.0F, 100.0F);
+            changed |= ImGui::SliderFloat3(("Rotation##" +number).c_str(), glm::value_ptr(rotation), -180.0F, 180.0F);
+            changed |= ImGui::SliderFloat3(("Scale##" + number).c_str(), glm::value_ptr(scale), 0.1F, 10.0F);
+            if (changed) {
+                transforms.setLocal(node.node, transform.getMatrix());
+            }
+        });
         ImGui::Spacing();
     }
 }
@@ -227,7 +410,7 @@ void themeSection() {
     }
 }
 
-void ven::Gui::render(const VkCommandBuffer& commandBuffer) {
+void ven::Gui::update(GuiFrame& frame) {
     const ImGuiIO& imGui = ImGui::GetIO();
     const float frameRate = imGui.Framerate;
     ImGui_ImplVulkan_NewFrame();
@@ -243,13 +426,33 @@ void ven::Gui::render(const VkCommandBuffer& commandBuffer) {
     ImGui::PushStyleColor(ImGuiCol_PopupBg, ImVec4(0.2F, 0.2F, 0.2F, 0.5F));
     if (ImGui::Begin("##Right Panel", nullptr, ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_NoTitleBar)) {
         m_frameStats.updateFrameTimes(imGui.DeltaTime);
+        // the first frame after a pacing change still carries the old configuration, it is not accounted to either
+        const PacingConfig pacing{ .presentMode = m_settings.presentMode, .framesInFlight = m_settings.framesInFlight, .maxFps = m_settings.maxFps };
+        if (pacing == m_lastPacing && m_settings.presentMode < PRESENT_MODE_COUNT) {
+            m_pacingStats.at(m_settings.presentMode).at(m_settings.framesInFlight - 1).add(static_cast<double>(imGui.DeltaTime) * 1000.0);
+        }
+        m_lastPacing = pacing;
+        smooth(m_timings.limiterWait, m_stats.frameTimings.limiterWait);
+        smooth(m_timings.input, m_stats.frameTimings.input);
+        smooth(m_timings.fenceWait, m_stats.frameTimings.fenceWait);
+        smooth(m_timings.acquire, m_stats.frameTimings.acquire);
+        smooth(m_timings.update, m_stats.frameTimings.update);
+        smooth(m_timings.record, m_stats.frameTimings.record);
+        smooth(m_timings.submit, m_stats.frameTimings.submit);
+        smooth(m_timings.present, m_stats.frameTimings.present);
+        smooth(m_timings.renderWait, m_stats.frameTimings.renderWait);
         frameSection(frameRate, m_frameStats, m_graphMaxFps);
+        framePacingSection(m_settings, m_stats, m_pacingStats);
+        latencySection(m_timings, m_stats.gpuTime);
         m_memoryMonitor.update();
         memorySection(m_memoryMonitor);
-        rendererSection(m_clearValues);
+        rendererSection(m_clearValues, m_settings, m_stats);
+        resolutionSection(m_settings, m_stats);
+        gpuSection(m_stats.gpu);
         cameraSection(m_camera);
-        lightSection(m_ambientColor);
-        objectsSection(m_models);
+        lightSection(m_ambientColor, m_settings, m_stats);
+        shadowSection(m_settings, m_stats.shadows);
+        objectsSection(m_scene, m_transforms);
         inputsSection(imGui);
     }
     ImGui::End();
@@ -259,5 +462,12 @@ void ven::Gui::render(const VkCommandBuffer& commandBuffer) {
     ImGui::EndMainMenuBar();
     ImGui::PopStyleColor(4);
     ImGui::Render();
-    ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), commandBuffer);
+    frame.capture(*ImGui::GetDrawData());
+}
+
+void ven::Gui::record(const VkCommandBuffer& commandBuffer, const GuiFrame& frame) {
+    if (!frame.isEmpty()) {
+        // the backend only reads the draw data, its signature is not const
+        ImGui_ImplVulkan_RenderDrawData(const_cast<ImDrawData*>(&frame.getDrawData()), commandBuffer);
+    }
 }
@@ -0,0 +1,31 @@
+#include "VEngine/Scene/Bounds.hpp"
+
+ven::Bounds ven::Bounds::transform(const glm::mat4& matrix) const {
+    // Arvo: each world axis of the box gathers the absolute contribution of every local axis
+    const glm::mat3 linear(matrix);
+    const glm::mat3 absolute(glm::abs(linear[0]), glm::abs(linear[1]), glm::abs(linear[2]));
+    const float scale = glm::max(glm::length(linear[0]), glm::max(glm::length(linear[1]), glm::length(linear[2])));
+    return { .center = glm::vec3(matrix * glm::vec4(center, 1.0F)), .extent = absolute * extent, .radius = radius * scale };
+}
+
+void ven::BoundsSoA::resize(const size_t size) {
+    count = size;
+    const size_t padded = (size + LANES - 1) / LANES * LANES;
+    for (std::vector<float>* component : {&centerX, &centerY, &centerZ, &extentX, &extentY, &extentZ, &radius}) {
+        component->assign(padded, 0.0F);
+    }
+}
+
+void ven::BoundsSoA::set(const size_t index, const Bounds& bounds) {
+    centerX[index] = bounds.center.x;
+    centerY[index] = bounds.center.y;
+    centerZ[index] = bounds.center.z;
+    extentX[index] = bounds.extent.x;
+    extentY[index] = bounds.extent.y;
+    extentZ[index] = bounds.extent.z;
+    radius[index] = bounds.radius;
+}
+
+ven::Bounds ven::BoundsSoA::get(const size_t index) const {
+    return { .center = {centerX[index], centerY[index], centerZ[index]}, .extent = {extentX[index], extentY[index], extentZ[index]}, .radius = radius[index] };
+}
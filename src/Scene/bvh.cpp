@@ -0,0 +1,344 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <numeric>
+
+#include "Utils/Profiler.hpp"
+#include "VEngine/Scene/Bvh.hpp"
+
+namespace {
+
+    constexpr float TRAVERSAL_COST = 1.0F; ///< cost of visiting an inner node relative to testing one primitive
+
+    float surfaceArea(const glm::vec3& min, const glm::vec3& max) {
+        const glm::vec3 size = glm::max(max - min, glm::vec3(0.0F));
+        return 2.0F * ((size.x * size.y) + (size.y * size.z) + (size.z * size.x));
+    }
+
+    /// @return -1 outside a plane, 0 crossing one, 1 inside all
+    int classify(const std::array<glm::vec4, 6>& planes, const glm::vec3& min, const glm::vec3& max) {
+        const glm::vec3 center = (min + max) * 0.5F;
+        const glm::vec3 extent = (max - min) * 0.5F;
+        int result = 1;
+        for (const glm::vec4& plane : planes) {
+            const glm::vec3 normal(plane);
+            const float distance = glm::dot(normal, center) + plane.w;
+            const float reach = glm::dot(glm::abs(normal), extent);
+            if (distance + reach < 0.0F) {
+                return -1;
+            }
+            if (distance - reach < 0.0F) {
+                result = 0;
+            }
+        }
+        return result;
+    }
+
+    bool overlapsSphere(const glm::vec3& min, const glm::vec3& max, const glm::vec3& center, const float radiusSquared) {
+        const glm::vec3 offset = glm::clamp(center, min, max) - center;
+        return glm::dot(offset, offset) <= radiusSquared;
+    }
+
+    /// @return Entry distance of the ray in the box, or a negative value when it misses it before maxDistance
+    float intersect(const glm::vec3& min, const glm::vec3& max, const glm::vec3& origin, const glm::vec3& inverseDirection, const float maxDistance) {
+        const glm::vec3 near = (min - origin) * inverseDirection;
+        const glm::vec3 far = (max - origin) * inverseDirection;
+        const glm::vec3 entry = glm::min(near, far);
+        const glm::vec3 exit = glm::max(near, far);
+        const float tEntry = glm::max(glm::max(entry.x, entry.y), glm::max(entry.z, 0.0F));
+        const float tExit = glm::min(glm::min(exit.x, exit.y), glm::min(exit.z, maxDistance));
+        return tEntry <= tExit ? tEntry : -1.0F;
+    }
+
+} // namespace
+
+void ven::Bvh::build(const std::span<const Bounds> bounds, utl::ThreadPool* threadPool) {
+    PROFILE_FUNCTION();
+    const auto count = static_cast<uint32_t>(bounds.size());
+    m_nodes.clear();
+    m_primitives.resize(count);
+    std::iota(m_primitives.begin(), m_primitives.end(), 0U);
+    m_boxes.resize(count);
+    m_centroids.resize(count);
+    BvhNode root{ .min = glm::vec3(std::numeric_limits<float>::max()), .leftFirst = 0, .max = glm::vec3(std::numeric_limits<float>::lowest()), .count = count };
+    for (uint32_t i = 0; i < count; i++) {
+        m_boxes[i] = { .min = bounds[i].center - bounds[i].extent, .max = bounds[i].center + bounds[i].extent };
+        m_centroids[i] = bounds[i].center;
+        root.min = glm::min(root.min, m_boxes[i].min);
+        root.max = glm::max(root.max, m_boxes[i].max);
+    }
+    if (count == 0) {
+        m_buildCost = m_cost = 0.0F;
+        return;
+    }
+    m_nodes.reserve(static_cast<size_t>(count) * 2);
+    m_nodes.push_back(root);
+    if (threadPool == nullptr || threadPool->getThreadCount() == 1 || count < PARALLEL_BUILD_SIZE) {
+        subdivide(m_nodes, 0, 0, MAX_DEPTH, nullptr);
+    } else {
+        // enough subtrees for every thread to get a few of them, the binned splits keep them roughly balanced
+        const auto splitDepth = static_cast<uint32_t>(std::bit_width(threadPool->getThreadCount() * 4));
+        std::vector<uint32_t> pending;
+        subdivide(m_nodes, 0, 0, splitDepth, &pending);
+        std::vector<std::vector<BvhNode>> subtrees(pending.size());
+        threadPool->parallelFor(static_cast<uint32_t>(pending.size()), [&](const uint32_t i) {
+            // each subtree owns the primitive range of its root, the partitions never overlap
+            subtrees[i].push_back(m_nodes[pending[i]]);
+            subdivide(subtrees[i], 0, splitDepth, MAX_DEPTH, nullptr);
+        });
+        // appended after every node built so far, children still come after their parent
+        for (size_t i = 0; i < pending.size(); i++) {
+            const auto offset = static_cast<uint32_t>(m_nodes.size()) - 1;
+            for (BvhNode& node : subtrees[i]) {
+                if (!node.isLeaf()) {
+                    node.leftFirst += offset;
+                }
+            }
+            m_nodes[pending[i]] = subtrees[i].front();
+            m_nodes.insert(m_nodes.end(), subtrees[i].begin() + 1, subtrees[i].end());
+        }
+    }
+    m_centroids.clear();
+    m_buildCost = m_cost = computeCost();
+}
+
+void ven::Bvh::subdivide(std::vector<BvhNode>& nodes, const uint32_t node, const uint32_t depth, const uint32_t maxDepth, std::vector<uint32_t>* pending) {
+    struct Bin {
+        Aabb box;
+        uint32_t count = 0;
+    };
+    std::vector<std::pair<uint32_t, uint32_t>> stack{{node, depth}};
+    while (!stack.empty()) {
+        const auto [index, level] = stack.back();
+        stack.pop_back();
+        if (level == maxDepth && pending != nullptr) {
+            pending->push_back(index);
+            continue;
+        }
+        const uint32_t first = nodes[index].leftFirst;
+        const uint32_t count = nodes[index].count;
+        if (count <= MAX_LEAF_SIZE || level + 1 >= MAX_DEPTH) {
+            continue;
+        }
+        glm::vec3 centroidMin(std::numeric_limits<float>::max());
+        glm::vec3 centroidMax(std::numeric_limits<float>::lowest());
+        for (uint32_t i = first; i < first + count; i++) {
+            centroidMin = glm::min(centroidMin, m_centroids[m_primitives[i]]);
+            centroidMax = glm::max(centroidMax, m_centroids[m_primitives[i]]);
+        }
+        // binned SAH, the split goes between two bins of the axis with the lowest cost
+        float bestCost = std::numeric_limits<float>::max();
+        int bestAxis = -1;
+        uint32_t bestBin = 0;
+        for (int axis = 0; axis < 3; axis++) {
+            const float extent = centroidMax[axis] - centroidMin[axis];
+            if (extent <= 0.0F) {
+                continue;
+            }
+            const float scale = static_cast<float>(BIN_COUNT) / extent;
+            std::array<Bin, BIN_COUNT> bins{};
+            for (uint32_t i = first; i < first + count; i++) {
+                const uint32_t primitive = m_primitives[i];
+                const auto bin = std::min(BIN_COUNT - 1, static_cast<uint32_t>((m_centroids[primitive][axis] - centroidMin[axis]) * scale));
+                bins[bin].count++;
+                bins[bin].box.min = glm::min(bins[bin].box.min, m_boxes[primitive].min);
+                bins[bin].box.max = glm::max(bins[bin].box.max, m_boxes[primitive].max);
+            }
+            std::array<float, BIN_COUNT - 1> leftCosts{};
+            Aabb left;
+            uint32_t leftCount = 0;
+            for (uint32_t bin = 0; bin < BIN_COUNT - 1; bin++) {
+                leftCount += bins[bin].count;
+                left.min = glm::min(left.min, bins[bin].box.min);
+                left.max = glm::max(left.max, bins[bin].box.max);
+                leftCosts[bin] = leftCount == 0 ? 0.0F : static_cast<float>(leftCount) * surfaceArea(left.min, left.max);
+            }
+            Aabb right;
+            uint32_t rightCount = 0;
+            for (uint32_t bin = BIN_COUNT - 1; bin > 0; bin--) {
+                rightCount += bins[bin].count;
+                right.min = glm::min(right.min, bins[bin].box.min);
+                right.max = glm::max(right.max, bins[bin].box.max);
+                const float cost = leftCosts[bin - 1] + (rightCount == 0 ? 0.0F : static_cast<float>(rightCount) * surfaceArea(right.min, right.max));
+                if (cost < bestCost && rightCount != 0 && rightCount != count) {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestBin = bin;
+                }
+            }
+        }
+        const float area = surfaceArea(nodes[index].min, nodes[index].max);
+        uint32_t leftCount = count / 2;
+        if (bestAxis >= 0) {
+            if ((TRAVERSAL_COST * area) + bestCost >= static_cast<float>(count) * area) {
+                continue;
+            }
+            const float scale = static_cast<float>(BIN_COUNT) / (centroidMax[bestAxis] - centroidMin[bestAxis]);
+            const auto middle = std::partition(m_primitives.begin() + first, m_primitives.begin() + first + count, [&](const uint32_t primitive) {
+                return std::min(BIN_COUNT - 1, static_cast<uint32_t>((m_centroids[primitive][bestAxis] - centroidMin[bestAxis]) * scale)) < bestBin;
+            });
+            leftCount = static_cast<uint32_t>(middle - (m_primitives.begin() + first));
+        }
+        // every centroid at the same place: no plane separates them, halve the range as is
+        const auto leftIndex = static_cast<uint32_t>(nodes.size());
+        for (const auto [childFirst, childCount] : {std::pair{first, leftCount}, std::pair{first + leftCount, count - leftCount}}) {
+            BvhNode child{ .min = glm::vec3(std::numeric_limits<float>::max()), .leftFirst = childFirst, .max = glm::vec3(std::numeric_limits<float>::lowest()), .count = childCount };
+            for (uint32_t i = childFirst; i < childFirst + childCount; i++) {
+                child.min = glm::min(child.min, m_boxes[m_primitives[i]].min);
+                child.max = glm::max(child.max, m_boxes[m_primitives[i]].max);
+            }
+            nodes.push_back(child);
+        }
+        nodes[index].leftFirst = leftIndex;
+        nodes[index].count = 0;
+        stack.emplace_back(leftIndex + 1, level + 1);
+        stack.emplace_back(leftIndex, level + 1);
+    }
+}
+
+void ven::Bvh::refit(const std::span<const Bounds> bounds) {
+    PROFILE_FUNCTION();
+    for (size_t i = 0; i < m_boxes.size(); i++) {
+        m_boxes[i] = { .min = bounds[i].center - bounds[i].extent, .max = bounds[i].center + bounds[i].extent };
+    }
+    // children are stored after their parent, a reverse sweep sees them updated first
+    for (size_t i = m_nodes.size(); i-- > 0;) {
+        BvhNode& node = m_nodes[i];
+        if (node.isLeaf()) {
+            node.min = glm::vec3(std::numeric_limits<float>::max());
+            node.max = glm::vec3(std::numeric_limits<float>::lowest());
+            for (uint32_t j = node.leftFirst; j < node.leftFirst + node.count; j++) {
+                node.min = glm::min(node.min, m_boxes[m_primitives[j]].min);
+                node.max = glm::max(node.max, m_boxes[m_primitives[j]].max);
+            }
+        } else {
+            node.min = glm::min(m_nodes[node.leftFirst].min, m_nodes[node.leftFirst + 1].min);
+            node.max = glm::max(m_nodes[node.leftFirst].max, m_nodes[node.leftFirst + 1].max);
+        }
+    }
+    m_cost = computeCost();
+}
+
+float ven::Bvh::computeCost() const {
+    if (m_nodes.empty()) {
+        return 0.0F;
+    }
+    float cost = 0.0F;
+    for (const BvhNode& node : m_nodes) {
+        const float area = surfaceArea(node.min, node.max);
+        cost += node.isLeaf() ? area * static_cast<float>(node.count) : area * TRAVERSAL_COST;
+    }
+    const float rootArea = surfaceArea(m_nodes.front().min, m_nodes.front().max);
+    return rootArea > 0.0F ? cost / rootArea : 0.0F;
+}
+
+void ven::Bvh::appendSubtree(const uint32_t node, std::vector<uint32_t>& result) const {
+    uint32_t first = node;
+    while (!m_nodes[first].isLeaf()) {
+        first = m_nodes[first].leftFirst;
+    }
+    uint32_t last = node;
+    while (!m_nodes[last].isLeaf()) {
+        last = m_nodes[last].leftFirst + 1;
+    }
+    result.insert(result.end(), m_primitives.begin() + m_nodes[first].leftFirst, m_primitives.begin() + m_nodes[last].leftFirst + m_nodes[last].count);
+}
+
+void ven::Bvh::queryFrustum(const Frustum& frustum, std::vector<uint32_t>& result) const {
+    if (m_nodes.empty()) {
+        return;
+    }
+    const std::array<glm::vec4, 6>& planes = frustum.getPlanes();
+    std::array<uint32_t, MAX_DEPTH + 1> stack{};
+    uint32_t size = 0;
+    stack[size++] = 0;
+    while (size > 0) {
+        const BvhNode& node = m_nodes[stack[--size]];
+        const int side = classify(planes, node.min, node.max);
+        if (side < 0) {
+            continue;
+        }
+        if (side > 0) {
+            appendSubtree(static_cast<uint32_t>(&node - m_nodes.data()), result);
+        } else if (node.isLeaf()) {
+            for (uint32_t i = node.leftFirst; i < node.leftFirst + node.count; i++) {
+                if (classify(planes, m_boxes[m_primitives[i]].min, m_boxes[m_primitives[i]].max) >= 0) {
+                    result.push_back(m_primitives[i]);
+                }
+            }
+        } else {
+            stack[size++] = node.leftFirst + 1;
+            stack[size++] = node.leftFirst;
+        }
+    }
+}
+
+void ven::Bvh::queryRadius(const glm::vec3& center, const float radius, std::vector<uint32_t>& result) const {
+    if (m_nodes.empty()) {
+        return;
+    }
+    const float radiusSquared = radius * radius;
+    std::array<uint32_t, MAX_DEPTH + 1> stack{};
+    uint32_t size = 0;
+    stack[size++] = 0;
+    while (size > 0) {
+        const BvhNode& node = m_nodes[stack[--size]];
+        if (!overlapsSphere(node.min, node.max, center, radiusSquared)) {
+            continue;
+        }
+        if (node.isLeaf()) {
+            for (uint32_t i = node.leftFirst; i < node.leftFirst + node.count; i++) {
+                if (overlapsSphere(m_boxes[m_primitives[i]].min, m_boxes[m_primitives[i]].max, center, radiusSquared)) {
+                    result.push_back(m_primitives[i]);
+                }
+            }
+        } else {
+            stack[size++] = node.leftFirst + 1;
+            stack[size++] = node.leftFirst;
+        }
+    }
+}
+
+std::optional<ven::RayHit> ven::Bvh::raycast(const glm::vec3& origin, const glm::vec3& direction, const float maxDistance) const {
+    if (m_nodes.empty()) {
+        return std::nullopt;
+    }
+    const glm::vec3 inverseDirection = 1.0F / direction;
+    std::optional<RayHit> hit;
+    float nearest = maxDistance;
+    std::array<uint32_t, MAX_DEPTH + 1> stack{};
+    uint32_t size = 0;
+    if (intersect(m_nodes.front().min, m_nodes.front().max, origin, inverseDirection, nearest) >= 0.0F) {
+        stack[size++] = 0;
+    }
+    while (size > 0) {
+        const BvhNode& node = m_nodes[stack[--size]];
+        if (node.isLeaf()) {
+            for (uint32_t i = node.leftFirst; i < node.leftFirst + node.count; i++) {
+                const Aabb& box = m_boxes[m_primitives[i]];
+                if (const float distance = intersect(box.min, box.max, origin, inverseDirection, nearest); distance >= 0.0F) {
+                    nearest = distance;
+                    hit = RayHit{ .primitive = m_primitives[i], .distance = distance };
+                }
+            }
+            continue;
+        }
+        // nearest child last so it is popped first, the other one is often skipped once a hit shortened the ray
+        const BvhNode& left = m_nodes[node.leftFirst];
+        const BvhNode& right = m_nodes[node.leftFirst + 1];
+        const float leftDistance = intersect(left.min, left.max, origin, inverseDirection, nearest);
+        const float rightDistance = intersect(right.min, right.max, origin, inverseDirection, nearest);
+        const bool leftFirst = leftDistance >= 0.0F && (rightDistance < 0.0F || leftDistance <= rightDistance);
+        const uint32_t nearChild = leftFirst ? node.leftFirst : node.leftFirst + 1;
+        const uint32_t farChild = leftFirst ? node.leftFirst + 1 : node.leftFirst;
+        const float farDistance = leftFirst ? rightDistance : leftDistance;
+        const float nearDistance = leftFirst ? leftDistance : rightDistance;
+        if (farDistance >= 0.0F) {
+            stack[size++] = farChild;
+        }
+        if (nearDistance >= 0.0F) {
+            stack[size++] = nearChild;
+        }
+    }
+    return hit;
+}
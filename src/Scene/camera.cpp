@@ -1,4 +1,3 @@
-#define GLM_FORCE_DEPTH_ZERO_TO_ONE
 #include <glm/gtc/matrix_transform.hpp>
 
 #include "VEngine/Scene/Camera.hpp"
@@ -12,6 +11,17 @@ void ven::Camera::rotate(const float yawOffset, const float pitchOffset, const f
     const float distance = m_lookSpeed * deltaTime;
     m_yaw += yawOffset * distance;
     m_pitch += pitchOffset * distance;
+    updateVectors();
+}
+
+void ven::Camera::setPose(const glm::vec3& position, const float yaw, const float pitch) {
+    m_position = position;
+    m_yaw = yaw;
+    m_pitch = pitch;
+    updateVectors();
+}
+
+void ven::Camera::updateVectors() {
     m_pitch = glm::clamp(m_pitch, -89.0F, 89.0F);
     m_front = glm::normalize(glm::vec3(cos(glm::radians(m_yaw)) * cos(glm::radians(m_pitch)), sin(glm::radians(m_pitch)), sin(glm::radians(m_yaw)) * cos(glm::radians(m_pitch))));
     m_right = glm::normalize(glm::cross(m_front, m_worldUp));
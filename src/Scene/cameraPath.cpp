@@ -0,0 +1,59 @@
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#include "Utils/ErrorHandling.hpp"
+#include "VEngine/Scene/CameraPath.hpp"
+
+template<typename T>
+static T catmullRom(const T& p0, const T& p1, const T& p2, const T& p3, const float u) {
+    const float u2 = u * u;
+    const float u3 = u2 * u;
+    return 0.5F * ((2.0F * p1) + ((p2 - p0) * u) + (((2.0F * p0) - (5.0F * p1) + (4.0F * p2) - p3) * u2) + ((-p0 + (3.0F * p1) - (3.0F * p2) + p3) * u3));
+}
+
+ven::CameraPath::CameraPath(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw utl::THROW_ERROR(("failed to open camera path: " + path).c_str());
+    }
+    std::string line;
+    for (size_t lineNumber = 1; std::getline(file, line); lineNumber++) {
+        line = line.substr(0, line.find('#'));
+        if (line.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+        std::istringstream stream(line);
+        Key key;
+        if (!(stream >> key.time >> key.position.x >> key.position.y >> key.position.z >> key.yaw >> key.pitch)) {
+            throw utl::THROW_ERROR((path + ":" + std::to_string(lineNumber) + ": expected time x y z yaw pitch").c_str());
+        }
+        if (!m_keys.empty() && key.time <= m_keys.back().time) {
+            throw utl::THROW_ERROR((path + ":" + std::to_string(lineNumber) + ": keys must be sorted by time").c_str());
+        }
+        m_keys.push_back(key);
+    }
+    if (m_keys.empty()) {
+        throw utl::THROW_ERROR(("camera path has no key: " + path).c_str());
+    }
+}
+
+void ven::CameraPath::apply(Camera& camera, const float elapsed) const {
+    const float time = m_keys.front().time + elapsed;
+    if (m_keys.size() == 1 || time <= m_keys.front().time) {
+        camera.setPose(m_keys.front().position, m_keys.front().yaw, m_keys.front().pitch);
+        return;
+    }
+    if (time >= m_keys.back().time) {
+        camera.setPose(m_keys.back().position, m_keys.back().yaw, m_keys.back().pitch);
+        return;
+    }
+    const auto next = std::ranges::upper_bound(m_keys, time, {}, &Key::time);
+    const size_t i = static_cast<size_t>(next - m_keys.begin()) - 1;
+    const Key& k0 = m_keys[i == 0 ? 0 : i - 1];
+    const Key& k1 = m_keys[i];
+    const Key& k2 = m_keys[i + 1];
+    const Key& k3 = m_keys[std::min(i + 2, m_keys.size() - 1)];
+    const float u = (time - k1.time) / (k2.time - k1.time);
+    camera.setPose(catmullRom(k0.position, k1.position, k2.position, k3.position, u), catmullRom(k0.yaw, k1.yaw, k2.yaw, k3.yaw, u), catmullRom(k0.pitch, k1.pitch, k2.pitch, k3.pitch, u));
+}
@@ -0,0 +1,66 @@
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #define VEN_FRUSTUM_SSE
+    #include <xmmintrin.h>
+#endif
+
+#include "VEngine/Scene/Frustum.hpp"
+
+ven::Frustum::Frustum(const glm::mat4& viewProjection) {
+    // Gribb & Hartmann, rows of the matrix: -w <= x, y <= w and 0 <= z <= w
+    const glm::mat4 rows = glm::transpose(viewProjection);
+    m_planes = { rows[3] + rows[0], rows[3] - rows[0], rows[3] + rows[1], rows[3] - rows[1], rows[2], rows[3] - rows[2] };
+    // normalized so the plane distance can be compared with the sphere radius and box extents
+    for (glm::vec4& plane : m_planes) {
+        plane /= glm::length(glm::vec3(plane));
+    }
+}
+
+bool ven::Frustum::isVisible(const Bounds& bounds) const {
+    for (const glm::vec4& plane : m_planes) {
+        const glm::vec3 normal(plane);
+        const float distance = glm::dot(normal, bounds.center) + plane.w;
+        // both volumes contain the object, it is outside as soon as the tighter one is
+        const float reach = glm::min(glm::dot(glm::abs(normal), bounds.extent), bounds.radius);
+        if (distance + reach < 0.0F) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ven::Frustum::cull(const BoundsSoA& bounds, std::vector<uint8_t>& visible) const {
+    visible.resize(bounds.centerX.size());
+    cullRange(bounds, visible, 0, bounds.centerX.size());
+    visible.resize(bounds.count);
+}
+
+void ven::Frustum::cullRange(const BoundsSoA& bounds, const std::span<uint8_t> visible, const size_t first, const size_t last) const {
+#ifdef VEN_FRUSTUM_SSE
+    const __m128 zero = _mm_setzero_ps();
+    for (size_t i = first; i < last; i += BoundsSoA::LANES) {
+        const __m128 centerX = _mm_loadu_ps(&bounds.centerX[i]);
+        const __m128 centerY = _mm_loadu_ps(&bounds.centerY[i]);
+        const __m128 centerZ = _mm_loadu_ps(&bounds.centerZ[i]);
+        const __m128 extentX = _mm_loadu_ps(&bounds.extentX[i]);
+        const __m128 extentY = _mm_loadu_ps(&bounds.extentY[i]);
+        const __m128 extentZ = _mm_loadu_ps(&bounds.extentZ[i]);
+        const __m128 radius = _mm_loadu_ps(&bounds.radius[i]);
+        __m128 inside = _mm_cmpeq_ps(zero, zero);
+        for (const glm::vec4& plane : m_planes) {
+            const __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.x), centerX), _mm_mul_ps(_mm_set1_ps(plane.y), centerY)),
+                                               _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.z), centerZ), _mm_set1_ps(plane.w)));
+            const __m128 boxReach = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(glm::abs(plane.x)), extentX), _mm_mul_ps(_mm_set1_ps(glm::abs(plane.y)), extentY)),
+                                               _mm_mul_ps(_mm_set1_ps(glm::abs(plane.z)), extentZ));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, _mm_min_ps(boxReach, radius)), zero));
+        }
+        const int mask = _mm_movemask_ps(inside);
+        for (size_t lane = 0; lane < BoundsSoA::LANES; lane++) {
+            visible[i + lane] = static_cast<uint8_t>((mask >> lane) & 1);
+        }
+    }
+#else
+    for (size_t i = first; i < last; i++) {
+        visible[i] = isVisible(bounds.get(i)) ? 1 : 0;
+    }
+#endif
+}
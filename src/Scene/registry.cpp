@@ -0,0 +1,90 @@
+#include "VEngine/Scene/Registry.hpp"
+
+std::array<size_t, ven::Registry::MAX_COMPONENTS> ven::Registry::s_componentSizes{};
+uint32_t ven::Registry::s_componentCount = 0;
+
+uint32_t ven::Registry::registerComponent(const size_t size) {
+    if (s_componentCount == MAX_COMPONENTS) {
+        throw utl::THROW_ERROR("too many component types");
+    }
+    s_componentSizes.at(s_componentCount) = size;
+    return s_componentCount++;
+}
+
+ven::Entity ven::Registry::allocateEntity() {
+    if (!m_freeEntities.empty()) {
+        const Entity entity = m_freeEntities.back();
+        m_freeEntities.pop_back();
+        return entity;
+    }
+    m_locations.emplace_back();
+    return static_cast<Entity>(m_locations.size() - 1);
+}
+
+uint32_t ven::Registry::getArchetype(const ComponentMask mask) {
+    if (const auto it = m_archetypeIndices.find(mask); it != m_archetypeIndices.end()) {
+        return it->second;
+    }
+    auto archetype = std::make_unique<Archetype>();
+    archetype->mask = mask;
+    for (uint32_t id = 0; id < MAX_COMPONENTS; id++) {
+        if ((mask & (ComponentMask{1} << id)) != 0) {
+            archetype->columns.at(id).elementSize = s_componentSizes.at(id);
+        }
+    }
+    const auto index = static_cast<uint32_t>(m_archetypes.size());
+    m_archetypes.push_back(std::move(archetype));
+    m_archetypeIndices.emplace(mask, index);
+    return index;
+}
+
+uint32_t ven::Registry::pushRow(const uint32_t archetype, const Entity entity) {
+    Archetype& target = *m_archetypes[archetype];
+    const auto row = static_cast<uint32_t>(target.entities.size());
+    target.entities.push_back(entity);
+    for (Column& column : target.columns) {
+        column.data.resize(column.data.size() + column.elementSize);
+    }
+    return row;
+}
+
+void ven::Registry::removeRow(const uint32_t archetype, const uint32_t row) {
+    Archetype& source = *m_archetypes[archetype];
+    const auto last = static_cast<uint32_t>(source.entities.size() - 1);
+    if (row != last) {
+        for (Column& column : source.columns) {
+            if (column.elementSize != 0) {
+                std::memcpy(column.data.data() + (row * column.elementSize), column.data.data() + (last * column.elementSize), column.elementSize);
+            }
+        }
+        source.entities[row] = source.entities[last];
+        m_locations[source.entities[row]].row = row;
+    }
+    source.entities.pop_back();
+    for (Column& column : source.columns) {
+        column.data.resize(column.data.size() - column.elementSize);
+    }
+}
+
+void ven::Registry::moveEntity(const Entity entity, const ComponentMask mask) {
+    const Location location = m_locations[entity];
+    const uint32_t archetype = getArchetype(mask);
+    const uint32_t row = pushRow(archetype, entity);
+    // the components both archetypes have are carried over, the added one is left zeroed for the caller
+    const Archetype& source = *m_archetypes[location.archetype];
+    Archetype& target = *m_archetypes[archetype];
+    for (uint32_t id = 0; id < MAX_COMPONENTS; id++) {
+        const size_t size = target.columns.at(id).elementSize;
+        if (size != 0 && (source.mask & (ComponentMask{1} << id)) != 0) {
+            std::memcpy(target.columns.at(id).data.data() + (row * size), source.columns.at(id).data.data() + (location.row * size), size);
+        }
+    }
+    removeRow(location.archetype, location.row);
+    m_locations[entity] = { .archetype = archetype, .row = row };
+}
+
+void ven::Registry::destroy(const Entity entity) {
+    const Location location = m_locations.at(entity);
+    removeRow(location.archetype, location.row);
+    m_freeEntities.push_back(entity);
+}
@@ -0,0 +1,125 @@
+#include <algorithm>
+
+#include "Utils/ErrorHandling.hpp"
+#include "Utils/Profiler.hpp"
+#include "VEngine/Scene/TransformHierarchy.hpp"
+
+uint32_t ven::TransformHierarchy::create(const uint32_t parent, const glm::mat4& local) {
+    if (parent != NONE && parent >= m_slots.size()) {
+        throw utl::THROW_ERROR("invalid parent transform node");
+    }
+    const auto node = static_cast<uint32_t>(m_slots.size());
+    const uint32_t depth = parent == NONE ? 0 : m_depths[parent] + 1;
+    // appended unsorted, the next update moves it into its level
+    m_slots.push_back(static_cast<uint32_t>(m_locals.size()));
+    m_parentNodes.push_back(parent);
+    m_depths.push_back(depth);
+    m_parents.push_back(parent == NONE ? NONE : m_slots[parent]);
+    m_locals.push_back(local);
+    m_worlds.emplace_back(1.0F);
+    m_dirty.push_back(1);
+    if (m_levelDirty.size() <= depth) {
+        m_levelDirty.resize(depth + 1, 0);
+    }
+    m_levelDirty[depth] = 1;
+    m_firstDirtyLevel = std::min(m_firstDirtyLevel, depth);
+    m_sorted = false;
+    return node;
+}
+
+void ven::TransformHierarchy::setLocal(const uint32_t node, const glm::mat4& local) {
+    const uint32_t slot = m_slots[node];
+    m_locals[slot] = local;
+    m_dirty[slot] = 1;
+    m_levelDirty[m_depths[node]] = 1;
+    m_firstDirtyLevel = std::min(m_firstDirtyLevel, m_depths[node]);
+}
+
+void ven::TransformHierarchy::sort() {
+    PROFILE_FUNCTION();
+    // counting sort on the depth, stable so siblings stay in creation order
+    const auto levelCount = static_cast<uint32_t>(m_levelDirty.size());
+    m_levels.assign(levelCount + 1, 0);
+    for (const uint32_t depth : m_depths) {
+        m_levels[depth + 1]++;
+    }
+    for (uint32_t level = 0; level < levelCount; level++) {
+        m_levels[level + 1] += m_levels[level];
+    }
+    std::vector<uint32_t> next(m_levels.begin(), m_levels.end() - 1);
+    std::vector<uint32_t> slots(m_slots.size());
+    for (size_t node = 0; node < m_slots.size(); node++) {
+        slots[node] = next[m_depths[node]]++;
+    }
+    std::vector<uint32_t> parents(m_slots.size());
+    std::vector<glm::mat4> locals(m_slots.size());
+    std::vector<glm::mat4> worlds(m_slots.size());
+    std::vector<uint8_t> dirty(m_slots.size());
+    for (size_t node = 0; node < m_slots.size(); node++) {
+        const uint32_t slot = slots[node];
+        const uint32_t previous = m_slots[node];
+        // parents were created first, their new slot is known
+        parents[slot] = m_parentNodes[node] == NONE ? NONE : slots[m_parentNodes[node]];
+        locals[slot] = m_locals[previous];
+        worlds[slot] = m_worlds[previous];
+        dirty[slot] = m_dirty[previous];
+    }
+    m_slots = std::move(slots);
+    m_parents = std::move(parents);
+    m_locals = std::move(locals);
+    m_worlds = std::move(worlds);
+    m_dirty = std::move(dirty);
+    m_sorted = true;
+}
+
+void ven::TransformHierarchy::updateSlots(const uint32_t first, const uint32_t last) {
+    for (uint32_t slot = first; slot < last; slot++) {
+        const uint32_t parent = m_parents[slot];
+        if (parent == NONE) {
+            if (m_dirty[slot] != 0) {
+                m_worlds[slot] = m_locals[slot];
+            }
+        } else if (m_dirty[slot] != 0 || m_dirty[parent] != 0) {
+            m_worlds[slot] = m_worlds[parent] * m_locals[slot];
+            // the children, one level down, see it as changed
+            m_dirty[slot] = 1;
+        }
+    }
+}
+
+bool ven::TransformHierarchy::update(utl::ThreadPool& threadPool) {
+    if (m_firstDirtyLevel == NONE) {
+        return false;
+    }
+    PROFILE_FUNCTION();
+    if (!m_sorted) {
+        sort();
+    }
+    const auto levelCount = static_cast<uint32_t>(m_levelDirty.size());
+    bool parentLevelUpdated = false;
+    for (uint32_t level = m_firstDirtyLevel; level < levelCount; level++) {
+        // a level is untouched when none of its nodes was set and nothing changed above it
+        if (m_levelDirty[level] == 0 && !parentLevelUpdated) {
+            continue;
+        }
+        const uint32_t first = m_levels[level];
+        const uint32_t count = m_levels[level + 1] - first;
+        // every parent is in the previous level, already done: the nodes of a level are independent
+        if (count >= PARALLEL_LEVEL_SIZE && threadPool.getThreadCount() > 1) {
+            const uint32_t chunkCount = threadPool.getThreadCount();
+            const uint32_t chunkSize = (count + chunkCount - 1) / chunkCount;
+            threadPool.parallelFor(chunkCount, [&](const uint32_t chunk) {
+                const uint32_t begin = first + std::min(count, chunk * chunkSize);
+                const uint32_t end = first + std::min(count, (chunk + 1) * chunkSize);
+                updateSlots(begin, end);
+            });
+        } else {
+            updateSlots(first, first + count);
+        }
+        parentLevelUpdated = true;
+    }
+    std::fill(m_dirty.begin() + m_levels[m_firstDirtyLevel], m_dirty.end(), 0);
+    std::fill(m_levelDirty.begin(), m_levelDirty.end(), 0);
+    m_firstDirtyLevel = NONE;
+    return true;
+}
@@ -1,8 +1,16 @@
+#include "Utils/Profiler.hpp"
+#include "VEngine/Core/BvhBenchmark.hpp"
 #include "VEngine/Core/Engine.hpp"
 
-int main() {
+int main(const int argc, char* argv[]) {
+    PROFILE_THREAD_NAME("Main");
     try {
-        ven::Engine().run();
+        const ven::Config config = ven::Config::parse(argc, argv);
+        if (config.bvhBenchmark) {
+            ven::BvhBenchmark(config.reportPath).run();
+            return EXIT_SUCCESS;
+        }
+        ven::Engine(config).run();
     } catch (const std::exception& e) {
         utl::printError(e.what());
         return EXIT_FAILURE;
@@ -0,0 +1,232 @@
+#include <algorithm>
+#include <numeric>
+#include <optional>
+#include <random>
+
+#include <gtest/gtest.h>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "VEngine/Scene/Bvh.hpp"
+
+namespace {
+
+    constexpr uint32_t SMALL_COUNT = 1000;
+    constexpr uint32_t LARGE_COUNT = ven::Bvh::PARALLEL_BUILD_SIZE * 3;
+    constexpr float SCENE_SIZE = 200.0F;
+
+    std::vector<ven::Bounds> randomBounds(const uint32_t count, const uint32_t seed) {
+        std::mt19937 random(seed);
+        std::uniform_real_distribution position(-SCENE_SIZE * 0.5F, SCENE_SIZE * 0.5F);
+        std::uniform_real_distribution size(0.1F, 3.0F);
+        std::vector<ven::Bounds> bounds(count);
+        for (ven::Bounds& object : bounds) {
+            object.center = glm::vec3(position(random), position(random), position(random));
+            object.extent = glm::vec3(size(random), size(random), size(random));
+            object.radius = glm::length(object.extent);
+        }
+        return bounds;
+    }
+
+    void move(std::vector<ven::Bounds>& bounds, const uint32_t seed) {
+        std::mt19937 random(seed);
+        std::uniform_real_distribution offset(-10.0F, 10.0F);
+        for (ven::Bounds& object : bounds) {
+            object.center += glm::vec3(offset(random), offset(random), offset(random));
+        }
+    }
+
+    std::vector<glm::mat4> randomCameras(const uint32_t count, const uint32_t seed) {
+        std::mt19937 random(seed);
+        std::uniform_real_distribution position(-SCENE_SIZE * 0.5F, SCENE_SIZE * 0.5F);
+        std::vector<glm::mat4> cameras;
+        for (uint32_t i = 0; i < count; i++) {
+            const glm::vec3 eye(position(random), position(random), position(random));
+            const glm::vec3 target(position(random), position(random), position(random));
+            cameras.push_back(glm::perspective(glm::radians(60.0F), 1.5F, 0.1F, SCENE_SIZE * 0.5F) * glm::lookAt(eye, target, glm::vec3(0.0F, 1.0F, 0.0F)));
+        }
+        return cameras;
+    }
+
+    std::vector<uint32_t> sorted(std::vector<uint32_t> primitives) {
+        std::ranges::sort(primitives);
+        return primitives;
+    }
+
+    std::vector<uint32_t> bruteFrustum(const std::vector<ven::Bounds>& bounds, const ven::Frustum& frustum) {
+        std::vector<uint32_t> result;
+        for (uint32_t i = 0; i < bounds.size(); i++) {
+            const bool outside = std::ranges::any_of(frustum.getPlanes(), [&](const glm::vec4& plane) {
+                const glm::vec3 normal(plane);
+                return glm::dot(normal, bounds[i].center) + plane.w + glm::dot(glm::abs(normal), bounds[i].extent) < 0.0F;
+            });
+            if (!outside) {
+                result.push_back(i);
+            }
+        }
+        return result;
+    }
+
+    std::vector<uint32_t> bruteRadius(const std::vector<ven::Bounds>& bounds, const glm::vec3& center, const float radius) {
+        std::vector<uint32_t> result;
+        for (uint32_t i = 0; i < bounds.size(); i++) {
+            const glm::vec3 offset = glm::clamp(center, bounds[i].center - bounds[i].extent, bounds[i].center + bounds[i].extent) - center;
+            if (glm::dot(offset, offset) <= radius * radius) {
+                result.push_back(i);
+            }
+        }
+        return result;
+    }
+
+    /// @return Entry distance in the box, negative when the ray misses it
+    float bruteEntry(const ven::Bounds& bounds, const glm::vec3& origin, const glm::vec3& direction) {
+        float entry = 0.0F;
+        float exit = std::numeric_limits<float>::max();
+        for (int axis = 0; axis < 3; axis++) {
+            const float near = (bounds.center[axis] - bounds.extent[axis] - origin[axis]) / direction[axis];
+            const float far = (bounds.center[axis] + bounds.extent[axis] - origin[axis]) / direction[axis];
+            entry = std::max(entry, std::min(near, far));
+            exit = std::min(exit, std::max(near, far));
+        }
+        return entry <= exit ? entry : -1.0F;
+    }
+
+    std::optional<float> bruteRaycast(const std::vector<ven::Bounds>& bounds, const glm::vec3& origin, const glm::vec3& direction) {
+        std::optional<float> nearest;
+        for (const ven::Bounds& object : bounds) {
+            if (const float distance = bruteEntry(object, origin, direction); distance >= 0.0F && (!nearest || distance < *nearest)) {
+                nearest = distance;
+            }
+        }
+        return nearest;
+    }
+
+    /// Every query of the tree against the brute force one over the same bounds
+    void expectMatchesBruteForce(const ven::Bvh& bvh, const std::vector<ven::Bounds>& bounds, const uint32_t seed) {
+        for (const glm::mat4& camera : randomCameras(8, seed)) {
+            const ven::Frustum frustum(camera);
+            std::vector<uint32_t> result;
+            bvh.queryFrustum(frustum, result);
+            EXPECT_EQ(sorted(result), bruteFrustum(bounds, frustum));
+        }
+        std::mt19937 random(seed);
+        std::uniform_real_distribution position(-SCENE_SIZE * 0.5F, SCENE_SIZE * 0.5F);
+        std::uniform_real_distribution radius(0.0F, 30.0F);
+        std::uniform_real_distribution axis(-1.0F, 1.0F);
+        for (uint32_t i = 0; i < 32; i++) {
+            const glm::vec3 center(position(random), position(random), position(random));
+            const float sphereRadius = radius(random);
+            std::vector<uint32_t> result;
+            bvh.queryRadius(center, sphereRadius, result);
+            EXPECT_EQ(sorted(result), bruteRadius(bounds, center, sphereRadius));
+        }
+        for (uint32_t i = 0; i < 64; i++) {
+            const glm::vec3 origin(position(random), position(random), position(random));
+            const glm::vec3 direction = glm::normalize(glm::vec3(axis(random), axis(random), axis(random)));
+            const std::optional<ven::RayHit> hit = bvh.raycast(origin, direction);
+            const std::optional<float> expected = bruteRaycast(bounds, origin, direction);
+            ASSERT_EQ(hit.has_value(), expected.has_value());
+            if (hit) {
+                // several boxes may be entered at the same distance, the hit one has to be one of them
+                EXPECT_FLOAT_EQ(hit->distance, *expected);
+                EXPECT_FLOAT_EQ(bruteEntry(bounds[hit->primitive], origin, direction), *expected);
+            }
+        }
+    }
+
+    /// Children after their parent, boxes enclosing their content and every primitive in exactly one leaf
+    void expectValidTree(const ven::Bvh& bvh, const std::vector<ven::Bounds>& bounds) {
+        const std::vector<ven::BvhNode>& nodes = bvh.getNodes();
+        const auto contains = [](const ven::BvhNode& node, const glm::vec3& min, const glm::vec3& max) {
+            return node.min.x <= min.x && node.min.y <= min.y && node.min.z <= min.z && node.max.x >= max.x && node.max.y >= max.y && node.max.z >= max.z;
+        };
+        for (uint32_t i = 0; i < nodes.size(); i++) {
+            if (!nodes[i].isLeaf()) {
+                ASSERT_GT(nodes[i].leftFirst, i);
+                ASSERT_LT(nodes[i].leftFirst + 1, nodes.size());
+                EXPECT_TRUE(contains(nodes[i], nodes[nodes[i].leftFirst].min, nodes[nodes[i].leftFirst].max));
+                EXPECT_TRUE(contains(nodes[i], nodes[nodes[i].leftFirst + 1].min, nodes[nodes[i].leftFirst + 1].max));
+            }
+        }
+        std::vector<uint32_t> all;
+        bvh.queryRadius(glm::vec3(0.0F), SCENE_SIZE * 10.0F, all);
+        std::vector<uint32_t> expected(bounds.size());
+        std::iota(expected.begin(), expected.end(), 0U);
+        EXPECT_EQ(sorted(all), expected);
+    }
+
+} // namespace
+
+TEST(BVH, empty){
+    ven::Bvh bvh;
+    bvh.build({});
+    std::vector<uint32_t> result;
+    bvh.queryRadius(glm::vec3(0.0F), 1.0F, result);
+    bvh.queryFrustum(ven::Frustum(randomCameras(1, 1).front()), result);
+    EXPECT_TRUE(result.empty());
+    EXPECT_FALSE(bvh.raycast(glm::vec3(0.0F), glm::vec3(0.0F, 0.0F, 1.0F)).has_value());
+}
+
+TEST(BVH, build){
+    const std::vector<ven::Bounds> bounds = randomBounds(SMALL_COUNT, 1);
+    ven::Bvh bvh;
+    bvh.build(bounds);
+    EXPECT_EQ(bvh.getPrimitiveCount(), SMALL_COUNT);
+    expectValidTree(bvh, bounds);
+    expectMatchesBruteForce(bvh, bounds, 2);
+    EXPECT_FALSE(bvh.shouldRebuild());
+}
+
+TEST(BVH, refit){
+    std::vector<ven::Bounds> bounds = randomBounds(SMALL_COUNT, 3);
+    ven::Bvh bvh;
+    bvh.build(bounds);
+    move(bounds, 4);
+    bvh.refit(bounds);
+    expectValidTree(bvh, bounds);
+    expectMatchesBruteForce(bvh, bounds, 5);
+}
+
+TEST(BVH, refitDegrades){
+    std::vector<ven::Bounds> bounds = randomBounds(SMALL_COUNT, 6);
+    ven::Bvh bvh;
+    bvh.build(bounds);
+    // every object thrown somewhere else, the leaves now span the whole scene
+    bounds = randomBounds(SMALL_COUNT, 7);
+    bvh.refit(bounds);
+    EXPECT_TRUE(bvh.shouldRebuild());
+    expectMatchesBruteForce(bvh, bounds, 8);
+}
+
+TEST(BVH, sameCentroid){
+    std::vector<ven::Bounds> bounds(64, ven::Bounds{ .center = glm::vec3(1.0F), .extent = glm::vec3(0.5F), .radius = 1.0F });
+    ven::Bvh bvh;
+    bvh.build(bounds);
+    expectValidTree(bvh, bounds);
+    std::vector<uint32_t> result;
+    bvh.queryRadius(glm::vec3(1.0F), 0.1F, result);
+    EXPECT_EQ(result.size(), bounds.size());
+}
+
+TEST(BVH, parallelBuild){
+    const std::vector<ven::Bounds> bounds = randomBounds(LARGE_COUNT, 9);
+    utl::ThreadPool threadPool(4);
+    ven::Bvh bvh;
+    bvh.build(bounds, &threadPool);
+    expectValidTree(bvh, bounds);
+    expectMatchesBruteForce(bvh, bounds, 10);
+    // the spliced subtrees are split like the ones built on one thread
+    ven::Bvh serial;
+    serial.build(bounds);
+    EXPECT_EQ(bvh.getNodes().size(), serial.getNodes().size());
+}
+
+TEST(BVH, parallelRefit){
+    std::vector<ven::Bounds> bounds = randomBounds(LARGE_COUNT, 11);
+    utl::ThreadPool threadPool(4);
+    ven::Bvh bvh;
+    bvh.build(bounds, &threadPool);
+    move(bounds, 12);
+    bvh.refit(bounds);
+    expectValidTree(bvh, bounds);
+    expectMatchesBruteForce(bvh, bounds, 13);
+}
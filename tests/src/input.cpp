@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+
+#include "VEngine/Core/Input.hpp"
+
+namespace {
+
+    ven::InputEvent key(const double time, const int code, const int action) { return { .time = time, .code = code, .type = ven::InputEventType::KEY, .action = static_cast<uint8_t>(action) }; }
+
+} // namespace
+
+TEST(INPUT_QUEUE, order){
+    ven::InputQueue queue;
+    queue.push(key(1.0, GLFW_KEY_W, GLFW_PRESS));
+    queue.push(key(2.0, GLFW_KEY_W, GLFW_RELEASE));
+    ven::InputEvent event;
+    ASSERT_TRUE(queue.pop(event));
+    EXPECT_EQ(event.time, 1.0);
+    ASSERT_TRUE(queue.pop(event));
+    EXPECT_EQ(event.time, 2.0);
+    EXPECT_FALSE(queue.pop(event));
+}
+
+TEST(INPUT_QUEUE, full){
+    ven::InputQueue queue;
+    for (uint32_t i = 0; i < ven::InputQueue::CAPACITY + 3; i++) {
+        queue.push(key(static_cast<double>(i), GLFW_KEY_W, GLFW_PRESS));
+    }
+    EXPECT_EQ(queue.getSize(), ven::InputQueue::CAPACITY);
+    EXPECT_EQ(queue.getDroppedCount(), 3U);
+    EXPECT_EQ(queue.peek(0).time, 0.0);
+}
+
+TEST(INPUT_STATE, pressedMidInterval){
+    ven::InputState state;
+    ven::InputQueue queue;
+    state.update(queue, 1.0);
+    queue.push(key(1.25, GLFW_KEY_W, GLFW_PRESS));
+    state.update(queue, 1.5);
+    EXPECT_TRUE(state.isKeyDown(GLFW_KEY_W));
+    EXPECT_TRUE(state.isKeyJustPressed(GLFW_KEY_W));
+    EXPECT_FLOAT_EQ(state.getKeyHeldFraction(GLFW_KEY_W), 0.5F);
+    // held through the whole next interval
+    state.update(queue, 2.0);
+    EXPECT_FALSE(state.isKeyJustPressed(GLFW_KEY_W));
+    EXPECT_FLOAT_EQ(state.getKeyHeldFraction(GLFW_KEY_W), 1.0F);
+}
+
+TEST(INPUT_STATE, releasedMidInterval){
+    ven::InputState state;
+    ven::InputQueue queue;
+    state.update(queue, 1.0);
+    queue.push(key(1.0, GLFW_KEY_W, GLFW_PRESS));
+    state.update(queue, 2.0);
+    queue.push(key(2.25, GLFW_KEY_W, GLFW_RELEASE));
+    state.update(queue, 3.0);
+    EXPECT_FALSE(state.isKeyDown(GLFW_KEY_W));
+    EXPECT_FLOAT_EQ(state.getKeyHeldFraction(GLFW_KEY_W), 0.25F);
+}
+
+TEST(INPUT_STATE, tapInOnePoll){
+    ven::InputState state;
+    ven::InputQueue queue;
+    state.update(queue, 1.0);
+    queue.push(key(1.5, GLFW_KEY_W, GLFW_PRESS));
+    queue.push(key(1.5, GLFW_KEY_W, GLFW_RELEASE));
+    state.update(queue, 2.0);
+    EXPECT_FALSE(state.isKeyDown(GLFW_KEY_W));
+    EXPECT_TRUE(state.isKeyJustPressed(GLFW_KEY_W));
+    EXPECT_FLOAT_EQ(state.getKeyHeldFraction(GLFW_KEY_W), static_cast<float>(ven::InputState::MIN_TAP_TIME));
+}
+
+TEST(INPUT_STATE, laterEventsStayQueued){
+    ven::InputState state;
+    ven::InputQueue queue;
+    state.update(queue, 1.0);
+    queue.push(key(1.5, GLFW_KEY_W, GLFW_PRESS));
+    queue.push(key(2.5, GLFW_KEY_W, GLFW_RELEASE));
+    state.update(queue, 2.0);
+    EXPECT_EQ(queue.getSize(), 1U);
+    EXPECT_TRUE(state.isKeyDown(GLFW_KEY_W));
+    state.update(queue, 3.0);
+    EXPECT_EQ(queue.getSize(), 0U);
+    EXPECT_FLOAT_EQ(state.getKeyHeldFraction(GLFW_KEY_W), 0.5F);
+}
+
+TEST(INPUT_STATE, stampBeforeIntervalIsClamped){
+    ven::InputState state;
+    ven::InputQueue queue;
+    state.update(queue, 2.0);
+    queue.push(key(1.0, GLFW_KEY_W, GLFW_PRESS));
+    state.update(queue, 3.0);
+    EXPECT_FLOAT_EQ(state.getKeyHeldFraction(GLFW_KEY_W), 1.0F);
+}
@@ -0,0 +1,148 @@
+#include <fstream>
+#include <iterator>
+
+#include <gtest/gtest.h>
+
+#include "VEngine/Core/InputRecording.hpp"
+
+namespace {
+
+    constexpr size_t FRAME_COUNT_OFFSET = 8; ///< after the magic and the version
+    constexpr size_t EVENT_COUNT_OFFSET = 12;
+    constexpr size_t FIRST_FRAME_EVENT_COUNT_OFFSET = 44 + sizeof(float) + sizeof(double); ///< header, dt and time of the first frame
+
+    ven::InputEvent event(const double time, const ven::InputEventType type, const int code, const float x = 0.0F, const float y = 0.0F) {
+        return { .time = time, .x = x, .y = y, .code = code, .type = type, .action = GLFW_PRESS };
+    }
+
+    std::string path(const std::string& name) { return testing::TempDir() + name; }
+
+    std::vector<char> readFile(const std::string& file) {
+        std::ifstream in(file, std::ios::binary);
+        return { std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+    }
+
+    void writeFile(const std::string& file, const std::vector<char>& bytes) {
+        std::ofstream out(file, std::ios::binary);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    /// Little endian, as the recording is
+    void patch(std::vector<char>& bytes, const size_t offset, const uint32_t value) {
+        for (size_t i = 0; i < sizeof(value); i++) {
+            bytes.at(offset + i) = static_cast<char>((value >> (8 * i)) & 0xFFU);
+        }
+    }
+
+    /// Two frames: a key, a scroll and a mouse button, then a scroll the Gui kept and a key
+    void record(ven::InputRecording& recording, ven::Camera& camera) {
+        camera.setPose(glm::vec3(1.0F, 2.0F, 3.0F), 30.0F, -10.0F);
+        camera.getMoveSpeed() = 4.0F;
+        camera.getLookSpeed() = 50.0F;
+        recording.begin(camera);
+        ven::InputQueue first;
+        first.push(event(0.1, ven::InputEventType::KEY, GLFW_KEY_W));
+        first.push(event(0.2, ven::InputEventType::SCROLL, 0, 0.0F, -1.5F));
+        first.push(event(0.3, ven::InputEventType::MOUSE_BUTTON, GLFW_MOUSE_BUTTON_LEFT, 12.5F, 40.0F));
+        // after the end of the frame, left for the next one
+        first.push(event(0.6, ven::InputEventType::KEY, GLFW_KEY_S));
+        recording.addFrame(0.016F, 0.5, first, true);
+        ven::InputQueue second;
+        second.push(event(0.6, ven::InputEventType::KEY, GLFW_KEY_S));
+        second.push(event(0.7, ven::InputEventType::SCROLL, 0, 0.0F, 2.0F));
+        recording.addFrame(0.017F, 1.0, second, false);
+    }
+
+} // namespace
+
+TEST(INPUT_RECORDING, addFrame){
+    ven::InputRecording recording;
+    ven::Camera camera;
+    record(recording, camera);
+    ASSERT_EQ(recording.getFrameCount(), 2U);
+    EXPECT_EQ(recording.getFrame(0).eventCount, 3U);
+    // the scroll of the second frame went to the Gui
+    EXPECT_EQ(recording.getFrame(1).firstEvent, 3U);
+    EXPECT_EQ(recording.getFrame(1).eventCount, 1U);
+}
+
+TEST(INPUT_RECORDING, roundTrip){
+    ven::InputRecording recording;
+    ven::Camera camera;
+    record(recording, camera);
+    const std::string file = path("roundTrip.venr");
+    recording.save(file);
+    ven::InputRecording loaded;
+    loaded.load(file);
+    ASSERT_EQ(loaded.getFrameCount(), recording.getFrameCount());
+    for (size_t frame = 0; frame < recording.getFrameCount(); frame++) {
+        EXPECT_EQ(loaded.getFrame(frame).dt, recording.getFrame(frame).dt);
+        EXPECT_EQ(loaded.getFrame(frame).time, recording.getFrame(frame).time);
+        EXPECT_EQ(loaded.getFrame(frame).firstEvent, recording.getFrame(frame).firstEvent);
+        EXPECT_EQ(loaded.getFrame(frame).eventCount, recording.getFrame(frame).eventCount);
+        ven::InputQueue expected;
+        ven::InputQueue replayed;
+        recording.replayEvents(frame, expected);
+        loaded.replayEvents(frame, replayed);
+        ASSERT_EQ(replayed.getSize(), expected.getSize());
+        for (uint32_t i = 0; i < expected.getSize(); i++) {
+            EXPECT_EQ(replayed.peek(i).time, expected.peek(i).time);
+            EXPECT_EQ(replayed.peek(i).x, expected.peek(i).x);
+            EXPECT_EQ(replayed.peek(i).y, expected.peek(i).y);
+            EXPECT_EQ(replayed.peek(i).code, expected.peek(i).code);
+            EXPECT_EQ(replayed.peek(i).type, expected.peek(i).type);
+            EXPECT_EQ(replayed.peek(i).action, expected.peek(i).action);
+        }
+    }
+    ven::Camera restored;
+    loaded.restoreCamera(restored);
+    EXPECT_EQ(restored.getPose(), camera.getPose());
+    EXPECT_EQ(restored.getMoveSpeed(), 4.0F);
+    EXPECT_EQ(restored.getLookSpeed(), 50.0F);
+}
+
+TEST(INPUT_RECORDING, truncated){
+    ven::InputRecording recording;
+    ven::Camera camera;
+    record(recording, camera);
+    const std::string file = path("truncated.venr");
+    recording.save(file);
+    const std::vector<char> bytes = readFile(file);
+    // in the events, in the frames and in the header
+    for (const size_t size : {bytes.size() - 1, FIRST_FRAME_EVENT_COUNT_OFFSET, size_t{10}}) {
+        writeFile(file, std::vector(bytes.begin(), bytes.begin() + static_cast<std::ptrdiff_t>(size)));
+        ven::InputRecording loaded;
+        EXPECT_THROW(loaded.load(file), std::runtime_error) << size;
+    }
+}
+
+TEST(INPUT_RECORDING, badCounts){
+    ven::InputRecording recording;
+    ven::Camera camera;
+    record(recording, camera);
+    const std::string file = path("badCounts.venr");
+    recording.save(file);
+    const std::vector<char> bytes = readFile(file);
+    // counts that do not match the size, one of them large enough to exhaust the memory if it were trusted
+    for (const auto& [offset, value] : {std::pair{FRAME_COUNT_OFFSET, 0x7FFFFFFFU}, std::pair{FRAME_COUNT_OFFSET, 3U}, std::pair{EVENT_COUNT_OFFSET, 5U}}) {
+        std::vector<char> corrupted = bytes;
+        patch(corrupted, offset, value);
+        writeFile(file, corrupted);
+        ven::InputRecording loaded;
+        EXPECT_THROW(loaded.load(file), std::runtime_error) << offset << " " << value;
+    }
+    // the size is right but the frames claim more events than there are
+    std::vector<char> corrupted = bytes;
+    patch(corrupted, FIRST_FRAME_EVENT_COUNT_OFFSET, 4);
+    writeFile(file, corrupted);
+    ven::InputRecording loaded;
+    EXPECT_THROW(loaded.load(file), std::runtime_error);
+}
+
+TEST(INPUT_RECORDING, notARecording){
+    ven::InputRecording loaded;
+    EXPECT_THROW(loaded.load(path("missing.venr")), std::runtime_error);
+    const std::string file = path("notARecording.venr");
+    writeFile(file, std::vector<char>(64, 'x'));
+    EXPECT_THROW(loaded.load(file), std::runtime_error);
+}
@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+
+#include "VEngine/Scene/Registry.hpp"
+
+namespace {
+
+    struct Position {
+        float x = 0.0F;
+        float y = 0.0F;
+    };
+
+    struct Velocity {
+        float x = 0.0F;
+        float y = 0.0F;
+    };
+
+    struct Tag {
+        uint32_t value = 0;
+    };
+
+    /// Entities matching Position in the query order, entity i of the result is row first + i of its chunk
+    std::vector<ven::Entity> queryOrder(ven::Registry& registry) {
+        std::vector<ven::Entity> entities(registry.count<Position>(), ven::Registry::INVALID_ENTITY);
+        registry.forEachChunk<const Position>([&](const uint32_t first, const std::span<const ven::Entity> chunk, std::span<const Position>) {
+            std::ranges::copy(chunk, entities.begin() + first);
+        });
+        return entities;
+    }
+
+    /// Every entity is found at the row it occupies in its archetype
+    void expectLocations(ven::Registry& registry) {
+        registry.forEachChunk<const Position>([&](uint32_t, const std::span<const ven::Entity> chunk, const std::span<const Position> positions) {
+            for (size_t row = 0; row < chunk.size(); row++) {
+                EXPECT_EQ(&registry.get<Position>(chunk[row]), &positions[row]);
+            }
+        });
+    }
+
+} // namespace
+
+TEST(REGISTRY, addRemove){
+    ven::Registry registry;
+    const ven::Entity entity = registry.create(Position{ .x = 1.0F, .y = 2.0F });
+    registry.add(entity, Velocity{ .x = 3.0F, .y = 4.0F });
+    ASSERT_TRUE(registry.has<Velocity>(entity));
+    EXPECT_EQ(registry.get<Position>(entity).y, 2.0F);
+    EXPECT_EQ(registry.get<Velocity>(entity).x, 3.0F);
+    EXPECT_EQ((registry.count<Position, Velocity>()), 1U);
+    // already there: overwritten in place
+    registry.add(entity, Velocity{ .x = 5.0F, .y = 6.0F });
+    EXPECT_EQ(registry.get<Velocity>(entity).x, 5.0F);
+    registry.remove<Position>(entity);
+    EXPECT_FALSE(registry.has<Position>(entity));
+    EXPECT_EQ(registry.get<Velocity>(entity).y, 6.0F);
+    EXPECT_EQ(registry.count<Position>(), 0U);
+    EXPECT_EQ(registry.count<Velocity>(), 1U);
+    EXPECT_THROW(static_cast<void>(registry.get<Position>(entity)), std::runtime_error);
+    // removing a missing component changes nothing
+    registry.remove<Position>(entity);
+    EXPECT_EQ(registry.get<Velocity>(entity).x, 5.0F);
+}
+
+TEST(REGISTRY, moveFillsHole){
+    ven::Registry registry;
+    std::vector<ven::Entity> entities;
+    for (uint32_t i = 0; i < 4; i++) {
+        entities.push_back(registry.create(Position{ .x = static_cast<float>(i) }, Tag{ .value = i }));
+    }
+    // the first row leaves for another archetype, the last one takes its place
+    registry.add(entities[0], Velocity{ .x = 10.0F });
+    for (uint32_t i = 0; i < 4; i++) {
+        EXPECT_EQ(registry.get<Position>(entities[i]).x, static_cast<float>(i));
+        EXPECT_EQ(registry.get<Tag>(entities[i]).value, i);
+    }
+    EXPECT_EQ(queryOrder(registry), (std::vector{entities[3], entities[1], entities[2], entities[0]}));
+    expectLocations(registry);
+}
+
+TEST(REGISTRY, destroySwapsLastRow){
+    ven::Registry registry;
+    std::vector<ven::Entity> entities;
+    for (uint32_t i = 0; i < 4; i++) {
+        entities.push_back(registry.create(Position{ .x = static_cast<float>(i) }));
+    }
+    registry.destroy(entities[1]);
+    EXPECT_EQ(registry.getEntityCount(), 3U);
+    EXPECT_EQ(queryOrder(registry), (std::vector{entities[0], entities[3], entities[2]}));
+    // the moved entity is found at its new row
+    EXPECT_EQ(registry.get<Position>(entities[3]).x, 3.0F);
+    EXPECT_EQ(registry.get<Position>(entities[2]).x, 2.0F);
+    expectLocations(registry);
+    // destroying the last row moves nothing
+    registry.destroy(entities[2]);
+    EXPECT_EQ(registry.get<Position>(entities[3]).x, 3.0F);
+    EXPECT_EQ(queryOrder(registry), (std::vector{entities[0], entities[3]}));
+    // ids are reused and the new entity starts with its own components
+    const ven::Entity reused = registry.create(Position{ .x = 7.0F });
+    EXPECT_EQ(reused, entities[2]);
+    EXPECT_EQ(registry.get<Position>(reused).x, 7.0F);
+    EXPECT_EQ(registry.get<Position>(entities[3]).x, 3.0F);
+    expectLocations(registry);
+}
+
+TEST(REGISTRY, parallelForEachFirst){
+    ven::Registry registry;
+    // three archetypes holding Position, each larger than a range so they are split
+    constexpr uint32_t ARCHETYPE_SIZE = (ven::Registry::MIN_PARALLEL_ROWS * 5) / 2;
+    for (uint32_t i = 0; i < ARCHETYPE_SIZE * 3; i++) {
+        const ven::Entity entity = registry.create(Position{ .x = static_cast<float>(i) });
+        if (i % 3 == 1) {
+            registry.add(entity, Velocity{});
+        } else if (i % 3 == 2) {
+            registry.add(entity, Tag{ .value = i });
+        }
+    }
+    registry.create(Velocity{});
+    const std::vector<ven::Entity> expected = queryOrder(registry);
+    ASSERT_EQ(expected.size(), ARCHETYPE_SIZE * 3);
+    utl::ThreadPool threadPool(4);
+    std::vector<ven::Entity> seen(expected.size(), ven::Registry::INVALID_ENTITY);
+    std::vector<float> values(expected.size(), -1.0F);
+    registry.parallelForEach<const Position>(threadPool, [&](const uint32_t first, const std::span<const ven::Entity> entities, const std::span<const Position> positions) {
+        for (size_t i = 0; i < entities.size(); i++) {
+            seen[first + i] = entities[i];
+            values[first + i] = positions[i].x;
+        }
+    });
+    EXPECT_EQ(seen, expected);
+    for (size_t i = 0; i < expected.size(); i++) {
+        EXPECT_EQ(values[i], registry.get<Position>(expected[i]).x);
+    }
+}
+
+TEST(REGISTRY, parallelForEachSmallQuery){
+    ven::Registry registry;
+    for (uint32_t i = 0; i < 10; i++) {
+        registry.create(Position{ .x = static_cast<float>(i) });
+    }
+    utl::ThreadPool threadPool(4);
+    uint32_t calls = 0;
+    registry.parallelForEach<Position>(threadPool, [&](const uint32_t first, const std::span<const ven::Entity> entities, const std::span<Position> positions) {
+        calls++;
+        EXPECT_EQ(first, 0U);
+        EXPECT_EQ(entities.size(), 10U);
+        for (Position& position : positions) {
+            position.y = 1.0F;
+        }
+    });
+    EXPECT_EQ(calls, 1U);
+    registry.forEach<const Position>([](const Position& position) { EXPECT_EQ(position.y, 1.0F); });
+}
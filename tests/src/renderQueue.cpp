@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <array>
+#include <limits>
+
+#include <gtest/gtest.h>
+
+#include "VEngine/Gfx/RenderQueue.hpp"
+
+namespace {
+
+    constexpr std::array DEPTHS{0.0F, 0.001F, 0.5F, 1.0F, 1.01F, 3.0F, 250.0F, 1e6F};
+    constexpr uint32_t MAX_MATERIAL = std::numeric_limits<uint32_t>::max();
+
+    uint64_t key(const ven::RenderBucket bucket, const uint32_t material, const float depth) {
+        return ven::RenderQueue::makeKey(bucket, ven::RenderQueue::getPipeline(bucket, ven::AlphaMode::SOLID), material, depth);
+    }
+
+} // namespace
+
+TEST(RENDER_QUEUE, opaqueFrontToBack){
+    for (const ven::RenderBucket bucket : {ven::RenderBucket::DEPTH_PREPASS, ven::RenderBucket::SOLID, ven::RenderBucket::MASKED}) {
+        for (size_t i = 1; i < DEPTHS.size(); i++) {
+            EXPECT_LT(key(bucket, 0, DEPTHS[i - 1]), key(bucket, 0, DEPTHS[i])) << DEPTHS[i];
+        }
+    }
+}
+
+TEST(RENDER_QUEUE, blendedBackToFront){
+    for (size_t i = 1; i < DEPTHS.size(); i++) {
+        EXPECT_GT(key(ven::RenderBucket::BLENDED, 0, DEPTHS[i - 1]), key(ven::RenderBucket::BLENDED, 0, DEPTHS[i])) << DEPTHS[i];
+    }
+}
+
+TEST(RENDER_QUEUE, negativeDepthIsNearest){
+    EXPECT_EQ(key(ven::RenderBucket::SOLID, 0, -1.0F), key(ven::RenderBucket::SOLID, 0, 0.0F));
+    EXPECT_EQ(key(ven::RenderBucket::BLENDED, 0, -1.0F), key(ven::RenderBucket::BLENDED, 0, 0.0F));
+}
+
+TEST(RENDER_QUEUE, bucketsInEnumOrder){
+    using ven::RenderBucket;
+    constexpr std::array BUCKETS{RenderBucket::DEPTH_PREPASS, RenderBucket::SOLID, RenderBucket::MASKED, RenderBucket::BLENDED};
+    for (size_t i = 1; i < BUCKETS.size(); i++) {
+        // the largest key of a bucket, whatever its pipeline, stays below the smallest of the next one
+        const uint64_t last = std::max({ven::RenderQueue::makeKey(BUCKETS[i - 1], ven::PipelineType::BLENDED, MAX_MATERIAL, 0.0F),
+                                        ven::RenderQueue::makeKey(BUCKETS[i - 1], ven::PipelineType::BLENDED, MAX_MATERIAL, std::numeric_limits<float>::max())});
+        const uint64_t first = std::min({ven::RenderQueue::makeKey(BUCKETS[i], ven::PipelineType::DEPTH, 0, 0.0F),
+                                         ven::RenderQueue::makeKey(BUCKETS[i], ven::PipelineType::DEPTH, 0, std::numeric_limits<float>::max())});
+        EXPECT_LT(last, first) << i;
+    }
+}
+
+TEST(RENDER_QUEUE, materialBelowDepth){
+    for (const ven::RenderBucket bucket : {ven::RenderBucket::SOLID, ven::RenderBucket::MASKED}) {
+        // a nearer draw goes first whatever its material, the material only orders draws at the same depth
+        EXPECT_LT(key(bucket, MAX_MATERIAL, 10.0F), key(bucket, 0, 10.01F));
+        EXPECT_LT(key(bucket, 1, 10.0F), key(bucket, 2, 10.0F));
+    }
+    EXPECT_LT(key(ven::RenderBucket::BLENDED, MAX_MATERIAL, 10.01F), key(ven::RenderBucket::BLENDED, 0, 10.0F));
+}
+
+TEST(RENDER_QUEUE, sort){
+    ven::RenderQueue queue;
+    // firstIndex identifies the draw in the sorted result
+    queue.push(ven::RenderBucket::BLENDED, 0, 1.0F, { .firstIndex = 5, .pipeline = ven::PipelineType::BLENDED });
+    queue.push(ven::RenderBucket::SOLID, 3, 2.0F, { .firstIndex = 2, .pipeline = ven::PipelineType::SOLID });
+    queue.push(ven::RenderBucket::BLENDED, 0, 4.0F, { .firstIndex = 4, .pipeline = ven::PipelineType::BLENDED });
+    queue.push(ven::RenderBucket::MASKED, 0, 1.0F, { .firstIndex = 3, .pipeline = ven::PipelineType::MASKED });
+    queue.push(ven::RenderBucket::SOLID, 7, 1.0F, { .firstIndex = 1, .pipeline = ven::PipelineType::SOLID });
+    queue.push(ven::RenderBucket::DEPTH_PREPASS, 0, 9.0F, { .firstIndex = 0, .pipeline = ven::PipelineType::DEPTH });
+    const std::vector<ven::DrawCommand>& draws = queue.sort();
+    ASSERT_EQ(draws.size(), 6U);
+    for (uint32_t i = 0; i < draws.size(); i++) {
+        EXPECT_EQ(draws[i].firstIndex, i);
+    }
+    queue.clear();
+    EXPECT_TRUE(queue.sort().empty());
+}
+
+TEST(RENDER_QUEUE, pipelines){
+    using ven::AlphaMode;
+    using ven::PipelineType;
+    using ven::RenderQueue;
+    EXPECT_EQ(RenderQueue::getBucket(AlphaMode::SOLID), ven::RenderBucket::SOLID);
+    EXPECT_EQ(RenderQueue::getBucket(AlphaMode::MASKED), ven::RenderBucket::MASKED);
+    EXPECT_EQ(RenderQueue::getBucket(AlphaMode::BLENDED), ven::RenderBucket::BLENDED);
+    EXPECT_EQ(RenderQueue::getPipeline(ven::RenderBucket::DEPTH_PREPASS, AlphaMode::SOLID), PipelineType::DEPTH);
+    EXPECT_EQ(RenderQueue::getPipeline(ven::RenderBucket::DEPTH_PREPASS, AlphaMode::MASKED), PipelineType::DEPTH_MASKED);
+    EXPECT_EQ(RenderQueue::getPipeline(ven::RenderBucket::MASKED, AlphaMode::MASKED), PipelineType::MASKED);
+    EXPECT_EQ(RenderQueue::getPipeline(ven::RenderBucket::BLENDED, AlphaMode::BLENDED), PipelineType::BLENDED);
+}
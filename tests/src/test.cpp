@@ -1,3 +0,0 @@
-#include <gtest/gtest.h>
-
-TEST(FUNCTION_MAP_OPT_LONG, width){ return void }
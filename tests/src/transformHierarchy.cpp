@@ -0,0 +1,163 @@
+#include <random>
+
+#include <gtest/gtest.h>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "VEngine/Scene/TransformHierarchy.hpp"
+
+namespace {
+
+    ///
+    /// @brief Hierarchy mirrored by plain parent / local arrays, the world matrices are recomputed from scratch to check it
+    ///
+    class Mirror {
+
+        public:
+
+            explicit Mirror(const uint32_t seed) : m_random(seed) {}
+
+            uint32_t create(const uint32_t parent) {
+                const glm::mat4 local = randomLocal();
+                const uint32_t node = m_hierarchy.create(parent, local);
+                m_parents.push_back(parent);
+                m_locals.push_back(local);
+                return node;
+            }
+
+            void setLocal(const uint32_t node) {
+                m_locals[node] = randomLocal();
+                m_hierarchy.setLocal(node, m_locals[node]);
+            }
+
+            void expectWorlds() const {
+                for (uint32_t node = 0; node < m_parents.size(); node++) {
+                    glm::mat4 expected = m_locals[node];
+                    for (uint32_t parent = m_parents[node]; parent != ven::TransformHierarchy::NONE; parent = m_parents[parent]) {
+                        expected = m_locals[parent] * expected;
+                    }
+                    const glm::mat4& world = m_hierarchy.getWorld(node);
+                    for (int column = 0; column < 4; column++) {
+                        for (int row = 0; row < 4; row++) {
+                            ASSERT_NEAR(world[column][row], expected[column][row], 1e-3F) << "node " << node;
+                        }
+                    }
+                }
+            }
+
+            ven::TransformHierarchy& getHierarchy() { return m_hierarchy; }
+            uint32_t getNodeCount() const { return static_cast<uint32_t>(m_parents.size()); }
+
+        private:
+
+            glm::mat4 randomLocal() {
+                std::uniform_real_distribution offset(-5.0F, 5.0F);
+                std::uniform_real_distribution angle(0.0F, 6.28F);
+                std::uniform_real_distribution scale(0.5F, 1.5F);
+                glm::mat4 local = glm::translate(glm::mat4(1.0F), glm::vec3(offset(m_random), offset(m_random), offset(m_random)));
+                local = glm::rotate(local, angle(m_random), glm::vec3(offset(m_random), offset(m_random), 1.0F));
+                return glm::scale(local, glm::vec3(scale(m_random)));
+            }
+
+            std::mt19937 m_random;
+            ven::TransformHierarchy m_hierarchy;
+            std::vector<uint32_t> m_parents;
+            std::vector<glm::mat4> m_locals;
+
+    }; // class Mirror
+
+    /// Roots with children down to depth levels, every node but the last level has branching children
+    void createTree(Mirror& mirror, const uint32_t roots, const uint32_t branching, const uint32_t levels) {
+        std::vector<uint32_t> level;
+        for (uint32_t i = 0; i < roots; i++) {
+            level.push_back(mirror.create(ven::TransformHierarchy::NONE));
+        }
+        for (uint32_t depth = 1; depth < levels; depth++) {
+            std::vector<uint32_t> next;
+            for (const uint32_t parent : level) {
+                for (uint32_t i = 0; i < branching; i++) {
+                    next.push_back(mirror.create(parent));
+                }
+            }
+            level = std::move(next);
+        }
+    }
+
+} // namespace
+
+TEST(TRANSFORM_HIERARCHY, firstUpdate){
+    utl::ThreadPool threadPool(1);
+    Mirror mirror(1);
+    createTree(mirror, 2, 3, 4);
+    EXPECT_TRUE(mirror.getHierarchy().update(threadPool));
+    mirror.expectWorlds();
+    EXPECT_FALSE(mirror.getHierarchy().update(threadPool));
+}
+
+TEST(TRANSFORM_HIERARCHY, setLocalMidLevel){
+    utl::ThreadPool threadPool(1);
+    Mirror mirror(2);
+    createTree(mirror, 2, 3, 4);
+    ASSERT_TRUE(mirror.getHierarchy().update(threadPool));
+    // nodes 8 to 25 are at depth 2, their subtrees change and the rest keeps its matrices
+    mirror.setLocal(9);
+    mirror.setLocal(12);
+    EXPECT_TRUE(mirror.getHierarchy().update(threadPool));
+    mirror.expectWorlds();
+    // a root and a node below it in the same update
+    mirror.setLocal(1);
+    mirror.setLocal(20);
+    EXPECT_TRUE(mirror.getHierarchy().update(threadPool));
+    mirror.expectWorlds();
+}
+
+TEST(TRANSFORM_HIERARCHY, createAfterUpdate){
+    utl::ThreadPool threadPool(1);
+    Mirror mirror(3);
+    createTree(mirror, 2, 2, 3);
+    ASSERT_TRUE(mirror.getHierarchy().update(threadPool));
+    // new nodes in every level and a deeper one: the next update sorts them into their levels
+    const uint32_t leaf = mirror.getNodeCount() - 1;
+    const uint32_t child = mirror.create(leaf);
+    mirror.create(child);
+    mirror.create(0);
+    const uint32_t root = mirror.create(ven::TransformHierarchy::NONE);
+    mirror.create(root);
+    // set before the sort, through the slot the node was appended to
+    mirror.setLocal(child);
+    mirror.setLocal(3);
+    EXPECT_TRUE(mirror.getHierarchy().update(threadPool));
+    EXPECT_EQ(mirror.getHierarchy().getNodeCount(), mirror.getNodeCount());
+    mirror.expectWorlds();
+    // the handles stay valid after the sort
+    mirror.setLocal(child);
+    mirror.setLocal(leaf);
+    EXPECT_TRUE(mirror.getHierarchy().update(threadPool));
+    mirror.expectWorlds();
+}
+
+TEST(TRANSFORM_HIERARCHY, parallelLevel){
+    utl::ThreadPool threadPool(4);
+    Mirror mirror(4);
+    // a second level larger than PARALLEL_LEVEL_SIZE, with a child each
+    createTree(mirror, 1, ven::TransformHierarchy::PARALLEL_LEVEL_SIZE + 100, 2);
+    const uint32_t count = mirror.getNodeCount();
+    for (uint32_t parent = 1; parent < count; parent++) {
+        mirror.create(parent);
+    }
+    ASSERT_TRUE(mirror.getHierarchy().update(threadPool));
+    mirror.expectWorlds();
+    // the root moves every node, a few children move their own subtree only
+    mirror.setLocal(0);
+    EXPECT_TRUE(mirror.getHierarchy().update(threadPool));
+    mirror.expectWorlds();
+    for (uint32_t parent = 1; parent < count; parent += 97) {
+        mirror.setLocal(parent);
+    }
+    EXPECT_TRUE(mirror.getHierarchy().update(threadPool));
+    mirror.expectWorlds();
+}
+
+TEST(TRANSFORM_HIERARCHY, invalidParent){
+    ven::TransformHierarchy hierarchy;
+    EXPECT_THROW(hierarchy.create(0, glm::mat4(1.0F)), std::runtime_error);
+}